@@ -1387,6 +1387,15 @@ spy_goal( USES_REGS1 )
       return;
     }
   }
+#ifdef INCREMENTAL_TABLING
+  if (pe->ExtraPredFlags & IncrementalPredFlag) {
+    incremental_predicate_call(pe);
+    if (!(pe->PredFlags & (CountPredFlag|ProfiledPredFlag|SpiedPredFlag))) {
+      P = pe->cs.p_code.TrueCodeOfPred;
+      return;
+    }
+  }
+#endif /* INCREMENTAL_TABLING */
   /* first check if we need to increase the counter */
   if ((pe->PredFlags & CountPredFlag)) {
     LOCK(pe->StatisticsForPred.lock);
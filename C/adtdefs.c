@@ -834,6 +834,10 @@ Yap_NewPredPropByFunctor(FunctorEntry *fe, Term cur_mod)
   p->StatisticsForPred.NOfEntries = 0;
   p->StatisticsForPred.NOfHeadSuccesses = 0;
   p->StatisticsForPred.NOfRetries = 0;
+#ifdef YAPOR_GRANULARITY_CONTROL
+  p->OrWorkOfPred = 0;
+  p->OrSamplesOfPred = 0;
+#endif /* YAPOR_GRANULARITY_CONTROL */
 #ifdef TABLING
   p->TableOfPred = NULL;
 #endif /* TABLING */
@@ -925,6 +929,10 @@ Yap_NewThreadPred(PredEntry *ap USES_REGS)
   p->StatisticsForPred.NOfEntries = 0;
   p->StatisticsForPred.NOfHeadSuccesses = 0;
   p->StatisticsForPred.NOfRetries = 0;
+#ifdef YAPOR_GRANULARITY_CONTROL
+  p->OrWorkOfPred = 0;
+  p->OrSamplesOfPred = 0;
+#endif /* YAPOR_GRANULARITY_CONTROL */
 #ifdef TABLING
   p->TableOfPred = NULL;
 #endif /* TABLING */
@@ -982,6 +990,10 @@ Yap_NewPredPropByAtom(AtomEntry *ae, Term cur_mod)
   p->StatisticsForPred.NOfRetries = 0;
   p->TimeStampOfPred = 0L; 
   p->LastCallOfPred = LUCALL_ASSERT; 
+#ifdef YAPOR_GRANULARITY_CONTROL
+  p->OrWorkOfPred = 0;
+  p->OrSamplesOfPred = 0;
+#endif /* YAPOR_GRANULARITY_CONTROL */
 #ifdef TABLING
   p->TableOfPred = NULL;
 #endif /* TABLING */
@@ -1014,7 +1014,11 @@ IPred(PredEntry *ap, UInt NSlots, yamop *next_pc)
     ap->cs.p_code.TrueCodeOfPred = BaseAddr;
     ap->PredFlags |= IndexedPredFlag;
   }
-  if (ap->PredFlags & (SpiedPredFlag|CountPredFlag|ProfiledPredFlag)) {
+  if (ap->PredFlags & (SpiedPredFlag|CountPredFlag|ProfiledPredFlag)
+#ifdef INCREMENTAL_TABLING
+      || ap->ExtraPredFlags & IncrementalPredFlag
+#endif /* INCREMENTAL_TABLING */
+      ) {
     ap->OpcodeOfPred = Yap_opcode(_spy_pred);
     ap->CodeOfPred = (yamop *)(&(ap->OpcodeOfPred)); 
 #if defined(YAPOR) || defined(THREADS)
@@ -1040,6 +1044,32 @@ Yap_IPred(PredEntry *p, UInt NSlots, yamop *next_pc)
   IPred(p, NSlots, next_pc);
 }
 
+#ifdef INCREMENTAL_TABLING
+/* calls to incremental dynamic predicates go through spy_pred, so that
+   the tabled subgoals calling them are recorded, p is already locked */
+void
+Yap_IncrementalPredCode(PredEntry *p)
+{
+  /* spy_pred builds the index itself when there is more than one clause */
+  if (p->cs.p_code.FirstClause == NULL) {
+    p->PredFlags &= ~IndexedPredFlag;
+    p->cs.p_code.TrueCodeOfPred = FAILCODE;
+  } else if (!(p->PredFlags & IndexedPredFlag)) {
+    p->cs.p_code.TrueCodeOfPred = p->cs.p_code.FirstClause;
+  }
+  p->OpcodeOfPred = Yap_opcode(_spy_pred);
+  p->CodeOfPred = (yamop *)(&(p->OpcodeOfPred)); 
+}
+
+/* a clause was added to or removed from an incremental dynamic predicate */
+void
+Yap_UpdateIncrementalPred(PredEntry *p)
+{
+  Yap_IncrementalPredCode(p);
+  incremental_predicate_update(p);
+}
+#endif /* INCREMENTAL_TABLING */
+
 #define GONEXT(TYPE)      code_p = ((yamop *)(&(code_p->y_u.TYPE.next)))
 
 static void
@@ -1047,6 +1077,10 @@ RemoveMainIndex(PredEntry *ap)
 {
   yamop *First = ap->cs.p_code.FirstClause;
   int spied = ap->PredFlags & (SpiedPredFlag|CountPredFlag|ProfiledPredFlag);
+#ifdef INCREMENTAL_TABLING
+  if (ap->ExtraPredFlags & IncrementalPredFlag)
+    spied = TRUE;
+#endif /* INCREMENTAL_TABLING */
 
   ap->PredFlags &= ~IndexedPredFlag;
   if (First == NULL) {
@@ -1620,6 +1654,10 @@ retract_all(PredEntry *p, int in_use)
     p->OpcodeOfPred = UNDEF_OPCODE;
   }
   p->cs.p_code.TrueCodeOfPred = p->CodeOfPred = (yamop *)(&(p->OpcodeOfPred));
+#ifdef INCREMENTAL_TABLING
+  if (p->ExtraPredFlags & IncrementalPredFlag)
+    Yap_IncrementalPredCode(p);
+#endif /* INCREMENTAL_TABLING */
   p->StatisticsForPred.NOfEntries = 0;
   p->StatisticsForPred.NOfHeadSuccesses = 0;
   p->StatisticsForPred.NOfRetries = 0;
@@ -2363,6 +2401,10 @@ addclause(Term t, yamop *cp, int mode, Term mod, Term *t4ref)
   }
   if (pflags & (SpiedPredFlag|CountPredFlag|ProfiledPredFlag))
     spy_flag = TRUE;
+#ifdef INCREMENTAL_TABLING
+  if (p->ExtraPredFlags & IncrementalPredFlag)
+    spy_flag = TRUE;
+#endif /* INCREMENTAL_TABLING */
   goal_expansion_support(p, tf);
   if (mode == consult) 
     not_was_reconsulted(p, t, TRUE);
@@ -2438,6 +2480,10 @@ addclause(Term t, yamop *cp, int mode, Term mod, Term *t4ref)
     }
 #endif
   }
+#ifdef INCREMENTAL_TABLING
+  if (p->ExtraPredFlags & IncrementalPredFlag)
+    Yap_UpdateIncrementalPred(p);
+#endif /* INCREMENTAL_TABLING */
   UNLOCKPE(32,p);
   if (pflags & LogUpdatePredFlag) {
     LogUpdClause *cl = (LogUpdClause *)ClauseCodeToLogUpdClause(cp);
@@ -2591,6 +2637,10 @@ Yap_add_logupd_clause(PredEntry *pe, LogUpdClause *cl, int mode) {
   } else {
     assertz_stat_clause(pe, cp, FALSE);
   }
+#ifdef INCREMENTAL_TABLING
+  if (pe->ExtraPredFlags & IncrementalPredFlag)
+    Yap_UpdateIncrementalPred(pe);
+#endif /* INCREMENTAL_TABLING */
 }
 
 static Int 
@@ -4147,6 +4147,10 @@ EraseLogUpdCl(LogUpdClause *clau)
       }
       clau->ClTimeEnd = ap->TimeStampOfPred;
       Yap_RemoveClauseFromIndex(ap, clau->ClCode);
+#ifdef INCREMENTAL_TABLING
+      if (ap->ExtraPredFlags & IncrementalPredFlag)
+	Yap_UpdateIncrementalPred(ap);
+#endif /* INCREMENTAL_TABLING */
       /* release the extra reference */
     }
     clau->ClRefCount--;
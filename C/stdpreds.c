@@ -1585,6 +1585,10 @@ p_access_yap_flags( USES_REGS1 )
   if (flag == TABLING_MODE_FLAG) {
 #ifdef TABLING
     tout = TermNil;
+    if (IsMode_Variant(yap_flags[flag]))
+      tout = MkPairTerm(MkAtomTerm(AtomVariant), tout);
+    else if (IsMode_Subsumptive(yap_flags[flag]))
+      tout = MkPairTerm(MkAtomTerm(AtomSubsumptive), tout);
     if (IsMode_LocalTrie(yap_flags[flag]))
       tout = MkPairTerm(MkAtomTerm(AtomLocalTrie), tout);
     else if (IsMode_GlobalTrie(yap_flags[flag]))
@@ -1753,6 +1757,20 @@ p_set_yap_flags( USES_REGS1 )
         tab_ent = TabEnt_next(tab_ent);
       }
       SetMode_CoInductive(yap_flags[TABLING_MODE_FLAG]);
+    } else if (value == 8) {  /* variant */
+      tab_ent_ptr tab_ent = GLOBAL_root_tab_ent;
+      while(tab_ent) {
+	SetMode_Variant(TabEnt_mode(tab_ent));
+	tab_ent = TabEnt_next(tab_ent);
+      }
+      SetMode_Variant(yap_flags[TABLING_MODE_FLAG]);
+    } else if (value == 9) {  /* subsumptive */
+      tab_ent_ptr tab_ent = GLOBAL_root_tab_ent;
+      while(tab_ent) {
+	SetMode_Subsumptive(TabEnt_mode(tab_ent));
+	tab_ent = TabEnt_next(tab_ent);
+      }
+      SetMode_Subsumptive(yap_flags[TABLING_MODE_FLAG]);
     } 
     break;
 #endif /* TABLING */
@@ -1903,6 +1921,26 @@ static Int p_parallel_mode( USES_REGS1 ) {
   return FALSE;
 }
 
+static Int p_parallel_wait_mode( USES_REGS1 ) {
+  return FALSE;
+}
+
+static Int p_parallel_scheduler_mode( USES_REGS1 ) {
+  return FALSE;
+}
+
+static Int p_parallel_copy_mode( USES_REGS1 ) {
+  return FALSE;
+}
+
+static Int p_yapor_trace_dump( USES_REGS1 ) {
+  return FALSE;
+}
+
+static Int p_parallel_granularity( USES_REGS1 ) {
+  return FALSE;
+}
+
 static Int p_yapor_workers( USES_REGS1 ) {
   return FALSE;
 }
@@ -2015,6 +2053,11 @@ the top-level.
   Yap_InitCPred("$has_eam", 0, p_has_eam, SafePredFlag|SyncPredFlag);
 #ifndef YAPOR
   Yap_InitCPred("parallel_mode", 1, p_parallel_mode, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("parallel_wait_mode", 1, p_parallel_wait_mode, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("parallel_scheduler_mode", 1, p_parallel_scheduler_mode, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("parallel_copy_mode", 1, p_parallel_copy_mode, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("yapor_trace_dump", 1, p_yapor_trace_dump, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("parallel_granularity", 1, p_parallel_granularity, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("$c_yapor_workers", 1, p_yapor_workers, SafePredFlag|SyncPredFlag);
 #endif /* YAPOR */
 #ifdef INES
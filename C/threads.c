@@ -500,6 +500,12 @@ thread_run(void *widp)
 #endif /* THREADS_FULL_SHARING */
     DETACH_PAGES(_pages_gt_node);
     DETACH_PAGES(_pages_gt_hash);
+#ifdef STRUCT_MAGAZINES
+    DETACH_MAGAZINE(struct subgoal_frame, _pages_sg_fr);
+    DETACH_MAGAZINE(struct dependency_frame, _pages_dep_fr);
+    DETACH_MAGAZINE(struct subgoal_trie_node, _pages_sg_node);
+    DETACH_MAGAZINE(struct answer_trie_node, _pages_ans_node);
+#endif /* STRUCT_MAGAZINES */
 #ifdef OUTPUT_THREADS_TABLING 
     fclose(LOCAL_thread_output);
 #endif /* OUTPUT_THREADS_TABLING */
@@ -1276,7 +1282,7 @@ p_new_mutex( USES_REGS1 )
 
    if (pthread_cond_broadcast(condp) < 0)
      return FALSE;
- v  return TRUE;
+   return TRUE;
  }
 
  static Int
@@ -655,6 +655,7 @@ don;t forget to also add in qly.h
 */
 typedef enum
 {
+  IncrementalPredFlag = ((UInt)0x00000020 << EXTRA_FLAG_BASE),		/* updates invalidate the incremental tables that depend on it */
   DiscontiguousPredFlag = ((UInt)0x00000010 << EXTRA_FLAG_BASE),	/* predicates whose clauses may be all-over the place.. */
   SysExportPredFlag = ((UInt)0x00000008 << EXTRA_FLAG_BASE),		/* reuse export list to prolog module. */
   NoTracePredFlag = ((UInt)0x00000004 << EXTRA_FLAG_BASE),		/* cannot trace this predicate */
@@ -750,6 +751,10 @@ typedef struct pred_entry
 #if defined(YAPOR) || defined(THREADS)
   lockvar PELock;		/* a simple lock to protect expansion */
 #endif
+#ifdef YAPOR_GRANULARITY_CONTROL
+  UInt OrWorkOfPred;		/* average work (ns) of a shared alternative */
+  UInt OrSamplesOfPred;		/* number of alternatives sampled */
+#endif /* YAPOR_GRANULARITY_CONTROL */
 #ifdef TABLING
   tab_ent_ptr TableOfPred;
 #endif				/* TABLING */
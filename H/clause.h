@@ -270,6 +270,10 @@ void    Yap_InitComma(void);
 
 /* cdmgr.c */
 void	Yap_IPred(PredEntry *, UInt, yamop *);
+#ifdef INCREMENTAL_TABLING
+void	Yap_IncrementalPredCode(PredEntry *);
+void	Yap_UpdateIncrementalPred(PredEntry *);
+#endif /* INCREMENTAL_TABLING */
 int	Yap_addclause(Term,yamop *,int,Term,Term*);
 void	Yap_add_logupd_clause(PredEntry *,LogUpdClause *,int);
 void	Yap_kill_iblock(ClauseUnion *,ClauseUnion *,PredEntry *);
@@ -138,6 +138,7 @@
   AtomGlobalSp = Yap_LookupAtom("global_sp");
   AtomGlobalTrie = Yap_LookupAtom("global_trie");
   AtomGoalExpansion = Yap_LookupAtom("goal_expansion");
+  AtomGroundHash = Yap_LookupAtom("ground_hash");
   AtomHat = Yap_LookupAtom("^");
   AtomHERE = Yap_LookupAtom("\n   <====HERE====>  \n");
   AtomHandleThrow = Yap_FullLookupAtom("$handle_throw");
@@ -146,6 +147,7 @@
   AtomIDB = Yap_LookupAtom("idb");
   AtomIOMode = Yap_LookupAtom("io_mode");
   AtomId = Yap_LookupAtom("id");
+  AtomIncremental = Yap_LookupAtom("incremental");
   AtomInf = Yap_LookupAtom("inf");
   AtomInfinity = Yap_LookupAtom("infinity");
   AtomInitGoal = Yap_FullLookupAtom("$init_goal");
@@ -307,6 +309,7 @@
   AtomStreamPosition = Yap_LookupAtom("stream_position");
   AtomString = Yap_LookupAtom("string");
   AtomSTRING = Yap_FullLookupAtom("String");
+  AtomSubsumptive = Yap_LookupAtom("subsumptive");
   AtomSwi = Yap_LookupAtom("swi");
   AtomSyntaxError = Yap_LookupAtom("syntax_error");
   AtomSyntaxErrorHandler = Yap_LookupAtom("syntax_error_handler");
@@ -345,6 +348,7 @@
   AtomVarBranches = Yap_LookupAtom("var_branches");
   AtomHiddenVar = Yap_FullLookupAtom("$V");
   AtomVariable = Yap_LookupAtom("variable");
+  AtomVariant = Yap_LookupAtom("variant");
   AtomVersionNumber = Yap_FullLookupAtom("$version_name");
   AtomWakeUpGoal = Yap_FullLookupAtom("$wake_up_goal");
   AtomWhen = Yap_FullLookupAtom("$when");
@@ -138,6 +138,7 @@
   AtomGlobalSp = AtomAdjust(AtomGlobalSp);
   AtomGlobalTrie = AtomAdjust(AtomGlobalTrie);
   AtomGoalExpansion = AtomAdjust(AtomGoalExpansion);
+  AtomGroundHash = AtomAdjust(AtomGroundHash);
   AtomHat = AtomAdjust(AtomHat);
   AtomHERE = AtomAdjust(AtomHERE);
   AtomHandleThrow = AtomAdjust(AtomHandleThrow);
@@ -146,6 +147,7 @@
   AtomIDB = AtomAdjust(AtomIDB);
   AtomIOMode = AtomAdjust(AtomIOMode);
   AtomId = AtomAdjust(AtomId);
+  AtomIncremental = AtomAdjust(AtomIncremental);
   AtomInf = AtomAdjust(AtomInf);
   AtomInfinity = AtomAdjust(AtomInfinity);
   AtomInitGoal = AtomAdjust(AtomInitGoal);
@@ -307,6 +309,7 @@
   AtomStreamPosition = AtomAdjust(AtomStreamPosition);
   AtomString = AtomAdjust(AtomString);
   AtomSTRING = AtomAdjust(AtomSTRING);
+  AtomSubsumptive = AtomAdjust(AtomSubsumptive);
   AtomSwi = AtomAdjust(AtomSwi);
   AtomSyntaxError = AtomAdjust(AtomSyntaxError);
   AtomSyntaxErrorHandler = AtomAdjust(AtomSyntaxErrorHandler);
@@ -345,6 +348,7 @@
   AtomVarBranches = AtomAdjust(AtomVarBranches);
   AtomHiddenVar = AtomAdjust(AtomHiddenVar);
   AtomVariable = AtomAdjust(AtomVariable);
+  AtomVariant = AtomAdjust(AtomVariant);
   AtomVersionNumber = AtomAdjust(AtomVersionNumber);
   AtomWakeUpGoal = AtomAdjust(AtomWakeUpGoal);
   AtomWhen = AtomAdjust(AtomWhen);
@@ -274,6 +274,8 @@
 #define AtomGlobalTrie Yap_heap_regs->AtomGlobalTrie_
   Atom AtomGoalExpansion_;
 #define AtomGoalExpansion Yap_heap_regs->AtomGoalExpansion_
+  Atom AtomGroundHash_;
+#define AtomGroundHash Yap_heap_regs->AtomGroundHash_
   Atom AtomHat_;
 #define AtomHat Yap_heap_regs->AtomHat_
   Atom AtomHERE_;
@@ -290,6 +292,8 @@
 #define AtomIOMode Yap_heap_regs->AtomIOMode_
   Atom AtomId_;
 #define AtomId Yap_heap_regs->AtomId_
+  Atom AtomIncremental_;
+#define AtomIncremental Yap_heap_regs->AtomIncremental_
   Atom AtomInf_;
 #define AtomInf Yap_heap_regs->AtomInf_
   Atom AtomInfinity_;
@@ -612,6 +616,8 @@
 #define AtomString Yap_heap_regs->AtomString_
   Atom AtomSTRING_;
 #define AtomSTRING Yap_heap_regs->AtomSTRING_
+  Atom AtomSubsumptive_;
+#define AtomSubsumptive Yap_heap_regs->AtomSubsumptive_
   Atom AtomSwi_;
 #define AtomSwi Yap_heap_regs->AtomSwi_
   Atom AtomSyntaxError_;
@@ -688,6 +694,8 @@
 #define AtomHiddenVar Yap_heap_regs->AtomHiddenVar_
   Atom AtomVariable_;
 #define AtomVariable Yap_heap_regs->AtomVariable_
+  Atom AtomVariant_;
+#define AtomVariant Yap_heap_regs->AtomVariant_
   Atom AtomVersionNumber_;
 #define AtomVersionNumber Yap_heap_regs->AtomVersionNumber_
   Atom AtomWakeUpGoal_;
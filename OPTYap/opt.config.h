@@ -26,7 +26,23 @@
 #define THREADS_INDIRECT_BUCKETS  ((MAX_THREADS - THREADS_DIRECT_BUCKETS) / THREADS_DIRECT_BUCKETS)  /* (1024 - 32) / 32 = 31 */
 #define THREADS_NUM_BUCKETS       (THREADS_DIRECT_BUCKETS + THREADS_INDIRECT_BUCKETS)
 #define TG_ANSWER_SLOTS    20
-#define MAX_BRANCH_DEPTH   1000
+#define QG_ANSWER_SLOTS    32
+#define MAX_BRANCH_DEPTH   (256 * BRANCH_CHUNK_SIZE)
+#define BRANCH_CHUNK_SIZE  1024
+#define COMPACTION_QUEUE_SIZE 1024
+#define ANSWER_EVENT_WAIT_USECS 1000
+#define BLOCKING_WAIT_SPINS 1000
+#define BLOCKING_WAIT_USECS 1000
+#define STEAL_DEQUE_SIZE 64
+#define MAGAZINE_BATCH_SIZE 32
+#define MAGAZINE_DEPOT_BATCHES 64
+#define MAGAZINE_RELEASE_SPILLS 4
+#define TRACE_BUFFER_SIZE 8192
+#define GRANULARITY_COPY_RATIO  4
+#define GRANULARITY_MIN_SAMPLES 8
+#define GRANULARITY_MAX_NODES   64
+#define SUSPENSION_COMPRESSION_MIN_BYTES 4096
+#define ANSWER_TRIE_RANGE_SIZE  32
 
 /**********************************************************************
 **      memory mapping scheme for YapOr (mandatory, define one)      **
@@ -34,11 +50,44 @@
 #define MMAP_MEMORY_MAPPING_SCHEME 1
 /* #define SHM_MEMORY_MAPPING_SCHEME 1 */
 
+/************************************************************************
+**      record a timeline of YapOr scheduler events ? (optional)       **
+*************************************************************************
+** Each worker records timestamped scheduler events (get_work,         **
+** sharing, suspension, resumption, public completion and idle         **
+** periods) in a ring of TRACE_BUFFER_SIZE events of its own.          **
+** Recording an event only takes a clock read and a store, without     **
+** locks, thus it can be kept enabled. yapor_trace_dump/1 writes the   **
+** events of the last parallel goal in the Chrome/Perfetto JSON trace  **
+** format.                                                             **
+************************************************************************/
+#define YAPOR_TRACING 1
+
+/************************************************************************
+**      control the granularity of the shared work ? (optional)        **
+*************************************************************************
+** The work done by each alternative taken from a shared node is timed **
+** and averaged in counters of the predicate of the node               **
+** (OrWorkOfPred/OrSamplesOfPred in PredEntry). A sharing request is   **
+** refused when the private nodes are expected to do less work than    **
+** the average cost of sharing times the ratio set with                **
+** parallel_granularity/1 (GRANULARITY_COPY_RATIO by default, 0        **
+** disables it). Nodes of predicates with less than                    **
+** GRANULARITY_MIN_SAMPLES samples are always shared.                  **
+** Off by default, as it has not yet been measured on multi-core runs. **
+************************************************************************/
+/* #define YAPOR_GRANULARITY_CONTROL 1 */
+
 /****************************************************************
 **      use shared pages memory alloc scheme ? (optional)      **
 ****************************************************************/
 /* #define USE_PAGES_MALLOC 1 */
 
+/***************************************************************************
+**      use per-worker magazines of free tabling structs ? (optional)     **
+***************************************************************************/
+#define STRUCT_MAGAZINES 1
+
 /**********************************************************************
 **      trail freeze scheme for tabling (mandatory, define one)      **
 **********************************************************************/
@@ -68,6 +117,12 @@
 ** only locks a table data structure when it is going to update it. You **
 ** can use (TRIE_TYPE)_ALLOC_BEFORE_CHECK with this scheme to allocate  **
 ** a node before checking if it will be necessary.                      **
+**                                                                      **
+** The ANSWER_TRIE_LOCK_FREE scheme never locks the answer trie levels. **
+** New nodes and hashes are published with compare-and-swap operations **
+** and lookups go through the trie without locking. Full hash buckets  **
+** are expanded into new hash levels, thus nodes are never moved. Only **
+** the leaf nodes are still locked to mark new answers.                **
 *************************************************************************/
 /* #define SUBGOAL_TRIE_LOCK_AT_ENTRY_LEVEL 1 */
 #define SUBGOAL_TRIE_LOCK_AT_NODE_LEVEL  1
@@ -77,6 +132,7 @@
 /* #define ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL 1 */
 #define ANSWER_TRIE_LOCK_AT_NODE_LEVEL  1
 /* #define ANSWER_TRIE_LOCK_AT_WRITE_LEVEL 1 */
+/* #define ANSWER_TRIE_LOCK_FREE           1 */
 /* #define ANSWER_TRIE_ALLOC_BEFORE_CHECK  1 */
 
 #define GLOBAL_TRIE_LOCK_AT_NODE_LEVEL  1
@@ -97,6 +153,20 @@
 *********************************************************/
 #define MODE_DIRECTED_TABLING 1
 
+/************************************************************************
+**      reclaim invalid answers using epochs ? (optional)              **
+*************************************************************************
+** With THREADS_FULL_SHARING or THREADS_CONSUMER_SHARING, the answers  **
+** replaced by mode directed tabling cannot be freed at completion     **
+** since other threads may still be reading them. The invalid answers  **
+** of a completed subgoal are retired to a limbo list in the current   **
+** epoch and are freed once every thread that entered the tables has   **
+** announced a later epoch, when entering the tables again without an  **
+** evaluation running or when completing its evaluation. The threads   **
+** left with no answers to load are not waited for.                    **
+************************************************************************/
+#define EPOCH_RECLAMATION 1
+
 /****************************************************************
 **      support early completion for tabling ? (optional)      **
 *****************************************************************/
@@ -107,6 +177,151 @@
 ******************************************************/
 #define TRIE_COMPACT_PAIRS 1
 
+/************************************************************************
+**      expand trie hashes incrementally ? (optional)                  **
+*************************************************************************
+** When a trie hash doubles its number of buckets, the nodes in the    **
+** old buckets are moved to the new buckets a few buckets at a time by **
+** the following insertions, instead of being all rehashed at once.    **
+** Tries using the (TRIE_TYPE)_LOCK_AT_WRITE_LEVEL scheme keep the     **
+** rehash at once since their readers go through the buckets without  **
+** locking.                                                            **
+************************************************************************/
+#define INCREMENTAL_HASH_EXPANSION 1
+
+/************************************************************************
+**      use a mixing hash function for trie entries ? (optional)       **
+*************************************************************************
+** By default, the bucket of a trie entry is given by its low bits,    **
+** after removing the tag bits. Consecutive integers and atoms or      **
+** functors allocated at aligned addresses then share a few buckets.   **
+** The mixing hash scrambles all the entry bits with the murmur3       **
+** finalizer (fmix) before selecting the bucket.                       **
+************************************************************************/
+/* #define TRIE_MIXING_HASH 1 */
+
+/************************************************************************
+**      compact the answer tries of compiled tables ? (optional)       **
+*************************************************************************
+** When a completed table is first executed by compiled code, its      **
+** answer trie is copied in depth-first order to a single block of     **
+** compact nodes. A compact node only keeps the trie instruction, the  **
+** entry and a 32-bit offset to its next sibling node, the first child **
+** node being the next node in the block. The original answer trie     **
+** nodes are then released.                                            **
+************************************************************************/
+#define COMPACT_ANSWER_TRIES 1
+
+/************************************************************************
+**      compact the answer tries at completion time ? (optional)       **
+*************************************************************************
+** Instead of waiting for the first execution of a completed table,    **
+** the answer tries are compacted when their subgoals are completed by **
+** a leader node. With YapOr, the completed subgoals are queued and    **
+** compacted by the workers that are idle waiting for work.            **
+************************************************************************/
+#define COMPACT_ANSWER_TRIES_AT_COMPLETION 1
+
+/************************************************************************
+**      compress the suspended branches ? (optional)                   **
+*************************************************************************
+** The global, local and trail blocks saved by suspend_branch() are    **
+** stored with an LZ77 codec working on cells, in the spirit of LZ4:   **
+** runs of cells repeated in a block (atoms, functors, integers and    **
+** empty cells) are replaced by references to their previous           **
+** occurrence. Blocks smaller than SUSPENSION_COMPRESSION_MIN_BYTES,   **
+** or that do not shrink, are stored raw. A parallel goal raises an    **
+** error when its suspended blocks went above the                      **
+** suspension_space_threshold flag (checked after each suspension).    **
+************************************************************************/
+#define SUSPENSION_COMPRESSION 1
+
+/************************************************************************
+**      share the completed answer tries in ranges ? (optional)        **
+*************************************************************************
+** When a shared node of a completed answer trie is taken by a worker, **
+** the worker also takes the following sibling nodes of the trie       **
+** level, up to the remaining siblings divided by the number of        **
+** workers and at most ANSWER_TRIE_RANGE_SIZE nodes. The or-frame is   **
+** left with the sibling after the range and the worker exploits the   **
+** range without locking it, thus the idle workers share the answer    **
+** trie in disjoint ranges of subtries.                                **
+************************************************************************/
+#define ANSWER_TRIE_RANGES 1
+
+/************************************************************************
+**      support call subsumption for completed tables ? (optional)     **
+*************************************************************************
+** With tabling_mode subsumptive, a new call that is an instance of a  **
+** completed subgoal of the same predicate is not evaluated. Instead,  **
+** the answers of the more general subgoal that unify with the call    **
+** are copied to the answer trie of the new subgoal, which is then     **
+** marked as completed.                                                **
+************************************************************************/
+#define TABLING_CALL_SUBSUMPTION 1
+
+/************************************************************************
+**      index the wide levels of compact answer tries ? (optional)     **
+*************************************************************************
+** When a subsumed call binds a variable of the subsuming subgoal to   **
+** an atom or an integer, the answers are loaded from the wide levels  **
+** of the compact answer trie by looking up the bound entry in a       **
+** hashed switch of the level, instead of scanning all its sibling     **
+** nodes. The switches are built for the levels with at least          **
+** MIN_NODES_PER_TRIE_SWITCH nodes, the first time the compact answer  **
+** trie subsumes a new call.                                           **
+************************************************************************/
+#define ANSWER_TRIE_SWITCHES 1
+
+/************************************************************************
+**      support saving and loading table snapshots ? (optional)        **
+*************************************************************************
+** save_tables/2 writes the completed subgoals of the given tables and **
+** their compact answer tries to a binary file, load_tables/2 maps the **
+** file back with mmap. The atoms and functors of the trie entries are **
+** relocated through the atom and functor tables of the file and the   **
+** loaded subgoals execute their answers directly from the mapped      **
+** compact answer tries.                                               **
+************************************************************************/
+#define TABLE_SNAPSHOTS 1
+
+/************************************************************************
+**      support incremental tabling ? (optional)                       **
+*************************************************************************
+** The subgoals of the tables declared as incremental record the       **
+** incremental tables and the dynamic predicates declared as           **
+** incremental that are called during their evaluation. When a clause  **
+** of such a dynamic predicate is asserted or retracted, the completed **
+** subgoals that depend on it are invalidated and are evaluated again  **
+** on their next call.                                                 **
+************************************************************************/
+#define INCREMENTAL_TABLING 1
+
+/************************************************************************
+**      free abolished tables in the background ? (optional)           **
+*************************************************************************
+** With yap_flag(table_abolish_mode,deferred), abolish_table/1 and     **
+** abolish_all_tables/0 detach the subgoal tries from the table        **
+** entries and return at once. The detached tries are freed one first  **
+** level subtrie at a time, by the YapOr workers idle waiting for work **
+** and at each new subgoal call.                                       **
+************************************************************************/
+#define DEFERRED_ABOLISH 1
+
+/************************************************************************
+**      hash the large ground calls of tabled predicates ? (optional)  **
+*************************************************************************
+** With tabling_mode ground_hash, a call whose arguments are ground    **
+** terms or distinct free variables, and that has at least             **
+** GROUND_CALL_MIN_CELLS cells, is flattened to a buffer of cells and  **
+** looked up, by the hash of the cells, in a hash table of the table   **
+** entry. A repeated call gets its subgoal trie leaf node from the     **
+** hash table and the subgoal trie is not walked. New calls, and calls **
+** that do not match the cells of any call in their bucket, walk the   **
+** subgoal trie as usual.                                              **
+************************************************************************/
+#define GROUND_CALL_HASHING 1
+
 /************************************************************
 **      support global trie for subterms ? (optional)      **
 ************************************************************/
@@ -117,9 +332,16 @@
 ******************************************************/
 /* #define INCOMPLETE_TABLING 1 */
 
-/******************************************************
-**      limit the table space size ? (optional)      **
-******************************************************/
+/************************************************************************
+**      limit the table space size ? (optional)                        **
+*************************************************************************
+** With yap_flag(table_space_limit,Bytes), the answer tries of the     **
+** least recently used completed subgoals are released when a new      **
+** subgoal is called and the table space exceeds the given budget. The **
+** released subgoals are evaluated again on their next call. Subgoals  **
+** being consumed are not in the LRU list and are never released. Each **
+** thread keeps its own LRU list of its own subgoals.                  **
+************************************************************************/
 /* #define LIMIT_TABLING 1 */
 
 /*********************************************************
@@ -170,9 +392,20 @@
 #if defined(MMAP_MEMORY_MAPPING_SCHEME) && defined(SHM_MEMORY_MAPPING_SCHEME)
 #error Do not define multiple memory mapping schemes
 #endif
+#if STEAL_DEQUE_SIZE & (STEAL_DEQUE_SIZE - 1)
+#error STEAL_DEQUE_SIZE must be a power of two
+#endif
+#if TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)
+#error TRACE_BUFFER_SIZE must be a power of two
+#endif
+#if MAX_BRANCH_DEPTH % BRANCH_CHUNK_SIZE
+#error MAX_BRANCH_DEPTH must be a multiple of BRANCH_CHUNK_SIZE
+#endif
 #else /* ! YAPOR */
 #undef MMAP_MEMORY_MAPPING_SCHEME
 #undef SHM_MEMORY_MAPPING_SCHEME
+#undef YAPOR_TRACING
+#undef YAPOR_GRANULARITY_CONTROL
 #undef DEBUG_YAPOR
 #endif /* YAPOR */
 
@@ -189,6 +422,15 @@
 #undef MODE_DIRECTED_TABLING
 #undef TABLING_EARLY_COMPLETION
 #undef TRIE_COMPACT_PAIRS
+#undef INCREMENTAL_HASH_EXPANSION
+#undef TRIE_MIXING_HASH
+#undef COMPACT_ANSWER_TRIES
+#undef TABLING_CALL_SUBSUMPTION
+#undef ANSWER_TRIE_SWITCHES
+#undef TABLE_SNAPSHOTS
+#undef INCREMENTAL_TABLING
+#undef DEFERRED_ABOLISH
+#undef GROUND_CALL_HASHING
 #undef GLOBAL_TRIE_FOR_SUBTERMS
 #undef INCOMPLETE_TABLING
 #undef LIMIT_TABLING
@@ -214,7 +456,7 @@
 #undef SUBGOAL_TRIE_ALLOC_BEFORE_CHECK
 #endif 
 /* ANSWER_TRIE_LOCK_LEVEL */
-#if !defined(ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL) && !defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL) && !defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL)
+#if !defined(ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL) && !defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL) && !defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL) && !defined(ANSWER_TRIE_LOCK_FREE)
 #error Define a answer trie lock scheme
 #endif
 #if defined(ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL) && defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL)
@@ -226,6 +468,9 @@
 #if defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL) && defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL)
 #error Do not define multiple answer trie lock schemes
 #endif
+#if defined(ANSWER_TRIE_LOCK_FREE) && (defined(ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL) || defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL) || defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL))
+#error Do not define multiple answer trie lock schemes
+#endif
 #ifndef ANSWER_TRIE_LOCK_AT_WRITE_LEVEL
 #undef ANSWER_TRIE_ALLOC_BEFORE_CHECK
 #endif 
@@ -254,6 +499,7 @@
 #undef ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL
 #undef ANSWER_TRIE_LOCK_AT_NODE_LEVEL
 #undef ANSWER_TRIE_LOCK_AT_WRITE_LEVEL
+#undef ANSWER_TRIE_LOCK_FREE
 #undef ANSWER_TRIE_ALLOC_BEFORE_CHECK
 #undef GLOBAL_TRIE_LOCK_AT_NODE_LEVEL
 #undef GLOBAL_TRIE_LOCK_AT_WRITE_LEVEL
@@ -294,6 +540,7 @@
 #undef ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL
 #undef ANSWER_TRIE_LOCK_AT_NODE_LEVEL
 #undef ANSWER_TRIE_LOCK_AT_WRITE_LEVEL
+#undef ANSWER_TRIE_LOCK_FREE
 #undef ANSWER_TRIE_ALLOC_BEFORE_CHECK
 #endif
 #else /* ! TABLING || ! THREADS */
@@ -307,7 +554,7 @@
 #if defined(SUBGOAL_TRIE_LOCK_AT_NODE_LEVEL) || defined(SUBGOAL_TRIE_LOCK_AT_WRITE_LEVEL)
 #define SUBGOAL_TRIE_LOCK_USING_NODE_FIELD   1
 #endif
-#if defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL) || defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL)
+#if defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL) || defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL) || defined(ANSWER_TRIE_LOCK_FREE)
 #define ANSWER_TRIE_LOCK_USING_NODE_FIELD    1
 #endif
 #if defined(GLOBAL_TRIE_LOCK_AT_NODE_LEVEL) || defined(GLOBAL_TRIE_LOCK_AT_WRITE_LEVEL)
@@ -317,7 +564,7 @@
 #if defined(SUBGOAL_TRIE_LOCK_AT_NODE_LEVEL) || defined(SUBGOAL_TRIE_LOCK_AT_WRITE_LEVEL)
 #define SUBGOAL_TRIE_LOCK_USING_GLOBAL_ARRAY 1
 #endif
-#if defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL) || defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL)
+#if defined(ANSWER_TRIE_LOCK_AT_NODE_LEVEL) || defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL) || defined(ANSWER_TRIE_LOCK_FREE)
 #define ANSWER_TRIE_LOCK_USING_GLOBAL_ARRAY  1
 #endif
 #if defined(GLOBAL_TRIE_LOCK_AT_NODE_LEVEL) || defined(GLOBAL_TRIE_LOCK_AT_WRITE_LEVEL)
@@ -338,20 +585,65 @@
 #define DEBUG_OPTYAP
 #endif
 
-#if defined(LIMIT_TABLING) && !defined(USE_PAGES_MALLOC)
-#error LIMIT_TABLING requires USE_PAGES_MALLOC
-#endif
-
 #if defined(YAPOR) || defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
 #undef TABLING_EARLY_COMPLETION
 #endif
 
+#if defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
+#undef COMPACT_ANSWER_TRIES
+#undef TABLING_CALL_SUBSUMPTION
+#endif
+
+#if defined(YAPOR) || defined(THREADS)
+#undef INCREMENTAL_TABLING
+#undef GROUND_CALL_HASHING
+#endif
+
+#ifdef LIMIT_TABLING
+/* the retired subgoal frames would be put back on the LRU chain when **
+** their in use state is untrailed                                     */
+#undef INCREMENTAL_TABLING
+#endif
+
+#if !defined(TABLING) || !(defined(YAPOR) || defined(THREADS)) || defined(USE_PAGES_MALLOC)
+#undef STRUCT_MAGAZINES
+#endif
+
+#ifndef COMPACT_ANSWER_TRIES
+#undef COMPACT_ANSWER_TRIES_AT_COMPLETION
+#undef TABLE_SNAPSHOTS
+#endif
+
+#if !defined(COMPACT_ANSWER_TRIES) || !defined(TABLING_CALL_SUBSUMPTION)
+#undef ANSWER_TRIE_SWITCHES
+#endif
+
+#if !HAVE_MMAP
+#undef TABLE_SNAPSHOTS
+#endif
+
 #if defined(YAPOR) || defined(THREADS)
 #undef INCOMPLETE_TABLING
-#undef LIMIT_TABLING
 #undef DETERMINISTIC_TABLING
 #endif
 
+#if defined(YAPOR) || defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
+#undef LIMIT_TABLING
+#endif
+
 #if defined(YAPOR)
 #undef MODE_DIRECTED_TABLING
 #endif
+
+#if !defined(TABLING) || !defined(YAPOR)
+#undef SUSPENSION_COMPRESSION
+#undef ANSWER_TRIE_RANGES
+#endif
+
+#if !defined(MODE_DIRECTED_TABLING) || !(defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING))
+#undef EPOCH_RECLAMATION
+#endif
+
+#if defined(THREADS)
+#undef DEFERRED_ABOLISH
+#endif
@@ -56,10 +56,30 @@
         PgEnt_strs_per_page(PG) = STRUCTS_PER_PAGE(STR_TYPE);  \
         PgEnt_first(PG) = NULL;                                \
         PgEnt_last(PG) = NULL;
+#elif defined(STRUCT_MAGAZINES)
+#define INIT_GLOBAL_PAGE_ENTRY(PG,STR_TYPE)                    \
+        INIT_LOCK(PgEnt_lock(PG));                             \
+        PgEnt_strs_in_use(PG) = 0;                             \
+        PgEnt_depot(PG) = NULL;                                \
+        PgEnt_depot_strs(PG) = 0;                              \
+        PgEnt_depot_full(PG) = 0;                              \
+        PgEnt_mag_allocs(PG) = 0;                              \
+        PgEnt_mag_refills(PG) = 0;                             \
+        PgEnt_mag_spills(PG) = 0;                              \
+        PgEnt_mag_chunks(PG) = 0;                              \
+        PgEnt_mag_releases(PG) = 0;                            \
+        PgEnt_mag_waits(PG) = 0;                               \
+        PgEnt_mag_lockers(PG) = 0
+#define INIT_LOCAL_PAGE_ENTRY(PG,STR_TYPE)   PgEnt_strs_in_use(PG) = 0
 #else
 #define INIT_GLOBAL_PAGE_ENTRY(PG,STR_TYPE)  PgEnt_strs_in_use(PG) = 0
 #define INIT_LOCAL_PAGE_ENTRY(PG,STR_TYPE)   PgEnt_strs_in_use(PG) = 0
 #endif /* USE_PAGES_MALLOC */
+#define INIT_LOCAL_MAGAZINE(MAG)                               \
+        Mag_first(MAG) = NULL;                                 \
+        Mag_strs(MAG) = 0;                                     \
+        Mag_strs_in_use(MAG) = 0;                              \
+        Mag_allocs(MAG) = 0
 
 
 
@@ -88,6 +108,9 @@ void Yap_init_global_optyap_data(int max_table_size, int n_workers, int sch_loop
   INIT_GLOBAL_PAGE_ENTRY(GLOBAL_pages_ans_hash, struct answer_trie_hash);
 #if defined(THREADS_FULL_SHARING)
   INIT_GLOBAL_PAGE_ENTRY(GLOBAL_pages_ans_ref_node, struct answer_ref_node);
+#endif
+#ifdef INCREMENTAL_TABLING
+  INIT_GLOBAL_PAGE_ENTRY(GLOBAL_pages_inc_dep, struct incremental_dependency);
 #endif
   INIT_GLOBAL_PAGE_ENTRY(GLOBAL_pages_gt_node, struct global_trie_node);
   INIT_GLOBAL_PAGE_ENTRY(GLOBAL_pages_gt_hash, struct global_trie_hash);
@@ -108,6 +131,7 @@ void Yap_init_global_optyap_data(int max_table_size, int n_workers, int sch_loop
 #ifdef YAPOR
   /* global static data */
   GLOBAL_number_workers= n_workers;
+  GLOBAL_bitmap_words = (n_workers + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS;
   GLOBAL_worker_pid(0) = getpid();
   for (i = 1; i < GLOBAL_number_workers; i++) GLOBAL_worker_pid(i) = 0;
   GLOBAL_scheduler_loop = sch_loop;
@@ -134,10 +158,22 @@ void Yap_init_global_optyap_data(int max_table_size, int n_workers, int sch_loop
   GLOBAL_locks_who_locked_heap = MAX_WORKERS;
   INIT_LOCK(GLOBAL_locks_heap_access);
   INIT_LOCK(GLOBAL_locks_alloc_block);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+  INIT_LOCK(GLOBAL_locks_compaction_queue);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
   if (GLOBAL_number_workers == 1)
     GLOBAL_parallel_mode = PARALLEL_MODE_OFF;
   else
     GLOBAL_parallel_mode = PARALLEL_MODE_ON;
+  GLOBAL_wait_mode = WAIT_MODE_SPIN;
+  GLOBAL_scheduler_mode = SCHEDULER_MODE_BITMAP;
+  GLOBAL_copy_mode = COPY_MODE_INCREMENTAL;
+#ifdef YAPOR_GRANULARITY_CONTROL
+  GLOBAL_granularity_ratio = GRANULARITY_COPY_RATIO;
+#endif /* YAPOR_GRANULARITY_CONTROL */
+  GLOBAL_work_events = 0;
+  GLOBAL_sleeping_workers = 0;
+  GLOBAL_signal_waiters = 0;
 #endif /* YAPOR */
 
 #ifdef TABLING
@@ -145,16 +181,26 @@ void Yap_init_global_optyap_data(int max_table_size, int n_workers, int sch_loop
   GLOBAL_root_gt = NULL;
   GLOBAL_root_tab_ent = NULL;
 #ifdef LIMIT_TABLING
-  if (max_table_size)
-    GLOBAL_max_pages = ((max_table_size - 1) * 1024 * 1024 / SHMMAX + 1) * SHMMAX / Yap_page_size;
-  else
-    GLOBAL_max_pages = -1;
-  GLOBAL_first_sg_fr = NULL;
-  GLOBAL_last_sg_fr = NULL;
-  GLOBAL_check_sg_fr = NULL;
+  GLOBAL_table_space_limit = (long) max_table_size * 1024 * 1024;
+  GLOBAL_table_space_bytes = 0;
+  GLOBAL_evicted_subgoals = 0;
+  GLOBAL_evicted_bytes = 0;
 #endif /* LIMIT_TABLING */
+#ifdef INCREMENTAL_TABLING
+  GLOBAL_root_inc_pred = NULL;
+  GLOBAL_incremental_updates = 0;
+  GLOBAL_invalidated_subgoals = 0;
+#endif /* INCREMENTAL_TABLING */
 #ifdef YAPOR
   new_dependency_frame(GLOBAL_root_dep_fr, FALSE, NULL, NULL, NULL, NULL, FALSE, NULL);
+  GLOBAL_suspension_space_threshold = 0;
+  GLOBAL_suspension_space_exceeded = 0;
+  GLOBAL_suspended_bytes = 0;
+  GLOBAL_suspended_raw_bytes = 0;
+  GLOBAL_suspended_peak_bytes = 0;
+  GLOBAL_suspended_branches = 0;
+  GLOBAL_suspended_total_bytes = 0;
+  GLOBAL_suspended_total_raw_bytes = 0;
 #endif /* YAPOR */
   for (i = 0; i < MAX_TABLE_VARS; i++) {
     CELL *pt = GLOBAL_table_var_enumerator_addr(i);
@@ -164,6 +210,37 @@ void Yap_init_global_optyap_data(int max_table_size, int n_workers, int sch_loop
   for (i = 0; i < TRIE_LOCK_BUCKETS; i++)
     INIT_LOCK(GLOBAL_trie_locks(i));
 #endif /* TRIE_LOCK_USING_GLOBAL_ARRAY */
+#ifdef COMPACT_ANSWER_TRIES
+  GLOBAL_cmp_ans_nodes = 0;
+#endif /* COMPACT_ANSWER_TRIES */
+#if defined(YAPOR) && defined(COMPACT_ANSWER_TRIES_AT_COMPLETION)
+  GLOBAL_compaction_queue_first = 0;
+  GLOBAL_compaction_queue_entries = 0;
+#endif /* YAPOR && COMPACT_ANSWER_TRIES_AT_COMPLETION */
+#ifdef TABLE_SNAPSHOTS
+  GLOBAL_table_snapshots = NULL;
+#endif /* TABLE_SNAPSHOTS */
+#ifdef DEFERRED_ABOLISH
+  GLOBAL_abolish_mode = ABOLISH_MODE_IMMEDIATE;
+  INIT_LOCK(GLOBAL_abolished_tries_lock);
+  GLOBAL_abolished_tries = NULL;
+  GLOBAL_abolished_tries_pending = 0;
+  GLOBAL_abolished_subtries_freed = 0;
+#endif /* DEFERRED_ABOLISH */
+#ifdef GROUND_CALL_HASHING
+  GLOBAL_ground_call_buffer = NULL;
+  GLOBAL_ground_call_buffer_size = 0;
+  GLOBAL_ground_call_lookups = 0;
+  GLOBAL_ground_call_hits = 0;
+#endif /* GROUND_CALL_HASHING */
+#ifdef EPOCH_RECLAMATION
+  INIT_LOCK(GLOBAL_epoch_lock);
+  GLOBAL_epoch = 0;
+  for (i = 0; i < 3; i++)
+    GLOBAL_epoch_limbo(i) = NULL;
+  GLOBAL_epoch_backlog = 0;
+  GLOBAL_epoch_reclaimed = 0;
+#endif /* EPOCH_RECLAMATION */
 #endif /* TABLING */
 
   return;
@@ -174,6 +251,9 @@ void Yap_init_local_optyap_data(int wid) {
 #if defined(YAPOR_THREADS) || defined(THREADS_CONSUMER_SHARING)
   CACHE_REGS
 #endif /* YAPOR_THREADS || THREADS_CONSUMER_SHARING */
+#ifdef YAPOR
+  int i;
+#endif /* YAPOR */
 
 #if defined(TABLING) && (defined(YAPOR) || defined(THREADS))
   /* local data related to memory management */
@@ -200,6 +280,12 @@ void Yap_init_local_optyap_data(int wid) {
   INIT_LOCAL_PAGE_ENTRY(REMOTE_pages_gt_hash(wid), struct global_trie_hash);
 #endif
 #endif /* TABLING && (YAPOR || THREADS) */
+#ifdef STRUCT_MAGAZINES
+  INIT_LOCAL_MAGAZINE(REMOTE_mag_pages_sg_fr(wid));
+  INIT_LOCAL_MAGAZINE(REMOTE_mag_pages_dep_fr(wid));
+  INIT_LOCAL_MAGAZINE(REMOTE_mag_pages_sg_node(wid));
+  INIT_LOCAL_MAGAZINE(REMOTE_mag_pages_ans_node(wid));
+#endif /* STRUCT_MAGAZINES */
 
 #ifdef YAPOR
   /* local data related to or-parallelism */
@@ -208,8 +294,34 @@ void Yap_init_local_optyap_data(int wid) {
   REMOTE_load(wid) = 0;
   REMOTE_share_request(wid) = MAX_WORKERS;
   REMOTE_reply_signal(wid) = worker_ready;
+  REMOTE_work_offers_top(wid) = REMOTE_work_offers_bottom(wid) = 0;
+  REMOTE_qg_answers(wid) = NULL;
+#ifdef YAPOR_TRACING
+  ALLOC_BLOCK(REMOTE_trace_events(wid), TRACE_BUFFER_SIZE * sizeof(struct optyap_trace_event), struct optyap_trace_event);
+  REMOTE_trace_top(wid) = 0;
+  REMOTE_trace_idle(wid) = FALSE;
+  REMOTE_trace_idle_refused(wid) = 0;
+#endif /* YAPOR_TRACING */
+#ifdef YAPOR_GRANULARITY_CONTROL
+  REMOTE_granularity_pred(wid) = NULL;
+  REMOTE_granularity_start(wid) = 0;
+  REMOTE_granularity_share_start(wid) = 0;
+  REMOTE_granularity_share_cost(wid) = 0;
+  REMOTE_granularity_shares(wid) = 0;
+  REMOTE_granularity_share_time(wid) = 0;
+  REMOTE_granularity_samples(wid) = 0;
+  REMOTE_granularity_work_time(wid) = 0;
+  REMOTE_granularity_refused(wid) = 0;
+#endif /* YAPOR_GRANULARITY_CONTROL */
+  for (i = 0; i < MAX_BRANCH_DEPTH / BRANCH_CHUNK_SIZE; i++)
+    REMOTE_branch_chunk(wid, i) = NULL;
+  SCH_check_branch_depth(wid, 0);
 #ifdef YAPOR_COPY
   INIT_LOCK(REMOTE_lock_signals(wid));
+  REMOTE_copy_stats_shares(wid) = 0;
+  REMOTE_copy_stats_global_bytes(wid) = 0;
+  REMOTE_copy_stats_local_bytes(wid) = 0;
+  REMOTE_copy_stats_trail_bytes(wid) = 0;
 #endif /* YAPOR_COPY */
   Set_REMOTE_prune_request(wid, NULL);
   INIT_LOCK(REMOTE_lock(wid));
@@ -219,6 +331,15 @@ void Yap_init_local_optyap_data(int wid) {
   /* local data related to tabling */
   REMOTE_top_sg_fr(wid) = NULL; 
   REMOTE_top_dep_fr(wid) = NULL; 
+#ifdef LIMIT_TABLING
+  REMOTE_first_sg_fr(wid) = NULL;
+  REMOTE_last_sg_fr(wid) = NULL;
+  REMOTE_lru_clock(wid) = 0;
+  REMOTE_lru_epoch(wid) = 0;
+#endif /* LIMIT_TABLING */
+#ifdef EPOCH_RECLAMATION
+  REMOTE_epoch(wid) = NO_EPOCH;
+#endif /* EPOCH_RECLAMATION */
 #ifdef YAPOR
   REMOTE_top_dep_fr(wid) = GLOBAL_root_dep_fr; 
   Set_REMOTE_top_cp_on_stack(wid, (choiceptr) LOCAL_LocalBase); /* ??? */
@@ -259,6 +380,9 @@ void Yap_init_root_frames(void) {
   OrFr_suspensions(or_fr) = NULL;
   OrFr_nearest_suspnode(or_fr) = or_fr;
 #endif /* TABLING */
+#ifdef YAPOR_GRANULARITY_CONTROL
+  OrFr_pred(or_fr) = NULL;
+#endif /* YAPOR_GRANULARITY_CONTROL */
   OrFr_next(or_fr) = NULL;
 #endif /* YAPOR */
 
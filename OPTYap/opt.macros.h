@@ -255,38 +255,7 @@ extern int Yap_page_size;
         }                                                                                  \
         UNLOCK(PgEnt_lock(GLOBAL_pages_alloc))
 
-#ifdef LIMIT_TABLING
-#define RECOVER_ALLOC_SPACE(PG_ENT, EXTRA_PG_ENT)					   \
-        if (GLOBAL_max_pages == PgEnt_pages_in_use(GLOBAL_pages_alloc)) {                  \
-          sg_fr_ptr sg_fr = GLOBAL_check_sg_fr;                                            \
-          do {                                                                             \
-            if (sg_fr)                                                                     \
-              sg_fr = SgFr_next(sg_fr);                                                    \
-            else                                                                           \
-              sg_fr = GLOBAL_first_sg_fr;                                                  \
-            if (sg_fr == NULL)                                                             \
-              Yap_Error(FATAL_ERROR, TermNil, "no space left (RECOVER_SPACE)");            \
-              /* see function 'InteractSIGINT' in file 'sysbits.c' */                      \
-              /*   Yap_Error(PURE_ABORT, TermNil, "");             */                      \
-              /*   restore_absmi_regs(&Yap_standard_regs);         */                      \
-              /*   siglongjmp (LOCAL_RestartEnv, 1);               */                      \
-            if (SgFr_first_answer(sg_fr) &&                                                \
-                SgFr_first_answer(sg_fr) != SgFr_answer_trie(sg_fr)) {                     \
-              SgFr_state(sg_fr) = ready;                                                   \
-	      free_answer_hash_chain(SgFr_hash_chain(sg_fr));                              \
-	      SgFr_hash_chain(sg_fr) = NULL;                                               \
-	      SgFr_first_answer(sg_fr) = NULL;                                             \
-              SgFr_last_answer(sg_fr) = NULL;                                              \
-              free_answer_trie(TrNode_child(SgFr_answer_trie(sg_fr)),                      \
-                               TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST);             \
-              TrNode_child(SgFr_answer_trie(sg_fr)) = NULL;                                \
-	    }                                                                              \
-          } while (PgEnt_first(GLOBAL_pages_void) == PgEnt_first(PG_ENT));                 \
-          GLOBAL_check_sg_fr = sg_fr;                                                      \
-        } else {						                           \
-	  ALLOC_SPACE();                                                                   \
-        }
-#elif THREADS
+#ifdef THREADS
 #define RECOVER_ALLOC_SPACE(PG_ENT, EXTRA_PG_ENT)					   \
         LOCK(PgEnt_lock(EXTRA_PG_ENT));    		                                   \
         if (PgEnt_first(EXTRA_PG_ENT)) {				                   \
@@ -417,6 +386,126 @@ extern int Yap_page_size;
         }
 #endif /***********************************************************************************/
 
+#ifdef STRUCT_MAGAZINES
+/*******************************************************************************************
+**                                    STRUCT_MAGAZINES                                    **
+** each worker keeps a magazine of free structs. Allocations and releases only touch the  **
+** local magazine, the global page entry is only locked to move a batch of structs from   **
+** the depot to an empty magazine (refill) or from a full magazine to the depot (spill).  **
+** When the depot is empty, a new batch is allocated a struct at a time, thus the structs **
+** of a spilled batch can be returned to the system. A batch is only released when the    **
+** depot has held MAGAZINE_DEPOT_BATCHES batches or more for MAGAZINE_RELEASE_SPILLS      **
+** consecutive spills, until then the depot keeps growing, so that workloads that free    **
+** and allocate batches in turn around the limit do not release and allocate them again.  **
+** The workers holding or waiting for the depot lock are counted to report the            **
+** acquisitions that had to wait.                                                         **
+*******************************************************************************************/
+#define LOCK_MAGAZINE_DEPOT(PG_ENT)                                                        \
+        { int depot_lockers = __sync_fetch_and_add(&PgEnt_mag_lockers(PG_ENT), 1);         \
+          LOCK(PgEnt_lock(PG_ENT));                                                        \
+          if (depot_lockers)                                                               \
+            UPDATE_STATS(PgEnt_mag_waits(PG_ENT), 1);                                      \
+        }
+#define UNLOCK_MAGAZINE_DEPOT(PG_ENT)                                                      \
+        __sync_fetch_and_sub(&PgEnt_mag_lockers(PG_ENT), 1);                               \
+        UNLOCK(PgEnt_lock(PG_ENT))
+
+#define REFILL_MAGAZINE(STR_TYPE, _PG_ENT)                                                 \
+        { STR_TYPE *first_str, *last_str;                                                  \
+          int cont = 1;                                                                    \
+          LOCK_MAGAZINE_DEPOT(GLOBAL##_PG_ENT);                                            \
+          if ((first_str = (STR_TYPE *) PgEnt_depot(GLOBAL##_PG_ENT)) != NULL) {           \
+            last_str = first_str;                                                          \
+            while (cont < MAGAZINE_BATCH_SIZE && STRUCT_NEXT(last_str)) {                  \
+              last_str = STRUCT_NEXT(last_str);                                            \
+              cont++;                                                                      \
+            }                                                                              \
+            PgEnt_depot(GLOBAL##_PG_ENT) = (void *) STRUCT_NEXT(last_str);                 \
+            UPDATE_STATS(PgEnt_depot_strs(GLOBAL##_PG_ENT), -cont);                        \
+            UPDATE_STATS(PgEnt_mag_refills(GLOBAL##_PG_ENT), 1);                           \
+            UNLOCK_MAGAZINE_DEPOT(GLOBAL##_PG_ENT);                                        \
+          } else {                                                                         \
+            UPDATE_STATS(PgEnt_mag_chunks(GLOBAL##_PG_ENT), 1);                            \
+            UNLOCK_MAGAZINE_DEPOT(GLOBAL##_PG_ENT);                                        \
+            ALLOC_BLOCK(first_str, sizeof(STR_TYPE), STR_TYPE);                            \
+            for (last_str = first_str; cont < MAGAZINE_BATCH_SIZE; cont++) {               \
+              STR_TYPE *new_str;                                                           \
+              ALLOC_BLOCK(new_str, sizeof(STR_TYPE), STR_TYPE);                            \
+              STRUCT_NEXT(last_str) = new_str;                                             \
+              last_str = new_str;                                                          \
+            }                                                                              \
+          }                                                                                \
+          STRUCT_NEXT(last_str) = NULL;                                                    \
+          Mag_first(LOCAL_mag##_PG_ENT) = (void *) first_str;                              \
+          Mag_strs(LOCAL_mag##_PG_ENT) = cont;                                             \
+        }
+
+#define SPILL_MAGAZINE(STR_TYPE, _MAG, _PG_ENT, NUMBER)                                    \
+        { STR_TYPE *first_str, *last_str;                                                  \
+          int cont, spilled_strs = NUMBER;                                                 \
+          first_str = last_str = (STR_TYPE *) Mag_first(_MAG);                             \
+          for (cont = 1; cont < spilled_strs; cont++)                                      \
+            last_str = STRUCT_NEXT(last_str);                                              \
+          Mag_first(_MAG) = (void *) STRUCT_NEXT(last_str);                                \
+          Mag_strs(_MAG) -= spilled_strs;                                                  \
+          LOCK_MAGAZINE_DEPOT(_PG_ENT);                                                    \
+          if (PgEnt_depot_strs(_PG_ENT) < MAGAZINE_DEPOT_BATCHES * MAGAZINE_BATCH_SIZE)     \
+            PgEnt_depot_full(_PG_ENT) = 0;                                                 \
+          else if (PgEnt_depot_full(_PG_ENT) < MAGAZINE_RELEASE_SPILLS)                    \
+            PgEnt_depot_full(_PG_ENT)++;                                                   \
+          if (PgEnt_depot_full(_PG_ENT) == MAGAZINE_RELEASE_SPILLS) {                      \
+            /* the depot stayed full --> release the batch */                              \
+            UPDATE_STATS(PgEnt_mag_releases(_PG_ENT), 1);                                  \
+            UNLOCK_MAGAZINE_DEPOT(_PG_ENT);                                                \
+            STRUCT_NEXT(last_str) = NULL;                                                  \
+            while (first_str) {                                                            \
+              last_str = STRUCT_NEXT(first_str);                                           \
+              FREE_BLOCK(first_str);                                                       \
+              first_str = last_str;                                                        \
+            }                                                                              \
+          } else {                                                                         \
+            STRUCT_NEXT(last_str) = (STR_TYPE *) PgEnt_depot(_PG_ENT);                     \
+            PgEnt_depot(_PG_ENT) = (void *) first_str;                                     \
+            UPDATE_STATS(PgEnt_depot_strs(_PG_ENT), spilled_strs);                         \
+            UPDATE_STATS(PgEnt_mag_spills(_PG_ENT), 1);                                    \
+            UNLOCK_MAGAZINE_DEPOT(_PG_ENT);                                                \
+          }                                                                                \
+        }
+
+#define GET_MAGAZINE_STRUCT(STR, STR_TYPE, _PG_ENT)                                        \
+        { if (Mag_first(LOCAL_mag##_PG_ENT) == NULL)                                       \
+            REFILL_MAGAZINE(STR_TYPE, _PG_ENT);                                            \
+          STR = (STR_TYPE *) Mag_first(LOCAL_mag##_PG_ENT);                                \
+          Mag_first(LOCAL_mag##_PG_ENT) = (void *) STRUCT_NEXT(STR);                       \
+          Mag_strs(LOCAL_mag##_PG_ENT)--;                                                  \
+          UPDATE_STATS(Mag_strs_in_use(LOCAL_mag##_PG_ENT), 1);                            \
+          UPDATE_STATS(Mag_allocs(LOCAL_mag##_PG_ENT), 1);                                 \
+        }
+
+#define PUT_MAGAZINE_STRUCT(STR, STR_TYPE, _PG_ENT)                                        \
+        { STRUCT_NEXT(STR) = (STR_TYPE *) Mag_first(LOCAL_mag##_PG_ENT);                   \
+          Mag_first(LOCAL_mag##_PG_ENT) = (void *) STR;                                    \
+          UPDATE_STATS(Mag_strs_in_use(LOCAL_mag##_PG_ENT), -1);                           \
+          if (++Mag_strs(LOCAL_mag##_PG_ENT) >= 2 * MAGAZINE_BATCH_SIZE)                   \
+            SPILL_MAGAZINE(STR_TYPE, LOCAL_mag##_PG_ENT, GLOBAL##_PG_ENT, MAGAZINE_BATCH_SIZE); \
+        }
+
+/* a finishing worker moves its free structs and its counters to the global page entry */
+#define DETACH_MAGAZINE(STR_TYPE, _PG_ENT)                                                 \
+        if (Mag_strs(LOCAL_mag##_PG_ENT))                                                  \
+          SPILL_MAGAZINE(STR_TYPE, LOCAL_mag##_PG_ENT, GLOBAL##_PG_ENT, Mag_strs(LOCAL_mag##_PG_ENT)); \
+        LOCK(PgEnt_lock(GLOBAL##_PG_ENT));                                                 \
+        UPDATE_STATS(PgEnt_strs_in_use(GLOBAL##_PG_ENT), Mag_strs_in_use(LOCAL_mag##_PG_ENT)); \
+        UPDATE_STATS(PgEnt_mag_allocs(GLOBAL##_PG_ENT), Mag_allocs(LOCAL_mag##_PG_ENT));   \
+        UNLOCK(PgEnt_lock(GLOBAL##_PG_ENT));                                               \
+        Mag_strs_in_use(LOCAL_mag##_PG_ENT) = Mag_allocs(LOCAL_mag##_PG_ENT) = 0
+
+#define ALLOC_MAGAZINE_STRUCT(STR, STR_TYPE, _PG_ENT)                 \
+        GET_MAGAZINE_STRUCT(STR, STR_TYPE, _PG_ENT)
+#define FREE_MAGAZINE_STRUCT(STR, STR_TYPE, _PG_ENT)                  \
+        PUT_MAGAZINE_STRUCT(STR, STR_TYPE, _PG_ENT)
+#endif /* STRUCT_MAGAZINES */
+
 #if defined(THREADS) && defined(TABLING)
 #define ALLOC_STRUCT(STR, STR_TYPE, _PG_ENT)                          \
         GET_FREE_STRUCT(STR, STR_TYPE, LOCAL##_PG_ENT, GLOBAL##_PG_ENT)
@@ -430,43 +519,62 @@ extern int Yap_page_size;
 #endif
 #define ALLOC_NEXT_STRUCT(LOCAL_STR, STR, STR_TYPE, _PG_ENT)          \
         GET_NEXT_FREE_STRUCT(LOCAL_STR, STR, STR_TYPE, GLOBAL##_PG_ENT)
+#ifndef STRUCT_MAGAZINES
+#define ALLOC_MAGAZINE_STRUCT(STR, STR_TYPE, _PG_ENT)                 \
+        ALLOC_STRUCT(STR, STR_TYPE, _PG_ENT)
+#define FREE_MAGAZINE_STRUCT(STR, STR_TYPE, _PG_ENT)                  \
+        FREE_STRUCT(STR, STR_TYPE, _PG_ENT)
+#endif /* !STRUCT_MAGAZINES */
+
+/* the bytes of the structs that limit_table_space() can release are kept in a running **
+** counter, so that the table space in use can be checked after each eviction         */
+#if defined(LIMIT_TABLING) && defined(THREADS)
+#define UPDATE_TABLE_SPACE(STR_TYPE, N)  __sync_fetch_and_add(&GLOBAL_table_space_bytes, (N) * (long) sizeof(STR_TYPE))
+#elif defined(LIMIT_TABLING)
+#define UPDATE_TABLE_SPACE(STR_TYPE, N)  UPDATE_STATS(GLOBAL_table_space_bytes, (N) * (long) sizeof(STR_TYPE))
+#else
+#define UPDATE_TABLE_SPACE(STR_TYPE, N)
+#endif /* LIMIT_TABLING */
 
-#define ALLOC_TABLE_ENTRY(STR)         ALLOC_STRUCT(STR, struct table_entry, _pages_tab_ent)
-#define FREE_TABLE_ENTRY(STR)           FREE_STRUCT(STR, struct table_entry, _pages_tab_ent)
+#define ALLOC_TABLE_ENTRY(STR)         ALLOC_STRUCT(STR, struct table_entry, _pages_tab_ent); UPDATE_TABLE_SPACE(struct table_entry, 1)
+#define FREE_TABLE_ENTRY(STR)           FREE_STRUCT(STR, struct table_entry, _pages_tab_ent); UPDATE_TABLE_SPACE(struct table_entry, -1)
 
 #define ALLOC_SUBGOAL_ENTRY(STR)       ALLOC_STRUCT(STR, struct subgoal_entry, _pages_sg_ent)
 #define FREE_SUBGOAL_ENTRY(STR)         FREE_STRUCT(STR, struct subgoal_entry, _pages_sg_ent)
 
-#define ALLOC_SUBGOAL_FRAME(STR)       ALLOC_STRUCT(STR, struct subgoal_frame, _pages_sg_fr)
-#define FREE_SUBGOAL_FRAME(STR)         FREE_STRUCT(STR, struct subgoal_frame, _pages_sg_fr)
+#define ALLOC_SUBGOAL_FRAME(STR)       ALLOC_MAGAZINE_STRUCT(STR, struct subgoal_frame, _pages_sg_fr); UPDATE_TABLE_SPACE(struct subgoal_frame, 1)
+#define FREE_SUBGOAL_FRAME(STR)         FREE_MAGAZINE_STRUCT(STR, struct subgoal_frame, _pages_sg_fr); UPDATE_TABLE_SPACE(struct subgoal_frame, -1)
 
-#define ALLOC_DEPENDENCY_FRAME(STR)    ALLOC_STRUCT(STR, struct dependency_frame, _pages_dep_fr)
-#define FREE_DEPENDENCY_FRAME(STR)      FREE_STRUCT(STR, struct dependency_frame, _pages_dep_fr)
+#define ALLOC_DEPENDENCY_FRAME(STR)    ALLOC_MAGAZINE_STRUCT(STR, struct dependency_frame, _pages_dep_fr); UPDATE_TABLE_SPACE(struct dependency_frame, 1)
+#define FREE_DEPENDENCY_FRAME(STR)      FREE_MAGAZINE_STRUCT(STR, struct dependency_frame, _pages_dep_fr); UPDATE_TABLE_SPACE(struct dependency_frame, -1)
 
-#define ALLOC_SUBGOAL_TRIE_NODE(STR)   ALLOC_STRUCT(STR, struct subgoal_trie_node, _pages_sg_node)
-#define FREE_SUBGOAL_TRIE_NODE(STR)     FREE_STRUCT(STR, struct subgoal_trie_node, _pages_sg_node)
+#define ALLOC_SUBGOAL_TRIE_NODE(STR)   ALLOC_MAGAZINE_STRUCT(STR, struct subgoal_trie_node, _pages_sg_node); UPDATE_TABLE_SPACE(struct subgoal_trie_node, 1)
+#define FREE_SUBGOAL_TRIE_NODE(STR)     FREE_MAGAZINE_STRUCT(STR, struct subgoal_trie_node, _pages_sg_node); UPDATE_TABLE_SPACE(struct subgoal_trie_node, -1)
 
-#define ALLOC_SUBGOAL_TRIE_HASH(STR)   ALLOC_STRUCT(STR, struct subgoal_trie_hash, _pages_sg_hash)
-#define FREE_SUBGOAL_TRIE_HASH(STR)     FREE_STRUCT(STR, struct subgoal_trie_hash, _pages_sg_hash)
+#define ALLOC_SUBGOAL_TRIE_HASH(STR)   ALLOC_STRUCT(STR, struct subgoal_trie_hash, _pages_sg_hash); UPDATE_TABLE_SPACE(struct subgoal_trie_hash, 1)
+#define FREE_SUBGOAL_TRIE_HASH(STR)     FREE_STRUCT(STR, struct subgoal_trie_hash, _pages_sg_hash); UPDATE_TABLE_SPACE(struct subgoal_trie_hash, -1)
 
-#ifdef YAPOR
+#if defined(YAPOR) && !defined(STRUCT_MAGAZINES)
 #define ALLOC_ANSWER_TRIE_NODE(STR)    ALLOC_NEXT_STRUCT(LOCAL_next_free_ans_node, STR, struct answer_trie_node, _pages_ans_node)
 #else
-#define ALLOC_ANSWER_TRIE_NODE(STR)    ALLOC_STRUCT(STR, struct answer_trie_node, _pages_ans_node)
+#define ALLOC_ANSWER_TRIE_NODE(STR)    ALLOC_MAGAZINE_STRUCT(STR, struct answer_trie_node, _pages_ans_node); UPDATE_TABLE_SPACE(struct answer_trie_node, 1)
 #endif
-#define FREE_ANSWER_TRIE_NODE(STR)      FREE_STRUCT(STR, struct answer_trie_node, _pages_ans_node)
+#define FREE_ANSWER_TRIE_NODE(STR)      FREE_MAGAZINE_STRUCT(STR, struct answer_trie_node, _pages_ans_node); UPDATE_TABLE_SPACE(struct answer_trie_node, -1)
 
-#define ALLOC_ANSWER_TRIE_HASH(STR)    ALLOC_STRUCT(STR, struct answer_trie_hash, _pages_ans_hash)
-#define FREE_ANSWER_TRIE_HASH(STR)      FREE_STRUCT(STR, struct answer_trie_hash, _pages_ans_hash)
+#define ALLOC_ANSWER_TRIE_HASH(STR)    ALLOC_STRUCT(STR, struct answer_trie_hash, _pages_ans_hash); UPDATE_TABLE_SPACE(struct answer_trie_hash, 1)
+#define FREE_ANSWER_TRIE_HASH(STR)      FREE_STRUCT(STR, struct answer_trie_hash, _pages_ans_hash); UPDATE_TABLE_SPACE(struct answer_trie_hash, -1)
 
 #define ALLOC_ANSWER_REF_NODE(STR)     ALLOC_STRUCT(STR, struct answer_ref_node, _pages_ans_ref_node)
 #define FREE_ANSWER_REF_NODE(STR)       FREE_STRUCT(STR, struct answer_ref_node, _pages_ans_ref_node)
 
-#define ALLOC_GLOBAL_TRIE_NODE(STR)    ALLOC_STRUCT(STR, struct global_trie_node, _pages_gt_node)
-#define FREE_GLOBAL_TRIE_NODE(STR)      FREE_STRUCT(STR, struct global_trie_node, _pages_gt_node)
+#define ALLOC_INCREMENTAL_DEPENDENCY(STR)  ALLOC_STRUCT(STR, struct incremental_dependency, _pages_inc_dep)
+#define FREE_INCREMENTAL_DEPENDENCY(STR)    FREE_STRUCT(STR, struct incremental_dependency, _pages_inc_dep)
+
+#define ALLOC_GLOBAL_TRIE_NODE(STR)    ALLOC_STRUCT(STR, struct global_trie_node, _pages_gt_node); UPDATE_TABLE_SPACE(struct global_trie_node, 1)
+#define FREE_GLOBAL_TRIE_NODE(STR)      FREE_STRUCT(STR, struct global_trie_node, _pages_gt_node); UPDATE_TABLE_SPACE(struct global_trie_node, -1)
 
-#define ALLOC_GLOBAL_TRIE_HASH(STR)    ALLOC_STRUCT(STR, struct global_trie_hash, _pages_gt_hash)
-#define FREE_GLOBAL_TRIE_HASH(STR)      FREE_STRUCT(STR, struct global_trie_hash, _pages_gt_hash)
+#define ALLOC_GLOBAL_TRIE_HASH(STR)    ALLOC_STRUCT(STR, struct global_trie_hash, _pages_gt_hash); UPDATE_TABLE_SPACE(struct global_trie_hash, 1)
+#define FREE_GLOBAL_TRIE_HASH(STR)      FREE_STRUCT(STR, struct global_trie_hash, _pages_gt_hash); UPDATE_TABLE_SPACE(struct global_trie_hash, -1)
 
 #define ALLOC_OR_FRAME(STR)            ALLOC_STRUCT(STR, struct or_frame, _pages_or_fr)
 #define FREE_OR_FRAME(STR)              FREE_STRUCT(STR, struct or_frame, _pages_or_fr)
@@ -478,7 +586,9 @@ extern int Yap_page_size;
 #define FREE_QG_ANSWER_FRAME(STR)       FREE_STRUCT(STR, struct query_goal_answer_frame, _pages_qg_ans_fr)
 
 #define ALLOC_SUSPENSION_FRAME(STR)    ALLOC_STRUCT(STR, struct suspension_frame, _pages_susp_fr)
-#define FREE_SUSPENSION_FRAME(STR)      FREE_BLOCK(SuspFr_global_start(STR));                          \
+#define FREE_SUSPENSION_FRAME(STR)      __sync_fetch_and_sub(&GLOBAL_suspended_bytes, SuspFr_stored_bytes(STR));    \
+                                        __sync_fetch_and_sub(&GLOBAL_suspended_raw_bytes, SuspFr_block_bytes(STR)); \
+                                        FREE_BLOCK(SuspFr_global_start(STR));                                       \
                                         FREE_STRUCT(STR, struct suspension_frame, _pages_susp_fr)
 
 #define ALLOC_TG_SOLUTION_FRAME(STR)   ALLOC_STRUCT(STR, struct table_subgoal_solution_frame, _pages_tg_sol_fr)
@@ -493,19 +603,89 @@ extern int Yap_page_size;
 **                         Bitmap manipulation                         **
 ************************************************************************/
 
-#define BITMAP_empty(b)		       ((b) == 0)
-#define BITMAP_member(b,n)	       (((b) & (1<<(n))) != 0)
-#define BITMAP_alone(b,n)	       ((b) == (1<<(n)))
-#define BITMAP_subset(b1,b2)	       (((b1) & (b2)) == b2)
-#define BITMAP_same(b1,b2)             ((b1) == (b2))
-#define BITMAP_clear(b)	               ((b) = 0)
-#define BITMAP_and(b1,b2)              ((b1) &= (b2))
-#define BITMAP_minus(b1,b2)            ((b1) &= ~(b2))
-#define BITMAP_insert(b,n)	       ((b) |= (1<<(n)))
-#define BITMAP_delete(b,n)	       ((b) &= (~(1<<(n))))
+#define BITMAP_WORD(n)                 ((n) / BITMAP_WORD_BITS)
+#define BITMAP_BIT(n)                  ((bitmap_word) 1 << ((n) % BITMAP_WORD_BITS))
+
+#define BITMAP_empty(b)		       bitmap_empty(&(b), GLOBAL_bitmap_words)
+#define BITMAP_member(b,n)	       (((b).word[BITMAP_WORD(n)] & BITMAP_BIT(n)) != 0)
+#define BITMAP_alone(b,n)	       bitmap_alone(&(b), n, GLOBAL_bitmap_words)
+#define BITMAP_subset(b1,b2)	       bitmap_subset(&(b1), &(b2), GLOBAL_bitmap_words)
+#define BITMAP_same(b1,b2)             bitmap_same(&(b1), &(b2), GLOBAL_bitmap_words)
+#define BITMAP_clear(b)	               bitmap_clear(&(b), GLOBAL_bitmap_words)
+#define BITMAP_and(b1,b2)              bitmap_and(&(b1), &(b2), GLOBAL_bitmap_words)
+#define BITMAP_minus(b1,b2)            bitmap_minus(&(b1), &(b2), GLOBAL_bitmap_words)
+#define BITMAP_insert(b,n)	       ((b).word[BITMAP_WORD(n)] |= BITMAP_BIT(n))
+#define BITMAP_delete(b,n)	       ((b).word[BITMAP_WORD(n)] &= ~BITMAP_BIT(n))
 #define BITMAP_copy(b1,b2)	       ((b1) = (b2))
-#define BITMAP_intersection(b1,b2,b3)  ((b1) = ((b2) & (b3)))
-#define BITMAP_difference(b1,b2,b3)    ((b1) = ((b2) & (~(b3))))
+#define BITMAP_intersection(b1,b2,b3)  bitmap_intersection(&(b1), &(b2), &(b3), GLOBAL_bitmap_words)
+#define BITMAP_difference(b1,b2,b3)    bitmap_difference(&(b1), &(b2), &(b3), GLOBAL_bitmap_words)
+
+static inline int bitmap_empty(volatile bitmap *b, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    if (b->word[i])
+      return FALSE;
+  return TRUE;
+}
+
+static inline int bitmap_alone(volatile bitmap *b, int n, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    if (b->word[i] != ((i == BITMAP_WORD(n)) ? BITMAP_BIT(n) : 0))
+      return FALSE;
+  return TRUE;
+}
+
+static inline int bitmap_subset(volatile bitmap *b1, volatile bitmap *b2, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    if ((b1->word[i] & b2->word[i]) != b2->word[i])
+      return FALSE;
+  return TRUE;
+}
+
+static inline int bitmap_same(volatile bitmap *b1, volatile bitmap *b2, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    if (b1->word[i] != b2->word[i])
+      return FALSE;
+  return TRUE;
+}
+
+static inline void bitmap_clear(volatile bitmap *b, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    b->word[i] = 0;
+  return;
+}
+
+static inline void bitmap_and(volatile bitmap *b1, volatile bitmap *b2, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    b1->word[i] &= b2->word[i];
+  return;
+}
+
+static inline void bitmap_minus(volatile bitmap *b1, volatile bitmap *b2, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    b1->word[i] &= ~b2->word[i];
+  return;
+}
+
+static inline void bitmap_intersection(volatile bitmap *b1, volatile bitmap *b2, volatile bitmap *b3, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    b1->word[i] = b2->word[i] & b3->word[i];
+  return;
+}
+
+static inline void bitmap_difference(volatile bitmap *b1, volatile bitmap *b2, volatile bitmap *b3, int words) {
+  int i;
+  for (i = 0; i < words; i++)
+    b1->word[i] = b2->word[i] & ~b3->word[i];
+  return;
+}
 
 
 
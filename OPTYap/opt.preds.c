@@ -27,11 +27,19 @@
 #if HAVE_SYS_TIME_H
 #include <sys/time.h>
 #endif /* HAVE_SYS_TIME_H */
+#ifdef YAPOR_TRACING
+#if HAVE_ERRNO_H
+#include <errno.h>
+#endif /* HAVE_ERRNO_H */
+#endif /* YAPOR_TRACING */
 #include "or.macros.h"
 #endif /* YAPOR */
 #ifdef TABLING
 #include "tab.macros.h"
 #endif /* TABLING */
+#ifdef INCREMENTAL_TABLING
+#include "clause.h"
+#endif /* INCREMENTAL_TABLING */
 
 #ifdef TABLING
 static Int p_freeze_choice_point( USES_REGS1 );
@@ -40,8 +48,25 @@ static Int p_abolish_frozen_choice_points_until( USES_REGS1 );
 static Int p_abolish_frozen_choice_points_all( USES_REGS1 );
 static Int p_table( USES_REGS1 );
 static Int p_tabling_mode( USES_REGS1 );
+#ifdef INCREMENTAL_TABLING
+static Int p_incremental_dynamic( USES_REGS1 );
+#endif /* INCREMENTAL_TABLING */
 static Int p_abolish_table( USES_REGS1 );
 static Int p_abolish_all_tables( USES_REGS1 );
+#ifdef LIMIT_TABLING
+static Int p_table_space_limit( USES_REGS1 );
+#endif /* LIMIT_TABLING */
+#ifdef YAPOR
+static Int p_suspension_space_threshold( USES_REGS1 );
+#endif /* YAPOR */
+#ifdef DEFERRED_ABOLISH
+static Int p_table_abolish_mode( USES_REGS1 );
+#endif /* DEFERRED_ABOLISH */
+#ifdef TABLE_SNAPSHOTS
+static tab_ent_ptr *get_table_entries(Term, int *);
+static Int p_save_tables( USES_REGS1 );
+static Int p_load_tables( USES_REGS1 );
+#endif /* TABLE_SNAPSHOTS */
 static Int p_show_tabled_predicates( USES_REGS1 );
 static Int p_show_table( USES_REGS1 );
 static Int p_show_all_tables( USES_REGS1 );
@@ -53,11 +78,20 @@ static Int p_show_statistics_global_trie( USES_REGS1 );
 
 #ifdef YAPOR
 static Int p_parallel_mode( USES_REGS1 );
+static Int p_parallel_wait_mode( USES_REGS1 );
+static Int p_parallel_scheduler_mode( USES_REGS1 );
+static Int p_parallel_copy_mode( USES_REGS1 );
+#ifdef YAPOR_GRANULARITY_CONTROL
+static Int p_parallel_granularity( USES_REGS1 );
+#endif /* YAPOR_GRANULARITY_CONTROL */
 static Int p_yapor_start( USES_REGS1 );
 static Int p_yapor_workers( USES_REGS1 );
 static Int p_worker( USES_REGS1 );
 static Int p_parallel_new_answer( USES_REGS1 );
 static Int p_parallel_get_answers( USES_REGS1 );
+#ifdef YAPOR_TRACING
+static Int p_yapor_trace_dump( USES_REGS1 );
+#endif /* YAPOR_TRACING */
 static Int p_show_statistics_or( USES_REGS1 );
 #endif /* YAPOR */
 #if defined(YAPOR) && defined(TABLING)
@@ -76,15 +110,26 @@ static inline struct page_statistics show_statistics_subgoal_entries(IOSTREAM *o
 #endif /* THREADS_FULL_SHARING || THREADS_CONSUMER_SHARING */
 static inline struct page_statistics show_statistics_subgoal_frames(IOSTREAM *out);
 static inline struct page_statistics show_statistics_dependency_frames(IOSTREAM *out);
+#ifdef INCREMENTAL_TABLING
+static inline struct page_statistics show_statistics_incremental_dependencies(IOSTREAM *out);
+#endif /* INCREMENTAL_TABLING */
 static inline struct page_statistics show_statistics_subgoal_trie_nodes(IOSTREAM *out);
 static inline struct page_statistics show_statistics_subgoal_trie_hashes(IOSTREAM *out);
 static inline struct page_statistics show_statistics_answer_trie_nodes(IOSTREAM *out);
 static inline struct page_statistics show_statistics_answer_trie_hashes(IOSTREAM *out);
+#ifdef COMPACT_ANSWER_TRIES
+static inline struct page_statistics show_statistics_compact_answer_trie_nodes(IOSTREAM *out);
+#endif /* COMPACT_ANSWER_TRIES */
 #if defined(THREADS_FULL_SHARING)
 static inline struct page_statistics show_statistics_answer_ref_nodes(IOSTREAM *out);
 #endif /* THREADS_FULL_SHARING */
 static inline struct page_statistics show_statistics_global_trie_nodes(IOSTREAM *out);
 static inline struct page_statistics show_statistics_global_trie_hashes(IOSTREAM *out);
+#ifdef STRUCT_MAGAZINES
+static struct local_magazine *remote_magazine(int, struct global_page_entry *);
+static long magazines_strs_in_use(struct global_page_entry *);
+static void show_statistics_magazine(IOSTREAM *, const char *, struct global_page_entry *);
+#endif /* STRUCT_MAGAZINES */
 #endif /* TABLING */
 #ifdef YAPOR
 static inline struct page_statistics show_statistics_or_frames(IOSTREAM *out);
@@ -181,9 +226,17 @@ struct page_statistics {
         INCREMENT_PAGE_STATS(STATS, GLOBAL##_PAGES)
 #endif
 
+#ifdef STRUCT_MAGAZINES
+#define GET_MAGAZINE_STATS(STATS, _PAGES)                                       \
+        PgEnt_strs_in_use(STATS) += magazines_strs_in_use(&(GLOBAL##_PAGES))
+#else
+#define GET_MAGAZINE_STATS(STATS, _PAGES)
+#endif /* STRUCT_MAGAZINES */
+
 #define GET_PAGE_STATS(STATS, STR_TYPE, _PAGES)                                 \
         INIT_PAGE_STATS(STATS);                                                 \
         GET_ALL_PAGE_STATS(STATS, STR_TYPE, _PAGES);                            \
+        GET_MAGAZINE_STATS(STATS, _PAGES);                                      \
         PgEnt_bytes_in_use(STATS) = PgEnt_strs_in_use(STATS) * sizeof(STR_TYPE)
 #define SHOW_PAGE_STATS(OUT_STREAM, STR_TYPE, _PAGES, STR_NAME)                                               \
         { struct page_statistics stats;                                                                \
@@ -206,6 +259,9 @@ void Yap_init_optyap_preds(void) {
   Yap_InitCPred("abolish_frozen_choice_points", 0, p_abolish_frozen_choice_points_all, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("$c_table", 3, p_table, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("$c_tabling_mode", 3, p_tabling_mode, SafePredFlag|SyncPredFlag);
+#ifdef INCREMENTAL_TABLING
+  Yap_InitCPred("$c_incremental_dynamic", 2, p_incremental_dynamic, SafePredFlag|SyncPredFlag);
+#endif /* INCREMENTAL_TABLING */
   Yap_InitCPred("$c_abolish_table", 2, p_abolish_table, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("abolish_all_tables", 0, p_abolish_all_tables, SafePredFlag|SyncPredFlag);
 /** @pred abolish_all_tables/0 
@@ -216,6 +272,19 @@ predicates. The predicates remain as tabled predicates.
 
  
 */
+#ifdef LIMIT_TABLING
+  Yap_InitCPred("$c_table_space_limit", 1, p_table_space_limit, SafePredFlag|SyncPredFlag);
+#endif /* LIMIT_TABLING */
+#ifdef YAPOR
+  Yap_InitCPred("$c_suspension_space_threshold", 1, p_suspension_space_threshold, SafePredFlag|SyncPredFlag);
+#endif /* YAPOR */
+#ifdef DEFERRED_ABOLISH
+  Yap_InitCPred("$c_table_abolish_mode", 1, p_table_abolish_mode, SafePredFlag|SyncPredFlag);
+#endif /* DEFERRED_ABOLISH */
+#ifdef TABLE_SNAPSHOTS
+  Yap_InitCPred("$c_save_tables", 2, p_save_tables, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("$c_load_tables", 2, p_load_tables, SafePredFlag|SyncPredFlag);
+#endif /* TABLE_SNAPSHOTS */
   Yap_InitCPred("show_tabled_predicates", 1, p_show_tabled_predicates, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("$c_show_table", 3, p_show_table, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("show_all_tables", 1, p_show_all_tables, SafePredFlag|SyncPredFlag);
@@ -226,11 +295,20 @@ predicates. The predicates remain as tabled predicates.
 #endif /* TABLING */
 #ifdef YAPOR
   Yap_InitCPred("parallel_mode", 1, p_parallel_mode, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("parallel_wait_mode", 1, p_parallel_wait_mode, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("parallel_scheduler_mode", 1, p_parallel_scheduler_mode, SafePredFlag|SyncPredFlag);
+  Yap_InitCPred("parallel_copy_mode", 1, p_parallel_copy_mode, SafePredFlag|SyncPredFlag);
+#ifdef YAPOR_GRANULARITY_CONTROL
+  Yap_InitCPred("parallel_granularity", 1, p_parallel_granularity, SafePredFlag|SyncPredFlag);
+#endif /* YAPOR_GRANULARITY_CONTROL */
   Yap_InitCPred("$c_yapor_start", 0, p_yapor_start, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("$c_yapor_workers", 1, p_yapor_workers, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("$c_worker", 0, p_worker, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("$c_parallel_new_answer", 1, p_parallel_new_answer, SafePredFlag|SyncPredFlag);
   Yap_InitCPred("$c_parallel_get_answers", 1, p_parallel_get_answers, SafePredFlag|SyncPredFlag);
+#ifdef YAPOR_TRACING
+  Yap_InitCPred("yapor_trace_dump", 1, p_yapor_trace_dump, SafePredFlag|SyncPredFlag);
+#endif /* YAPOR_TRACING */
   Yap_InitCPred("or_statistics", 1, p_show_statistics_or, SafePredFlag|SyncPredFlag);
 #endif /* YAPOR */
 #if defined(YAPOR) && defined(TABLING)
@@ -240,6 +318,19 @@ predicates. The predicates remain as tabled predicates.
 }
 
 
+#ifdef LIMIT_TABLING
+long table_space_in_use(void) {
+  /* bytes in use by the table space (data structures that the LRU eviction can release) */
+  long bytes = GLOBAL_table_space_bytes;
+
+#ifdef COMPACT_ANSWER_TRIES
+  bytes += GLOBAL_cmp_ans_nodes * sizeof(struct compact_answer_trie_node);
+#endif /* COMPACT_ANSWER_TRIES */
+  return bytes;
+}
+#endif /* LIMIT_TABLING */
+
+
 #ifdef YAPOR
 void finish_yapor(void) {
   GLOBAL_execution_time = current_time() - GLOBAL_execution_time;
@@ -412,10 +503,26 @@ static Int p_tabling_mode( USES_REGS1 ) {
       t = MkPairTerm(MkAtomTerm(AtomBatched), t);
     else if (IsMode_Local(TabEnt_flags(tab_ent)))
       t = MkPairTerm(MkAtomTerm(AtomLocal), t);
+    if (IsMode_Variant(TabEnt_flags(tab_ent)))
+      t = MkPairTerm(MkAtomTerm(AtomVariant), t);
+    else if (IsMode_Subsumptive(TabEnt_flags(tab_ent)))
+      t = MkPairTerm(MkAtomTerm(AtomSubsumptive), t);
     if (IsMode_CoInductive(TabEnt_flags(tab_ent)))
       t = MkPairTerm(MkAtomTerm(AtomCoInductive), t);
+#ifdef INCREMENTAL_TABLING
+    if (IsMode_Incremental(TabEnt_flags(tab_ent)))
+      t = MkPairTerm(MkAtomTerm(AtomIncremental), t);
+#endif /* INCREMENTAL_TABLING */
+#ifdef GROUND_CALL_HASHING
+    if (IsMode_GroundHash(TabEnt_flags(tab_ent)))
+      t = MkPairTerm(MkAtomTerm(AtomGroundHash), t);
+#endif /* GROUND_CALL_HASHING */
     t = MkPairTerm(MkAtomTerm(AtomDefault), t);
     t = MkPairTerm(t, TermNil);
+    if (IsMode_Variant(TabEnt_mode(tab_ent)))
+      t = MkPairTerm(MkAtomTerm(AtomVariant), t);
+    else if (IsMode_Subsumptive(TabEnt_mode(tab_ent)))
+      t = MkPairTerm(MkAtomTerm(AtomSubsumptive), t);
     if (IsMode_LocalTrie(TabEnt_mode(tab_ent)))
       t = MkPairTerm(MkAtomTerm(AtomLocalTrie), t);
     else if (IsMode_GlobalTrie(TabEnt_mode(tab_ent)))
@@ -471,12 +578,60 @@ static Int p_tabling_mode( USES_REGS1 ) {
     }  else if (value == 7) {  /* coinductive */ //only affect the predicate flag. Also it cant be unset
       SetMode_CoInductive(TabEnt_flags(tab_ent));
       return(TRUE);
+    } else if (value == 8) {  /* variant */
+      SetMode_Variant(TabEnt_flags(tab_ent));
+      if (! IsMode_Subsumptive(yap_flags[TABLING_MODE_FLAG])) {
+        SetMode_Variant(TabEnt_mode(tab_ent));
+        return(TRUE);
+      }
+    } else if (value == 9) {  /* subsumptive */
+      SetMode_Subsumptive(TabEnt_flags(tab_ent));
+      if (! IsMode_Variant(yap_flags[TABLING_MODE_FLAG])) {
+        SetMode_Subsumptive(TabEnt_mode(tab_ent));
+        return(TRUE);
+      }
+#ifdef INCREMENTAL_TABLING
+    } else if (value == 10) {  /* incremental */ //only affect the predicate flag
+      SetMode_Incremental(TabEnt_flags(tab_ent));
+      return(TRUE);
+#endif /* INCREMENTAL_TABLING */
+#ifdef GROUND_CALL_HASHING
+    } else if (value == 11) {  /* ground_hash */ //only affect the predicate flag
+      SetMode_GroundHash(TabEnt_flags(tab_ent));
+      return(TRUE);
+#endif /* GROUND_CALL_HASHING */
     }
   }
   return (FALSE);
 }
 
 
+#ifdef INCREMENTAL_TABLING
+static Int p_incremental_dynamic( USES_REGS1 ) {
+  Term mod, t;
+  PredEntry *pe;
+
+  mod = Deref(ARG1);
+  t = Deref(ARG2);
+  if (IsAtomTerm(t))
+    pe = RepPredProp(PredPropByAtom(AtomOfTerm(t), mod));
+  else if (IsApplTerm(t))
+    pe = RepPredProp(PredPropByFunc(FunctorOfTerm(t), mod));
+  else
+    return (FALSE);
+  /* only logical update dynamic predicates are supported */
+  if (!(pe->PredFlags & LogUpdatePredFlag))
+    return (FALSE);
+  if (!(pe->ExtraPredFlags & IncrementalPredFlag)) {
+    pe->ExtraPredFlags |= IncrementalPredFlag;
+    new_incremental_predicate(pe);
+    Yap_IncrementalPredCode(pe);
+  }
+  return (TRUE);
+}
+#endif /* INCREMENTAL_TABLING */
+
+
 static Int p_abolish_table( USES_REGS1 ) {
   Term mod, t;
   tab_ent_ptr tab_ent;
@@ -506,6 +661,134 @@ static Int p_abolish_all_tables( USES_REGS1 ) {
 }
 
 
+#ifdef LIMIT_TABLING
+static Int p_table_space_limit( USES_REGS1 ) {
+  Term t = Deref(ARG1);
+
+  if (IsVarTerm(t))
+    return Yap_unify(t, MkIntegerTerm(GLOBAL_table_space_limit));
+  if (!IsIntegerTerm(t) || IntegerOfTerm(t) < 0)
+    return (FALSE);
+  GLOBAL_table_space_limit = IntegerOfTerm(t);
+  limit_table_space();
+  return (TRUE);
+}
+#endif /* LIMIT_TABLING */
+
+
+#ifdef YAPOR
+static Int p_suspension_space_threshold( USES_REGS1 ) {
+  Term t = Deref(ARG1);
+
+  if (IsVarTerm(t))
+    return Yap_unify(t, MkIntegerTerm(GLOBAL_suspension_space_threshold));
+  if (!IsIntegerTerm(t) || IntegerOfTerm(t) < 0)
+    return (FALSE);
+  GLOBAL_suspension_space_threshold = IntegerOfTerm(t);
+  return (TRUE);
+}
+#endif /* YAPOR */
+
+
+#ifdef DEFERRED_ABOLISH
+static Int p_table_abolish_mode( USES_REGS1 ) {
+  Term t = Deref(ARG1);
+
+  if (IsVarTerm(t)) {
+    Term ta;
+    if (GLOBAL_abolish_mode == ABOLISH_MODE_DEFERRED)
+      ta = MkAtomTerm(Yap_LookupAtom("deferred"));
+    else /* ABOLISH_MODE_IMMEDIATE */
+      ta = MkAtomTerm(Yap_LookupAtom("immediate"));
+    return Yap_unify(t, ta);
+  }
+  if (IsAtomTerm(t)) {
+    char *s = RepAtom(AtomOfTerm(t))->StrOfAE;
+    if (strcmp(s, "deferred") == 0) {
+      GLOBAL_abolish_mode = ABOLISH_MODE_DEFERRED;
+      return (TRUE);
+    }
+    if (strcmp(s, "immediate") == 0) {
+      GLOBAL_abolish_mode = ABOLISH_MODE_IMMEDIATE;
+      /* free the tries still detached */
+      while (free_abolished_subtrie());
+      return (TRUE);
+    }
+  }
+  return (FALSE);
+}
+#endif /* DEFERRED_ABOLISH */
+
+
+#ifdef TABLE_SNAPSHOTS
+static tab_ent_ptr *get_table_entries(Term list, int *n) {
+  /* list of Mod:Pred terms --> array of table entries (NULL if out of memory) */
+  tab_ent_ptr *tab_ents;
+  Term t;
+  int i = 0;
+
+  for (t = list; IsPairTerm(t); t = Deref(TailOfTerm(t)))
+    i++;
+  tab_ents = (tab_ent_ptr *) malloc((i + 1) * sizeof(tab_ent_ptr));
+  if (tab_ents == NULL)
+    return NULL;
+  *n = 0;
+  for (t = list; IsPairTerm(t); t = Deref(TailOfTerm(t))) {
+    Term pred = Deref(HeadOfTerm(t));
+    Term mod, pred_functor;
+    PredEntry *pe;
+    if (! IsApplTerm(pred) || FunctorOfTerm(pred) != FunctorModule)
+      continue;
+    mod = Deref(ArgOfTerm(1, pred));
+    pred_functor = Deref(ArgOfTerm(2, pred));
+    if (IsAtomTerm(pred_functor))
+      pe = RepPredProp(PredPropByAtom(AtomOfTerm(pred_functor), mod));
+    else if (IsApplTerm(pred_functor))
+      pe = RepPredProp(PredPropByFunc(FunctorOfTerm(pred_functor), mod));
+    else
+      continue;
+    if (pe->TableOfPred)
+      tab_ents[(*n)++] = pe->TableOfPred;
+  }
+  return tab_ents;
+}
+
+
+static Int p_save_tables( USES_REGS1 ) {
+  Term t = Deref(ARG1);
+  tab_ent_ptr *tab_ents;
+  int n, ok;
+
+  if (IsVarTerm(t) || !IsAtomTerm(t))
+    return (FALSE);
+  if ((tab_ents = get_table_entries(Deref(ARG2), &n)) == NULL) {
+    Yap_Error(OUT_OF_HEAP_ERROR, TermNil, "save_tables/2 (out of memory)");
+    return (FALSE);
+  }
+  ok = save_tables(RepAtom(AtomOfTerm(t))->StrOfAE, tab_ents, n);
+  free(tab_ents);
+  return (ok);
+}
+
+
+static Int p_load_tables( USES_REGS1 ) {
+  Term t = Deref(ARG1);
+  tab_ent_ptr *tab_ents;
+  int n, ok;
+
+  if (IsVarTerm(t) || !IsAtomTerm(t))
+    return (FALSE);
+  if ((tab_ents = get_table_entries(Deref(ARG2), &n)) == NULL) {
+    Yap_Error(OUT_OF_HEAP_ERROR, TermNil, "load_tables/2 (out of memory)");
+    return (FALSE);
+  }
+  ok = load_tables(RepAtom(AtomOfTerm(t))->StrOfAE, tab_ents, n);
+  free(tab_ents);
+  return (ok);
+}
+#endif /* TABLE_SNAPSHOTS */
+
+
 static Int p_show_tabled_predicates( USES_REGS1 ) {
   IOSTREAM *out;
   tab_ent_ptr tab_ent;
@@ -638,6 +921,10 @@ static Int p_show_statistics_tabling( USES_REGS1 ) {
   INCREMENT_AUX_STATS(stats, bytes, total_pages);
   stats = show_statistics_dependency_frames(out);
   INCREMENT_AUX_STATS(stats, bytes, total_pages);
+#ifdef INCREMENTAL_TABLING
+  stats = show_statistics_incremental_dependencies(out);
+  INCREMENT_AUX_STATS(stats, bytes, total_pages);
+#endif /* INCREMENTAL_TABLING */
   Sfprintf(out, "  Memory in use (I):               %10ld bytes\n\n", bytes);
   total_bytes += bytes;
   bytes = 0;
@@ -654,6 +941,10 @@ static Int p_show_statistics_tabling( USES_REGS1 ) {
   stats = show_statistics_answer_ref_nodes(out);
   INCREMENT_AUX_STATS(stats, bytes, total_pages);
 #endif /* THREADS_FULL_SHARING */
+#ifdef COMPACT_ANSWER_TRIES
+  stats = show_statistics_compact_answer_trie_nodes(out);
+  INCREMENT_AUX_STATS(stats, bytes, total_pages);
+#endif /* COMPACT_ANSWER_TRIES */
   Sfprintf(out, "  Memory in use (II):              %10ld bytes\n\n", bytes);
   total_bytes += bytes;
   bytes = 0;
@@ -672,6 +963,42 @@ static Int p_show_statistics_tabling( USES_REGS1 ) {
 #else 
   Sfprintf(out, "Total memory in use (I+II+III):    %10ld bytes\n", total_bytes);
 #endif /* USE_PAGES_MALLOC */
+#ifdef LIMIT_TABLING
+  Sfprintf(out, "\nTable space limit (LRU eviction)\n");
+  Sfprintf(out, "  Table space limit:               %10ld bytes\n", GLOBAL_table_space_limit);
+  Sfprintf(out, "  Evicted subgoals:                %10ld\n", GLOBAL_evicted_subgoals);
+  Sfprintf(out, "  Evicted memory:                  %10ld bytes\n", GLOBAL_evicted_bytes);
+#endif /* LIMIT_TABLING */
+#ifdef STRUCT_MAGAZINES
+  Sfprintf(out, "\nAllocator magazines (batches of %d structs)\n", MAGAZINE_BATCH_SIZE);
+  show_statistics_magazine(out, "Subgoal frames:      ", &GLOBAL_pages_sg_fr);
+  show_statistics_magazine(out, "Dependency frames:   ", &GLOBAL_pages_dep_fr);
+  show_statistics_magazine(out, "Subgoal trie nodes:  ", &GLOBAL_pages_sg_node);
+  show_statistics_magazine(out, "Answer trie nodes:   ", &GLOBAL_pages_ans_node);
+#endif /* STRUCT_MAGAZINES */
+#ifdef INCREMENTAL_TABLING
+  Sfprintf(out, "\nIncremental tabling\n");
+  Sfprintf(out, "  Dynamic predicate updates:       %10ld\n", GLOBAL_incremental_updates);
+  Sfprintf(out, "  Invalidated subgoals:            %10ld\n", GLOBAL_invalidated_subgoals);
+#endif /* INCREMENTAL_TABLING */
+#ifdef DEFERRED_ABOLISH
+  Sfprintf(out, "\nDeferred abolish (%s mode)\n",
+          GLOBAL_abolish_mode == ABOLISH_MODE_DEFERRED ? "deferred" : "immediate");
+  Sfprintf(out, "  Detached tries not yet freed:    %10ld\n", GLOBAL_abolished_tries_pending);
+  Sfprintf(out, "  First level subtries freed:      %10ld\n", GLOBAL_abolished_subtries_freed);
+#endif /* DEFERRED_ABOLISH */
+#ifdef GROUND_CALL_HASHING
+  Sfprintf(out, "\nGround call hashing\n");
+  Sfprintf(out, "  Ground call lookups:             %10ld\n", GLOBAL_ground_call_lookups);
+  Sfprintf(out, "  Ground call hits:                %10ld\n", GLOBAL_ground_call_hits);
+#endif /* GROUND_CALL_HASHING */
+#ifdef EPOCH_RECLAMATION
+  Sfprintf(out, "\nInvalid answers reclamation\n");
+  Sfprintf(out, "  Current epoch:                   %10ld\n", GLOBAL_epoch);
+  Sfprintf(out, "  Invalid answers waiting:         %10ld (%ld bytes)\n",
+          GLOBAL_epoch_backlog, GLOBAL_epoch_backlog * (long) sizeof(struct answer_trie_node));
+  Sfprintf(out, "  Invalid answers reclaimed:       %10ld\n", GLOBAL_epoch_reclaimed);
+#endif /* EPOCH_RECLAMATION */
   PL_release_stream(out);
   return (TRUE);
 }
@@ -729,7 +1056,109 @@ static Int p_parallel_mode( USES_REGS1 ) {
 }
 
 
+static Int p_parallel_wait_mode( USES_REGS1 ) {
+  Term t;
+  t = Deref(ARG1);
+  if (IsVarTerm(t)) {
+    Term ta;
+    if (GLOBAL_wait_mode == WAIT_MODE_SPIN) 
+      ta = MkAtomTerm(Yap_LookupAtom("spin"));
+    else /* WAIT_MODE_BLOCK */
+      ta = MkAtomTerm(Yap_LookupAtom("block"));
+    YapBind((CELL *)t, ta);
+    return(TRUE);
+  }
+  if (IsAtomTerm(t) && GLOBAL_parallel_mode != PARALLEL_MODE_RUNNING) {
+    char *s;
+    s = RepAtom(AtomOfTerm(t))->StrOfAE;
+    if (strcmp(s,"spin") == 0) {
+      GLOBAL_wait_mode = WAIT_MODE_SPIN;
+      return(TRUE);
+    }
+    if (strcmp(s,"block") == 0) {
+      GLOBAL_wait_mode = WAIT_MODE_BLOCK;
+      return(TRUE);
+    }
+  }
+  return(FALSE);
+}
+
+
+static Int p_parallel_scheduler_mode( USES_REGS1 ) {
+  Term t;
+  t = Deref(ARG1);
+  if (IsVarTerm(t)) {
+    Term ta;
+    if (GLOBAL_scheduler_mode == SCHEDULER_MODE_BITMAP) 
+      ta = MkAtomTerm(Yap_LookupAtom("bitmap"));
+    else /* SCHEDULER_MODE_STEAL */
+      ta = MkAtomTerm(Yap_LookupAtom("steal"));
+    YapBind((CELL *)t, ta);
+    return(TRUE);
+  }
+  if (IsAtomTerm(t) && GLOBAL_parallel_mode != PARALLEL_MODE_RUNNING) {
+    char *s;
+    s = RepAtom(AtomOfTerm(t))->StrOfAE;
+    if (strcmp(s,"bitmap") == 0) {
+      GLOBAL_scheduler_mode = SCHEDULER_MODE_BITMAP;
+      return(TRUE);
+    }
+    if (strcmp(s,"steal") == 0) {
+      GLOBAL_scheduler_mode = SCHEDULER_MODE_STEAL;
+      return(TRUE);
+    }
+  }
+  return(FALSE);
+}
+
+
+static Int p_parallel_copy_mode( USES_REGS1 ) {
+  Term t;
+  t = Deref(ARG1);
+  if (IsVarTerm(t)) {
+    Term ta;
+    if (GLOBAL_copy_mode == COPY_MODE_INCREMENTAL) 
+      ta = MkAtomTerm(Yap_LookupAtom("incremental"));
+    else /* COPY_MODE_FULL */
+      ta = MkAtomTerm(Yap_LookupAtom("full"));
+    YapBind((CELL *)t, ta);
+    return(TRUE);
+  }
+  if (IsAtomTerm(t) && GLOBAL_parallel_mode != PARALLEL_MODE_RUNNING) {
+    char *s;
+    s = RepAtom(AtomOfTerm(t))->StrOfAE;
+    if (strcmp(s,"incremental") == 0) {
+      GLOBAL_copy_mode = COPY_MODE_INCREMENTAL;
+      return(TRUE);
+    }
+    if (strcmp(s,"full") == 0) {
+      GLOBAL_copy_mode = COPY_MODE_FULL;
+      return(TRUE);
+    }
+  }
+  return(FALSE);
+}
+
+
+#ifdef YAPOR_GRANULARITY_CONTROL
+static Int p_parallel_granularity( USES_REGS1 ) {
+  Term t;
+  t = Deref(ARG1);
+  if (IsVarTerm(t)) {
+    YapBind((CELL *)t, MkIntTerm(GLOBAL_granularity_ratio));
+    return(TRUE);
+  }
+  if (IsIntTerm(t) && IntOfTerm(t) >= 0 && GLOBAL_parallel_mode != PARALLEL_MODE_RUNNING) {
+    GLOBAL_granularity_ratio = IntOfTerm(t);
+    return(TRUE);
+  }
+  return(FALSE);
+}
+#endif /* YAPOR_GRANULARITY_CONTROL */
+
+
 static Int p_yapor_start( USES_REGS1 ) {
+  int i;
 #ifdef TIMESTAMP_CHECK
   GLOBAL_timestamp = 0;
 #endif /* TIMESTAMP_CHECK */
@@ -739,6 +1168,23 @@ static Int p_yapor_start( USES_REGS1 ) {
 #ifdef TABLING_INNER_CUTS
   BITMAP_clear(GLOBAL_bm_pruning_workers);
 #endif /* TABLING_INNER_CUTS */
+  for (i = 0; i < GLOBAL_number_workers; i++) {
+    REMOTE_work_offers_top(i) = REMOTE_work_offers_bottom(i) = 0;
+#ifdef YAPOR_TRACING
+    REMOTE_trace_top(i) = 0;
+    REMOTE_trace_idle(i) = FALSE;
+    REMOTE_trace_idle_refused(i) = 0;
+#endif /* YAPOR_TRACING */
+#ifdef YAPOR_GRANULARITY_CONTROL
+    REMOTE_granularity_pred(i) = NULL;
+#endif /* YAPOR_GRANULARITY_CONTROL */
+#ifdef ANSWER_TRIE_RANGES
+    REMOTE_trie_range_node(i) = NULL;
+#endif /* ANSWER_TRIE_RANGES */
+  }
+#ifdef TABLING
+  GLOBAL_suspension_space_exceeded = 0;
+#endif /* TABLING */
   make_root_choice_point();
   GLOBAL_parallel_mode = PARALLEL_MODE_RUNNING;
   GLOBAL_execution_time = current_time();
@@ -764,33 +1210,29 @@ static Int p_worker( USES_REGS1 ) {
 
 
 static Int p_parallel_new_answer( USES_REGS1 ) {
-  qg_ans_fr_ptr actual_answer;
-  or_fr_ptr leftmost_or_fr;
-
-  ALLOC_QG_ANSWER_FRAME(actual_answer);
-  AnsFr_answer(actual_answer) = Deref(ARG1);
-  AnsFr_next(actual_answer) = NULL;
-  leftmost_or_fr = CUT_leftmost_or_frame();
-  LOCK_OR_FRAME(leftmost_or_fr);
-  if (Get_LOCAL_prune_request()) {
-    UNLOCK_OR_FRAME(leftmost_or_fr);
-    FREE_QG_ANSWER_FRAME(actual_answer);
-  } else {
-    CUT_store_answer(leftmost_or_fr, actual_answer);
-    UNLOCK_OR_FRAME(leftmost_or_fr);
-  }
+  if (Get_LOCAL_prune_request())
+    return (TRUE);
+  CUT_buffer_answer(Deref(ARG1));
   return (TRUE);
 }
 
 
 static Int p_parallel_get_answers( USES_REGS1 ){
   Term t = TermNil;
+  CELL *tail = &t;
 
+  CUT_flush_buffered_answers();
   if (OrFr_qg_solutions(LOCAL_top_or_fr)) {
     qg_ans_fr_ptr aux_answer1, aux_answer2;
+    int i;
+    /* the answers are in left-to-right order, thus the list is built from the head */
     aux_answer1 = SolFr_first(OrFr_qg_solutions(LOCAL_top_or_fr));
     while (aux_answer1) {
-      t = MkPairTerm(AnsFr_answer(aux_answer1), t);
+      for (i = 0; i < AnsFr_free_slot(aux_answer1); i++) {
+        Term pair = MkPairTerm(AnsFr_answer(aux_answer1, i), TermNil);
+        *tail = pair;
+        tail = RepPair(pair) + 1;
+      }
       aux_answer2 = aux_answer1;
       aux_answer1 = AnsFr_next(aux_answer1);
       FREE_QG_ANSWER_FRAME(aux_answer2);
@@ -803,6 +1245,59 @@ static Int p_parallel_get_answers( USES_REGS1 ){
 }
 
 
+#ifdef YAPOR_TRACING
+static Int p_yapor_trace_dump( USES_REGS1 ) {
+  static const char *event_names[] = { "get_work", "p_share_work", "q_share_work", "share_private_nodes",
+                                       "suspend_branch", "resume_suspension_frame", "public_completion", "idle" };
+  Term t = Deref(ARG1);
+  FILE *file;
+  UInt start_time, first, top, i;
+  int wid, depth;
+
+  if (IsVarTerm(t) || !IsAtomTerm(t))
+    return (FALSE);
+  if ((file = fopen(RepAtom(AtomOfTerm(t))->StrOfAE, "w")) == NULL) {
+    Yap_Error(SYSTEM_ERROR, TermNil, "yapor_trace_dump/1 (fopen %s: %s)", RepAtom(AtomOfTerm(t))->StrOfAE, strerror(errno));
+    return (FALSE);
+  }
+  /* the oldest event still in the rings is the origin of the timeline */
+  start_time = 0;
+  for (wid = 0; wid < GLOBAL_number_workers; wid++) {
+    top = REMOTE_trace_top(wid);
+    first = (top > TRACE_BUFFER_SIZE) ? top - TRACE_BUFFER_SIZE : 0;
+    if (top && (start_time == 0 || REMOTE_trace_events(wid)[first & (TRACE_BUFFER_SIZE - 1)].time < start_time))
+      start_time = REMOTE_trace_events(wid)[first & (TRACE_BUFFER_SIZE - 1)].time;
+  }
+  /* one thread per worker, timestamps in microseconds */
+  fprintf(file, "{\"traceEvents\":[\n");
+  for (wid = 0; wid < GLOBAL_number_workers; wid++) {
+    fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"worker %d\"}}",
+            wid ? ",\n" : "", wid, wid);
+    top = REMOTE_trace_top(wid);
+    first = (top > TRACE_BUFFER_SIZE) ? top - TRACE_BUFFER_SIZE : 0;
+    depth = 0;
+    for (i = first; i < top; i++) {
+      struct optyap_trace_event *trace_event = REMOTE_trace_events(wid) + (i & (TRACE_BUFFER_SIZE - 1));
+      if (trace_event->phase == 'B')
+        depth++;
+      else if (depth == 0)
+        continue;  /* the begin event was overwritten */
+      else
+        depth--;
+      fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":0,\"tid\":%d,\"ts\":%.3f",
+              event_names[trace_event->event], trace_event->phase, wid, (double) (trace_event->time - start_time) / 1000);
+      if (trace_event->refused)  /* end of an idle period */
+        fprintf(file, ",\"args\":{\"refused_requests\":%d}", trace_event->refused);
+      fprintf(file, "}");
+    }
+  }
+  fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+  fclose(file);
+  return (TRUE);
+}
+#endif /* YAPOR_TRACING */
+
+
 static Int p_show_statistics_or( USES_REGS1 ) {
   struct page_statistics stats;
   long bytes, total_bytes = 0;
@@ -838,6 +1333,54 @@ static Int p_show_statistics_or( USES_REGS1 ) {
 #else 
   Sfprintf(out, "Total memory in use (I+II):        %10ld bytes\n", total_bytes);
 #endif /* USE_PAGES_MALLOC */
+#ifdef YAPOR_COPY
+  { UInt shares = 0, global_bytes = 0, local_bytes = 0, trail_bytes = 0, copied_bytes;
+    int i;
+    for (i = 0; i < GLOBAL_number_workers; i++) {
+      shares += REMOTE_copy_stats_shares(i);
+      global_bytes += REMOTE_copy_stats_global_bytes(i);
+      local_bytes += REMOTE_copy_stats_local_bytes(i);
+      trail_bytes += REMOTE_copy_stats_trail_bytes(i);
+    }
+    copied_bytes = global_bytes + local_bytes + trail_bytes;
+    Sfprintf(out, "\nStack copying (%s mode)\n", GLOBAL_copy_mode == COPY_MODE_INCREMENTAL ? "incremental" : "full");
+    Sfprintf(out, "  Sharing operations:              %10lu\n", (unsigned long) shares);
+    Sfprintf(out, "  Global stack copied:             %10lu bytes\n", (unsigned long) global_bytes);
+    Sfprintf(out, "  Local stack copied:              %10lu bytes\n", (unsigned long) local_bytes);
+    Sfprintf(out, "  Trail copied:                    %10lu bytes\n", (unsigned long) trail_bytes);
+    Sfprintf(out, "  Bytes copied per share:          %10lu bytes\n", (unsigned long) (shares ? copied_bytes / shares : 0));
+  }
+#endif /* YAPOR_COPY */
+#ifdef YAPOR_GRANULARITY_CONTROL
+  { UInt refused = 0, shares = 0, share_time = 0, samples = 0, work_time = 0;
+    int i;
+    for (i = 0; i < GLOBAL_number_workers; i++) {
+      refused += REMOTE_granularity_refused(i);
+      shares += REMOTE_granularity_shares(i);
+      share_time += REMOTE_granularity_share_time(i);
+      samples += REMOTE_granularity_samples(i);
+      work_time += REMOTE_granularity_work_time(i);
+    }
+    Sfprintf(out, "\nGranularity control (ratio %d)\n", GLOBAL_granularity_ratio);
+    Sfprintf(out, "  Sharing requests refused:        %10lu\n", (unsigned long) refused);
+    Sfprintf(out, "  Time per sharing operation:      %10lu ns\n", (unsigned long) (shares ? share_time / shares : 0));
+    Sfprintf(out, "  Shared alternatives sampled:     %10lu\n", (unsigned long) samples);
+    Sfprintf(out, "  Work per shared alternative:     %10lu ns\n", (unsigned long) (samples ? work_time / samples : 0));
+    Sfprintf(out, "  Sharing time / work time:        %10.3f\n", work_time ? (double) share_time / work_time : 0.0);
+  }
+#endif /* YAPOR_GRANULARITY_CONTROL */
+#ifdef ANSWER_TRIE_RANGES
+  { UInt ranges = 0, alternatives = 0;
+    int i;
+    for (i = 0; i < GLOBAL_number_workers; i++) {
+      ranges += REMOTE_trie_range_ranges(i);
+      alternatives += REMOTE_trie_range_alternatives(i);
+    }
+    Sfprintf(out, "\nAnswer trie ranges (at most %d siblings)\n", ANSWER_TRIE_RANGE_SIZE);
+    Sfprintf(out, "  Ranges taken:                    %10lu\n", (unsigned long) ranges);
+    Sfprintf(out, "  Trie nodes taken in ranges:      %10lu\n", (unsigned long) alternatives);
+  }
+#endif /* ANSWER_TRIE_RANGES */
   PL_release_stream(out);
   return (TRUE);
 }
@@ -895,6 +1438,10 @@ static Int p_show_statistics_opt( USES_REGS1 ) {
   stats = show_statistics_answer_ref_nodes(out);
   INCREMENT_AUX_STATS(stats, bytes, total_pages);
 #endif /* THREADS_FULL_SHARING */
+#ifdef COMPACT_ANSWER_TRIES
+  stats = show_statistics_compact_answer_trie_nodes(out);
+  INCREMENT_AUX_STATS(stats, bytes, total_pages);
+#endif /* COMPACT_ANSWER_TRIES */
   Sfprintf(out, "  Memory in use (II):              %10ld bytes\n\n", bytes);
   total_bytes += bytes;
   bytes = 0;
@@ -927,6 +1474,14 @@ static Int p_show_statistics_opt( USES_REGS1 ) {
 #else 
   Sfprintf(out, "Total memory in use (I+II+III+IV): %10ld bytes\n", total_bytes);
 #endif /* USE_PAGES_MALLOC */
+  Sfprintf(out, "\nSuspended branches\n");
+  Sfprintf(out, "  Suspension space threshold:      %10ld bytes\n", GLOBAL_suspension_space_threshold);
+  Sfprintf(out, "  Suspended branches:              %10ld\n", GLOBAL_suspended_branches);
+  Sfprintf(out, "  Suspended blocks in use:         %10ld bytes (%ld bytes stored)\n",
+          GLOBAL_suspended_raw_bytes, GLOBAL_suspended_bytes);
+  Sfprintf(out, "  Suspended blocks in total:       %10ld bytes (%ld bytes stored)\n",
+          GLOBAL_suspended_total_raw_bytes, GLOBAL_suspended_total_bytes);
+  Sfprintf(out, "  Peak memory in suspended blocks: %10ld bytes\n", GLOBAL_suspended_peak_bytes);
   PL_release_stream(out);
   return (TRUE);
 }
@@ -999,6 +1554,10 @@ static Int p_get_optyap_statistics( USES_REGS1 ) {
     bytes += PgEnt_bytes_in_use(stats);
     if (value != 0) structs = PgEnt_strs_in_use(stats);
   }
+#ifdef COMPACT_ANSWER_TRIES
+  if (value == 0)  /* compact answer tries are allocated as blocks, thus they do not use pages */
+    bytes += GLOBAL_cmp_ans_nodes * sizeof(struct compact_answer_trie_node);
+#endif /* COMPACT_ANSWER_TRIES */
 #endif /* TABLING */
 #ifdef YAPOR
   if (value == 0 || value == 4) {  /* or_frames */
@@ -1023,6 +1582,10 @@ static Int p_get_optyap_statistics( USES_REGS1 ) {
     bytes += PgEnt_bytes_in_use(stats);
     if (value != 0) structs = PgEnt_strs_in_use(stats);
   }
+  if (value == 24) {  /* suspended_blocks */
+    bytes = GLOBAL_suspended_total_bytes;
+    structs = GLOBAL_suspended_total_raw_bytes;
+  }
 #ifdef TABLING_INNER_CUTS
   if (value == 0 || value == 14) {  /* table_subgoal_solution_frames */
     GET_PAGE_STATS(stats, struct table_subgoal_solution_frame, _pages_tg_sol_fr);
@@ -1036,6 +1599,67 @@ static Int p_get_optyap_statistics( USES_REGS1 ) {
   }
 #endif /* TABLING_INNER_CUTS */
 #endif /* YAPOR && TABLING */
+#ifdef LIMIT_TABLING
+  if (value == 18) {  /* evicted_subgoals */
+    bytes = GLOBAL_evicted_bytes;
+    structs = GLOBAL_evicted_subgoals;
+  }
+#endif /* LIMIT_TABLING */
+#ifdef INCREMENTAL_TABLING
+  if (value == 19) {  /* incremental_updates */
+    bytes = GLOBAL_incremental_updates;
+    structs = GLOBAL_invalidated_subgoals;
+  }
+#endif /* INCREMENTAL_TABLING */
+#ifdef DEFERRED_ABOLISH
+  if (value == 21) {  /* abolished_tries */
+    bytes = GLOBAL_abolished_subtries_freed;
+    structs = GLOBAL_abolished_tries_pending;
+  }
+#endif /* DEFERRED_ABOLISH */
+#ifdef GROUND_CALL_HASHING
+  if (value == 22) {  /* ground_calls */
+    bytes = GLOBAL_ground_call_hits;
+    structs = GLOBAL_ground_call_lookups;
+  }
+#endif /* GROUND_CALL_HASHING */
+#ifdef YAPOR_GRANULARITY_CONTROL
+  if (value == 23) {  /* granularity */
+    int i;
+    bytes = structs = 0;
+    for (i = 0; i < GLOBAL_number_workers; i++) {
+      bytes += REMOTE_granularity_share_time(i) / 1000;
+      structs += REMOTE_granularity_work_time(i) / 1000;
+    }
+  }
+#endif /* YAPOR_GRANULARITY_CONTROL */
+#ifdef ANSWER_TRIE_RANGES
+  if (value == 25) {  /* answer_trie_ranges */
+    int i;
+    bytes = structs = 0;
+    for (i = 0; i < GLOBAL_number_workers; i++) {
+      bytes += REMOTE_trie_range_ranges(i);
+      structs += REMOTE_trie_range_alternatives(i);
+    }
+  }
+#endif /* ANSWER_TRIE_RANGES */
+#ifdef STRUCT_MAGAZINES
+  if (value == 26) {  /* magazine_locks */
+    struct global_page_entry *pg_ents[] = { &GLOBAL_pages_sg_fr, &GLOBAL_pages_dep_fr, &GLOBAL_pages_sg_node, &GLOBAL_pages_ans_node };
+    int i;
+    bytes = structs = 0;
+    for (i = 0; i < 4; i++) {
+      bytes += PgEnt_mag_refills(*pg_ents[i]) + PgEnt_mag_spills(*pg_ents[i]) + PgEnt_mag_chunks(*pg_ents[i]) + PgEnt_mag_releases(*pg_ents[i]);
+      structs += PgEnt_mag_waits(*pg_ents[i]);
+    }
+  }
+#endif /* STRUCT_MAGAZINES */
+#ifdef EPOCH_RECLAMATION
+  if (value == 20) {  /* invalid_answers_backlog */
+    structs = GLOBAL_epoch_backlog;
+    bytes = structs * sizeof(struct answer_trie_node);
+  }
+#endif /* EPOCH_RECLAMATION */
 
   if (value == 0) {  /* total_memory */
 #ifdef USE_PAGES_MALLOC
@@ -1104,6 +1728,81 @@ static inline struct page_statistics show_statistics_dependency_frames(IOSTREAM
 }
 
 
+#ifdef STRUCT_MAGAZINES
+static struct local_magazine *remote_magazine(int wid, struct global_page_entry *pg_ent) {
+  if (pg_ent == &GLOBAL_pages_sg_fr)
+    return &REMOTE_mag_pages_sg_fr(wid);
+  if (pg_ent == &GLOBAL_pages_dep_fr)
+    return &REMOTE_mag_pages_dep_fr(wid);
+  if (pg_ent == &GLOBAL_pages_sg_node)
+    return &REMOTE_mag_pages_sg_node(wid);
+  if (pg_ent == &GLOBAL_pages_ans_node)
+    return &REMOTE_mag_pages_ans_node(wid);
+  return NULL;
+}
+
+
+#ifdef THREADS
+#define FOR_ALL_WORKERS(WID)                                 \
+        for (WID = 0; WID < MAX_THREADS && Yap_local[WID]; WID++)   \
+          if (REMOTE_ThreadHandle(WID).in_use)
+#else
+#define FOR_ALL_WORKERS(WID)                                 \
+        for (WID = 0; WID < GLOBAL_number_workers; WID++)
+#endif /* THREADS */
+
+
+static long magazines_strs_in_use(struct global_page_entry *pg_ent) {
+  /* structs allocated and released by the workers are counted in their magazines */
+  long strs_in_use = 0;
+  int wid;
+
+  if (remote_magazine(0, pg_ent) == NULL)
+    return 0;
+#ifdef THREADS
+  LOCK(GLOBAL_ThreadHandlesLock);
+#endif /* THREADS */
+  FOR_ALL_WORKERS(wid)
+    strs_in_use += Mag_strs_in_use(*remote_magazine(wid, pg_ent));
+#ifdef THREADS
+  UNLOCK(GLOBAL_ThreadHandlesLock);
+#endif /* THREADS */
+  return strs_in_use;
+}
+
+
+static void show_statistics_magazine(IOSTREAM *out, const char *name, struct global_page_entry *pg_ent) {
+  long allocs = PgEnt_mag_allocs(*pg_ent), cached = 0, locks;
+  int wid;
+
+#ifdef THREADS
+  LOCK(GLOBAL_ThreadHandlesLock);
+#endif /* THREADS */
+  FOR_ALL_WORKERS(wid) {
+    allocs += Mag_allocs(*remote_magazine(wid, pg_ent));
+    cached += Mag_strs(*remote_magazine(wid, pg_ent));
+  }
+#ifdef THREADS
+  UNLOCK(GLOBAL_ThreadHandlesLock);
+#endif /* THREADS */
+  locks = PgEnt_mag_refills(*pg_ent) + PgEnt_mag_spills(*pg_ent) + PgEnt_mag_chunks(*pg_ent) + PgEnt_mag_releases(*pg_ent);
+  Sfprintf(out, "  %s %10ld allocs, %ld global locks (%ld refills, %ld spills, %ld new batches, %ld released batches)\n",
+           name, allocs, locks, PgEnt_mag_refills(*pg_ent), PgEnt_mag_spills(*pg_ent), PgEnt_mag_chunks(*pg_ent), PgEnt_mag_releases(*pg_ent));
+  Sfprintf(out, "  %-21s %10ld global locks waited for another worker\n", "", PgEnt_mag_waits(*pg_ent));
+  Sfprintf(out, "  %-21s %10ld free structs (%ld in magazines and %ld in depot)\n",
+           "", cached + PgEnt_depot_strs(*pg_ent), cached, PgEnt_depot_strs(*pg_ent));
+  return;
+}
+#endif /* STRUCT_MAGAZINES */
+
+
+#ifdef INCREMENTAL_TABLING
+static inline struct page_statistics show_statistics_incremental_dependencies(IOSTREAM *out) {
+  SHOW_PAGE_STATS(out, struct incremental_dependency, _pages_inc_dep, "Incremental dependencies:     ");
+}
+#endif /* INCREMENTAL_TABLING */
+
+
 static inline struct page_statistics show_statistics_subgoal_trie_nodes(IOSTREAM *out) {
   SHOW_PAGE_STATS(out, struct subgoal_trie_node, _pages_sg_node, "Subgoal trie nodes:           ");
 }
@@ -1119,6 +1818,22 @@ static inline struct page_statistics show_statistics_answer_trie_nodes(IOSTREAM
 }
 
 
+#ifdef COMPACT_ANSWER_TRIES
+static inline struct page_statistics show_statistics_compact_answer_trie_nodes(IOSTREAM *out) {
+  /* compact answer tries are allocated as blocks, thus they do not use pages */
+  struct page_statistics stats;
+#ifdef USE_PAGES_MALLOC
+  PgEnt_pages_in_use(stats) = 0;
+#endif /* USE_PAGES_MALLOC */
+  PgEnt_strs_in_use(stats) = GLOBAL_cmp_ans_nodes;
+  PgEnt_bytes_in_use(stats) = PgEnt_strs_in_use(stats) * sizeof(struct compact_answer_trie_node);
+  Sfprintf(out, "  Compact answer trie nodes:       %10ld bytes (%ld structs in use)\n",
+           PgEnt_bytes_in_use(stats), PgEnt_strs_in_use(stats));
+  return stats;
+}
+#endif /* COMPACT_ANSWER_TRIES */
+
+
 static inline struct page_statistics show_statistics_answer_trie_hashes(IOSTREAM *out) {
   SHOW_PAGE_STATS(out, struct answer_trie_hash, _pages_ans_hash, "Answer trie hashes:           ");
 }
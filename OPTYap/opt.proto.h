@@ -35,6 +35,9 @@ void itos(int, char *);
 #ifdef YAPOR
 void finish_yapor(void);
 #endif /* YAPOR */
+#ifdef LIMIT_TABLING
+long table_space_in_use(void);
+#endif /* LIMIT_TABLING */
 
 
 
@@ -50,11 +53,40 @@ ans_node_ptr mode_directed_answer_search(sg_fr_ptr, CELL *);
 #endif /* MODE_DIRECTED_TABLING */
 void load_answer(ans_node_ptr, CELL *);
 CELL *exec_substitution(gt_node_ptr, CELL *);
+void update_answer_trie_instructions(sg_fr_ptr);
 void update_answer_trie(sg_fr_ptr);
 void free_subgoal_trie(sg_node_ptr, int, int);
 void free_answer_trie(ans_node_ptr, int, int);
+#ifdef COMPACT_ANSWER_TRIES
+cmp_node_ptr build_compact_answer_trie(ans_node_ptr, long *);
+void install_compact_answer_trie(sg_fr_ptr, cmp_node_ptr);
+void free_answer_trie_nodes(ans_node_ptr);
+void free_compact_answer_trie(cmp_node_ptr);
+#endif /* COMPACT_ANSWER_TRIES */
 void free_answer_hash_chain(ans_hash_ptr);
 void abolish_table(tab_ent_ptr);
+#if defined(INCREMENTAL_TABLING) || defined(EPOCH_RECLAMATION)
+choiceptr oldest_loading_choice_point(void);
+#endif /* INCREMENTAL_TABLING || EPOCH_RECLAMATION */
+#ifdef LIMIT_TABLING
+void limit_table_space(void);
+#endif /* LIMIT_TABLING */
+#ifdef INCREMENTAL_TABLING
+void new_incremental_predicate(struct pred_entry *);
+void incremental_predicate_call(struct pred_entry *);
+void incremental_predicate_update(struct pred_entry *);
+#endif /* INCREMENTAL_TABLING */
+#ifdef DEFERRED_ABOLISH
+int free_abolished_subtrie(void);
+#endif /* DEFERRED_ABOLISH */
+#ifdef EPOCH_RECLAMATION
+void retire_invalid_answers(sg_fr_ptr);
+void reclaim_invalid_answers(void);
+#endif /* EPOCH_RECLAMATION */
+#ifdef TABLE_SNAPSHOTS
+int save_tables(char *, tab_ent_ptr *, int);
+int load_tables(char *, tab_ent_ptr *, int);
+#endif /* TABLE_SNAPSHOTS */
 void show_table(tab_ent_ptr, int, IOSTREAM *);
 void show_global_trie(int, IOSTREAM *);
 #endif /* TABLING */
@@ -69,6 +101,10 @@ void show_global_trie(int, IOSTREAM *);
 void private_completion(sg_fr_ptr);
 #ifdef YAPOR
 void public_completion(void);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+int compact_queued_answer_trie(void);
+void flush_compaction_queue(tab_ent_ptr);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
 void complete_suspension_frames(or_fr_ptr);
 void suspend_branch(void);
 void resume_suspension_frame(susp_fr_ptr, or_fr_ptr);
@@ -16,7 +16,15 @@
 **********************/
 
 typedef double realtime;
-typedef unsigned long bitmap;
+
+/* worker sets are multi-word bitmaps, only the first GLOBAL_bitmap_words **
+** words are used, as given by the number of workers at start-up         */
+typedef unsigned long bitmap_word;
+#define BITMAP_WORD_BITS  (8 * SIZEOF_LONG_INT)
+#define BITMAP_WORDS      ((MAX_WORKERS + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS)
+typedef struct {
+  bitmap_word word[BITMAP_WORDS];
+} bitmap;
 
 #ifdef YAPOR_THREADS
 /* Threads may not assume addresses are the same at different workers */
@@ -126,6 +134,18 @@ struct global_page_entry {
   volatile long pages_in_use;
 #endif /* USE_PAGES_MALLOC */
   volatile long structs_in_use;
+#ifdef STRUCT_MAGAZINES
+  void *depot;              /* free structs spilled by the worker magazines */
+  long depot_structs;
+  int depot_full_spills;    /* consecutive spills that found the depot full */
+  long magazine_allocs;     /* allocations of the workers that released their magazines */
+  long magazine_refills;    /* batches moved from the depot to a magazine */
+  long magazine_spills;     /* batches moved from a magazine to the depot */
+  long magazine_chunks;     /* batches allocated when the depot is empty */
+  long magazine_releases;   /* batches released when the depot is full */
+  long magazine_waits;      /* depot lock acquisitions that waited for another worker */
+  volatile int magazine_lockers;
+#endif /* STRUCT_MAGAZINES */
 };
 
 struct local_page_entry {
@@ -145,6 +165,43 @@ struct local_page_entry {
 #define PgEnt_pages_in_use(X)   ((X).pages_in_use)
 #define PgEnt_strs_in_use(X)    ((X).structs_in_use)
 #define PgEnt_strs_free(X)      (PgEnt_pg_in_use(X) * PgEnt_str_per_pg(X) - PgEnt_str_in_use(X))
+#define PgEnt_depot(X)          ((X).depot)
+#define PgEnt_depot_strs(X)     ((X).depot_structs)
+#define PgEnt_depot_full(X)     ((X).depot_full_spills)
+#define PgEnt_mag_allocs(X)     ((X).magazine_allocs)
+#define PgEnt_mag_refills(X)    ((X).magazine_refills)
+#define PgEnt_mag_spills(X)     ((X).magazine_spills)
+#define PgEnt_mag_chunks(X)     ((X).magazine_chunks)
+#define PgEnt_mag_releases(X)   ((X).magazine_releases)
+#define PgEnt_mag_waits(X)      ((X).magazine_waits)
+#define PgEnt_mag_lockers(X)    ((X).magazine_lockers)
+
+
+
+/*****************************
+**      local_magazine      **
+*****************************/
+
+#ifdef STRUCT_MAGAZINES
+struct local_magazine {
+  void *first_struct;
+  int structs;
+  long structs_in_use;      /* allocated minus released by the worker */
+  long allocs;
+};
+
+struct local_magazines {
+  struct local_magazine subgoal_frame_magazine;
+  struct local_magazine dependency_frame_magazine;
+  struct local_magazine subgoal_trie_node_magazine;
+  struct local_magazine answer_trie_node_magazine;
+};
+#endif /* STRUCT_MAGAZINES */
+
+#define Mag_first(X)            ((X).first_struct)
+#define Mag_strs(X)             ((X).structs)
+#define Mag_strs_in_use(X)      ((X).structs_in_use)
+#define Mag_allocs(X)           ((X).allocs)
 
 
 
@@ -171,6 +228,9 @@ struct global_pages {
   struct global_page_entry answer_trie_hash_pages;
 #if defined(THREADS_FULL_SHARING)
   struct global_page_entry answer_ref_node_pages;
+#endif
+#ifdef INCREMENTAL_TABLING
+  struct global_page_entry incremental_dependency_pages;
 #endif
   struct global_page_entry global_trie_node_pages;
   struct global_page_entry global_trie_hash_pages;
@@ -243,6 +303,9 @@ struct global_optyap_locks {
   int who_locked_heap;
   lockvar heap_access;
   lockvar alloc_block;
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+  lockvar compaction_queue;
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
 };
 #endif /* YAPOR */
 
@@ -272,6 +335,44 @@ struct local_optyap_signals {
     worker_ready = 4
   } reply_signal;
 };
+
+/* Chase-Lev deque of shared nodes with untried alternatives: the owner  **
+** pushes and withdraws offers at the bottom, thieves steal at the top    */
+struct local_optyap_work_offers {
+  volatile Int top;
+  volatile Int bottom;
+  struct {
+    struct or_frame *or_frame;
+    int depth;
+  } offers[STEAL_DEQUE_SIZE];
+};
+
+#ifdef YAPOR_TRACING
+#define TRACE_GET_WORK             0
+#define TRACE_P_SHARE_WORK         1
+#define TRACE_Q_SHARE_WORK         2
+#define TRACE_SHARE_PRIVATE_NODES  3
+#define TRACE_SUSPEND_BRANCH       4
+#define TRACE_RESUME_SUSPENSION    5
+#define TRACE_PUBLIC_COMPLETION    6
+#define TRACE_IDLE                 7
+
+struct optyap_trace_event {
+  UInt time;  /* nanoseconds */
+  int refused;  /* sharing requests refused in an idle period (end of TRACE_IDLE) */
+  short event;
+  char phase;  /* 'B' (begin) or 'E' (end) */
+};
+
+/* ring of scheduler events written only by its worker, the event **
+** number i is at events[i & (TRACE_BUFFER_SIZE - 1)]              */
+struct local_optyap_trace {
+  struct optyap_trace_event *events;
+  volatile UInt top;
+  int idle;
+  int idle_refused;
+};
+#endif /* YAPOR_TRACING */
 #endif /* YAPOR */
 
 
@@ -289,6 +390,7 @@ struct global_optyap_data {
   int scheduler_loop;
   int delayed_release_load;
   int number_workers;
+  int bitmap_words;
   int worker_pid[MAX_WORKERS];
   
 #ifdef YAPOR_COW
@@ -313,8 +415,16 @@ struct global_optyap_data {
   volatile bitmap pruning_workers;
 #endif /* TABLING_INNER_CUTS */
   struct global_optyap_locks locks;
-  volatile unsigned int branch[MAX_WORKERS][MAX_BRANCH_DEPTH];
   volatile char parallel_mode;  /* PARALLEL_MODE_OFF / PARALLEL_MODE_ON / PARALLEL_MODE_RUNNING */
+  volatile int wait_mode;       /* WAIT_MODE_SPIN / WAIT_MODE_BLOCK */
+  volatile int scheduler_mode;  /* SCHEDULER_MODE_BITMAP / SCHEDULER_MODE_STEAL */
+  volatile int copy_mode;       /* COPY_MODE_INCREMENTAL / COPY_MODE_FULL */
+#ifdef YAPOR_GRANULARITY_CONTROL
+  volatile int granularity_ratio;  /* 0 if the granularity control is disabled */
+#endif /* YAPOR_GRANULARITY_CONTROL */
+  volatile int work_events;
+  volatile int sleeping_workers;
+  volatile int signal_waiters;
 #endif /* YAPOR */
 
 #ifdef TABLING
@@ -322,13 +432,26 @@ struct global_optyap_data {
   struct global_trie_node *root_global_trie;
   struct table_entry *root_table_entry;
 #ifdef LIMIT_TABLING
-  int max_pages;
-  struct subgoal_frame *first_subgoal_frame;
-  struct subgoal_frame *last_subgoal_frame;
-  struct subgoal_frame *check_subgoal_frame;
+  volatile long table_space_limit;
+  volatile long table_space_bytes;
+  volatile long evicted_subgoals;
+  volatile long evicted_bytes;
 #endif /* LIMIT_TABLING */
+#ifdef INCREMENTAL_TABLING
+  struct incremental_predicate *root_incremental_predicate;
+  long incremental_updates;
+  long invalidated_subgoals;
+#endif /* INCREMENTAL_TABLING */
 #ifdef YAPOR
   struct dependency_frame *root_dependency_frame;
+  volatile long suspension_space_threshold;  /* 0 if there is no threshold */
+  volatile long suspension_space_exceeded;   /* suspended bytes when the threshold was exceeded, 0 otherwise */
+  volatile long suspended_bytes;         /* memory held by the suspended blocks */
+  volatile long suspended_raw_bytes;     /* size of the suspended blocks before compression */
+  volatile long suspended_peak_bytes;
+  volatile long suspended_branches;
+  volatile long suspended_total_bytes;
+  volatile long suspended_total_raw_bytes;
 #endif /* YAPOR */
 #ifdef THREADS_CONSUMER_SHARING
   struct threads_dependency_frame threads_dependency_frame[MAX_THREADS];
@@ -340,6 +463,39 @@ struct global_optyap_data {
 #ifdef TIMESTAMP_CHECK
   long timestamp;
 #endif /* TIMESTAMP_CHECK */
+#ifdef COMPACT_ANSWER_TRIES
+  volatile long compact_answer_trie_nodes;
+#endif /* COMPACT_ANSWER_TRIES */
+#if defined(YAPOR) && defined(COMPACT_ANSWER_TRIES_AT_COMPLETION)
+  struct subgoal_frame *compaction_queue[COMPACTION_QUEUE_SIZE];
+  int compaction_queue_first;
+  volatile int compaction_queue_entries;
+#endif /* YAPOR && COMPACT_ANSWER_TRIES_AT_COMPLETION */
+#ifdef TABLE_SNAPSHOTS
+  struct table_snapshot *table_snapshots;
+#endif /* TABLE_SNAPSHOTS */
+#ifdef DEFERRED_ABOLISH
+  volatile int abolish_mode;  /* ABOLISH_MODE_IMMEDIATE / ABOLISH_MODE_DEFERRED */
+#ifdef YAPOR
+  lockvar abolished_tries_lock;
+#endif /* YAPOR */
+  struct abolished_trie *abolished_tries;
+  volatile long abolished_tries_pending;
+  long abolished_subtries_freed;
+#endif /* DEFERRED_ABOLISH */
+#ifdef GROUND_CALL_HASHING
+  CELL *ground_call_buffer;
+  UInt ground_call_buffer_size;
+  long ground_call_lookups;
+  long ground_call_hits;
+#endif /* GROUND_CALL_HASHING */
+#ifdef EPOCH_RECLAMATION
+  lockvar epoch_lock;
+  volatile long epoch;
+  struct answer_trie_node *epoch_limbo[3];  /* invalid answers retired in the last three epochs */
+  volatile long epoch_backlog;              /* invalid answers waiting in the limbo lists */
+  long epoch_reclaimed;
+#endif /* EPOCH_RECLAMATION */
 #endif /* TABLING */
 };
 
@@ -354,6 +510,7 @@ struct global_optyap_data {
 #define GLOBAL_pages_ans_node                   (GLOBAL_optyap_data.pages.answer_trie_node_pages)
 #define GLOBAL_pages_ans_hash                   (GLOBAL_optyap_data.pages.answer_trie_hash_pages)
 #define GLOBAL_pages_ans_ref_node               (GLOBAL_optyap_data.pages.answer_ref_node_pages)
+#define GLOBAL_pages_inc_dep                    (GLOBAL_optyap_data.pages.incremental_dependency_pages)
 #define GLOBAL_pages_gt_node                    (GLOBAL_optyap_data.pages.global_trie_node_pages)
 #define GLOBAL_pages_gt_hash                    (GLOBAL_optyap_data.pages.global_trie_hash_pages)
 #define GLOBAL_pages_or_fr                      (GLOBAL_optyap_data.pages.or_frame_pages)
@@ -365,6 +522,7 @@ struct global_optyap_data {
 #define GLOBAL_scheduler_loop                   (GLOBAL_optyap_data.scheduler_loop)
 #define GLOBAL_delayed_release_load             (GLOBAL_optyap_data.delayed_release_load)
 #define GLOBAL_number_workers                   (GLOBAL_optyap_data.number_workers)
+#define GLOBAL_bitmap_words                     (GLOBAL_optyap_data.bitmap_words)
 #define GLOBAL_worker_pid(worker)               (GLOBAL_optyap_data.worker_pid[worker])
 #define GLOBAL_master_worker                    (GLOBAL_optyap_data.master_worker)
 #define GLOBAL_execution_time                   (GLOBAL_optyap_data.execution_time)
@@ -393,20 +551,57 @@ struct global_optyap_data {
 #define GLOBAL_locks_who_locked_heap            (GLOBAL_optyap_data.locks.who_locked_heap)
 #define GLOBAL_locks_heap_access                (GLOBAL_optyap_data.locks.heap_access)
 #define GLOBAL_locks_alloc_block                (GLOBAL_optyap_data.locks.alloc_block)
-#define GLOBAL_branch(worker, depth)            (GLOBAL_optyap_data.branch[worker][depth])
+#define GLOBAL_locks_compaction_queue           (GLOBAL_optyap_data.locks.compaction_queue)
 #define GLOBAL_parallel_mode                    (GLOBAL_optyap_data.parallel_mode)
+#define GLOBAL_wait_mode                        (GLOBAL_optyap_data.wait_mode)
+#define GLOBAL_scheduler_mode                   (GLOBAL_optyap_data.scheduler_mode)
+#define GLOBAL_copy_mode                        (GLOBAL_optyap_data.copy_mode)
+#define GLOBAL_granularity_ratio                (GLOBAL_optyap_data.granularity_ratio)
+#define GLOBAL_work_events                      (GLOBAL_optyap_data.work_events)
+#define GLOBAL_sleeping_workers                 (GLOBAL_optyap_data.sleeping_workers)
+#define GLOBAL_signal_waiters                   (GLOBAL_optyap_data.signal_waiters)
 #define GLOBAL_root_gt                          (GLOBAL_optyap_data.root_global_trie)
 #define GLOBAL_root_tab_ent                     (GLOBAL_optyap_data.root_table_entry)
-#define GLOBAL_max_pages                        (GLOBAL_optyap_data.max_pages)
-#define GLOBAL_first_sg_fr                      (GLOBAL_optyap_data.first_subgoal_frame)
-#define GLOBAL_last_sg_fr                       (GLOBAL_optyap_data.last_subgoal_frame)
-#define GLOBAL_check_sg_fr                      (GLOBAL_optyap_data.check_subgoal_frame)
+#define GLOBAL_table_space_limit                (GLOBAL_optyap_data.table_space_limit)
+#define GLOBAL_table_space_bytes                (GLOBAL_optyap_data.table_space_bytes)
+#define GLOBAL_evicted_subgoals                 (GLOBAL_optyap_data.evicted_subgoals)
+#define GLOBAL_evicted_bytes                    (GLOBAL_optyap_data.evicted_bytes)
+#define GLOBAL_root_inc_pred                    (GLOBAL_optyap_data.root_incremental_predicate)
+#define GLOBAL_incremental_updates              (GLOBAL_optyap_data.incremental_updates)
+#define GLOBAL_invalidated_subgoals             (GLOBAL_optyap_data.invalidated_subgoals)
 #define GLOBAL_root_dep_fr                      (GLOBAL_optyap_data.root_dependency_frame)
+#define GLOBAL_suspension_space_threshold       (GLOBAL_optyap_data.suspension_space_threshold)
+#define GLOBAL_suspension_space_exceeded        (GLOBAL_optyap_data.suspension_space_exceeded)
+#define GLOBAL_suspended_bytes                  (GLOBAL_optyap_data.suspended_bytes)
+#define GLOBAL_suspended_raw_bytes              (GLOBAL_optyap_data.suspended_raw_bytes)
+#define GLOBAL_suspended_peak_bytes             (GLOBAL_optyap_data.suspended_peak_bytes)
+#define GLOBAL_suspended_branches               (GLOBAL_optyap_data.suspended_branches)
+#define GLOBAL_suspended_total_bytes            (GLOBAL_optyap_data.suspended_total_bytes)
+#define GLOBAL_suspended_total_raw_bytes        (GLOBAL_optyap_data.suspended_total_raw_bytes)
 #define GLOBAL_th_dep_fr(wid)                   (GLOBAL_optyap_data.threads_dependency_frame[wid])
 #define GLOBAL_table_var_enumerator(index)      (GLOBAL_optyap_data.table_var_enumerator[index])
 #define GLOBAL_table_var_enumerator_addr(index) (GLOBAL_optyap_data.table_var_enumerator + (index))
 #define GLOBAL_trie_locks(index)                (GLOBAL_optyap_data.trie_locks[index])
 #define GLOBAL_timestamp                        (GLOBAL_optyap_data.timestamp)
+#define GLOBAL_cmp_ans_nodes                    (GLOBAL_optyap_data.compact_answer_trie_nodes)
+#define GLOBAL_compaction_queue(index)          (GLOBAL_optyap_data.compaction_queue[index])
+#define GLOBAL_compaction_queue_first           (GLOBAL_optyap_data.compaction_queue_first)
+#define GLOBAL_compaction_queue_entries         (GLOBAL_optyap_data.compaction_queue_entries)
+#define GLOBAL_table_snapshots                  (GLOBAL_optyap_data.table_snapshots)
+#define GLOBAL_abolish_mode                     (GLOBAL_optyap_data.abolish_mode)
+#define GLOBAL_abolished_tries_lock             (GLOBAL_optyap_data.abolished_tries_lock)
+#define GLOBAL_abolished_tries                  (GLOBAL_optyap_data.abolished_tries)
+#define GLOBAL_abolished_tries_pending          (GLOBAL_optyap_data.abolished_tries_pending)
+#define GLOBAL_abolished_subtries_freed         (GLOBAL_optyap_data.abolished_subtries_freed)
+#define GLOBAL_ground_call_buffer               (GLOBAL_optyap_data.ground_call_buffer)
+#define GLOBAL_ground_call_buffer_size          (GLOBAL_optyap_data.ground_call_buffer_size)
+#define GLOBAL_ground_call_lookups              (GLOBAL_optyap_data.ground_call_lookups)
+#define GLOBAL_ground_call_hits                 (GLOBAL_optyap_data.ground_call_hits)
+#define GLOBAL_epoch_lock                       (GLOBAL_optyap_data.epoch_lock)
+#define GLOBAL_epoch                            (GLOBAL_optyap_data.epoch)
+#define GLOBAL_epoch_limbo(index)               (GLOBAL_optyap_data.epoch_limbo[(index) % 3])
+#define GLOBAL_epoch_backlog                    (GLOBAL_optyap_data.epoch_backlog)
+#define GLOBAL_epoch_reclaimed                  (GLOBAL_optyap_data.epoch_reclaimed)
 
 
 
@@ -419,6 +614,9 @@ struct local_optyap_data {
   /* local data related to memory management */
   struct local_pages pages;
 #endif /* TABLING && (YAPOR || THREADS) */
+#ifdef STRUCT_MAGAZINES
+  struct local_magazines magazines;
+#endif /* STRUCT_MAGAZINES */
 
 #ifdef YAPOR
   lockvar lock;
@@ -437,10 +635,46 @@ struct local_optyap_data {
 #endif /* YAPOR_THREADS */
   volatile int share_request;
   struct local_optyap_signals share_signals;
+  struct local_optyap_work_offers work_offers;
+  struct query_goal_solution_frame *query_answers;  /* answers not yet stored in the leftmost or-frame */
+#ifdef YAPOR_TRACING
+  struct local_optyap_trace trace;
+#endif /* YAPOR_TRACING */
+#ifdef YAPOR_GRANULARITY_CONTROL
+  struct {
+    struct pred_entry *predicate;  /* predicate of the shared alternative being timed */
+    UInt start;
+    UInt share_start;
+    UInt share_cost;               /* moving average of the time (ns) of a sharing operation */
+    UInt shares;
+    UInt share_time;
+    UInt samples;
+    UInt work_time;
+    UInt refused;                  /* sharing requests refused as too small */
+  } granularity;
+#endif /* YAPOR_GRANULARITY_CONTROL */
+#ifdef ANSWER_TRIE_RANGES
+  struct {
+    choiceptr node;                /* shared trie node of the range (NULL if none) */
+    yamop *next;                   /* next alternative of the range */
+    yamop *end;                    /* first alternative after the range */
+    UInt ranges;
+    UInt alternatives;
+  } trie_range;
+#endif /* ANSWER_TRIE_RANGES */
+  volatile unsigned int * volatile branch_chunks[MAX_BRANCH_DEPTH / BRANCH_CHUNK_SIZE];  /* allocated on demand */
   volatile struct {
     CELL start;
     CELL end;
   } global_copy, local_copy, trail_copy;
+#ifdef YAPOR_COPY
+  struct {
+    UInt shares;
+    UInt global_bytes;
+    UInt local_bytes;
+    UInt trail_bytes;
+  } copy_statistics;  /* updated by the worker that accepts the sharing request */
+#endif /* YAPOR_COPY */
 #endif /* YAPOR */
 
 #ifdef TABLING
@@ -450,6 +684,15 @@ struct local_optyap_data {
 #ifdef TABLING_INNER_CUTS
   choiceptr bottom_pruning_scope;
 #endif /* TABLING_INNER_CUTS */
+#ifdef LIMIT_TABLING
+  struct subgoal_frame *first_subgoal_frame;  /* least recently used */
+  struct subgoal_frame *last_subgoal_frame;   /* most recently used */
+  UInt lru_clock;
+  UInt lru_epoch;  /* value of the LRU clock at the last eviction pass */
+#endif /* LIMIT_TABLING */
+#ifdef EPOCH_RECLAMATION
+  volatile long epoch;  /* global epoch announced when the tables were last entered (NO_EPOCH if left) */
+#endif /* EPOCH_RECLAMATION */
 #ifdef YAPOR
 #ifdef YAPOR_THREADS
   Int top_choice_point_on_stack_offset;
@@ -486,6 +729,10 @@ struct local_optyap_data {
 #define LOCAL_pages_gt_node                (LOCAL_optyap_data.pages.global_trie_node_pages)
 #define LOCAL_pages_gt_hash                (LOCAL_optyap_data.pages.global_trie_hash_pages)
 #define LOCAL_next_free_ans_node           (LOCAL_optyap_data.pages.next_free_answer_trie_node)
+#define LOCAL_mag_pages_sg_fr              (LOCAL_optyap_data.magazines.subgoal_frame_magazine)
+#define LOCAL_mag_pages_dep_fr             (LOCAL_optyap_data.magazines.dependency_frame_magazine)
+#define LOCAL_mag_pages_sg_node            (LOCAL_optyap_data.magazines.subgoal_trie_node_magazine)
+#define LOCAL_mag_pages_ans_node           (LOCAL_optyap_data.magazines.answer_trie_node_magazine)
 #define LOCAL_lock                         (LOCAL_optyap_data.lock)
 #define LOCAL_load                         (LOCAL_optyap_data.load)
 #ifdef YAPOR_THREADS
@@ -510,15 +757,47 @@ struct local_optyap_data {
 #define LOCAL_p_fase_signal                (LOCAL_optyap_data.share_signals.P_fase)
 #define LOCAL_q_fase_signal                (LOCAL_optyap_data.share_signals.Q_fase)
 #define LOCAL_lock_signals                 (LOCAL_optyap_data.share_signals.lock)
+#define LOCAL_work_offers_top              (LOCAL_optyap_data.work_offers.top)
+#define LOCAL_work_offers_bottom           (LOCAL_optyap_data.work_offers.bottom)
+#define LOCAL_work_offer_or_fr(i)          (LOCAL_optyap_data.work_offers.offers[(i) & (STEAL_DEQUE_SIZE - 1)].or_frame)
+#define LOCAL_work_offer_depth(i)          (LOCAL_optyap_data.work_offers.offers[(i) & (STEAL_DEQUE_SIZE - 1)].depth)
+#define LOCAL_qg_answers                   (LOCAL_optyap_data.query_answers)
+#define LOCAL_trace_events                 (LOCAL_optyap_data.trace.events)
+#define LOCAL_trace_top                    (LOCAL_optyap_data.trace.top)
+#define LOCAL_trace_idle                   (LOCAL_optyap_data.trace.idle)
+#define LOCAL_trace_idle_refused           (LOCAL_optyap_data.trace.idle_refused)
+#define LOCAL_granularity_pred             (LOCAL_optyap_data.granularity.predicate)
+#define LOCAL_granularity_start            (LOCAL_optyap_data.granularity.start)
+#define LOCAL_granularity_share_start      (LOCAL_optyap_data.granularity.share_start)
+#define LOCAL_granularity_share_cost       (LOCAL_optyap_data.granularity.share_cost)
+#define LOCAL_granularity_shares           (LOCAL_optyap_data.granularity.shares)
+#define LOCAL_granularity_share_time       (LOCAL_optyap_data.granularity.share_time)
+#define LOCAL_granularity_samples          (LOCAL_optyap_data.granularity.samples)
+#define LOCAL_granularity_work_time        (LOCAL_optyap_data.granularity.work_time)
+#define LOCAL_granularity_refused          (LOCAL_optyap_data.granularity.refused)
+#define LOCAL_trie_range_node              (LOCAL_optyap_data.trie_range.node)
+#define LOCAL_trie_range_next              (LOCAL_optyap_data.trie_range.next)
+#define LOCAL_trie_range_end               (LOCAL_optyap_data.trie_range.end)
+#define LOCAL_trie_range_ranges            (LOCAL_optyap_data.trie_range.ranges)
+#define LOCAL_trie_range_alternatives      (LOCAL_optyap_data.trie_range.alternatives)
 #define LOCAL_start_global_copy            (LOCAL_optyap_data.global_copy.start)
 #define LOCAL_end_global_copy              (LOCAL_optyap_data.global_copy.end)
 #define LOCAL_start_local_copy             (LOCAL_optyap_data.local_copy.start)
 #define LOCAL_end_local_copy               (LOCAL_optyap_data.local_copy.end)
 #define LOCAL_start_trail_copy             (LOCAL_optyap_data.trail_copy.start)
 #define LOCAL_end_trail_copy               (LOCAL_optyap_data.trail_copy.end)
+#define LOCAL_copy_stats_shares            (LOCAL_optyap_data.copy_statistics.shares)
+#define LOCAL_copy_stats_global_bytes      (LOCAL_optyap_data.copy_statistics.global_bytes)
+#define LOCAL_copy_stats_local_bytes       (LOCAL_optyap_data.copy_statistics.local_bytes)
+#define LOCAL_copy_stats_trail_bytes       (LOCAL_optyap_data.copy_statistics.trail_bytes)
 #define LOCAL_top_sg_fr                    (LOCAL_optyap_data.top_subgoal_frame)
 #define LOCAL_top_dep_fr                   (LOCAL_optyap_data.top_dependency_frame)
 #define LOCAL_pruning_scope                (LOCAL_optyap_data.bottom_pruning_scope)
+#define LOCAL_first_sg_fr                  (LOCAL_optyap_data.first_subgoal_frame)
+#define LOCAL_last_sg_fr                   (LOCAL_optyap_data.last_subgoal_frame)
+#define LOCAL_lru_clock                    (LOCAL_optyap_data.lru_clock)
+#define LOCAL_lru_epoch                    (LOCAL_optyap_data.lru_epoch)
+#define LOCAL_epoch                        (LOCAL_optyap_data.epoch)
 #ifdef YAPOR_THREADS
 #define Get_LOCAL_top_cp_on_stack()        offset_to_cptr(LOCAL_optyap_data.top_choice_point_on_stack_offset)
 #define Set_LOCAL_top_cp_on_stack(cpt)     (LOCAL_optyap_data.top_choice_point_on_stack_offset =  cptr_to_offset(cpt))
@@ -548,6 +827,10 @@ struct local_optyap_data {
 #define REMOTE_pages_gt_node(wid)              (REMOTE(wid)->optyap_data_.pages.global_trie_node_pages)
 #define REMOTE_pages_gt_hash(wid)              (REMOTE(wid)->optyap_data_.pages.global_trie_hash_pages)
 #define REMOTE_next_free_ans_node(wid)         (REMOTE(wid)->optyap_data_.pages.next_free_answer_trie_node)
+#define REMOTE_mag_pages_sg_fr(wid)            (REMOTE(wid)->optyap_data_.magazines.subgoal_frame_magazine)
+#define REMOTE_mag_pages_dep_fr(wid)           (REMOTE(wid)->optyap_data_.magazines.dependency_frame_magazine)
+#define REMOTE_mag_pages_sg_node(wid)          (REMOTE(wid)->optyap_data_.magazines.subgoal_trie_node_magazine)
+#define REMOTE_mag_pages_ans_node(wid)         (REMOTE(wid)->optyap_data_.magazines.answer_trie_node_magazine)
 #define REMOTE_lock(wid)                       (REMOTE(wid)->optyap_data_.lock)
 #define REMOTE_load(wid)                       (REMOTE(wid)->optyap_data_.load)
 #ifdef YAPOR_THREADS
@@ -571,15 +854,49 @@ struct local_optyap_data {
 #define REMOTE_p_fase_signal(wid)              (REMOTE(wid)->optyap_data_.share_signals.P_fase)
 #define REMOTE_q_fase_signal(wid)              (REMOTE(wid)->optyap_data_.share_signals.Q_fase)
 #define REMOTE_lock_signals(wid)               (REMOTE(wid)->optyap_data_.share_signals.lock)
+#define REMOTE_branch_chunk(wid, chunk)        (REMOTE(wid)->optyap_data_.branch_chunks[chunk])
+#define REMOTE_branch(wid, depth)              (REMOTE_branch_chunk(wid, (depth) / BRANCH_CHUNK_SIZE)[(depth) % BRANCH_CHUNK_SIZE])
+#define REMOTE_work_offers_top(wid)            (REMOTE(wid)->optyap_data_.work_offers.top)
+#define REMOTE_work_offers_bottom(wid)         (REMOTE(wid)->optyap_data_.work_offers.bottom)
+#define REMOTE_work_offer_or_fr(wid, i)        (REMOTE(wid)->optyap_data_.work_offers.offers[(i) & (STEAL_DEQUE_SIZE - 1)].or_frame)
+#define REMOTE_work_offer_depth(wid, i)        (REMOTE(wid)->optyap_data_.work_offers.offers[(i) & (STEAL_DEQUE_SIZE - 1)].depth)
+#define REMOTE_qg_answers(wid)                 (REMOTE(wid)->optyap_data_.query_answers)
+#define REMOTE_trace_events(wid)               (REMOTE(wid)->optyap_data_.trace.events)
+#define REMOTE_trace_top(wid)                  (REMOTE(wid)->optyap_data_.trace.top)
+#define REMOTE_trace_idle(wid)                 (REMOTE(wid)->optyap_data_.trace.idle)
+#define REMOTE_trace_idle_refused(wid)         (REMOTE(wid)->optyap_data_.trace.idle_refused)
+#define REMOTE_granularity_pred(wid)           (REMOTE(wid)->optyap_data_.granularity.predicate)
+#define REMOTE_granularity_start(wid)          (REMOTE(wid)->optyap_data_.granularity.start)
+#define REMOTE_granularity_share_start(wid)    (REMOTE(wid)->optyap_data_.granularity.share_start)
+#define REMOTE_granularity_share_cost(wid)     (REMOTE(wid)->optyap_data_.granularity.share_cost)
+#define REMOTE_granularity_shares(wid)         (REMOTE(wid)->optyap_data_.granularity.shares)
+#define REMOTE_granularity_share_time(wid)     (REMOTE(wid)->optyap_data_.granularity.share_time)
+#define REMOTE_granularity_samples(wid)        (REMOTE(wid)->optyap_data_.granularity.samples)
+#define REMOTE_granularity_work_time(wid)      (REMOTE(wid)->optyap_data_.granularity.work_time)
+#define REMOTE_granularity_refused(wid)        (REMOTE(wid)->optyap_data_.granularity.refused)
+#define REMOTE_trie_range_node(wid)            (REMOTE(wid)->optyap_data_.trie_range.node)
+#define REMOTE_trie_range_next(wid)            (REMOTE(wid)->optyap_data_.trie_range.next)
+#define REMOTE_trie_range_end(wid)             (REMOTE(wid)->optyap_data_.trie_range.end)
+#define REMOTE_trie_range_ranges(wid)          (REMOTE(wid)->optyap_data_.trie_range.ranges)
+#define REMOTE_trie_range_alternatives(wid)    (REMOTE(wid)->optyap_data_.trie_range.alternatives)
 #define REMOTE_start_global_copy(wid)          (REMOTE(wid)->optyap_data_.global_copy.start)
 #define REMOTE_end_global_copy(wid)            (REMOTE(wid)->optyap_data_.global_copy.end)
 #define REMOTE_start_local_copy(wid)           (REMOTE(wid)->optyap_data_.local_copy.start)
 #define REMOTE_end_local_copy(wid)             (REMOTE(wid)->optyap_data_.local_copy.end)
 #define REMOTE_start_trail_copy(wid)           (REMOTE(wid)->optyap_data_.trail_copy.start)
 #define REMOTE_end_trail_copy(wid)             (REMOTE(wid)->optyap_data_.trail_copy.end)
+#define REMOTE_copy_stats_shares(wid)          (REMOTE(wid)->optyap_data_.copy_statistics.shares)
+#define REMOTE_copy_stats_global_bytes(wid)    (REMOTE(wid)->optyap_data_.copy_statistics.global_bytes)
+#define REMOTE_copy_stats_local_bytes(wid)     (REMOTE(wid)->optyap_data_.copy_statistics.local_bytes)
+#define REMOTE_copy_stats_trail_bytes(wid)     (REMOTE(wid)->optyap_data_.copy_statistics.trail_bytes)
 #define REMOTE_top_sg_fr(wid)                  (REMOTE(wid)->optyap_data_.top_subgoal_frame)
 #define REMOTE_top_dep_fr(wid)                 (REMOTE(wid)->optyap_data_.top_dependency_frame)
 #define REMOTE_pruning_scope(wid)              (REMOTE(wid)->optyap_data_.bottom_pruning_scope)
+#define REMOTE_first_sg_fr(wid)                (REMOTE(wid)->optyap_data_.first_subgoal_frame)
+#define REMOTE_last_sg_fr(wid)                 (REMOTE(wid)->optyap_data_.last_subgoal_frame)
+#define REMOTE_lru_clock(wid)                  (REMOTE(wid)->optyap_data_.lru_clock)
+#define REMOTE_lru_epoch(wid)                  (REMOTE(wid)->optyap_data_.lru_epoch)
+#define REMOTE_epoch(wid)                      (REMOTE(wid)->optyap_data_.epoch)
 #ifdef YAPOR_THREADS
 #define REMOTE_top_cp_on_stack(wid)            offset_to_cptr(REMOTE(wid)->optyap_data_.top_choice_point_on_stack_offset)
 #define Set_REMOTE_top_cp_on_stack(wid, bptr)  (REMOTE(wid)->optyap_data_.top_choice_point_on_stack_offset = cptr_to_offset(bptr))
@@ -43,27 +43,31 @@ static void share_private_nodes(int worker_q);
 **      Local macros      **
 ** ---------------------- */
 
-#define INCREMENTAL_COPY 1
-#if INCREMENTAL_COPY
-#define COMPUTE_SEGMENTS_TO_COPY_TO(Q)                                   \
-	if (REMOTE_top_cp(Q) == GLOBAL_root_cp)	                         \
-          REMOTE_start_global_copy(Q) = (CELL) (H0);                     \
-	else                                                             \
-          REMOTE_start_global_copy(Q) = (CELL) (REMOTE_top_cp(Q)->cp_h); \
-        REMOTE_end_global_copy(Q)   = (CELL) (B->cp_h);                  \
-        REMOTE_start_local_copy(Q)  = (CELL) (B);                        \
-        REMOTE_end_local_copy(Q)    = (CELL) (REMOTE_top_cp(Q));         \
-        REMOTE_start_trail_copy(Q)  = (CELL) (REMOTE_top_cp(Q)->cp_tr);  \
-        REMOTE_end_trail_copy(Q)    = (CELL) (TR)
-#else
-#define COMPUTE_SEGMENTS_TO_COPY_TO(Q)                                   \
-        REMOTE_start_global_copy(Q) = (CELL) (H0);                       \
-        REMOTE_end_global_copy(Q)   = (CELL) (HR);                       \
-        REMOTE_start_local_copy(Q)  = (CELL) (B);                        \
-        REMOTE_end_local_copy(Q)    = (CELL) (GLOBAL_root_cp);           \
-        REMOTE_start_trail_copy(Q)  = (CELL) (GLOBAL_root_cp->cp_tr);    \
-        REMOTE_end_trail_copy(Q)    = (CELL) (TR)
-#endif
+#define COMPUTE_SEGMENTS_TO_COPY_TO(Q)                                     \
+        if (GLOBAL_copy_mode == COPY_MODE_INCREMENTAL) {                   \
+          if (REMOTE_top_cp(Q) == GLOBAL_root_cp)                          \
+            REMOTE_start_global_copy(Q) = (CELL) (H0);                     \
+          else                                                             \
+            REMOTE_start_global_copy(Q) = (CELL) (REMOTE_top_cp(Q)->cp_h); \
+          REMOTE_end_global_copy(Q)   = (CELL) (B->cp_h);                  \
+          REMOTE_start_local_copy(Q)  = (CELL) (B);                        \
+          REMOTE_end_local_copy(Q)    = (CELL) (REMOTE_top_cp(Q));         \
+          REMOTE_start_trail_copy(Q)  = (CELL) (REMOTE_top_cp(Q)->cp_tr);  \
+          REMOTE_end_trail_copy(Q)    = (CELL) (TR);                       \
+        } else {                                                           \
+          REMOTE_start_global_copy(Q) = (CELL) (H0);                       \
+          REMOTE_end_global_copy(Q)   = (CELL) (HR);                       \
+          REMOTE_start_local_copy(Q)  = (CELL) (B);                        \
+          REMOTE_end_local_copy(Q)    = (CELL) (GLOBAL_root_cp);           \
+          REMOTE_start_trail_copy(Q)  = (CELL) (GLOBAL_root_cp->cp_tr);    \
+          REMOTE_end_trail_copy(Q)    = (CELL) (TR);                       \
+        }
+
+#define UPDATE_COPY_STATISTICS(Q)                                                                    \
+        LOCAL_copy_stats_shares++;                                                                   \
+        LOCAL_copy_stats_global_bytes += REMOTE_end_global_copy(Q) - REMOTE_start_global_copy(Q);    \
+        LOCAL_copy_stats_local_bytes  += REMOTE_end_local_copy(Q)  - REMOTE_start_local_copy(Q);     \
+        LOCAL_copy_stats_trail_bytes  += REMOTE_end_trail_copy(Q)  - REMOTE_start_trail_copy(Q)
 
 #define P_COPY_GLOBAL_TO(Q)                                                         \
         memcpy((void *) (worker_offset(Q) + REMOTE_start_global_copy(Q)),           \
@@ -138,27 +142,32 @@ int p_share_work(void) {
 
   if (! BITMAP_member(OrFr_members(REMOTE_top_or_fr(worker_q)), worker_id) ||
       B == REMOTE_top_cp(worker_q) ||
-      (LOCAL_load <= GLOBAL_delayed_release_load  && OrFr_nearest_livenode(LOCAL_top_or_fr) == NULL)) {
+      (LOCAL_load <= GLOBAL_delayed_release_load  && OrFr_nearest_livenode(LOCAL_top_or_fr) == NULL) ||
+      SCH_small_granularity()) {
     /* refuse sharing request */
-    REMOTE_reply_signal(LOCAL_share_request) = no_sharing;
+    SCH_set_signal(REMOTE_reply_signal(LOCAL_share_request), no_sharing);
     LOCAL_share_request = MAX_WORKERS;
     PUT_OUT_REQUESTABLE(worker_id);
     return 0;
   }
   /* sharing request accepted */
+  SCH_share_begin();
   COMPUTE_SEGMENTS_TO_COPY_TO(worker_q);
+  UPDATE_COPY_STATISTICS(worker_q);
   REMOTE_q_fase_signal(worker_q) = Q_idle;
   REMOTE_p_fase_signal(worker_q) = P_idle;
 #ifndef TABLING
   /* wait for incomplete installations */
-  while (LOCAL_reply_signal != worker_ready);
+  SCH_wait_while(LOCAL_reply_signal != worker_ready, LOCAL_reply_signal);
 #endif /* TABLING */
-  LOCAL_reply_signal = sharing;
-  REMOTE_reply_signal(worker_q) = sharing;
+  SCH_set_signal(LOCAL_reply_signal, sharing);
+  SCH_set_signal(REMOTE_reply_signal(worker_q), sharing);
+  SCH_trace_begin(TRACE_SHARE_PRIVATE_NODES);
   share_private_nodes(worker_q);
+  SCH_trace_end(TRACE_SHARE_PRIVATE_NODES);
   if(Get_LOCAL_prune_request())
     CUT_send_prune_request(worker_q, Get_LOCAL_prune_request()); 
-  REMOTE_reply_signal(worker_q) = nodes_shared;
+  SCH_set_signal(REMOTE_reply_signal(worker_q), nodes_shared);
   /* copy local stack ? */
   LOCK(REMOTE_lock_signals(worker_q));
   if (REMOTE_q_fase_signal(worker_q) < local) {
@@ -188,10 +197,12 @@ int p_share_work(void) {
   } else UNLOCK(REMOTE_lock_signals(worker_q));
 
 sync_with_q:
-  REMOTE_reply_signal(worker_q) = copy_done;
-  while (LOCAL_reply_signal == sharing);
-  while (REMOTE_reply_signal(worker_q) != worker_ready);
+  SCH_set_signal(REMOTE_reply_signal(worker_q), copy_done);
+  SCH_wait_while(LOCAL_reply_signal == sharing, LOCAL_reply_signal);
+  SCH_wait_while(REMOTE_reply_signal(worker_q) != worker_ready, REMOTE_reply_signal(worker_q));
+  SCH_share_end();
   LOCAL_share_request = MAX_WORKERS;
+  SCH_publish_work_offers();
   PUT_IN_REQUESTABLE(worker_id);
 
   return 1;
@@ -262,10 +273,10 @@ int q_share_work(int worker_p) {
   UNLOCK_WORKER(worker_p);
 
   /* wait for an answer */
-  while (LOCAL_reply_signal == worker_ready);
+  SCH_wait_while(LOCAL_reply_signal == worker_ready, LOCAL_reply_signal);
   if (LOCAL_reply_signal == no_sharing) {
     /* sharing request refused */
-    LOCAL_reply_signal = worker_ready;
+    SCH_set_signal(LOCAL_reply_signal, worker_ready);
     return FALSE;
   }
 
@@ -292,7 +303,7 @@ int q_share_work(int worker_p) {
   }
 
   /* copy local stack ? */
-  while (LOCAL_reply_signal < nodes_shared);
+  SCH_wait_while(LOCAL_reply_signal < nodes_shared, LOCAL_reply_signal);
   LOCK(LOCAL_lock_signals);
   if (LOCAL_p_fase_signal > local) {
     LOCAL_q_fase_signal = local;
@@ -302,64 +313,64 @@ int q_share_work(int worker_p) {
 
 sync_with_p:
 #ifdef TABLING
-  REMOTE_reply_signal(worker_p) = worker_ready;
+  SCH_set_signal(REMOTE_reply_signal(worker_p), worker_ready);
 #else
-  REMOTE_reply_signal(worker_p) = copy_done;
+  SCH_set_signal(REMOTE_reply_signal(worker_p), copy_done);
 #endif /* TABLING */
-  while (LOCAL_reply_signal != copy_done);
-
-#if INCREMENTAL_COPY
-  /* install fase --> TR and LOCAL_top_cp->cp_tr are equal */
-  aux_tr = ((choiceptr) LOCAL_start_local_copy)->cp_tr;
-  TR = ((choiceptr) LOCAL_end_local_copy)->cp_tr;
-  Yap_NEW_MAHASH((ma_h_inner_struct *)HR);
-  while (TR != aux_tr) {
-    aux_cell = TrailTerm(--aux_tr);
-    if (IsVarTerm(aux_cell)) {
-      if (aux_cell < LOCAL_start_global_copy || EQUAL_OR_YOUNGER_CP((choiceptr)LOCAL_end_local_copy, (choiceptr)aux_cell)) {
-	YAPOR_ERROR_CHECKING(q_share_work, (CELL *)aux_cell < H0);
-	YAPOR_ERROR_CHECKING(q_share_work, (ADDR)aux_cell > LOCAL_LocalBase);
+  SCH_wait_while(LOCAL_reply_signal != copy_done, LOCAL_reply_signal);
+
+  if (GLOBAL_copy_mode == COPY_MODE_INCREMENTAL) {
+    /* install fase --> TR and LOCAL_top_cp->cp_tr are equal */
+    aux_tr = ((choiceptr) LOCAL_start_local_copy)->cp_tr;
+    TR = ((choiceptr) LOCAL_end_local_copy)->cp_tr;
+    Yap_NEW_MAHASH((ma_h_inner_struct *)HR);
+    while (TR != aux_tr) {
+      aux_cell = TrailTerm(--aux_tr);
+      if (IsVarTerm(aux_cell)) {
+        if (aux_cell < LOCAL_start_global_copy || EQUAL_OR_YOUNGER_CP((choiceptr)LOCAL_end_local_copy, (choiceptr)aux_cell)) {
+          YAPOR_ERROR_CHECKING(q_share_work, (CELL *)aux_cell < H0);
+          YAPOR_ERROR_CHECKING(q_share_work, (ADDR)aux_cell > LOCAL_LocalBase);
 #ifdef TABLING
-        *((CELL *) aux_cell) = TrailVal(aux_tr);
+          *((CELL *) aux_cell) = TrailVal(aux_tr);
 #else
-        *((CELL *) aux_cell) = *((CELL *) (worker_offset(worker_p) + aux_cell));
+          *((CELL *) aux_cell) = *((CELL *) (worker_offset(worker_p) + aux_cell));
 #endif /* TABLING */
-      }
+        }
 #ifdef TABLING 
-    } else if (IsPairTerm(aux_cell)) {
-      aux_cell = (CELL) RepPair(aux_cell);
-      if (IN_BETWEEN(LOCAL_TrailBase, aux_cell, LOCAL_TrailTop)) {
-        /* avoid frozen segments */
-        aux_tr = (tr_fr_ptr) aux_cell;
-      }
+      } else if (IsPairTerm(aux_cell)) {
+        aux_cell = (CELL) RepPair(aux_cell);
+        if (IN_BETWEEN(LOCAL_TrailBase, aux_cell, LOCAL_TrailTop)) {
+          /* avoid frozen segments */
+          aux_tr = (tr_fr_ptr) aux_cell;
+        }
 #endif /* TABLING */
 #ifdef MULTI_ASSIGNMENT_VARIABLES
-    } else if (IsApplTerm(aux_cell)) {
-      CELL *cell_ptr = RepAppl(aux_cell);
-      if (((CELL *)aux_cell < LOCAL_top_cp->cp_h || 
-          EQUAL_OR_YOUNGER_CP(LOCAL_top_cp, (choiceptr)aux_cell)) &&
-	  !Yap_lookup_ma_var(cell_ptr)) {
-	/* first time we found the variable, let's put the new value */
+      } else if (IsApplTerm(aux_cell)) {
+        CELL *cell_ptr = RepAppl(aux_cell);
+        if (((CELL *)aux_cell < LOCAL_top_cp->cp_h || 
+            EQUAL_OR_YOUNGER_CP(LOCAL_top_cp, (choiceptr)aux_cell)) &&
+            !Yap_lookup_ma_var(cell_ptr)) {
+          /* first time we found the variable, let's put the new value */
 #ifdef TABLING
-        *cell_ptr = TrailVal(aux_tr);
+          *cell_ptr = TrailVal(aux_tr);
 #else
-        *cell_ptr = *((CELL *) (worker_offset(worker_p) + (CELL)cell_ptr));
+          *cell_ptr = *((CELL *) (worker_offset(worker_p) + (CELL)cell_ptr));
 #endif /* TABLING */
-      }
-      /* skip the old value */
-      aux_tr--;
+        }
+        /* skip the old value */
+        aux_tr--;
 #endif /* MULTI_ASSIGNMENT_VARIABLES */
+      }
     }
   }
-#endif /* incremental */
 
   /* update registers and return */
   PUT_OUT_ROOT_NODE(worker_id);
 #ifndef TABLING
-  REMOTE_reply_signal(worker_p) = worker_ready;
+  SCH_set_signal(REMOTE_reply_signal(worker_p), worker_ready);
 #endif /* TABLING */
   TR = (tr_fr_ptr) LOCAL_end_trail_copy;
-  LOCAL_reply_signal = worker_ready;
+  SCH_set_signal(LOCAL_reply_signal, worker_ready);
   PUT_IN_REQUESTABLE(worker_id);
 #ifdef TABLING
   adjust_freeze_registers();
@@ -405,6 +416,7 @@ void share_private_nodes(int worker_q) {
 #endif /* DEBUG_OPTYAP */
 
     /* update old shared nodes */
+    SCH_check_branch_depth(worker_q, OrFr_depth(LOCAL_top_or_fr));
     or_frame = LOCAL_top_or_fr;
     while (or_frame != REMOTE_top_or_fr(worker_q)) {
       LOCK_OR_FRAME(or_frame);
@@ -503,6 +515,9 @@ void share_private_nodes(int worker_q) {
       OrFr_pend_prune_cp(or_frame) = NULL;
       OrFr_nearest_leftnode(or_frame) = LOCAL_top_or_fr;
       OrFr_qg_solutions(or_frame) = NULL;
+#ifdef YAPOR_GRANULARITY_CONTROL
+      OrFr_pred(or_frame) = Yap_PredForChoicePt(sharing_node);
+#endif /* YAPOR_GRANULARITY_CONTROL */
 #ifdef TABLING_INNER_CUTS
       OrFr_tg_solutions(or_frame) = NULL;
 #endif /* TABLING_INNER_CUTS */
@@ -568,8 +583,8 @@ void share_private_nodes(int worker_q) {
 #endif /* TABLING */
 
     /* update depth */
-    if (depth >= MAX_BRANCH_DEPTH)
-      Yap_Error(INTERNAL_ERROR, TermNil, "maximum depth exceded (share_private_nodes)");
+    SCH_check_branch_depth(worker_id, depth);
+    SCH_check_branch_depth(worker_q, depth);
     or_frame = B->cp_or_fr;
 #ifdef TABLING
     previous_or_frame = LOCAL_top_cp_on_stack->cp_or_fr;
@@ -631,7 +646,12 @@ void share_private_nodes(int worker_q) {
     Set_REMOTE_top_cp(worker_q,B);
     Set_LOCAL_top_cp(B);
     REMOTE_top_or_fr(worker_q) = LOCAL_top_or_fr = Get_LOCAL_top_cp()->cp_or_fr;
-    UNLOCK_OR_FRAME(old_top);  
+    UNLOCK_OR_FRAME(old_top);
+#ifdef ANSWER_TRIE_RANGES
+    /* hand out the rest of the range of trie siblings */
+    SCH_release_trie_range();
+    REMOTE_trie_range_node(worker_q) = NULL;
+#endif /* ANSWER_TRIE_RANGES */
 
 #ifdef TABLING
     /* update subgoal frames in the maintained private branches */
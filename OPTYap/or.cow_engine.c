@@ -86,27 +86,33 @@ int p_share_work(void) {
 
   if (! BITMAP_member(OrFr_members(REMOTE_top_or_fr(worker_q)), worker_id) ||
       B == REMOTE_top_cp(worker_q) ||
-      (LOCAL_load <= GLOBAL_delayed_release_load && OrFr_nearest_livenode(LOCAL_top_or_fr) == NULL)) {
+      (LOCAL_load <= GLOBAL_delayed_release_load && OrFr_nearest_livenode(LOCAL_top_or_fr) == NULL) ||
+      SCH_small_granularity()) {
     /* refuse sharing request */
-    REMOTE_reply_signal(LOCAL_share_request) = no_sharing;
+    SCH_set_signal(REMOTE_reply_signal(LOCAL_share_request), no_sharing);
     LOCAL_share_request = MAX_WORKERS;
     PUT_OUT_REQUESTABLE(worker_id);
     return TRUE;
   }
   /* sharing request accepted */
-  REMOTE_reply_signal(worker_q) = sharing;
+  SCH_share_begin();
+  SCH_set_signal(REMOTE_reply_signal(worker_q), sharing);
+  SCH_trace_begin(TRACE_SHARE_PRIVATE_NODES);
   share_private_nodes(worker_q);
+  SCH_trace_end(TRACE_SHARE_PRIVATE_NODES);
   if ((son = fork()) == 0) {
     worker_id = worker_q;  /* child becomes requesting worker */
     LOCAL = REMOTE(worker_id);
-    LOCAL_reply_signal = worker_ready;
+    SCH_set_signal(LOCAL_reply_signal, worker_ready);
     PUT_IN_REQUESTABLE(worker_id);
     PUT_BUSY(worker_id);
 
     return FALSE;
   } else {
     GLOBAL_worker_pid(worker_q) = son;
+    SCH_share_end();
     LOCAL_share_request = MAX_WORKERS;
+    SCH_publish_work_offers();
     PUT_IN_REQUESTABLE(worker_id);
 
     return TRUE;
@@ -139,10 +145,10 @@ int q_share_work(int worker_p) {
   UNLOCK_WORKER(worker_p);
 
   /* wait for an answer */
-  while (LOCAL_reply_signal == worker_ready);
+  SCH_wait_while(LOCAL_reply_signal == worker_ready, LOCAL_reply_signal);
   if (LOCAL_reply_signal == no_sharing) {
     /* sharing request refused */
-    LOCAL_reply_signal = worker_ready;
+    SCH_set_signal(LOCAL_reply_signal, worker_ready);
     return FALSE;
   }
   /* exit this process */
@@ -175,6 +181,9 @@ void share_private_nodes(int worker_q) {
     OrFr_pend_prune_cp(or_frame) = NULL;
     OrFr_nearest_leftnode(or_frame) = LOCAL_top_or_fr;
     OrFr_qg_solutions(or_frame) = NULL;
+#ifdef YAPOR_GRANULARITY_CONTROL
+    OrFr_pred(or_frame) = Yap_PredForChoicePt(AuxB);
+#endif /* YAPOR_GRANULARITY_CONTROL */
     BITMAP_clear(OrFr_members(or_frame));
     BITMAP_insert(OrFr_members(or_frame), worker_id);
     BITMAP_insert(OrFr_members(or_frame), worker_q);
@@ -196,8 +205,8 @@ void share_private_nodes(int worker_q) {
     OrFr_nearest_livenode(previous_or_frame) = OrFr_next(previous_or_frame) = or_frame;
   }
   /* update depth */
-  if (depth >= MAX_BRANCH_DEPTH)
-    Yap_Error(INTERNAL_ERROR, TermNil, "maximum depth exceded (share_private_nodes)");
+  SCH_check_branch_depth(worker_id, depth);
+  SCH_check_branch_depth(worker_q, depth);
   or_frame = B->cp_or_fr;
   while (or_frame != LOCAL_top_or_fr) {
     unsigned int branch;
@@ -40,6 +40,7 @@ void prune_shared_branch(choiceptr prune_cp, int* pend_ltt) {
 #ifdef TABLING_INNER_CUTS
   tg_sol_fr_ptr tg_solutions, aux_tg_solutions;
 #endif /* TABLING_INNER_CUTS */
+  CUT_flush_buffered_answers();
   leftmost_or_fr = CUT_leftmost_or_frame();
   if (Get_LOCAL_prune_request())
     return;
@@ -30,6 +30,16 @@
       free_root_choice_point();
       /* wait until no one is executing */
       while (! BITMAP_empty(GLOBAL_bm_root_cp_workers));
+#ifdef TABLING
+      if (GLOBAL_suspension_space_exceeded) {
+        /* the answers of the parallel goal are dropped */
+        CUT_free_solution_frames(OrFr_qg_solutions(LOCAL_top_or_fr));
+        OrFr_qg_solutions(LOCAL_top_or_fr) = NULL;
+        saveregs();
+        Yap_Error(RESOURCE_ERROR_MEMORY, TermNil, "suspension space threshold exceeded (%ld bytes in suspended branches)", GLOBAL_suspension_space_exceeded);
+        setregs();
+      }
+#endif /* TABLING */
       goto fail;
     } else {
       PREG = GETWORK_FIRST_TIME;
@@ -42,6 +52,8 @@
 
 
   PBOp(getwork,Otapl)
+    /* the buffered answers belong to the branch being left */
+    CUT_flush_buffered_answers();
 #ifdef TABLING
 
     if (DepFr_leader_cp(LOCAL_top_dep_fr) == Get_LOCAL_top_cp()) {
@@ -60,6 +72,7 @@
           /*                     there are unexploited alternatives                     **
 	  ** we should exploit all the available alternatives before execute completion */
           PREG = OrFr_alternative(LOCAL_top_or_fr);
+          SCH_sample_alternative(LOCAL_top_or_fr);
           PREFETCH_OP(PREG);
           GONext();
         }
@@ -80,10 +93,21 @@
       goto completion;
     }
 #endif /* TABLING */
+#ifdef ANSWER_TRIE_RANGES
+    if (SCH_trie_range_active()) {
+      /* the worker has a range of siblings of the current trie node */
+      SCH_check_prune_request();
+      PREG = LOCAL_trie_range_next;
+      SCH_sample_alternative(LOCAL_top_or_fr);
+      PREFETCH_OP(PREG);
+      GONext();
+    }
+#endif /* ANSWER_TRIE_RANGES */
     LOCK_OR_FRAME(LOCAL_top_or_fr);
 
     if (OrFr_alternative(LOCAL_top_or_fr)) {
       PREG = OrFr_alternative(LOCAL_top_or_fr);
+      SCH_sample_alternative(LOCAL_top_or_fr);
       PREFETCH_OP(PREG);
       GONext();
     } else {
@@ -97,10 +121,12 @@
   /* The idea is to check whether we are the last worker in the node.
      If we are, we can go ahead, otherwise we should call the scheduler. */
   PBOp(getwork_seq,Otapl)
+    CUT_flush_buffered_answers();
     LOCK_OR_FRAME(LOCAL_top_or_fr);
     if (OrFr_alternative(LOCAL_top_or_fr) &&
         BITMAP_alone(OrFr_members(LOCAL_top_or_fr), worker_id)) {
       PREG = OrFr_alternative(LOCAL_top_or_fr);
+      SCH_sample_alternative(LOCAL_top_or_fr);
       PREFETCH_OP(PREG);
       GONext();
     } else {
@@ -20,6 +20,15 @@
 
 /* get a def for NULL */
 #include <stdlib.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#else
+#include <sched.h>
+#include <sys/time.h>
+#endif /* __linux__ */
 
 static inline void PUT_IN_ROOT_NODE(int);
 static inline void PUT_OUT_ROOT_NODE(int);
@@ -29,12 +38,41 @@ static inline void PUT_IN_PRUNING(int);
 static inline void PUT_OUT_PRUNING(int);
 #endif /* TABLING_INNER_CUTS */
 
+static inline void SCH_sleep_on_word(volatile int *, int, long);
+static inline void SCH_wake_up_word(volatile int *);
+static inline void SCH_sleep_on_signal(volatile int *, int);
+static inline void SCH_wait_for_work(int);
+static inline void SCH_signal_work(void);
+#if defined(YAPOR_TRACING) || defined(YAPOR_GRANULARITY_CONTROL)
+static inline UInt SCH_clock(void);
+#endif /* YAPOR_TRACING || YAPOR_GRANULARITY_CONTROL */
+#ifdef YAPOR_TRACING
+static inline void SCH_trace_event(int, int, UInt, int);
+#endif /* YAPOR_TRACING */
+#ifdef YAPOR_GRANULARITY_CONTROL
+static inline void SCH_granularity_sample(struct pred_entry *);
+static inline void SCH_granularity_shared(UInt);
+static inline int SCH_granularity_worth_sharing(void);
+#endif /* YAPOR_GRANULARITY_CONTROL */
+static inline int SCH_q_share_work(int);
+
+static inline void SCH_publish_work_offers(void);
+static inline void SCH_withdraw_work_offers(int);
+static inline int SCH_read_work_offer(int, Int *, or_fr_ptr *, int *);
+static inline void SCH_consume_work_offer(int, Int);
+
 static inline void PUT_IN_REQUESTABLE(int);
 static inline void PUT_OUT_REQUESTABLE(int);
 static inline void SCH_update_local_or_tops(void);
+static inline void SCH_check_branch_depth(int, int);
 static inline void SCH_refuse_share_request_if_any(void);
 static inline void SCH_set_load(choiceptr);
 static inline void SCH_new_alternative(yamop *,yamop *);
+#ifdef ANSWER_TRIE_RANGES
+static inline void SCH_new_trie_alternative(yamop *,yamop *);
+static inline void SCH_trie_range_alternative(yamop *,yamop *);
+static inline void SCH_release_trie_range(void);
+#endif /* ANSWER_TRIE_RANGES */
 
 static inline void CUT_send_prune_request(int, choiceptr);
 static inline void CUT_reset_prune_request(void);
@@ -45,7 +83,8 @@ static inline or_fr_ptr CUT_leftmost_or_frame(void);
 static inline or_fr_ptr CUT_leftmost_until(or_fr_ptr, int);
 #endif /* TABLING_INNER_CUTS */
 
-static inline void CUT_store_answer(or_fr_ptr, qg_ans_fr_ptr);
+static inline void CUT_buffer_answer(Term);
+static inline void CUT_flush_buffered_answers(void);
 static inline void CUT_store_answers(or_fr_ptr, qg_sol_fr_ptr);
 static inline void CUT_join_answers_in_an_unique_frame(qg_sol_fr_ptr);
 static inline void CUT_free_solution_frame(qg_sol_fr_ptr);
@@ -91,7 +130,7 @@ static inline qg_sol_fr_ptr CUT_prune_solution_frames(qg_sol_fr_ptr, int);
 #define PUT_YAMOP_SEQ(INST)        (INST)->y_u.Otapl.or_arg |= YAMOP_SEQ_FLAG
 #define PUT_YAMOP_CUT(INST)        (INST)->y_u.Otapl.or_arg |= YAMOP_CUT_FLAG
 
-#define BRANCH(WORKER, DEPTH)      GLOBAL_branch(WORKER, DEPTH)
+#define BRANCH(WORKER, DEPTH)      REMOTE_branch(WORKER, DEPTH)
 #define BRANCH_LTT(WORKER, DEPTH)  (BRANCH(WORKER, DEPTH) & YAMOP_LTT_BITS)
 #define BRANCH_CUT(WORKER, DEPTH)  (BRANCH(WORKER, DEPTH) & YAMOP_CUT_FLAG)
 
@@ -107,6 +146,65 @@ static inline qg_sol_fr_ptr CUT_prune_solution_frames(qg_sol_fr_ptr, int);
 
 
 
+/* -------------------------- **
+**      Wait Mode Macros      **
+** -------------------------- */
+
+#define WAIT_MODE_SPIN   0
+#define WAIT_MODE_BLOCK  1
+
+/* with WAIT_MODE_BLOCK, a worker waiting for a signal spins BLOCKING_WAIT_SPINS **
+** times and then sleeps until the signal is updated with SCH_set_signal(). The  **
+** sleeping workers are counted in GLOBAL_signal_waiters, so that the stores of  **
+** SCH_set_signal() only make the wake up system call when someone is sleeping   */
+#define SCH_wait_while(CONDITION, SIGNAL)                                                  \
+        { int spins = 0;                                                                   \
+          while (1) {                                                                      \
+            int signal_value = (int) (SIGNAL);                                             \
+            if (! (CONDITION))                                                             \
+              break;                                                                       \
+            if (GLOBAL_wait_mode == WAIT_MODE_BLOCK && ++spins > BLOCKING_WAIT_SPINS)      \
+              SCH_sleep_on_signal((volatile int *) &(SIGNAL), signal_value);               \
+          }                                                                                \
+        }
+
+/* the full barrier orders the store of the signal before the read of the waiters **
+** count, thus a worker incrementing the count after the read finds the new value **
+** when going to sleep and does not sleep                                         */
+#define SCH_set_signal(SIGNAL, VALUE)                          \
+        do {                                                   \
+          (SIGNAL) = (VALUE);                                  \
+          if (GLOBAL_wait_mode == WAIT_MODE_BLOCK) {           \
+            __sync_synchronize();                              \
+            if (GLOBAL_signal_waiters > 0)                     \
+              SCH_wake_up_word((volatile int *) &(SIGNAL));    \
+          }                                                    \
+        } while (0)
+
+
+
+/* ------------------------------- **
+**      Scheduler Mode Macros      **
+** ------------------------------- */
+
+#define SCHEDULER_MODE_BITMAP  0
+#define SCHEDULER_MODE_STEAL   1
+
+
+
+/* -------------------------- **
+**      Copy Mode Macros      **
+** -------------------------- */
+
+/* with COPY_MODE_INCREMENTAL, the sharing worker copies only the stack     **
+** segments between its current node and the top node of the requesting     **
+** worker (the youngest node common to both branches). With COPY_MODE_FULL, **
+** it copies the stacks from the root node, as in the original YapOr model  */
+#define COPY_MODE_INCREMENTAL  0
+#define COPY_MODE_FULL         1
+
+
+
 /* ----------------------- **
 **      Engine Macros      **
 ** ----------------------- */
@@ -127,8 +225,54 @@ static inline qg_sol_fr_ptr CUT_prune_solution_frames(qg_sol_fr_ptr, int);
 
 #define SCH_top_shared_cp(CP)  (Get_LOCAL_top_cp() == CP)
 
+#ifdef ANSWER_TRIE_RANGES
+#define SCH_trie_range_active()  (LOCAL_trie_range_node == Get_LOCAL_top_cp())
+/* before the top node is moved up to NEW_TOP_CP: the range is left with its node */
+#define SCH_leave_trie_range(NEW_TOP_CP)                                         \
+        if (LOCAL_trie_range_node && YOUNGER_CP(LOCAL_trie_range_node, NEW_TOP_CP)) { \
+          SCH_release_trie_range();                                               \
+          LOCAL_trie_range_node = NULL;                                           \
+        }
+#else
+#define SCH_leave_trie_range(NEW_TOP_CP)
+#endif /* ANSWER_TRIE_RANGES */
+
 #define SCH_any_share_request  (LOCAL_share_request != MAX_WORKERS)
 
+#ifdef YAPOR_TRACING
+#define SCH_trace_begin(EVENT)  SCH_trace_event(EVENT, 'B', SCH_clock(), 0)
+#define SCH_trace_end(EVENT)    SCH_trace_event(EVENT, 'E', SCH_clock(), 0)
+#define SCH_trace_idle_begin()                                 \
+        { LOCAL_trace_idle = TRUE;                             \
+          LOCAL_trace_idle_refused = 0;                        \
+          SCH_trace_event(TRACE_IDLE, 'B', SCH_clock(), 0);    \
+        }
+#define SCH_trace_idle_end()                                                     \
+        if (LOCAL_trace_idle) {                                                  \
+          LOCAL_trace_idle = FALSE;                                              \
+          SCH_trace_event(TRACE_IDLE, 'E', SCH_clock(), LOCAL_trace_idle_refused); \
+        }
+#else
+#define SCH_trace_begin(EVENT)
+#define SCH_trace_end(EVENT)
+#define SCH_trace_idle_begin()
+#define SCH_trace_idle_end()
+#endif /* YAPOR_TRACING */
+
+#ifdef YAPOR_GRANULARITY_CONTROL
+#define SCH_sample_alternative(OR_FR)   SCH_granularity_sample(OrFr_pred(OR_FR))
+#define SCH_stop_sampling()             SCH_granularity_sample(NULL)
+#define SCH_share_begin()               LOCAL_granularity_share_start = SCH_clock()
+#define SCH_share_end()                 SCH_granularity_shared(SCH_clock() - LOCAL_granularity_share_start)
+#define SCH_small_granularity()         (! SCH_granularity_worth_sharing())
+#else
+#define SCH_sample_alternative(OR_FR)
+#define SCH_stop_sampling()
+#define SCH_share_begin()
+#define SCH_share_end()
+#define SCH_small_granularity()         FALSE
+#endif /* YAPOR_GRANULARITY_CONTROL */
+
 #define SCHEDULER_GET_WORK()          \
         if (get_work())               \
           goto shared_fail;           \
@@ -141,18 +285,26 @@ static inline qg_sol_fr_ptr CUT_prune_solution_frames(qg_sol_fr_ptr, int);
         }
 
 #if defined(YAPOR_COPY) || defined(YAPOR_SBA) || defined(YAPOR_THREADS)
-#define SCH_check_share_request()     \
-        if (SCH_any_share_request) {  \
-	  ASP = YENV;                 \
-	  saveregs();                 \
-          p_share_work();             \
-	  setregs();                  \
+#define SCH_check_share_request()              \
+        if (SCH_any_share_request) {           \
+	  ASP = YENV;                          \
+	  saveregs();                          \
+          CUT_flush_buffered_answers();        \
+          SCH_trace_begin(TRACE_P_SHARE_WORK); \
+          p_share_work();                      \
+          SCH_trace_end(TRACE_P_SHARE_WORK);   \
+	  setregs();                           \
         }
 #else /* YAPOR_COW */
-#define SCH_check_share_request()     \
-        if (SCH_any_share_request) {  \
-          if (! p_share_work())       \
-            goto shared_fail;         \
+#define SCH_check_share_request()              \
+        if (SCH_any_share_request) {           \
+          int shared;                          \
+          CUT_flush_buffered_answers();        \
+          SCH_trace_begin(TRACE_P_SHARE_WORK); \
+          shared = p_share_work();             \
+          SCH_trace_end(TRACE_P_SHARE_WORK);   \
+          if (! shared)                        \
+            goto shared_fail;                  \
         }
 #endif /* YAPOR_COPY || YAPOR_SBA || YAPOR_COW || YAPOR_THREADS */
 
@@ -213,6 +365,303 @@ static inline qg_sol_fr_ptr CUT_prune_solution_frames(qg_sol_fr_ptr, int);
 
 
 
+/* -------------------- **
+**      Wait Stuff      **
+** -------------------- */
+
+/* the futexes are not private since the YapOr workers may be processes sharing memory */
+static inline
+void SCH_sleep_on_word(volatile int *word, int value, long usecs) {
+#ifdef __linux__
+  struct timespec timeout;
+  timeout.tv_sec = usecs / 1000000;
+  timeout.tv_nsec = (usecs % 1000000) * 1000;
+  syscall(SYS_futex, word, FUTEX_WAIT, value, &timeout, NULL, 0);
+#else
+  sched_yield();
+#endif /* __linux__ */
+  return;
+}
+
+
+static inline
+void SCH_wake_up_word(volatile int *word) {
+#ifdef __linux__
+  syscall(SYS_futex, word, FUTEX_WAKE, MAX_WORKERS, NULL, NULL, 0);
+#endif /* __linux__ */
+  return;
+}
+
+
+#if defined(YAPOR_TRACING) || defined(YAPOR_GRANULARITY_CONTROL)
+/* monotonic time in nanoseconds */
+static inline
+UInt SCH_clock(void) {
+#ifdef __linux__
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (UInt) now.tv_sec * 1000000000 + now.tv_nsec;
+#else
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (UInt) now.tv_sec * 1000000000 + now.tv_usec * 1000;
+#endif /* __linux__ */
+}
+#endif /* YAPOR_TRACING || YAPOR_GRANULARITY_CONTROL */
+
+
+#ifdef YAPOR_TRACING
+/* appends an event to the ring of the current worker, the oldest **
+** events are overwritten when the ring is full                   */
+static inline
+void SCH_trace_event(int event, int phase, UInt time, int refused) {
+  CACHE_REGS
+  struct optyap_trace_event *trace_event;
+  UInt top = LOCAL_trace_top;
+
+  trace_event = LOCAL_trace_events + (top & (TRACE_BUFFER_SIZE - 1));
+  trace_event->time = time;
+  trace_event->refused = refused;
+  trace_event->event = event;
+  trace_event->phase = phase;
+  LOCAL_trace_top = top + 1;
+  return;
+}
+#endif /* YAPOR_TRACING */
+
+
+#ifdef YAPOR_GRANULARITY_CONTROL
+/* ends the timing of the shared alternative being executed, if any, and **
+** starts timing a new alternative of predicate pe (NULL if none). The   **
+** counters of the predicates are updated without locks, thus a sample   **
+** can be lost when two workers update the same predicate at once        */
+static inline
+void SCH_granularity_sample(struct pred_entry *pe) {
+  CACHE_REGS
+  struct pred_entry *previous = LOCAL_granularity_pred;
+  UInt now;
+
+  if (previous == NULL && pe == NULL)
+    return;
+  now = SCH_clock();
+  if (previous) {
+    UInt work = now - LOCAL_granularity_start;
+    LOCAL_granularity_samples++;
+    LOCAL_granularity_work_time += work;
+    if (previous->OrSamplesOfPred == 0)
+      previous->OrWorkOfPred = work;
+    else  /* moving average, the last 8 samples weight 2/3 */
+      previous->OrWorkOfPred = (7 * previous->OrWorkOfPred + work) / 8;
+    previous->OrSamplesOfPred++;
+  }
+  LOCAL_granularity_pred = pe;
+  LOCAL_granularity_start = now;
+  return;
+}
+
+
+/* called by the worker that accepted a sharing request with the time it took */
+static inline
+void SCH_granularity_shared(UInt time) {
+  CACHE_REGS
+  LOCAL_granularity_shares++;
+  LOCAL_granularity_share_time += time;
+  if (LOCAL_granularity_share_cost == 0)
+    LOCAL_granularity_share_cost = time;
+  else
+    LOCAL_granularity_share_cost = (7 * LOCAL_granularity_share_cost + time) / 8;
+  return;
+}
+
+
+/* estimates the work left in the private nodes of the current worker from **
+** the untried alternatives of each node and the average work of the        **
+** alternatives of its predicate. Sharing is worth it if that work is at     **
+** least GLOBAL_granularity_ratio times the average cost of a sharing        **
+** operation or if it cannot be estimated (unknown predicates, predicates    **
+** with few samples or more than GRANULARITY_MAX_NODES private nodes)        */
+static inline
+int SCH_granularity_worth_sharing(void) {
+  CACHE_REGS
+  choiceptr cp = B;
+  UInt work = 0, min_work;
+  int nodes = 0;
+
+  min_work = GLOBAL_granularity_ratio * LOCAL_granularity_share_cost;
+  if (min_work == 0)
+    return TRUE;
+#ifdef TABLING
+  while (YOUNGER_CP(cp, Get_LOCAL_top_cp_on_stack())) {
+#else
+  while (cp != Get_LOCAL_top_cp()) {
+#endif /* TABLING */
+    if (cp->cp_ap && ! YAMOP_SEQ(cp->cp_ap)) {
+      struct pred_entry *pe = Yap_PredForChoicePt(cp);
+      UInt alternatives = YAMOP_LTT(cp->cp_ap);
+      if (pe == NULL || pe->OrSamplesOfPred < GRANULARITY_MIN_SAMPLES || ++nodes > GRANULARITY_MAX_NODES)
+        return TRUE;
+      work += (alternatives ? alternatives : 1) * pe->OrWorkOfPred;
+      if (work >= min_work)
+        return TRUE;
+    }
+    cp = cp->cp_b;
+  }
+  LOCAL_granularity_refused++;
+  return FALSE;
+}
+#endif /* YAPOR_GRANULARITY_CONTROL */
+
+
+/* requests work from worker p (q_share_work() of the engine being used). The **
+** requests refused while idle are only counted in the end event of the idle  **
+** period, otherwise the idle workers polling the busy ones flood the rings   */
+static inline
+int SCH_q_share_work(int worker_p) {
+  int shared;
+#ifdef YAPOR_TRACING
+  CACHE_REGS
+  UInt begin = SCH_clock();
+#endif /* YAPOR_TRACING */
+
+  shared = q_share_work(worker_p);
+#ifdef YAPOR_TRACING
+  if (LOCAL_trace_idle && ! shared)
+    LOCAL_trace_idle_refused++;
+  else {
+    SCH_trace_event(TRACE_Q_SHARE_WORK, 'B', begin, 0);
+    SCH_trace_end(TRACE_Q_SHARE_WORK);
+  }
+#endif /* YAPOR_TRACING */
+  return shared;
+}
+
+
+/* called by SCH_wait_while(), value is the value of the signal before checking the condition */
+static inline
+void SCH_sleep_on_signal(volatile int *signal, int value) {
+  __sync_fetch_and_add(&GLOBAL_signal_waiters, 1);
+  SCH_sleep_on_word(signal, value, BLOCKING_WAIT_USECS);
+  __sync_fetch_and_sub(&GLOBAL_signal_waiters, 1);
+  return;
+}
+
+
+/* called by idle workers that found no work in the last scheduler round, **
+** work_events is the value of GLOBAL_work_events before that round       */
+static inline
+void SCH_wait_for_work(int work_events) {
+  __sync_fetch_and_add(&GLOBAL_sleeping_workers, 1);
+  SCH_sleep_on_word(&GLOBAL_work_events, work_events, BLOCKING_WAIT_USECS);
+  __sync_fetch_and_sub(&GLOBAL_sleeping_workers, 1);
+  return;
+}
+
+
+static inline
+void SCH_signal_work(void) {
+  if (GLOBAL_wait_mode == WAIT_MODE_BLOCK) {
+    __sync_fetch_and_add(&GLOBAL_work_events, 1);
+    if (GLOBAL_sleeping_workers > 0)
+      SCH_wake_up_word(&GLOBAL_work_events);
+  }
+  return;
+}
+
+
+
+/* -------------------------- **
+**      Work Offer Stuff      **
+** -------------------------- */
+
+#define SCH_available_work_offer(OR_FR)                                  \
+        (OrFr_alternative(OR_FR) && ! YAMOP_SEQ(OrFr_alternative(OR_FR)))
+
+/* called by the owner after sharing its private nodes: offers the shared   **
+** nodes younger than the last offer, older nodes first, and drops the      **
+** youngest ones if the deque is full. The offers are validated by thieves  */
+static inline
+void SCH_publish_work_offers(void) {
+  CACHE_REGS
+  or_fr_ptr or_frame;
+  Int bottom, free_offers, offers, i;
+  int last_depth;
+
+  if (GLOBAL_scheduler_mode != SCHEDULER_MODE_STEAL)
+    return;
+  bottom = LOCAL_work_offers_bottom;
+  free_offers = STEAL_DEQUE_SIZE - (bottom - LOCAL_work_offers_top);
+  last_depth = (bottom > LOCAL_work_offers_top) ? LOCAL_work_offer_depth(bottom - 1) : 0;
+  i = OrFr_depth(LOCAL_top_or_fr) - last_depth;
+  offers = (i < free_offers) ? i : free_offers;
+  if (offers <= 0)
+    return;
+  for (or_frame = LOCAL_top_or_fr; i > 0; or_frame = OrFr_next_on_stack(or_frame))
+    if (--i < offers) {
+      LOCAL_work_offer_or_fr(bottom + i) = or_frame;
+      LOCAL_work_offer_depth(bottom + i) = OrFr_depth(or_frame);
+    }
+  __sync_synchronize();
+  LOCAL_work_offers_bottom = bottom + offers;
+  return;
+}
+
+
+/* called by the owner when moving up in the branch: withdraws the **
+** offers that are younger than the new top or-frame               */
+static inline
+void SCH_withdraw_work_offers(int depth) {
+  CACHE_REGS
+  Int top, bottom;
+
+  while ((bottom = LOCAL_work_offers_bottom) > LOCAL_work_offers_top &&
+         LOCAL_work_offer_depth(bottom - 1) > depth) {
+    LOCAL_work_offers_bottom = --bottom;
+    __sync_synchronize();
+    top = LOCAL_work_offers_top;
+    if (top < bottom)
+      continue;
+    if (top == bottom) {
+      /* last offer --> race with the thieves */
+      __sync_bool_compare_and_swap(&LOCAL_work_offers_top, top, top + 1);
+      top++;
+    }
+    LOCAL_work_offers_bottom = top;
+    return;
+  }
+  return;
+}
+
+
+/* called by thieves: reads the oldest offer of worker p. The offer is **
+** only consumed, with SCH_consume_work_offer(), once it is found stale **
+** or the sharing request to worker p was accepted, thus a refused      **
+** request leaves it for the next thieves                               */
+static inline
+int SCH_read_work_offer(int p, Int *top_ptr, or_fr_ptr *or_frame, int *depth) {
+  Int top, bottom;
+
+  top = REMOTE_work_offers_top(p);
+  __sync_synchronize();
+  bottom = REMOTE_work_offers_bottom(p);
+  if (top >= bottom)
+    return FALSE;
+  *or_frame = REMOTE_work_offer_or_fr(p, top);
+  *depth = REMOTE_work_offer_depth(p, top);
+  *top_ptr = top;
+  return TRUE;
+}
+
+
+/* called by thieves: the compare and swap fails if the offer was meanwhile **
+** consumed by another thief or withdrawn by its owner, which is harmless   */
+static inline
+void SCH_consume_work_offer(int p, Int top) {
+  __sync_bool_compare_and_swap(&REMOTE_work_offers_top(p), top, top + 1);
+  return;
+}
+
+
+
 /* ---------------------- **
 **      Engine Stuff      **
 ** ---------------------- */
@@ -221,6 +670,8 @@ void PUT_IN_ROOT_NODE(int worker_num) {
   LOCK(GLOBAL_locks_bm_root_cp_workers);
   BITMAP_insert(GLOBAL_bm_root_cp_workers, worker_num);
   UNLOCK(GLOBAL_locks_bm_root_cp_workers);
+  /* the idle workers may be waiting for all workers to reach the root node */
+  SCH_signal_work();
   return;
 }
 
@@ -272,6 +723,7 @@ void PUT_IN_REQUESTABLE(int p) {
   LOCK(GLOBAL_locks_bm_requestable_workers);
   BITMAP_insert(GLOBAL_bm_requestable_workers, p);
   UNLOCK(GLOBAL_locks_bm_requestable_workers);
+  SCH_signal_work();
   return;
 }
 
@@ -288,8 +740,29 @@ void PUT_OUT_REQUESTABLE(int p) {
 static inline 
 void SCH_update_local_or_tops(void) {
   CACHE_REGS
+#ifdef ANSWER_TRIE_RANGES
+  if (SCH_trie_range_active())
+    /* leaving the node of the range (pruned) */
+    LOCAL_trie_range_node = NULL;
+#endif /* ANSWER_TRIE_RANGES */
   Set_LOCAL_top_cp(Get_LOCAL_top_cp()->cp_b);
   LOCAL_top_or_fr = Get_LOCAL_top_cp()->cp_or_fr;
+  if (GLOBAL_scheduler_mode == SCHEDULER_MODE_STEAL)
+    SCH_withdraw_work_offers(OrFr_depth(LOCAL_top_or_fr));
+  return;
+}
+
+
+/* allocates the branch chunks of a worker up to the given depth, when **
+** sharing the chunks of the requesting worker are allocated by P      */
+static inline
+void SCH_check_branch_depth(int worker, int depth) {
+  int chunk;
+
+  if (depth >= MAX_BRANCH_DEPTH)
+    Yap_Error(INTERNAL_ERROR, TermNil, "maximum depth exceded (SCH_check_branch_depth)");
+  for (chunk = depth / BRANCH_CHUNK_SIZE; chunk >= 0 && REMOTE_branch_chunk(worker, chunk) == NULL; chunk--)
+    ALLOC_BLOCK(REMOTE_branch_chunk(worker, chunk), BRANCH_CHUNK_SIZE * sizeof(unsigned int), volatile unsigned int);
   return;
 }
 
@@ -298,7 +771,7 @@ static inline
 void SCH_refuse_share_request_if_any(void)  {
   CACHE_REGS
   if (SCH_any_share_request) {
-    REMOTE_reply_signal(LOCAL_share_request) = no_sharing;
+    SCH_set_signal(REMOTE_reply_signal(LOCAL_share_request), no_sharing);
     LOCAL_share_request = MAX_WORKERS;
     PUT_OUT_REQUESTABLE(worker_id);
   }
@@ -341,6 +814,74 @@ void SCH_new_alternative(yamop *curpc, yamop *new) {
 }
 
 
+#ifdef ANSWER_TRIE_RANGES
+/* called by the trie instructions of a shared node of a completed answer trie, **
+** with the or-frame locked. Besides the current alternative, the worker takes  **
+** a range of the following siblings, which is exploited by the getwork         **
+** instruction without locking the or-frame, and leaves the or-frame with the   **
+** sibling after the range                                                      */
+static inline
+void SCH_new_trie_alternative(yamop *curpc, yamop *new) {
+  CACHE_REGS
+  int size;
+
+  if (new == NULL || (size = YAMOP_LTT(new) / GLOBAL_number_workers) < 2) {
+    SCH_new_alternative(curpc, new);
+    return;
+  }
+  if (size > ANSWER_TRIE_RANGE_SIZE)
+    size = ANSWER_TRIE_RANGE_SIZE;
+  LOCAL_trie_range_node = Get_LOCAL_top_cp();
+  LOCAL_trie_range_next = new;
+  LOCAL_trie_range_ranges++;
+  LOCAL_trie_range_alternatives += size;
+  do {
+#ifdef COMPACT_ANSWER_TRIES
+    new = (yamop *) CmpNode_next((cmp_node_ptr) new);
+#else
+    new = (yamop *) TrNode_next((ans_node_ptr) new);
+#endif /* COMPACT_ANSWER_TRIES */
+  } while (--size);
+  LOCAL_trie_range_end = new;
+  SCH_new_alternative(curpc, new);
+  return;
+}
+
+
+/* called by the trie instructions of the shared node of the range, the or-frame is not locked */
+static inline
+void SCH_trie_range_alternative(yamop *curpc, yamop *new) {
+  CACHE_REGS
+  BRANCH(worker_id, OrFr_depth(LOCAL_top_or_fr)) = YAMOP_OR_ARG(curpc);
+  if (new == LOCAL_trie_range_end)
+    LOCAL_trie_range_node = NULL;
+  else
+    LOCAL_trie_range_next = new;
+  return;
+}
+
+
+/* gives the rest of the range back to the or-frame of its node, unless the **
+** siblings after the range were meanwhile taken by other workers           */
+static inline
+void SCH_release_trie_range(void) {
+  CACHE_REGS
+  or_fr_ptr or_frame;
+
+  if (LOCAL_trie_range_node == NULL)
+    return;
+  or_frame = LOCAL_trie_range_node->cp_or_fr;
+  LOCK_OR_FRAME(or_frame);
+  if (OrFr_alternative(or_frame) == LOCAL_trie_range_end) {
+    OrFr_alternative(or_frame) = LOCAL_trie_range_next;
+    LOCAL_trie_range_node = NULL;
+  }
+  UNLOCK_OR_FRAME(or_frame);
+  return;
+}
+#endif /* ANSWER_TRIE_RANGES */
+
+
 
 /* ---------------------------- **
 **      Cut Stuff: Pruning      **
@@ -405,7 +946,7 @@ or_fr_ptr CUT_leftmost_or_frame(void) {
   do {
     ltt = BRANCH_LTT(worker_id, depth);
     BITMAP_difference(members, OrFr_members(leftmost_or_fr), members);
-    if (members)
+    if (! BITMAP_empty(members))
       for (i = 0; i < GLOBAL_number_workers; i++)
         if (BITMAP_member(members, i) && BRANCH_LTT(i, depth) > ltt)
           goto update_nearest_leftnode_data;
@@ -444,7 +985,7 @@ or_fr_ptr CUT_leftmost_until(or_fr_ptr start_or_fr, int until_depth) {
     BITMAP_delete(prune_members, worker_id);
     ltt = BRANCH_LTT(worker_id, depth);
     BITMAP_intersection(members, prune_members, OrFr_members(leftmost_or_fr));
-    if (members) {
+    if (! BITMAP_empty(members)) {
       for (i = 0; i < GLOBAL_number_workers; i++) {
         if (BITMAP_member(members, i) && 
             BRANCH_LTT(i, depth) > ltt &&
@@ -459,7 +1000,7 @@ or_fr_ptr CUT_leftmost_until(or_fr_ptr start_or_fr, int until_depth) {
     while (depth > until_depth) {
       ltt = BRANCH_LTT(worker_id, depth);
       BITMAP_intersection(members, prune_members, OrFr_members(leftmost_or_fr));
-      if (members) {
+      if (! BITMAP_empty(members)) {
         for (i = 0; i < GLOBAL_number_workers; i++) {
           if (BITMAP_member(members, i) &&
               BRANCH_LTT(i, depth) > ltt &&
@@ -506,27 +1047,49 @@ or_fr_ptr CUT_leftmost_until(or_fr_ptr start_or_fr, int until_depth) {
 ** ------------------------------------------------ */
 
 static inline 
-void CUT_store_answer(or_fr_ptr or_frame, qg_ans_fr_ptr new_answer) {
+void CUT_buffer_answer(Term answer) {
   CACHE_REGS
-  int ltt;
-  qg_sol_fr_ptr *solution_ptr;
+  qg_sol_fr_ptr solution = LOCAL_qg_answers;
+  qg_ans_fr_ptr answers;
+
+  /* answers are kept in a local chunk, that is stored in the leftmost or-frame only when full */
+  if (solution == NULL) {
+    ALLOC_QG_ANSWER_FRAME(answers);
+    AnsFr_free_slot(answers) = 0;
+    AnsFr_next(answers) = NULL;
+    ALLOC_QG_SOLUTION_FRAME(solution);
+    SolFr_next(solution) = NULL;
+    SolFr_first(solution) = answers;
+    SolFr_last(solution) = answers;
+    LOCAL_qg_answers = solution;
+  } else
+    answers = SolFr_last(solution);
+  AnsFr_answer(answers, AnsFr_free_slot(answers)) = answer;
+  if (++AnsFr_free_slot(answers) == QG_ANSWER_SLOTS)
+    CUT_flush_buffered_answers();
+  return;
+}
 
-  ltt = BRANCH_LTT(worker_id, OrFr_depth(or_frame));
-  solution_ptr = & OrFr_qg_solutions(or_frame);
-  while (*solution_ptr && ltt > SolFr_ltt(*solution_ptr)) {
-    solution_ptr = & SolFr_next(*solution_ptr);
-  }
-  if (*solution_ptr && ltt == SolFr_ltt(*solution_ptr)) {
-    AnsFr_next(SolFr_last(*solution_ptr)) = new_answer;
-    SolFr_last(*solution_ptr) = new_answer;
+
+static inline 
+void CUT_flush_buffered_answers(void) {
+  CACHE_REGS
+  qg_sol_fr_ptr solution = LOCAL_qg_answers;
+  or_fr_ptr leftmost_or_fr;
+
+  /* must be called before the worker leaves its current branch or takes a **
+  ** new alternative of a shared node (getwork), shares or prunes its work   */
+  if (solution == NULL)
+    return;
+  LOCAL_qg_answers = NULL;
+  leftmost_or_fr = CUT_leftmost_or_frame();
+  LOCK_OR_FRAME(leftmost_or_fr);
+  if (Get_LOCAL_prune_request()) {
+    UNLOCK_OR_FRAME(leftmost_or_fr);
+    CUT_free_solution_frame(solution);
   } else {
-    qg_sol_fr_ptr new_solution;
-    ALLOC_QG_SOLUTION_FRAME(new_solution);
-    SolFr_next(new_solution) = *solution_ptr;
-    SolFr_ltt(new_solution) = ltt;
-    SolFr_first(new_solution) = new_answer;
-    SolFr_last(new_solution) = new_answer;
-    *solution_ptr = new_solution;
+    CUT_store_answers(leftmost_or_fr, solution);
+    UNLOCK_OR_FRAME(leftmost_or_fr);
   }
   return;
 }
@@ -538,9 +1101,11 @@ void CUT_store_answers(or_fr_ptr or_frame, qg_sol_fr_ptr new_solution) {
   int ltt;
   qg_sol_fr_ptr *solution_ptr;
 
+  /* the ltt of a branch is the number of alternatives at its right, thus **
+  ** the solution frames are kept in decreasing ltt (left-to-right) order */
   ltt = BRANCH_LTT(worker_id, OrFr_depth(or_frame));
   solution_ptr = & OrFr_qg_solutions(or_frame);
-  while (*solution_ptr && ltt > SolFr_ltt(*solution_ptr)) {
+  while (*solution_ptr && ltt < SolFr_ltt(*solution_ptr)) {
     solution_ptr = & SolFr_next(*solution_ptr);
   }
   if (*solution_ptr && ltt == SolFr_ltt(*solution_ptr)) {
@@ -600,13 +1165,15 @@ void CUT_free_solution_frames(qg_sol_fr_ptr current_solution) {
 
 static inline 
 qg_sol_fr_ptr CUT_prune_solution_frames(qg_sol_fr_ptr solutions, int ltt) {
-  qg_sol_fr_ptr next_solution;
+  qg_sol_fr_ptr *solution_ptr;
 
-  while (solutions && ltt > SolFr_ltt(solutions)) {
-    next_solution = SolFr_next(solutions);
-    CUT_free_solution_frame(solutions);
-    solutions = next_solution;
+  /* the solution frames of the branches at the right of ltt are the last ones */
+  solution_ptr = & solutions;
+  while (*solution_ptr && ltt <= SolFr_ltt(*solution_ptr)) {
+    solution_ptr = & SolFr_next(*solution_ptr);
   }
+  CUT_free_solution_frames(*solution_ptr);
+  *solution_ptr = NULL;
   return solutions;
 }
 
@@ -121,21 +121,27 @@ void p_share_work(void) {
 
   if (! BITMAP_member(OrFr_members(REMOTE_top_or_fr(worker_q)), worker_id) ||
       B == REMOTE_top_cp(worker_q) ||
-      (LOCAL_load <= GLOBAL_delayed_release_load && OrFr_nearest_livenode(LOCAL_top_or_fr) == NULL)) {
+      (LOCAL_load <= GLOBAL_delayed_release_load && OrFr_nearest_livenode(LOCAL_top_or_fr) == NULL) ||
+      SCH_small_granularity()) {
     /* refuse sharing request */
-    REMOTE_reply_signal(LOCAL_share_request) = no_sharing;
+    SCH_set_signal(REMOTE_reply_signal(LOCAL_share_request), no_sharing);
     LOCAL_share_request = MAX_WORKERS;
     PUT_OUT_REQUESTABLE(worker_id);
     return;
   }
   /* sharing request accepted */
+  SCH_share_begin();
   /* LOCAL_reply_signal = sharing; */
   COMPUTE_SEGMENTS_TO_COPY_TO(worker_q);
+  SCH_trace_begin(TRACE_SHARE_PRIVATE_NODES);
   share_private_nodes(worker_q);
-  REMOTE_reply_signal(worker_q) = sharing;
+  SCH_trace_end(TRACE_SHARE_PRIVATE_NODES);
+  SCH_set_signal(REMOTE_reply_signal(worker_q), sharing);
   /* REMOTE_reply_signal(worker_q) = nodes_shared; */
   /* while (LOCAL_reply_signal == sharing); */
+  SCH_share_end();
   LOCAL_share_request = MAX_WORKERS;
+  SCH_publish_work_offers();
   PUT_IN_REQUESTABLE(worker_id);
 
   return;
@@ -173,10 +179,10 @@ int q_share_work(int worker_p) {
   UNLOCK_WORKER(worker_p);
 
   /* wait for an answer */
-  while (LOCAL_reply_signal == worker_ready);
+  SCH_wait_while(LOCAL_reply_signal == worker_ready, LOCAL_reply_signal);
   if (LOCAL_reply_signal == no_sharing) {
     /* sharing request refused */
-    LOCAL_reply_signal = worker_ready;
+    SCH_set_signal(LOCAL_reply_signal, worker_ready);
     return FALSE;
   }
 
@@ -208,7 +214,7 @@ int q_share_work(int worker_p) {
 
   /* update registers and return */
   /* REMOTE_reply_signal(worker_p) = worker_ready; */
-  LOCAL_reply_signal = worker_ready;
+  SCH_set_signal(LOCAL_reply_signal, worker_ready);
   PUT_IN_REQUESTABLE(worker_id);
   TR = LOCAL_top_cp->cp_tr;
   return TRUE;
@@ -240,6 +246,9 @@ void share_private_nodes(int worker_q) {
     OrFr_pend_prune_cp(or_frame) = NULL;
     OrFr_nearest_leftnode(or_frame) = LOCAL_top_or_fr;
     OrFr_qg_solutions(or_frame) = NULL;
+#ifdef YAPOR_GRANULARITY_CONTROL
+    OrFr_pred(or_frame) = Yap_PredForChoicePt(AuxB);
+#endif /* YAPOR_GRANULARITY_CONTROL */
     BITMAP_clear(OrFr_members(or_frame));
     BITMAP_insert(OrFr_members(or_frame), worker_id);
     BITMAP_insert(OrFr_members(or_frame), worker_q);
@@ -261,8 +270,8 @@ void share_private_nodes(int worker_q) {
     OrFr_nearest_livenode(previous_or_frame) = OrFr_next(previous_or_frame) = or_frame;
   }
   /* update depth */
-  if (depth >= MAX_BRANCH_DEPTH)
-    Yap_Error(INTERNAL_ERROR, TermNil, "maximum depth exceded (share_private_nodes)");
+  SCH_check_branch_depth(worker_id, depth);
+  SCH_check_branch_depth(worker_q, depth);
   or_frame = B->cp_or_fr;
 
   while (or_frame != LOCAL_top_or_fr) {
@@ -30,8 +30,11 @@
 **      Local functions declaration      **
 ** ------------------------------------- */
 
+static int search_for_work(void);
 static int move_up_one_node(or_fr_ptr nearest_livenode);
 static int get_work_below(void);
+static int steal_work(void);
+static void move_up_to_work_offer(or_fr_ptr or_fr_offered);
 static int get_work_above(void);
 static int find_a_better_position(void);
 static int search_for_hidden_shared_work(bitmap stable_busy);
@@ -123,7 +126,21 @@ void move_up_to_prune_request(void) {
 
 int get_work(void) {
   CACHE_REGS
-  int counter;
+  int found_work;
+
+  SCH_trace_begin(TRACE_GET_WORK);
+  SCH_stop_sampling();
+  found_work = search_for_work();
+  SCH_trace_idle_end();
+  SCH_trace_end(TRACE_GET_WORK);
+  return found_work;
+}
+
+
+static
+int search_for_work(void) {
+  CACHE_REGS
+  int counter, idle_rounds;
   bitmap stable_busy;
   yamop *alt_with_work;
   or_fr_ptr or_fr_with_work, or_fr_to_move_to;
@@ -134,22 +151,41 @@ int get_work(void) {
   /* reset local load */
   LOCAL_load = 0;
 
+  /* store the answers buffered on the current branch */
+  CUT_flush_buffered_answers();
+
   /* check for prune request */
   if (Get_LOCAL_prune_request())
     move_up_to_prune_request();
 
+#ifdef ANSWER_TRIE_RANGES
+  if (SCH_trie_range_active())
+    /* the worker has a range of trie siblings in the top node */
+    return TRUE;
+#endif /* ANSWER_TRIE_RANGES */
+
   /* find nearest node with available work */
   or_fr_with_work = LOCAL_top_or_fr;
   do {
     or_fr_with_work = OrFr_nearest_livenode(or_fr_with_work);
     if (or_fr_with_work == NULL)
       break;
+#ifdef ANSWER_TRIE_RANGES
+    if (LOCAL_trie_range_node && OrFr_depth(or_fr_with_work) <= OrFr_depth(LOCAL_trie_range_node->cp_or_fr))
+      /* the range of trie siblings taken by the worker is not in its or-frame */
+      break;
+#endif /* ANSWER_TRIE_RANGES */
     alt_with_work = OrFr_alternative(or_fr_with_work);
   } while (alt_with_work == NULL || YAMOP_SEQ(alt_with_work));
+#ifdef ANSWER_TRIE_RANGES
+  if (LOCAL_trie_range_node &&
+      (or_fr_with_work == NULL || OrFr_depth(or_fr_with_work) <= OrFr_depth(LOCAL_trie_range_node->cp_or_fr)))
+    or_fr_with_work = LOCAL_trie_range_node->cp_or_fr;
+#endif /* ANSWER_TRIE_RANGES */
 
 #ifndef TABLING
   /* wait for incomplete installations */
-  while (LOCAL_reply_signal != worker_ready);
+  SCH_wait_while(LOCAL_reply_signal != worker_ready, LOCAL_reply_signal);
 #endif /* TABLING */
 
   if (or_fr_with_work) {
@@ -192,11 +228,14 @@ int get_work(void) {
   LOCK_WORKER(worker_id);
   PUT_IDLE(worker_id);
   UNLOCK_WORKER(worker_id);
+  SCH_trace_idle_begin();
   SCH_refuse_share_request_if_any();
   
   counter = 0;
+  idle_rounds = 0;
   BITMAP_difference(stable_busy, OrFr_members(LOCAL_top_or_fr), GLOBAL_bm_idle_workers);
    while (1) {
+    int work_events = GLOBAL_work_events;
     while (BITMAP_subset(GLOBAL_bm_idle_workers, OrFr_members(LOCAL_top_or_fr)) &&
            Get_LOCAL_top_cp() != Get_GLOBAL_root_cp()) {
       /* no busy workers here and below */
@@ -214,10 +253,22 @@ int get_work(void) {
            Only when all workers are idle and in the root choicepoint it is safe to
            finish execution. */
         PUT_IN_ROOT_NODE(worker_id);
-      if (BITMAP_same(GLOBAL_bm_root_cp_workers, GLOBAL_bm_present_workers))
+      if (BITMAP_same(GLOBAL_bm_root_cp_workers, GLOBAL_bm_present_workers)) {
         /* All workers are idle in the root choicepoint. Execution 
-           must finish as there is no available computation. */
-        return FALSE;
+           must finish as there is no available computation. The
+           bitmaps may span several words, thus confirm it while
+           no worker can leave the root choicepoint. */
+        int all_in_root;
+        LOCK(GLOBAL_locks_bm_root_cp_workers);
+        all_in_root = BITMAP_same(GLOBAL_bm_root_cp_workers, GLOBAL_bm_present_workers);
+        UNLOCK(GLOBAL_locks_bm_root_cp_workers);
+        if (all_in_root)
+          return FALSE;
+      }
+    }
+    if (GLOBAL_scheduler_mode == SCHEDULER_MODE_STEAL && steal_work()) {
+      PUT_BUSY(worker_id);
+      return TRUE;
     }
     if (get_work_below()) {
       PUT_BUSY(worker_id);
@@ -231,6 +282,16 @@ int get_work(void) {
       PUT_BUSY(worker_id);
       return TRUE;
     }
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+    /* no work available --> compact the answer tries of completed subgoals */
+    if (compact_queued_answer_trie())
+      continue;
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
+#ifdef DEFERRED_ABOLISH
+    /* no work available --> free the tries of the abolished tables */
+    if (free_abolished_subtrie())
+      continue;
+#endif /* DEFERRED_ABOLISH */
     if (++counter == GLOBAL_scheduler_loop) {
       if (search_for_hidden_shared_work(stable_busy)) {
         PUT_BUSY(worker_id);
@@ -241,6 +302,9 @@ int get_work(void) {
     } else {
       BITMAP_minus(stable_busy, GLOBAL_bm_idle_workers);
     }
+    if (GLOBAL_wait_mode == WAIT_MODE_BLOCK && ++idle_rounds > BLOCKING_WAIT_SPINS)
+      /* no work found for a while --> sleep until some worker becomes requestable */
+      SCH_wait_for_work(work_events);
   }
 }
 
@@ -531,7 +595,81 @@ int get_work_below(void){
   }
   if (worker_p == -1) 
     return FALSE;
-  return (q_share_work(worker_p));
+  return (SCH_q_share_work(worker_p));
+}
+
+
+static
+int steal_work(void){
+  CACHE_REGS
+  int i, worker_p, depth;
+  Int top;
+  bitmap busy_below;
+  or_fr_ptr or_fr_offered, or_fr_on_branch;
+
+  BITMAP_difference(busy_below, OrFr_members(LOCAL_top_or_fr), GLOBAL_bm_idle_workers);
+  BITMAP_delete(busy_below, worker_id);
+  for (i = 1; i < GLOBAL_number_workers; i++) {
+    worker_p = (worker_id + i) % GLOBAL_number_workers;
+    if (! BITMAP_member(busy_below, worker_p))
+      continue;
+    /* steal the oldest offer of worker p that is below the current node */
+    while (SCH_read_work_offer(worker_p, &top, &or_fr_offered, &depth)) {
+      if (depth <= OrFr_depth(LOCAL_top_or_fr) || ! SCH_available_work_offer(or_fr_offered)) {
+        /* stale offer --> drop it without starting a sharing with worker p */
+        SCH_consume_work_offer(worker_p, top);
+        continue;
+      }
+      if (! SCH_q_share_work(worker_p))
+        /* refused request --> the offer is left for the next thieves */
+        return FALSE;
+      SCH_consume_work_offer(worker_p, top);
+      /* the offered node is valid if it is in the copied branch */
+      or_fr_on_branch = LOCAL_top_or_fr;
+      while (OrFr_depth(or_fr_on_branch) > depth)
+        or_fr_on_branch = OrFr_next_on_stack(or_fr_on_branch);
+      if (or_fr_on_branch == or_fr_offered)
+        move_up_to_work_offer(or_fr_offered);
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+
+static
+void move_up_to_work_offer(or_fr_ptr or_fr_offered) {
+  CACHE_REGS
+  yamop *alt_with_work;
+  or_fr_ptr or_fr_with_work;
+#ifdef TABLING
+  choiceptr leader_node = DepFr_leader_cp(LOCAL_top_dep_fr);
+
+  if (leader_node && YOUNGER_CP(leader_node, GetOrFr_node(or_fr_offered)))
+    /* there is a leader node before the offered node */
+    return;
+#endif /* TABLING */
+
+  /* the nodes between the top node and the offered node must have no available work */
+  or_fr_with_work = LOCAL_top_or_fr;
+  alt_with_work = OrFr_alternative(or_fr_with_work);
+  while (alt_with_work == NULL || YAMOP_SEQ(alt_with_work)) {
+    or_fr_with_work = OrFr_nearest_livenode(or_fr_with_work);
+    if (or_fr_with_work == NULL || OrFr_depth(or_fr_with_work) <= OrFr_depth(or_fr_offered))
+      break;
+    alt_with_work = OrFr_alternative(or_fr_with_work);
+  }
+  if (or_fr_with_work != or_fr_offered || ! SCH_available_work_offer(or_fr_offered))
+    /* younger nodes with work or no work left in the offered node --> stay in the top node */
+    return;
+
+  /* move up to the offered node, its alternative is then taken by the getwork instruction */
+  do {
+    if (! move_up_one_node(or_fr_offered))
+      /* the top node was given work to do (pending prune, sequential node or resumed suspension) */
+      return;
+  } while (LOCAL_top_or_fr != or_fr_offered);
+  return;
 }
 
 
@@ -585,7 +723,7 @@ int get_work_above(void){
   BITMAP_delete(GLOBAL_bm_invisible_workers, worker_id);
   BITMAP_delete(GLOBAL_bm_invisible_workers, worker_p);
   UNLOCK(GLOBAL_locks_bm_invisible_workers);
-  return (q_share_work(worker_p));
+  return (SCH_q_share_work(worker_p));
 }
 
 
@@ -638,6 +776,6 @@ int search_for_hidden_shared_work(bitmap stable_busy){
     if (BITMAP_member(invisible_work ,i))
       break;
   }
-  return (q_share_work(i));
+  return (SCH_q_share_work(i));
 }
 #endif /* YAPOR */
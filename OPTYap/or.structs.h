@@ -88,6 +88,9 @@ typedef struct or_frame {
   struct suspension_frame *suspensions;
   struct or_frame *nearest_suspension_node;
 #endif /* TABLING */
+#ifdef YAPOR_GRANULARITY_CONTROL
+  struct pred_entry *predicate;  /* predicate of the alternatives of the node (NULL if unknown) */
+#endif /* YAPOR_GRANULARITY_CONTROL */
   struct or_frame *next;
 } *or_fr_ptr;
 
@@ -124,6 +127,7 @@ typedef struct or_frame {
 #endif /* TABLING */
 #define OrFr_suspensions(X)       ((X)->suspensions)
 #define OrFr_nearest_suspnode(X)  ((X)->nearest_suspension_node)
+#define OrFr_pred(X)              ((X)->predicate)
 #define OrFr_next(X)              ((X)->next)
 
 
@@ -151,12 +155,14 @@ typedef struct query_goal_solution_frame{
 ** ---------------------------------------- */
 
 typedef struct query_goal_answer_frame{
-  Term answer;
+  int next_free_slot;
+  Term answer[QG_ANSWER_SLOTS];
   struct query_goal_answer_frame *next;
 } *qg_ans_fr_ptr;
 
-#define AnsFr_answer(X)  ((X)->answer)
-#define AnsFr_next(X)    ((X)->next)
+#define AnsFr_free_slot(X)  ((X)->next_free_slot)
+#define AnsFr_answer(X,N)   ((X)->answer[N])
+#define AnsFr_next(X)       ((X)->next)
 
 
 
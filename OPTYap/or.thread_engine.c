@@ -30,7 +30,6 @@
 #endif /* TABLING */
 
 
-#define INCREMENTAL_COPYING 1
 #define COMPUTE_SEGMENTS_TO_COPY_TO(Q)                                   \
         REMOTE_start_global_copy(Q) = (CELL) (REMOTE_top_cp(Q)->cp_h);   \
         REMOTE_end_global_copy(Q)   = (CELL) (B->cp_h);                  \
@@ -110,30 +109,36 @@ int p_share_work() {
 
   if (! BITMAP_member(OrFr_members(REMOTE_top_or_fr(worker_q)), worker_id) ||
       B == REMOTE_top_cp(worker_q) ||
-      (LOCAL_load <= GLOBAL_delayed_release_load && OrFr_nearest_livenode(LOCAL_top_or_fr) == NULL)) {
+      (LOCAL_load <= GLOBAL_delayed_release_load && OrFr_nearest_livenode(LOCAL_top_or_fr) == NULL) ||
+      SCH_small_granularity()) {
     /* refuse sharing request */
-    REMOTE_reply_signal(LOCAL_share_request) = no_sharing;
+    SCH_set_signal(REMOTE_reply_signal(LOCAL_share_request), no_sharing);
     LOCAL_share_request = MAX_WORKERS;
     PUT_OUT_REQUESTABLE(worker_id);
     return TRUE;
   }
   /* sharing request accepted */
+  SCH_share_begin();
   COMPUTE_SEGMENTS_TO_COPY_TO(worker_q);
   REMOTE_q_fase_signal(worker_q) = Q_idle;
   REMOTE_p_fase_signal(worker_q) = P_idle;
 #ifndef TABLING
   /* wait for incomplete installations */
-  while (LOCAL_reply_signal != worker_ready);
+  SCH_wait_while(LOCAL_reply_signal != worker_ready, LOCAL_reply_signal);
 #endif /* TABLING */
-  LOCAL_reply_signal = sharing;
-  REMOTE_reply_signal(worker_q) = sharing;
+  SCH_set_signal(LOCAL_reply_signal, sharing);
+  SCH_set_signal(REMOTE_reply_signal(worker_q), sharing);
+  SCH_trace_begin(TRACE_SHARE_PRIVATE_NODES);
   share_private_nodes(worker_q);
+  SCH_trace_end(TRACE_SHARE_PRIVATE_NODES);
   if(Get_LOCAL_prune_request())
     CUT_send_prune_request(worker_q, Get_LOCAL_prune_request()); 
-  REMOTE_reply_signal(worker_q) = nodes_shared;
-  while (LOCAL_reply_signal == sharing);
-  while (REMOTE_reply_signal(worker_q) != worker_ready);
+  SCH_set_signal(REMOTE_reply_signal(worker_q), nodes_shared);
+  SCH_wait_while(LOCAL_reply_signal == sharing, LOCAL_reply_signal);
+  SCH_wait_while(REMOTE_reply_signal(worker_q) != worker_ready, REMOTE_reply_signal(worker_q));
+  SCH_share_end();
   LOCAL_share_request = MAX_WORKERS;
+  SCH_publish_work_offers();
   PUT_IN_REQUESTABLE(worker_id);
 
   return TRUE;
@@ -202,26 +207,22 @@ int q_share_work(int worker_p) {
   UNLOCK_WORKER(worker_p);
 
   /* wait for an answer */
-  while (LOCAL_reply_signal == worker_ready);
+  SCH_wait_while(LOCAL_reply_signal == worker_ready, LOCAL_reply_signal);
   if (LOCAL_reply_signal == no_sharing) {
     /* sharing request refused */
-    LOCAL_reply_signal = worker_ready;
+    SCH_set_signal(LOCAL_reply_signal, worker_ready);
     return FALSE;
   }
-  while (LOCAL_reply_signal == sharing);
+  SCH_wait_while(LOCAL_reply_signal == sharing, LOCAL_reply_signal);
 
-#if INCREMENTAL_COPYING
-  Yap_CopyThreadStacks(worker_id, worker_p, TRUE);
-#else
-  Yap_CopyThreadStacks(worker_id, worker_p, FALSE);
-#endif
+  Yap_CopyThreadStacks(worker_id, worker_p, GLOBAL_copy_mode == COPY_MODE_INCREMENTAL);
 
   PUT_OUT_ROOT_NODE(worker_id);
   /* update registers and return */
 #ifndef TABLING
-  REMOTE_reply_signal(worker_p) = worker_ready;
+  SCH_set_signal(REMOTE_reply_signal(worker_p), worker_ready);
 #endif /* TABLING */
-  LOCAL_reply_signal = worker_ready;
+  SCH_set_signal(LOCAL_reply_signal, worker_ready);
   PUT_IN_REQUESTABLE(worker_id);
   return TRUE;
 }
@@ -267,6 +268,7 @@ void share_private_nodes(int worker_q) {
 #endif /* DEBUG_OPTYAP */
 
     /* update old shared nodes */
+    SCH_check_branch_depth(worker_q, OrFr_depth(LOCAL_top_or_fr));
     or_frame = LOCAL_top_or_fr;
     while (or_frame != REMOTE_top_or_fr(worker_q)) {
       LOCK_OR_FRAME(or_frame);
@@ -366,6 +368,9 @@ void share_private_nodes(int worker_q) {
       Set_OrFr_pend_prune_cp(or_frame, NULL);
       OrFr_nearest_leftnode(or_frame) = LOCAL_top_or_fr;
       OrFr_qg_solutions(or_frame) = NULL;
+#ifdef YAPOR_GRANULARITY_CONTROL
+      OrFr_pred(or_frame) = Yap_PredForChoicePt(sharing_node);
+#endif /* YAPOR_GRANULARITY_CONTROL */
 #ifdef TABLING_INNER_CUTS
       OrFr_tg_solutions(or_frame) = NULL;
 #endif /* TABLING_INNER_CUTS */
@@ -431,8 +436,8 @@ void share_private_nodes(int worker_q) {
 #endif /* TABLING */
 
     /* update depth */
-    if (depth >= MAX_BRANCH_DEPTH)
-      Yap_Error(INTERNAL_ERROR, TermNil, "maximum depth exceded (share_private_nodes)");
+    SCH_check_branch_depth(worker_id, depth);
+    SCH_check_branch_depth(worker_q, depth);
     or_frame = B->cp_or_fr;
 #ifdef TABLING
     previous_or_frame = Get_LOCAL_top_cp_on_stack()->cp_or_fr;
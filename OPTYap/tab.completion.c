@@ -30,7 +30,238 @@
 **      Local functions      **
 ******************************/
 
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+static void compact_completed_answer_trie(sg_fr_ptr sg_fr) {
+  ans_node_ptr ans_trie;
+  cmp_node_ptr cmp_trie;
+  long nodes;
+
+  LOCK_SG_FR(sg_fr);
+  /* tables consumed in load_answers mode keep their answer tries unchanged */
+  if (SgFr_state(sg_fr) != complete ||
+      IsMode_LoadAnswers(TabEnt_mode(SgFr_tab_ent(sg_fr))) ||
+      SgFr_first_answer(sg_fr) == NULL || SgFr_first_answer(sg_fr) == SgFr_answer_trie(sg_fr)) {
+    UNLOCK_SG_FR(sg_fr);
+    return;
+  }
+  if (SgFr_compacted_trie(sg_fr) == NULL)
+    update_answer_trie_instructions(sg_fr);
+  ans_trie = SgFr_compacted_trie(sg_fr);
+  UNLOCK_SG_FR(sg_fr);
+  /* the completed answer trie no longer changes, thus the compact answer trie  **
+  ** is built without the lock and the subgoal can meanwhile be called by others */
+  cmp_trie = build_compact_answer_trie(ans_trie, &nodes);
+  LOCK_SG_FR(sg_fr);
+  if (SgFr_state(sg_fr) == complete) {
+    install_compact_answer_trie(sg_fr, cmp_trie);
+    cmp_trie = NULL;
+  }
+  UNLOCK_SG_FR(sg_fr);
+  if (cmp_trie) {
+    /* the subgoal was meanwhile executed and compacted by another worker */
+    FREE_BLOCK(cmp_trie);
+    UPDATE_COMPACT_ANSWER_TRIE_NODES(-nodes);
+  }
+  return;
+}
+
+
+static void schedule_answer_trie_compaction(sg_fr_ptr sg_fr) {
 #ifdef YAPOR
+  if (GLOBAL_parallel_mode == PARALLEL_MODE_RUNNING) {
+    /* leave the compaction to the idle workers. If the queue is full, **
+    ** the answer trie is compacted when the table is first executed   */
+    LOCK(GLOBAL_locks_compaction_queue);
+    if (GLOBAL_compaction_queue_entries < COMPACTION_QUEUE_SIZE) {
+      GLOBAL_compaction_queue((GLOBAL_compaction_queue_first + GLOBAL_compaction_queue_entries) % COMPACTION_QUEUE_SIZE) = sg_fr;
+      GLOBAL_compaction_queue_entries++;
+    }
+    UNLOCK(GLOBAL_locks_compaction_queue);
+    return;
+  }
+#endif /* YAPOR */
+  compact_completed_answer_trie(sg_fr);
+  return;
+}
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
+
+
+#ifdef YAPOR
+#ifdef SUSPENSION_COMPRESSION
+/* The suspended blocks are compressed with an LZ77 codec working on cells,  **
+** in the spirit of LZ4. The compressed block is a sequence of tokens. Each  **
+** token starts with a byte with the number of literal cells in the high    **
+** nibble and the length of the match minus one in the low nibble (a nibble **
+** of 15 is followed by bytes adding up to the rest of the number, the last **
+** one below 255), followed by the literal cells and by the distance of the **
+** match in cells (7 bits per byte). The last token may have no match.      */
+
+#define SUSPENSION_HASH_BITS  12
+#define SUSPENSION_HASH(C)    ((((UInt) (C)) * 2654435761UL >> 16) & ((1 << SUSPENSION_HASH_BITS) - 1))
+
+static inline unsigned char *compressed_length(unsigned char *out, long length) {
+  while (length >= 255) {
+    *out++ = 255;
+    length -= 255;
+  }
+  *out++ = (unsigned char) length;
+  return out;
+}
+
+
+static long compress_cells(CELL *in, long cells, unsigned char *out, long max_bytes) {
+  long hash[1 << SUSPENSION_HASH_BITS];
+  unsigned char *out_ptr = out, *out_end = out + max_bytes;
+  long in_ptr = 0, anchor = 0, literals, match, distance;
+
+  memset(hash, 0xff, sizeof(hash));
+  while (in_ptr < cells) {
+    unsigned h = SUSPENSION_HASH(in[in_ptr]);
+    long ref = hash[h];
+    hash[h] = in_ptr;
+    if (ref < 0 || in[ref] != in[in_ptr]) {
+      in_ptr++;
+      continue;
+    }
+    for (match = 1; in_ptr + match < cells && in[ref + match] == in[in_ptr + match]; match++);
+    literals = in_ptr - anchor;
+    distance = in_ptr - ref;
+    /* give up if the token may not fit */
+    if (out_ptr + 1 + literals / 255 + 1 + literals * sizeof(CELL) + match / 255 + 1 + 2 * sizeof(CELL) > out_end)
+      return -1;
+    *out_ptr++ = (unsigned char) ((literals < 15 ? literals : 15) << 4 | (match - 1 < 15 ? match - 1 : 15));
+    if (literals >= 15)
+      out_ptr = compressed_length(out_ptr, literals - 15);
+    memcpy(out_ptr, in + anchor, literals * sizeof(CELL));
+    out_ptr += literals * sizeof(CELL);
+    if (match - 1 >= 15)
+      out_ptr = compressed_length(out_ptr, match - 1 - 15);
+    while (distance >= 128) {
+      *out_ptr++ = (unsigned char) (distance | 128);
+      distance >>= 7;
+    }
+    *out_ptr++ = (unsigned char) distance;
+    in_ptr += match;
+    anchor = in_ptr;
+  }
+  literals = cells - anchor;
+  if (literals) {
+    if (out_ptr + 1 + literals / 255 + 1 + literals * sizeof(CELL) > out_end)
+      return -1;
+    *out_ptr++ = (unsigned char) ((literals < 15 ? literals : 15) << 4);
+    if (literals >= 15)
+      out_ptr = compressed_length(out_ptr, literals - 15);
+    memcpy(out_ptr, in + anchor, literals * sizeof(CELL));
+    out_ptr += literals * sizeof(CELL);
+  }
+  return out_ptr - out;
+}
+
+
+static void uncompress_cells(unsigned char *in, CELL *out, long cells) {
+  CELL *out_end = out + cells, *ref;
+  long literals, match, distance;
+  int shift;
+
+  while (out < out_end) {
+    literals = *in >> 4;
+    match = (*in++ & 15) + 1;
+    if (literals == 15)
+      do literals += *in; while (*in++ == 255);
+    memcpy(out, in, literals * sizeof(CELL));
+    in += literals * sizeof(CELL);
+    out += literals;
+    if (out == out_end)
+      break;
+    if (match == 16)
+      do match += *in; while (*in++ == 255);
+    distance = shift = 0;
+    do {
+      distance |= (long) (*in & 127) << shift;
+      shift += 7;
+    } while (*in++ & 128);
+    /* the match may overlap the cells being written */
+    for (ref = out - distance; match > 0; match--)
+      *out++ = *ref++;
+  }
+  return;
+}
+#endif /* SUSPENSION_COMPRESSION */
+
+
+static long store_suspended_block(void *block, void *start, long size) {
+#ifdef SUSPENSION_COMPRESSION
+  if (size >= SUSPENSION_COMPRESSION_MIN_BYTES) {
+    long stored = compress_cells((CELL *) start, size / sizeof(CELL), (unsigned char *) block, size - 1);
+    if (stored >= 0)
+      return stored;
+  }
+#endif /* SUSPENSION_COMPRESSION */
+  memcpy(block, start, size);
+  return size;
+}
+
+
+static void restore_suspended_block(void *start, void *block, long size, long stored) {
+#ifdef SUSPENSION_COMPRESSION
+  if (stored < size) {
+    uncompress_cells((unsigned char *) block, (CELL *) start, size / sizeof(CELL));
+    return;
+  }
+#endif /* SUSPENSION_COMPRESSION */
+  memcpy(start, block, size);
+  return;
+}
+
+
+static void store_suspended_blocks(susp_fr_ptr susp_fr) {
+  long size = SuspFr_block_bytes(susp_fr), stored, peak;
+  void *block;
+
+  /* the blocks are stored one after the other in a single memory block */
+  ALLOC_BLOCK(block, size, void *);
+  SuspFr_global_start(susp_fr) = block;
+  SuspFr_global_stored(susp_fr) = store_suspended_block(SuspFr_global_start(susp_fr), SuspFr_global_reg(susp_fr), SuspFr_global_size(susp_fr));
+  SuspFr_local_start(susp_fr) = SuspFr_global_start(susp_fr) + SuspFr_global_stored(susp_fr);
+  SuspFr_local_stored(susp_fr) = store_suspended_block(SuspFr_local_start(susp_fr), SuspFr_local_reg(susp_fr), SuspFr_local_size(susp_fr));
+  SuspFr_trail_start(susp_fr) = SuspFr_local_start(susp_fr) + SuspFr_local_stored(susp_fr);
+  SuspFr_trail_stored(susp_fr) = store_suspended_block(SuspFr_trail_start(susp_fr), SuspFr_trail_reg(susp_fr), SuspFr_trail_size(susp_fr));
+  stored = SuspFr_stored_bytes(susp_fr);
+  if (stored < size) {
+    /* release the unused part of the memory block */
+    ALLOC_BLOCK(block, stored, void *);
+    memcpy(block, SuspFr_global_start(susp_fr), stored);
+    FREE_BLOCK(SuspFr_global_start(susp_fr));
+    SuspFr_global_start(susp_fr) = block;
+    SuspFr_local_start(susp_fr) = SuspFr_global_start(susp_fr) + SuspFr_global_stored(susp_fr);
+    SuspFr_trail_start(susp_fr) = SuspFr_local_start(susp_fr) + SuspFr_local_stored(susp_fr);
+  }
+
+  /* update the statistics and check the suspension space threshold */
+  __sync_fetch_and_add(&GLOBAL_suspended_branches, 1);
+  __sync_fetch_and_add(&GLOBAL_suspended_total_bytes, stored);
+  __sync_fetch_and_add(&GLOBAL_suspended_total_raw_bytes, size);
+  __sync_fetch_and_add(&GLOBAL_suspended_raw_bytes, size);
+  stored = __sync_add_and_fetch(&GLOBAL_suspended_bytes, stored);
+  while ((peak = GLOBAL_suspended_peak_bytes) < stored)
+    if (__sync_bool_compare_and_swap(&GLOBAL_suspended_peak_bytes, peak, stored))
+      break;
+  if (GLOBAL_suspension_space_threshold && stored > GLOBAL_suspension_space_threshold)
+    /* the threshold is not a ceiling: the branch must be suspended anyway, **
+    ** and the error is raised when the parallel execution ends            */
+    __sync_bool_compare_and_swap(&GLOBAL_suspension_space_exceeded, 0, stored);
+  return;
+}
+
+
+static void restore_suspended_blocks(susp_fr_ptr susp_fr) {
+  restore_suspended_block(SuspFr_global_reg(susp_fr), SuspFr_global_start(susp_fr), SuspFr_global_size(susp_fr), SuspFr_global_stored(susp_fr));
+  restore_suspended_block(SuspFr_local_reg(susp_fr), SuspFr_local_start(susp_fr), SuspFr_local_size(susp_fr), SuspFr_local_stored(susp_fr));
+  restore_suspended_block(SuspFr_trail_reg(susp_fr), SuspFr_trail_start(susp_fr), SuspFr_trail_size(susp_fr), SuspFr_trail_stored(susp_fr));
+  return;
+}
+
+
 static void complete_suspension_branch(susp_fr_ptr susp_fr, choiceptr top_cp, or_fr_ptr *chain_or_fr, dep_fr_ptr *chain_dep_fr) {
   or_fr_ptr aux_or_fr;
   sg_fr_ptr aux_sg_fr;
@@ -114,19 +345,33 @@ void private_completion(sg_fr_ptr sg_fr) {
     LOCAL_top_sg_fr = SgFr_next(aux_sg_fr);
     mark_as_completed(aux_sg_fr);
     insert_into_global_sg_fr_list(aux_sg_fr);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+    schedule_answer_trie_compaction(aux_sg_fr);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
   }
   aux_sg_fr = LOCAL_top_sg_fr;
   LOCAL_top_sg_fr = SgFr_next(aux_sg_fr);
   mark_as_completed(aux_sg_fr);
   insert_into_global_sg_fr_list(aux_sg_fr);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+  schedule_answer_trie_compaction(aux_sg_fr);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
 #else
   while (LOCAL_top_sg_fr != sg_fr) {
     mark_as_completed(LOCAL_top_sg_fr);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+    schedule_answer_trie_compaction(LOCAL_top_sg_fr);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
     LOCAL_top_sg_fr = SgFr_next(LOCAL_top_sg_fr);
   }
   mark_as_completed(LOCAL_top_sg_fr);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+  schedule_answer_trie_compaction(LOCAL_top_sg_fr);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
   LOCAL_top_sg_fr = SgFr_next(LOCAL_top_sg_fr);
 #endif /* LIMIT_TABLING */
+  /* the evaluation is over, thus the thread only reads completed answer tries */
+  leave_epoch();
 
   /* release dependency frames */
   while (EQUAL_OR_YOUNGER_CP(DepFr_cons_cp(LOCAL_top_dep_fr), B)) {  /* never equal if batched scheduling */
@@ -155,6 +400,7 @@ void public_completion(void) {
   susp_fr_ptr susp_fr, next_susp_fr;
   qg_sol_fr_ptr solutions, aux_solutions;
 
+  SCH_trace_begin(TRACE_PUBLIC_COMPLETION);
   if (YOUNGER_CP(Get_LOCAL_top_cp(), B_FZ)) {
     /* the current node is a generator node without younger consumer **
     ** nodes --> we only have the current node to complete           */
@@ -169,6 +415,9 @@ void public_completion(void) {
       top_sg_fr = SgFr_next(GEN_CP(Get_LOCAL_top_cp())->cp_sg_fr);
     do {
       mark_as_completed(LOCAL_top_sg_fr);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+      schedule_answer_trie_compaction(LOCAL_top_sg_fr);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
       LOCAL_top_sg_fr = SgFr_next(LOCAL_top_sg_fr);
     } while (LOCAL_top_sg_fr != top_sg_fr);
 
@@ -185,12 +434,18 @@ void public_completion(void) {
       while (LOCAL_top_sg_fr && 
              EQUAL_OR_YOUNGER_CP(SgFr_gen_cp(LOCAL_top_sg_fr), Get_LOCAL_top_cp())) {
         mark_as_completed(LOCAL_top_sg_fr);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+        schedule_answer_trie_compaction(LOCAL_top_sg_fr);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
         LOCAL_top_sg_fr = SgFr_next(LOCAL_top_sg_fr);
       }
     } else {
       while (LOCAL_top_sg_fr && 
              YOUNGER_CP(SgFr_gen_cp(LOCAL_top_sg_fr), Get_LOCAL_top_cp())) {
         mark_as_completed(LOCAL_top_sg_fr);
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+        schedule_answer_trie_compaction(LOCAL_top_sg_fr);
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
         LOCAL_top_sg_fr = SgFr_next(LOCAL_top_sg_fr);
       }
     }
@@ -267,9 +522,51 @@ void public_completion(void) {
 
   /* adjust top register */
   Set_LOCAL_top_cp_on_stack( Get_LOCAL_top_cp() );
+  SCH_trace_end(TRACE_PUBLIC_COMPLETION);
+
+  return;
+}
+
+
+#ifdef COMPACT_ANSWER_TRIES_AT_COMPLETION
+int compact_queued_answer_trie(void) {
+  sg_fr_ptr sg_fr;
+
+  if (GLOBAL_compaction_queue_entries == 0)
+    return FALSE;
+  LOCK(GLOBAL_locks_compaction_queue);
+  if (GLOBAL_compaction_queue_entries == 0) {
+    UNLOCK(GLOBAL_locks_compaction_queue);
+    return FALSE;
+  }
+  sg_fr = GLOBAL_compaction_queue(GLOBAL_compaction_queue_first);
+  GLOBAL_compaction_queue_first = (GLOBAL_compaction_queue_first + 1) % COMPACTION_QUEUE_SIZE;
+  GLOBAL_compaction_queue_entries--;
+  /* the queue lock is kept while compacting the answer trie, **
+  ** thus abolish_table() cannot release the subgoal frame     */
+  compact_completed_answer_trie(sg_fr);
+  UNLOCK(GLOBAL_locks_compaction_queue);
+  return TRUE;
+}
+
+
+void flush_compaction_queue(tab_ent_ptr tab_ent) {
+  /* removes the queued subgoal frames of tab_ent, keeping the order of the others */
+  int i, entries = 0;
 
+  LOCK(GLOBAL_locks_compaction_queue);
+  for (i = 0; i < GLOBAL_compaction_queue_entries; i++) {
+    sg_fr_ptr sg_fr = GLOBAL_compaction_queue((GLOBAL_compaction_queue_first + i) % COMPACTION_QUEUE_SIZE);
+    if (SgFr_tab_ent(sg_fr) != tab_ent) {
+      GLOBAL_compaction_queue((GLOBAL_compaction_queue_first + entries) % COMPACTION_QUEUE_SIZE) = sg_fr;
+      entries++;
+    }
+  }
+  GLOBAL_compaction_queue_entries = entries;
+  UNLOCK(GLOBAL_locks_compaction_queue);
   return;
 }
+#endif /* COMPACT_ANSWER_TRIES_AT_COMPLETION */
 
 
 void complete_suspension_frames(or_fr_ptr or_fr) {
@@ -344,6 +641,10 @@ void suspend_branch(void) {
   }
 #endif /* DEBUG_OPTYAP */
 
+  SCH_trace_begin(TRACE_SUSPEND_BRANCH);
+  /* store the answers buffered on the branch being suspended */
+  CUT_flush_buffered_answers();
+
   or_frame = Get_LOCAL_top_cp_on_stack()->cp_or_fr;
   LOCK_OR_FRAME(or_frame);
   if (B_FZ == Get_LOCAL_top_cp_on_stack() && OrFr_owners(or_frame) > 1) {
@@ -398,6 +699,7 @@ void suspend_branch(void) {
 
   /* adjust freeze registers */
   adjust_freeze_registers();
+  SCH_trace_end(TRACE_SUSPEND_BRANCH);
 
   return;
 }
@@ -408,16 +710,12 @@ void resume_suspension_frame(susp_fr_ptr resume_fr, or_fr_ptr top_or_fr) {
   or_fr_ptr or_frame;
   sg_fr_ptr sg_frame;
 
+  SCH_trace_begin(TRACE_RESUME_SUSPENSION);
+  /* store the answers buffered on the current branch */
+  CUT_flush_buffered_answers();
+
   /* copy suspended stacks */
-  memcpy(SuspFr_global_reg(resume_fr),
-         SuspFr_global_start(resume_fr),
-         SuspFr_global_size(resume_fr));
-  memcpy(SuspFr_local_reg(resume_fr),
-         SuspFr_local_start(resume_fr),
-         SuspFr_local_size(resume_fr));
-  memcpy(SuspFr_trail_reg(resume_fr),
-         SuspFr_trail_start(resume_fr),
-         SuspFr_trail_size(resume_fr));
+  restore_suspended_blocks(resume_fr);
 
   OPTYAP_ERROR_CHECKING(resume_suspension_frame, DepFr_cons_cp(SuspFr_top_dep_fr(resume_fr))->cp_h != SuspFr_global_reg(resume_fr) + SuspFr_global_size(resume_fr));
   OPTYAP_ERROR_CHECKING(resume_suspension_frame, DepFr_cons_cp(SuspFr_top_dep_fr(resume_fr))->cp_tr != SuspFr_trail_reg(resume_fr) + SuspFr_trail_size(resume_fr));
@@ -458,6 +756,7 @@ void resume_suspension_frame(susp_fr_ptr resume_fr, or_fr_ptr top_or_fr) {
 
   /* free suspension frame */
   FREE_SUSPENSION_FRAME(resume_fr);
+  SCH_trace_end(TRACE_RESUME_SUSPENSION);
 
   return;
 }
@@ -596,7 +596,7 @@
 #if defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
 	if (IsMode_LoadAnswers(TabEnt_mode(tab_ent)) || SgFr_active_workers(sg_fr) > 0) {
 #else
-        if (IsMode_LoadAnswers(TabEnt_mode(tab_ent))) {
+        if (IsMode_LoadAnswers(TabEnt_mode(tab_ent)) && ! IS_COMPACT_ANSWER_TRIE(sg_fr)) {
 #endif /* THREADS_FULL_SHARING || THREADS_CONSUMER_SHARING */
           /* load answers from the trie */
 	  UNLOCK_SG_FR(sg_fr);
@@ -746,7 +746,7 @@
 #if defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
 	if (IsMode_LoadAnswers(TabEnt_mode(tab_ent)) || SgFr_active_workers(sg_fr) > 0) {
 #else
-        if (IsMode_LoadAnswers(TabEnt_mode(tab_ent))) {
+        if (IsMode_LoadAnswers(TabEnt_mode(tab_ent)) && ! IS_COMPACT_ANSWER_TRIE(sg_fr)) {
 #endif /* THREADS_FULL_SHARING || THREADS_CONSUMER_SHARING */
           /* load answers from the trie */
 	  UNLOCK_SG_FR(sg_fr);
@@ -908,7 +908,7 @@
 #if defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
 	if (IsMode_LoadAnswers(TabEnt_mode(tab_ent)) || SgFr_active_workers(sg_fr) > 0) {
 #else
-        if (IsMode_LoadAnswers(TabEnt_mode(tab_ent))) {
+        if (IsMode_LoadAnswers(TabEnt_mode(tab_ent)) && ! IS_COMPACT_ANSWER_TRIE(sg_fr)) {
 #endif /* THREADS_FULL_SHARING || THREADS_CONSUMER_SHARING */
           /* load answers from the trie */
 	  UNLOCK_SG_FR(sg_fr);
@@ -1109,7 +1109,7 @@
           BITMAP_delete(prune_members, worker_id);
           ltt = BRANCH_LTT(worker_id, depth);
           BITMAP_intersection(members, prune_members, OrFr_members(LOCAL_top_or_fr));
-          if (members) {
+          if (! BITMAP_empty(members)) {
             for (i = 0; i < GLOBAL_number_workers; i++) {
               if (BITMAP_member(members, i) && 
                   BRANCH_LTT(i, depth) > ltt && 
@@ -1150,7 +1150,7 @@
           if (depth > until_depth) {
             ltt = BRANCH_LTT(worker_id, depth);
             BITMAP_intersection(members, prune_members, OrFr_members(leftmost_or_fr));
-            if (members) {
+            if (! BITMAP_empty(members)) {
               for (i = 0; i < GLOBAL_number_workers; i++) {
                 if (BITMAP_member(members, i) &&
                     BRANCH_LTT(i, depth) > ltt &&
@@ -1165,7 +1165,7 @@
             while (depth > until_depth) {
               ltt = BRANCH_LTT(worker_id, depth);
               BITMAP_intersection(members, prune_members, OrFr_members(leftmost_or_fr));
-              if (members) {
+              if (! BITMAP_empty(members)) {
                 for (i = 0; i < GLOBAL_number_workers; i++) {
                   if (BITMAP_member(members, i) &&
                       BRANCH_LTT(i, depth) > ltt &&
@@ -1237,6 +1237,9 @@
       }
 #endif /* DEBUG_TABLING */
       UNLOCK_SG_FR(sg_fr);
+#ifdef THREADS_CONSUMER_SHARING
+      signal_answer_event(sg_fr);
+#endif /* THREADS_CONSUMER_SHARING */
       if (IS_BATCHED_GEN_CP(gcp)) {
 #ifdef THREADS_FULL_SHARING
         if (worker_id >= ANSWER_LEAF_NODE_MAX_THREADS)
@@ -1447,6 +1450,7 @@
           start_or_fr = LOCAL_top_or_fr;
           end_or_fr = DepFr_top_or_fr(dep_fr);
           if (start_or_fr != end_or_fr) {
+            SCH_leave_trie_range(GetOrFr_node(end_or_fr));
             LOCAL_top_or_fr = end_or_fr;
             Set_LOCAL_top_cp(GetOrFr_node(end_or_fr));
             do {
@@ -1526,6 +1530,7 @@
         end_or_fr = chain_cp->cp_or_fr;
         start_or_fr = LOCAL_top_or_fr;
         if (start_or_fr != end_or_fr) {
+          SCH_leave_trie_range(GetOrFr_node(end_or_fr));
           LOCAL_top_or_fr = end_or_fr;
           Set_LOCAL_top_cp(GetOrFr_node(end_or_fr));
           while (start_or_fr != end_or_fr) {
@@ -1955,7 +1960,7 @@ complete_all:
 	  remove_from_global_sg_fr_list(sg_fr);
 	  TRAIL_FRAME(sg_fr);
 #endif /* LIMIT_TABLING */
-	  if (IsMode_LoadAnswers(TabEnt_mode(tab_ent))) {
+	  if (IsMode_LoadAnswers(TabEnt_mode(tab_ent)) && ! IS_COMPACT_ANSWER_TRIE(sg_fr)) {
             /* load answers from the trie */
 	    if(TrNode_child(ans_node) != NULL) {
 	      store_loader_node(tab_ent, ans_node);
@@ -2018,6 +2023,8 @@ answer_resolution_completion:
      do {
        dep_fr_ptr dep_fr;
        ans_node_ptr ans_node;
+       sg_fr_ptr wait_sg_fr = NULL;  /* external subgoal to wait for when there are no unconsumed answers */
+       ans_node_ptr wait_ans_node = NULL;
      
 
        do_not_complete_tables = 0; /* 0 - complete all the tables 1 - do not complete all the tables */	
@@ -2045,6 +2052,10 @@ answer_resolution_completion:
 	 sg_fr_ptr sg_fr = GEN_CP(B)->cp_sg_fr;
 	 if (SgFr_sg_ent_state(sg_fr) < complete || (SgFr_sg_ent_state(sg_fr) >= complete && TrNode_child(ans_node)!= NULL))
 	   do_not_complete_tables = 1; 
+	 if (SgFr_sg_ent_state(sg_fr) < complete) {
+	   wait_sg_fr = sg_fr;
+	   wait_ans_node = ans_node;
+	 }
 
        } else {   /* using the B->cp_ap == ANSWER_RESOLUTION_COMPLETION to distinguish gen_cons nodes from gen */
 	 /* generator node */
@@ -2109,7 +2120,10 @@ answer_resolution_completion:
 	   sg_fr_ptr sg_fr = GEN_CP(DepFr_cons_cp(dep_fr))->cp_sg_fr;
 	   if (SgFr_sg_ent_state(sg_fr) < complete || (SgFr_sg_ent_state(sg_fr) >= complete && TrNode_child(ans_node)!= NULL))
 	     do_not_complete_tables = 1;
-	   
+	   if (SgFr_sg_ent_state(sg_fr) < complete) {
+	     wait_sg_fr = sg_fr;
+	     wait_ans_node = ans_node;
+	   }
 	 }
 	 dep_fr = DepFr_next(dep_fr);
        }       
@@ -2118,9 +2132,12 @@ answer_resolution_completion:
 
        if (do_not_complete_tables == 1){
 	 /*all the dependency frames have consumed all answers and we have external tables */
-	 if (ThDepFr_next(GLOBAL_th_dep_fr(wid)) == wid)
-	   /* worker_id is not inside an SCC */
+	 if (ThDepFr_next(GLOBAL_th_dep_fr(wid)) == wid) {
+	   /* worker_id is not inside an SCC --> sleep until the external subgoal has news */
+	   if (wait_sg_fr)
+	     wait_for_answer_event(wait_sg_fr, wait_ans_node);
 	   continue;
+	 }
 	 
 	 if (ThDepFr_state(GLOBAL_th_dep_fr(wid)) == working) {
 	   int c_wid = ThDepFr_next(GLOBAL_th_dep_fr(wid));
@@ -2175,6 +2192,9 @@ answer_resolution_completion:
 	     }while(c_wid != wid);
 	     ThDepFr_state(GLOBAL_th_dep_fr(wid)) = completing;
 	   }
+	   if (wait_sg_fr && ThDepFr_state(GLOBAL_th_dep_fr(wid)) == idle)
+	     /* the other threads of the SCC are still working */
+	     wait_for_answer_event(wait_sg_fr, wait_ans_node);
 	 }else if (ThDepFr_state(GLOBAL_th_dep_fr(wid)) == completing){
 	   INFO_THREADS("ans_reso_com (5) : completing thread_state =%d",ThDepFr_state(GLOBAL_th_dep_fr(wid)));
 	   break;  	     /*do_not_complete_tables = 0;   -- same as "break;" */
@@ -23,12 +23,26 @@
 #ifdef YAPOR
 #include "or.macros.h"
 #endif
+#ifdef THREADS_CONSUMER_SHARING
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <limits.h>
+#include <time.h>
+#else
+#include <sched.h>
+#endif /* __linux__ */
+#endif /* THREADS_CONSUMER_SHARING */
 
 #ifdef THREADS
 static inline void **__get_insert_thread_bucket(void **, lockvar * USES_REGS);
 static inline void **__get_thread_bucket(void ** USES_REGS);
 static inline void abolish_thread_buckets(void **);
 #endif /* THREADS */
+#ifdef TRIE_MIXING_HASH
+static inline CELL trie_hash_mix(CELL);
+#endif /* TRIE_MIXING_HASH */
 static inline sg_node_ptr get_insert_subgoal_trie(tab_ent_ptr USES_REGS);
 static inline sg_node_ptr __get_subgoal_trie(tab_ent_ptr USES_REGS);
 static inline sg_node_ptr get_subgoal_trie_for_abolish(tab_ent_ptr USES_REGS);
@@ -37,12 +51,14 @@ static inline sg_fr_ptr get_subgoal_frame(sg_node_ptr);
 static inline sg_fr_ptr get_subgoal_frame_for_abolish(sg_node_ptr USES_REGS);
 #ifdef THREADS_FULL_SHARING
 static inline void __SgFr_batched_cached_answers_check_insert(sg_fr_ptr, ans_node_ptr USES_REGS);
-static inline int SgFr_batched_cached_answers_check_remove(sg_fr_ptr, ans_node_ptr);
+static inline int __SgFr_batched_cached_answers_check_remove(sg_fr_ptr, ans_node_ptr USES_REGS);
 #endif /* THREADS_FULL_SHARING */
 #ifdef THREADS_CONSUMER_SHARING
 static inline void __add_to_tdv(int, int USES_REGS);
 static inline void __check_for_deadlock(sg_fr_ptr USES_REGS);
 static inline sg_fr_ptr __deadlock_detection(sg_fr_ptr USES_REGS);
+static inline void signal_answer_event(sg_fr_ptr);
+static inline void wait_for_answer_event(sg_fr_ptr, ans_node_ptr);
 #endif /* THREADS_CONSUMER_SHARING */
 static inline Int __freeze_current_cp( USES_REGS1 );
 static inline void __wake_frozen_cp(Int USES_REGS);
@@ -92,6 +108,11 @@ static inline tg_sol_fr_ptr CUT_prune_tg_solution_frames(tg_sol_fr_ptr, int);
 #define Flag_GlobalTrie         0x200
 #define Flags_TrieMode          (Flag_LocalTrie | Flag_GlobalTrie)
 #define Flag_CoInductive        0x008
+#define Flag_Variant            0x400
+#define Flag_Subsumptive        0x800
+#define Flags_CallMode          (Flag_Variant | Flag_Subsumptive)
+#define Flag_Incremental        0x1000
+#define Flag_GroundHash         0x2000
 
 #define SetMode_Batched(X)      (X) = ((X) & ~Flags_SchedulingMode) | Flag_Batched
 #define SetMode_Local(X)        (X) = ((X) & ~Flags_SchedulingMode) | Flag_Local
@@ -100,6 +121,10 @@ static inline tg_sol_fr_ptr CUT_prune_tg_solution_frames(tg_sol_fr_ptr, int);
 #define SetMode_LocalTrie(X)    (X) = ((X) & ~Flags_TrieMode) | Flag_LocalTrie
 #define SetMode_GlobalTrie(X)   (X) = ((X) & ~Flags_TrieMode) | Flag_GlobalTrie
 #define SetMode_CoInductive(X)  (X) = (X) | Flag_CoInductive
+#define SetMode_Variant(X)      (X) = ((X) & ~Flags_CallMode) | Flag_Variant
+#define SetMode_Subsumptive(X)  (X) = ((X) & ~Flags_CallMode) | Flag_Subsumptive
+#define SetMode_Incremental(X)  (X) = (X) | Flag_Incremental
+#define SetMode_GroundHash(X)   (X) = (X) | Flag_GroundHash
 #define IsMode_Batched(X)       ((X) & Flag_Batched)
 #define IsMode_Local(X)         ((X) & Flag_Local)
 #define IsMode_ExecAnswers(X)   ((X) & Flag_ExecAnswers)
@@ -107,6 +132,10 @@ static inline tg_sol_fr_ptr CUT_prune_tg_solution_frames(tg_sol_fr_ptr, int);
 #define IsMode_LocalTrie(X)     ((X) & Flag_LocalTrie)
 #define IsMode_GlobalTrie(X)    ((X) & Flag_GlobalTrie)
 #define IsMode_CoInductive(X)   ((X) & Flag_CoInductive)
+#define IsMode_Variant(X)       ((X) & Flag_Variant)
+#define IsMode_Subsumptive(X)   ((X) & Flag_Subsumptive)
+#define IsMode_Incremental(X)   ((X) & Flag_Incremental)
+#define IsMode_GroundHash(X)    ((X) & Flag_GroundHash)
 
 
 
@@ -137,6 +166,16 @@ typedef enum {
 #define TRAVERSE_POSITION_FIRST    1
 #define TRAVERSE_POSITION_LAST     2
 
+/* ground call hashing */
+#define GROUND_CALL_MIN_CELLS      64
+#define GROUND_CALL_MAX_CELLS      (1 << 20)  /* also bounds the rational terms */
+#define GROUND_CALL_MAX_DEPTH      4096
+#define GROUND_CALL_BASE_BUCKETS   64
+
+/* abolish modes */
+#define ABOLISH_MODE_IMMEDIATE     0
+#define ABOLISH_MODE_DEFERRED      1
+
 /* mode directed tabling */
 #define MODE_DIRECTED_TAGBITS         0xF
 #define MODE_DIRECTED_NUMBER_TAGBITS  4
@@ -181,9 +220,10 @@ typedef enum {
 #endif /* SIZEOF_INT_P */
 #define ANSWER_LEAF_NODE_INSTR_RELATIVE(NODE)  (TrNode_instr(NODE) = TrNode_instr(NODE) - _trie_do_var + 1)
 #define ANSWER_LEAF_NODE_INSTR_ABSOLUTE(NODE)  (TrNode_instr(NODE) = (TrNode_instr(NODE) & ANSWER_LEAF_NODE_INSTR_MASK) + _trie_do_var - 1)
-#define ANSWER_LEAF_NODE_SET_WID(NODE,WID)     BITMAP_insert(TrNode_instr(NODE), WID + ANSWER_LEAF_NODE_INSTR_BITS)
-#define ANSWER_LEAF_NODE_DEL_WID(NODE,WID)     BITMAP_delete(TrNode_instr(NODE), WID + ANSWER_LEAF_NODE_INSTR_BITS)
-#define ANSWER_LEAF_NODE_CHECK_WID(NODE,WID)   BITMAP_member(TrNode_instr(NODE), WID + ANSWER_LEAF_NODE_INSTR_BITS)
+#define ANSWER_LEAF_NODE_WID_BIT(WID)          ((CELL) 1 << ((WID) + ANSWER_LEAF_NODE_INSTR_BITS))
+#define ANSWER_LEAF_NODE_SET_WID(NODE,WID)     (TrNode_instr(NODE) |= ANSWER_LEAF_NODE_WID_BIT(WID))
+#define ANSWER_LEAF_NODE_DEL_WID(NODE,WID)     (TrNode_instr(NODE) &= ~ANSWER_LEAF_NODE_WID_BIT(WID))
+#define ANSWER_LEAF_NODE_CHECK_WID(NODE,WID)   ((TrNode_instr(NODE) & ANSWER_LEAF_NODE_WID_BIT(WID)) != 0)
 
 /* choice points */
 #define NORM_CP(CP)                 ((choiceptr)(CP))
@@ -213,11 +253,44 @@ typedef enum {
 #define UNTAG_SUBGOAL_NODE(NODE)             ((CELL) (NODE) & ~(0x1))
 #define UNTAG_ANSWER_NODE(NODE)              ((CELL) (NODE) & ~(0x3))
 
+/* compact answer tries */
+#ifdef COMPACT_ANSWER_TRIES
+#define TAG_AS_COMPACT_LEAF_NODE(NODE)       CmpNode_offset(NODE) |= 0x1
+#define IS_COMPACT_LEAF_NODE(NODE)           (CmpNode_offset(NODE) & 0x1)
+#define IS_COMPACT_ANSWER_TRIE(SG_FR)        (SgFr_state(SG_FR) >= compiled)
+#define UPDATE_COMPACT_ANSWER_TRIE_NODES(N)  __sync_fetch_and_add(&GLOBAL_cmp_ans_nodes, (N))
+#define SgFr_init_compacted_trie_field(SG_FR)                                                             \
+        SgFr_compacted_trie(SG_FR) = NULL
+#define FREE_SUBGOAL_ANSWER_TRIE(SG_FR)                                                                   \
+        if (IS_COMPACT_ANSWER_TRIE(SG_FR)) {                                                              \
+          FREE_ANSWER_TRIE_SWITCHES(SG_FR);                                                               \
+          free_compact_answer_trie((cmp_node_ptr) TrNode_child(SgFr_answer_trie(SG_FR)));                 \
+          if (SgFr_compacted_trie(SG_FR)) {                                                               \
+            free_answer_trie_nodes(SgFr_compacted_trie(SG_FR));                                           \
+            SgFr_compacted_trie(SG_FR) = NULL;                                                            \
+          }                                                                                               \
+        } else                                                                                            \
+          free_answer_trie(TrNode_child(SgFr_answer_trie(SG_FR)), TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST)
+#else
+#define IS_COMPACT_ANSWER_TRIE(SG_FR)        0
+#define SgFr_init_compacted_trie_field(SG_FR)
+#define FREE_SUBGOAL_ANSWER_TRIE(SG_FR)                                                                   \
+        free_answer_trie(TrNode_child(SgFr_answer_trie(SG_FR)), TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST)
+#endif /* COMPACT_ANSWER_TRIES */
+
 /* trie hashes */
 #define MAX_NODES_PER_TRIE_LEVEL        8
+#define MIN_NODES_PER_TRIE_SWITCH       (4 * MAX_NODES_PER_TRIE_LEVEL)
 #define MAX_NODES_PER_BUCKET            (MAX_NODES_PER_TRIE_LEVEL / 2)
 #define BASE_HASH_BUCKETS               64
-#define HASH_ENTRY(ENTRY, NUM_BUCKETS)  ((((CELL) ENTRY) >> NumberOfLowTagBits) & (NUM_BUCKETS - 1))
+#ifdef TRIE_MIXING_HASH
+#define HASH_KEY(ENTRY)                 trie_hash_mix((CELL) (ENTRY))
+#define HASH_KEY_BITS                   (sizeof(CELL) * 8)
+#else
+#define HASH_KEY(ENTRY)                 (((CELL) (ENTRY)) >> NumberOfLowTagBits)
+#define HASH_KEY_BITS                   (sizeof(CELL) * 8 - NumberOfLowTagBits)
+#endif /* TRIE_MIXING_HASH */
+#define HASH_ENTRY(ENTRY, NUM_BUCKETS)  (HASH_KEY(ENTRY) & (NUM_BUCKETS - 1))
 #define SUBGOAL_TRIE_HASH_MARK          ((Term) MakeTableVarTerm(MAX_TABLE_VARS))
 #define IS_SUBGOAL_TRIE_HASH(NODE)      (TrNode_entry(NODE) == SUBGOAL_TRIE_HASH_MARK)
 #define ANSWER_TRIE_HASH_MARK           0
@@ -225,6 +298,13 @@ typedef enum {
 #define GLOBAL_TRIE_HASH_MARK           ((Term) MakeTableVarTerm(MAX_TABLE_VARS))
 #define IS_GLOBAL_TRIE_HASH(NODE)       (TrNode_entry(NODE) == GLOBAL_TRIE_HASH_MARK)
 #define HASH_TRIE_LOCK(NODE)            GLOBAL_trie_locks((((CELL) (NODE)) >> 5) & (TRIE_LOCK_BUCKETS - 1))
+#define HASH_EXPANSION_STEPS            4  /* old buckets moved by each insertion on an expanding hash */
+#ifdef ANSWER_TRIE_LOCK_FREE
+#define HASH_LEVEL_BITS                 6  /* log2(BASE_HASH_BUCKETS) */
+#define HASH_MAX_SHIFT                  (HASH_KEY_BITS - HASH_LEVEL_BITS)
+#define HASH_ENTRY_AT_LEVEL(ENTRY, NUM_BUCKETS, SHIFT)  ((HASH_KEY(ENTRY) >> (SHIFT)) & (NUM_BUCKETS - 1))
+#define BOOL_CAS(PTR, OLD, NEW)         __sync_bool_compare_and_swap((PTR), (OLD), (NEW))
+#endif /* ANSWER_TRIE_LOCK_FREE */
 
 /* auxiliary stack */
 #define STACK_PUSH_UP(ITEM, STACK)          *--(STACK) = (CELL)(ITEM)
@@ -374,6 +454,12 @@ typedef enum {
         AnsHash_init_previous_field(HASH, SG_FR);  \
         Hash_next(HASH) = SgFr_hash_chain(SG_FR);  \
 	SgFr_hash_chain(SG_FR) = HASH
+#elif defined(ANSWER_TRIE_LOCK_FREE)
+#define LOCK_ANSWER_TRIE(SG_FR)
+#define UNLOCK_ANSWER_TRIE(SG_FR)
+#define AnsHash_init_chain_fields(HASH, SG_FR)                      \
+        do Hash_next(HASH) = SgFr_hash_chain(SG_FR);                \
+        while (! BOOL_CAS(&SgFr_hash_chain(SG_FR), Hash_next(HASH), HASH))
 #else
 #define LOCK_ANSWER_TRIE(SG_FR)
 #define UNLOCK_ANSWER_TRIE(SG_FR)
@@ -449,8 +535,12 @@ typedef enum {
 #ifdef THREADS_CONSUMER_SHARING
 #define DepFr_init_external_field(DEP_FR, IS_EXTERNAL)          \
         DepFr_external(DEP_FR) = IS_EXTERNAL
+#define SgEnt_init_answer_events_fields(SG_ENT)                 \
+        SgEnt_answer_events(SG_ENT) = 0;                        \
+        SgEnt_waiting_workers(SG_ENT) = 0
 #else
 #define DepFr_init_external_field(DEP_FR, IS_EXTERNAL)
+#define SgEnt_init_answer_events_fields(SG_ENT)
 #endif /* THREADS_CONSUMER_SHARING */
 
 #if defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
@@ -489,6 +579,7 @@ typedef enum {
         SetMode_Batched(TabEnt_flags(TAB_ENT));                        \
         SetMode_ExecAnswers(TabEnt_flags(TAB_ENT));                    \
         SetMode_LocalTrie(TabEnt_flags(TAB_ENT));                      \
+        SetMode_Variant(TabEnt_flags(TAB_ENT));                        \
         TabEnt_mode(TAB_ENT) = TabEnt_flags(TAB_ENT);                  \
         if (IsMode_Local(yap_flags[TABLING_MODE_FLAG]))                \
           SetMode_Local(TabEnt_mode(TAB_ENT));                         \
@@ -496,8 +587,12 @@ typedef enum {
           SetMode_LoadAnswers(TabEnt_mode(TAB_ENT));                   \
         if (IsMode_GlobalTrie(yap_flags[TABLING_MODE_FLAG]))           \
           SetMode_GlobalTrie(TabEnt_mode(TAB_ENT));                    \
+        if (IsMode_Subsumptive(yap_flags[TABLING_MODE_FLAG]))          \
+          SetMode_Subsumptive(TabEnt_mode(TAB_ENT));                   \
         TabEnt_init_mode_directed_field(TAB_ENT, MODE_ARRAY);          \
         TabEnt_init_subgoal_trie_field(TAB_ENT);                       \
+        TabEnt_init_incremental_fields(TAB_ENT);                       \
+        TabEnt_init_ground_calls_field(TAB_ENT);                       \
         TabEnt_next(TAB_ENT) = GLOBAL_root_tab_ent;                    \
         GLOBAL_root_tab_ent = TAB_ENT
 
@@ -512,6 +607,7 @@ typedef enum {
           SgEnt_last_answer(SG_ENT) = NULL;		            \
           SgEnt_sg_ent_state(SG_ENT) = ready;		 	    \
           SgEnt_active_workers(SG_ENT) = 0;                         \
+          SgEnt_init_answer_events_fields(SG_ENT);                  \
           INIT_BUCKETS(&SgEnt_sg_fr(SG_ENT), THREADS_NUM_BUCKETS);  \
         }
 
@@ -538,12 +634,17 @@ typedef enum {
           SgFr_answer_trie(SG_FR) = ans_node;                      \
           SgFr_first_answer(SG_FR) = NULL;                         \
           SgFr_last_answer(SG_FR) = NULL;                          \
+          SgFr_init_answer_switches_field(SG_FR);                  \
+          SgFr_init_compacted_trie_field(SG_FR);                   \
 	  SgFr_init_mode_directed_fields(SG_FR, MODE_ARRAY);	   \
+	  SgFr_init_limit_tabling_fields(SG_FR);		   \
+	  SgFr_init_incremental_fields(SG_FR);			   \
           SgFr_state(SG_FR) = ready;                               \
 	}
 
 #define init_subgoal_frame(SG_FR)                                  \
-        { SgFr_init_yapor_fields(SG_FR);                           \
+        { step_deferred_abolish();                                 \
+          SgFr_init_yapor_fields(SG_FR);                           \
           SgFr_state(SG_FR) = evaluating;                          \
           SgFr_next(SG_FR) = LOCAL_top_sg_fr;                      \
           LOCAL_top_sg_fr = SG_FR;                                 \
@@ -569,15 +670,10 @@ typedef enum {
         SuspFr_global_reg(SUSP_FR) = (void *) (H_REG);                                 \
         SuspFr_local_reg(SUSP_FR) = (void *) (B_REG);                                  \
         SuspFr_trail_reg(SUSP_FR) = (void *) (TR_REG);                                 \
-        ALLOC_BLOCK(SuspFr_global_start(SUSP_FR), H_SIZE + B_SIZE + TR_SIZE, void *);  \
-        SuspFr_local_start(SUSP_FR) = SuspFr_global_start(SUSP_FR) + H_SIZE;           \
-        SuspFr_trail_start(SUSP_FR) = SuspFr_local_start(SUSP_FR) + B_SIZE;            \
         SuspFr_global_size(SUSP_FR) = H_SIZE;                                          \
         SuspFr_local_size(SUSP_FR) = B_SIZE;                                           \
         SuspFr_trail_size(SUSP_FR) = TR_SIZE;                                          \
-        memcpy(SuspFr_global_start(SUSP_FR), SuspFr_global_reg(SUSP_FR), H_SIZE);      \
-        memcpy(SuspFr_local_start(SUSP_FR), SuspFr_local_reg(SUSP_FR), B_SIZE);        \
-        memcpy(SuspFr_trail_start(SUSP_FR), SuspFr_trail_reg(SUSP_FR), TR_SIZE)
+        store_suspended_blocks(SUSP_FR)
 
 #define new_subgoal_trie_node(NODE, ENTRY, CHILD, PARENT, NEXT)  \
         ALLOC_SUBGOAL_TRIE_NODE(NODE);                           \
@@ -615,7 +711,8 @@ typedef enum {
         Hash_mark(HASH) = SUBGOAL_TRIE_HASH_MARK;               \
         Hash_num_buckets(HASH) = BASE_HASH_BUCKETS;             \
         ALLOC_BUCKETS(Hash_buckets(HASH), BASE_HASH_BUCKETS);   \
-        Hash_num_nodes(HASH) = NUM_NODES
+        Hash_num_nodes(HASH) = NUM_NODES;                       \
+        Hash_init_expansion_fields(HASH)
 
 #define new_answer_trie_hash(HASH, NUM_NODES, SG_FR)            \
         ALLOC_ANSWER_TRIE_HASH(HASH);                           \
@@ -623,49 +720,234 @@ typedef enum {
         Hash_num_buckets(HASH) = BASE_HASH_BUCKETS;             \
         ALLOC_BUCKETS(Hash_buckets(HASH), BASE_HASH_BUCKETS);   \
         Hash_num_nodes(HASH) = NUM_NODES;                       \
+        Hash_init_expansion_fields(HASH);                       \
         AnsHash_init_chain_fields(HASH, SG_FR)
 
+#ifdef ANSWER_TRIE_LOCK_FREE
+/* the hash is not yet published, thus it is not inserted in the subgoal frame chain */
+#define new_lock_free_answer_trie_hash(HASH, NUM_NODES, OLD_CHAIN, SHIFT)  \
+        ALLOC_ANSWER_TRIE_HASH(HASH);                                      \
+        Hash_mark(HASH) = ANSWER_TRIE_HASH_MARK;                           \
+        Hash_num_buckets(HASH) = BASE_HASH_BUCKETS;                        \
+        ALLOC_BUCKETS(Hash_buckets(HASH), BASE_HASH_BUCKETS);              \
+        Hash_num_nodes(HASH) = NUM_NODES;                                  \
+        Hash_init_expansion_fields(HASH);                                  \
+        Hash_old_chain(HASH) = OLD_CHAIN;                                  \
+        Hash_shift(HASH) = SHIFT
+#endif /* ANSWER_TRIE_LOCK_FREE */
+
 #define new_global_trie_hash(HASH, NUM_NODES)                   \
         ALLOC_GLOBAL_TRIE_HASH(HASH);                           \
         Hash_mark(HASH) = GLOBAL_TRIE_HASH_MARK;                \
         Hash_num_buckets(HASH) = BASE_HASH_BUCKETS;             \
         ALLOC_BUCKETS(Hash_buckets(HASH), BASE_HASH_BUCKETS);   \
-	Hash_num_nodes(HASH) = NUM_NODES
+	Hash_num_nodes(HASH) = NUM_NODES;                       \
+        Hash_init_expansion_fields(HASH)
+
+#ifdef INCREMENTAL_HASH_EXPANSION
+#define Hash_init_expansion_fields(HASH)                                                 \
+        Hash_old_buckets(HASH) = NULL
+
+/* doubles the number of buckets, the nodes are left in the old buckets */
+#define START_TRIE_HASH_EXPANSION(HASH, NODE_PTR)                                        \
+        { NODE_PTR *new_hash_buckets;                                                    \
+          ALLOC_BUCKETS(new_hash_buckets, Hash_num_buckets(HASH) * 2);                   \
+          Hash_old_buckets(HASH) = Hash_buckets(HASH);                                   \
+          Hash_old_buckets_left(HASH) = Hash_num_buckets(HASH);                          \
+          Hash_buckets(HASH) = new_hash_buckets;                                         \
+          Hash_num_buckets(HASH) = Hash_num_buckets(HASH) * 2;                           \
+        }
+
+#define MOVE_TRIE_HASH_OLD_BUCKET(HASH, OLD_BUCKET, NODE_PTR)                            \
+        { NODE_PTR move_node, move_next_node, *move_bucket;                              \
+          move_node = *(OLD_BUCKET);                                                     \
+          while (move_node) {                                                            \
+            move_bucket = Hash_buckets(HASH) + HASH_ENTRY(TrNode_entry(move_node), Hash_num_buckets(HASH)); \
+            move_next_node = TrNode_next(move_node);                                     \
+            TrNode_next(move_node) = *move_bucket;                                       \
+            *move_bucket = move_node;                                                    \
+            move_node = move_next_node;                                                  \
+          }                                                                              \
+          *(OLD_BUCKET) = NULL;                                                          \
+        }
+
+/* moves the old bucket where ENTRY may be, so that it can be searched in the new buckets */
+#define MOVE_TRIE_HASH_ENTRY(HASH, ENTRY, NODE_PTR)                                      \
+        do {                                                                             \
+          if (Hash_old_buckets(HASH)) {                                                  \
+            NODE_PTR *entry_old_bucket;                                                  \
+            entry_old_bucket = Hash_old_buckets(HASH) + HASH_ENTRY(ENTRY, Hash_num_buckets(HASH) / 2); \
+            MOVE_TRIE_HASH_OLD_BUCKET(HASH, entry_old_bucket, NODE_PTR);                 \
+          }                                                                              \
+        } while (0)
+
+/* moves the next STEPS old buckets and frees the old buckets when all have been moved */
+#define STEP_TRIE_HASH_EXPANSION(HASH, NODE_PTR, STEPS)                                  \
+        do {                                                                             \
+          if (Hash_old_buckets(HASH)) {                                                  \
+            NODE_PTR *step_old_bucket;                                                   \
+            int steps = STEPS;                                                           \
+            while (steps-- && Hash_old_buckets_left(HASH)) {                             \
+              step_old_bucket = Hash_old_buckets(HASH) + --Hash_old_buckets_left(HASH);  \
+              MOVE_TRIE_HASH_OLD_BUCKET(HASH, step_old_bucket, NODE_PTR);                \
+            }                                                                            \
+            if (Hash_old_buckets_left(HASH) == 0) {                                      \
+              FREE_BUCKETS(Hash_old_buckets(HASH));                                      \
+              Hash_old_buckets(HASH) = NULL;                                             \
+            }                                                                            \
+          }                                                                              \
+        } while (0)
+
+#define FINISH_TRIE_HASH_EXPANSION(HASH, NODE_PTR)                                       \
+        STEP_TRIE_HASH_EXPANSION(HASH, NODE_PTR, Hash_old_buckets_left(HASH))
+
+/* the read-only traversals do not move the old buckets, they visit both bucket arrays */
+#define TRIE_HASH_BUCKET_ARRAYS(HASH)             (Hash_old_buckets(HASH) ? 2 : 1)
+#define TRIE_HASH_BUCKET_ARRAY(HASH, ARRAY)       ((ARRAY) ? Hash_old_buckets(HASH) : Hash_buckets(HASH))
+#define TRIE_HASH_BUCKET_ARRAY_SIZE(HASH, ARRAY)  ((ARRAY) ? Hash_num_buckets(HASH) / 2 : Hash_num_buckets(HASH))
+#else
+#define Hash_init_expansion_fields(HASH)
+#define MOVE_TRIE_HASH_ENTRY(HASH, ENTRY, NODE_PTR)
+#define FINISH_TRIE_HASH_EXPANSION(HASH, NODE_PTR)
+#define TRIE_HASH_BUCKET_ARRAYS(HASH)             1
+#define TRIE_HASH_BUCKET_ARRAY(HASH, ARRAY)       Hash_buckets(HASH)
+#define TRIE_HASH_BUCKET_ARRAY_SIZE(HASH, ARRAY)  Hash_num_buckets(HASH)
+#endif /* INCREMENTAL_HASH_EXPANSION */
 
 #ifdef LIMIT_TABLING
-#define insert_into_global_sg_fr_list(SG_FR)                                 \
-        SgFr_previous(SG_FR) = GLOBAL_last_sg_fr;                            \
-        SgFr_next(SG_FR) = NULL;                                             \
-        if (GLOBAL_first_sg_fr == NULL)                                      \
-          GLOBAL_first_sg_fr = SG_FR;                                        \
-        else                                                                 \
-          SgFr_next(GLOBAL_last_sg_fr) = SG_FR;                              \
-        GLOBAL_last_sg_fr = SG_FR
-#define remove_from_global_sg_fr_list(SG_FR)                                 \
-        if (SgFr_previous(SG_FR)) {                                          \
-          if ((SgFr_next(SgFr_previous(SG_FR)) = SgFr_next(SG_FR)) != NULL)  \
-            SgFr_previous(SgFr_next(SG_FR)) = SgFr_previous(SG_FR);          \
-          else                                                               \
-            GLOBAL_last_sg_fr = SgFr_previous(SG_FR);                        \
-        } else {                                                             \
-          if ((GLOBAL_first_sg_fr = SgFr_next(SG_FR)) != NULL)               \
-            SgFr_previous(SgFr_next(SG_FR)) = NULL;                          \
-          else                                                               \
-            GLOBAL_last_sg_fr = NULL;                                        \
-	}                                                                    \
-        if (GLOBAL_check_sg_fr == SG_FR)                                     \
-          GLOBAL_check_sg_fr = SgFr_previous(SG_FR)
+#define insert_into_global_sg_fr_list(SG_FR)                                  \
+        SgFr_timestamp(SG_FR) = ++LOCAL_lru_clock;                            \
+        SgFr_previous(SG_FR) = LOCAL_last_sg_fr;                              \
+        SgFr_next(SG_FR) = NULL;                                              \
+        if (LOCAL_first_sg_fr == NULL)                                        \
+          LOCAL_first_sg_fr = SG_FR;                                          \
+        else                                                                  \
+          SgFr_next(LOCAL_last_sg_fr) = SG_FR;                                \
+        LOCAL_last_sg_fr = SG_FR
+#define remove_from_global_sg_fr_list(SG_FR)                                  \
+        if (SgFr_timestamp(SG_FR)) {                                          \
+          if (SgFr_previous(SG_FR)) {                                         \
+            if ((SgFr_next(SgFr_previous(SG_FR)) = SgFr_next(SG_FR)) != NULL) \
+              SgFr_previous(SgFr_next(SG_FR)) = SgFr_previous(SG_FR);         \
+            else                                                              \
+              LOCAL_last_sg_fr = SgFr_previous(SG_FR);                        \
+          } else {                                                            \
+            if ((LOCAL_first_sg_fr = SgFr_next(SG_FR)) != NULL)               \
+              SgFr_previous(SgFr_next(SG_FR)) = NULL;                         \
+            else                                                              \
+              LOCAL_last_sg_fr = NULL;                                        \
+	  }                                                                   \
+          SgFr_timestamp(SG_FR) = 0;                                          \
+        }
+#define update_global_sg_fr_list(SG_FR)                                       \
+        SgFr_timestamp(SG_FR) = ++LOCAL_lru_clock
+#define SgFr_init_limit_tabling_fields(SG_FR)                                 \
+        SgFr_timestamp(SG_FR) = 0
 #else
 #define insert_into_global_sg_fr_list(SG_FR)
 #define remove_from_global_sg_fr_list(SG_FR)
+#define update_global_sg_fr_list(SG_FR)
+#define SgFr_init_limit_tabling_fields(SG_FR)
 #endif /* LIMIT_TABLING */
 
+#ifdef ANSWER_TRIE_SWITCHES
+#define SgFr_init_answer_switches_field(SG_FR)                                \
+        SgFr_answer_switches(SG_FR) = NULL
+#define FREE_ANSWER_TRIE_SWITCHES(SG_FR)                                      \
+        if (SgFr_answer_switches(SG_FR)) {                                    \
+          FREE_BLOCK(SgFr_answer_switches(SG_FR));                            \
+          SgFr_answer_switches(SG_FR) = NULL;                                 \
+        }
+#else
+#define SgFr_init_answer_switches_field(SG_FR)
+#define FREE_ANSWER_TRIE_SWITCHES(SG_FR)
+#endif /* ANSWER_TRIE_SWITCHES */
+
+#ifdef INCREMENTAL_TABLING
+#define TabEnt_init_incremental_fields(TAB_ENT)                               \
+        TabEnt_generation(TAB_ENT) = 0;                                       \
+        TabEnt_retired_sg_fr(TAB_ENT) = NULL
+#define SgFr_init_incremental_fields(SG_FR)                                   \
+        SgFr_inc_dependents(SG_FR) = NULL;                                    \
+        SgFr_inc_invalid(SG_FR) = FALSE
+#define new_incremental_dependency(INC_DEP, SG_FR, NEXT)                      \
+        ALLOC_INCREMENTAL_DEPENDENCY(INC_DEP);                                \
+        IncDep_sg_fr(INC_DEP) = SG_FR;                                        \
+        IncDep_tab_ent(INC_DEP) = SgFr_tab_ent(SG_FR);                        \
+        IncDep_generation(INC_DEP) = TabEnt_generation(SgFr_tab_ent(SG_FR));  \
+        IncDep_next(INC_DEP) = NEXT
+#else
+#define TabEnt_init_incremental_fields(TAB_ENT)
+#define SgFr_init_incremental_fields(SG_FR)
+#endif /* INCREMENTAL_TABLING */
+
+#ifdef GROUND_CALL_HASHING
+#define TabEnt_init_ground_calls_field(TAB_ENT)                               \
+        TabEnt_ground_calls(TAB_ENT) = NULL
+#else
+#define TabEnt_init_ground_calls_field(TAB_ENT)
+#endif /* GROUND_CALL_HASHING */
+
+#ifdef DEFERRED_ABOLISH
+/* each new subgoal call frees a first level subtrie of the abolished tables */
+#define step_deferred_abolish()                                               \
+        if (GLOBAL_abolished_tries)                                           \
+          free_abolished_subtrie()
+#else
+#define step_deferred_abolish()
+#endif /* DEFERRED_ABOLISH */
+
+#ifdef EPOCH_RECLAMATION
+/* a thread announces the current epoch before reading the answer tries, see  **
+** reclaim_invalid_answers() in tab.tries.c. While an evaluation is running,  **
+** the thread keeps the epoch of its entry, as its consumer nodes may still   **
+** point to answers retired meanwhile. A thread leaves the tables with        **
+** NO_EPOCH, and thus holds no answers, when its top evaluation completes or  **
+** show_table() ends without loader or trie instruction nodes left to run     */
+#define NO_EPOCH  (-1)
+#define enter_epoch()                                                         \
+        if (LOCAL_top_sg_fr == NULL) {                                        \
+          reclaim_invalid_answers();                                          \
+          LOCAL_epoch = GLOBAL_epoch;                                         \
+          __sync_synchronize();                                               \
+        }
+#define leave_epoch()                                                         \
+        if (LOCAL_top_sg_fr == NULL) {                                        \
+          LOCAL_epoch = oldest_loading_choice_point() ? GLOBAL_epoch : NO_EPOCH; \
+          __sync_synchronize();                                               \
+        }
+#else
+#define enter_epoch()
+#define leave_epoch()
+#endif /* EPOCH_RECLAMATION */
+
 
 
 /******************************
 **      Inline funcions      **
 ******************************/
 
+#ifdef TRIE_MIXING_HASH
+static inline CELL trie_hash_mix(CELL key) {
+  /* murmur3 finalization mix, as in C/exo.c */
+#if SIZEOF_INT_P == 8
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+#else
+  key ^= key >> 16;
+  key *= 0x85ebca6b;
+  key ^= key >> 13;
+  key *= 0xc2b2ae35;
+  key ^= key >> 16;
+#endif /* SIZEOF_INT_P */
+  return key;
+}
+#endif /* TRIE_MIXING_HASH */
+
+
 #ifdef THREADS
 #define get_insert_thread_bucket(b, bl) __get_insert_thread_bucket((b), (bl) PASS_REGS)
 
@@ -801,9 +1083,11 @@ static inline sg_fr_ptr *get_insert_subgoal_frame_addr(sg_node_ptr sg_node USES_
 
 static inline sg_fr_ptr get_subgoal_frame(sg_node_ptr sg_node) {
 #if defined(THREADS_SUBGOAL_SHARING)
+  CACHE_REGS
   sg_fr_ptr *sg_fr_addr = (sg_fr_ptr *) get_thread_bucket((void **) UNTAG_SUBGOAL_NODE(TrNode_sg_fr(sg_node)));
   return *sg_fr_addr;
 #elif defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
+  CACHE_REGS
   sg_fr_ptr *sg_fr_addr = (sg_fr_ptr *) get_thread_bucket((void **) &SgEnt_sg_fr((sg_ent_ptr) UNTAG_SUBGOAL_NODE(TrNode_sg_fr(sg_node))));
   return *sg_fr_addr;
 #else
@@ -837,7 +1121,7 @@ static inline sg_fr_ptr get_subgoal_frame_for_abolish(sg_node_ptr sg_node USES_R
 
 #ifdef THREADS_FULL_SHARING
 #define SgFr_batched_cached_answers_check_insert(s, a) __SgFr_batched_cached_answers_check_insert((s), (a) PASS_REGS)
-static inline void SgFr_batched_cached_answers_check_insert(sg_fr_ptr sg_fr, ans_node_ptr ans_node USES_REGS) {
+static inline void __SgFr_batched_cached_answers_check_insert(sg_fr_ptr sg_fr, ans_node_ptr ans_node USES_REGS) {
 
   if (SgFr_batched_last_answer(sg_fr) == NULL)
     SgFr_batched_last_answer(sg_fr) = SgFr_first_answer(sg_fr);
@@ -867,7 +1151,7 @@ static inline void SgFr_batched_cached_answers_check_insert(sg_fr_ptr sg_fr, ans
 
 #define SgFr_batched_cached_answers_check_remove(s, a) __SgFr_batched_cached_answers_check_remove((s), (a) PASS_REGS)
 
-static inline int __SgFr_batched_cached_answers_check_remove(sg_fr_ptr sg_fr, ans_node_ptr ans_node USES_REgS) {
+static inline int __SgFr_batched_cached_answers_check_remove(sg_fr_ptr sg_fr, ans_node_ptr ans_node USES_REGS) {
   struct answer_ref_node *local_uncons_ans;
 
   local_uncons_ans = SgFr_batched_cached_answers(sg_fr) ; 
@@ -940,6 +1224,7 @@ static inline void __add_to_tdv(int wid, int wid_dep USES_REGS) {
 }
 
 #define check_for_deadlock(s) __check_for_deadlock((s) PASS_REGS)
+#define deadlock_detection(s) __deadlock_detection((s) PASS_REGS)
 
 static inline void __check_for_deadlock(sg_fr_ptr sg_fr USES_REGS) {
   sg_fr_ptr local_sg_fr = deadlock_detection(sg_fr);
@@ -954,8 +1239,6 @@ static inline void __check_for_deadlock(sg_fr_ptr sg_fr USES_REGS) {
   return; 
 }
 
-#define deadlock_detection(s) __deadlock_detection((s) PASS_REGS)
-
 static inline sg_fr_ptr __deadlock_detection(sg_fr_ptr sg_fr USES_REGS) {
   sg_fr_ptr remote_sg_fr = REMOTE_top_sg_fr(SgFr_gen_worker(sg_fr));
 
@@ -987,6 +1270,41 @@ static inline sg_fr_ptr __deadlock_detection(sg_fr_ptr sg_fr USES_REGS) {
   }
   return NULL;
 }
+
+
+/* a new answer or the completion of a subgoal wakes up the workers waiting on its entry */
+static inline void signal_answer_event(sg_fr_ptr sg_fr) {
+  __sync_fetch_and_add(&SgFr_answer_events(sg_fr), 1);
+  if (SgFr_waiting_workers(sg_fr) > 0) {
+#ifdef __linux__
+    syscall(SYS_futex, &SgFr_answer_events(sg_fr), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#endif /* __linux__ */
+  }
+  return;
+}
+
+
+/* sleeps until a new answer is found for the subgoal (after ans_node), the subgoal  **
+** is completed or ANSWER_EVENT_WAIT_USECS go by. The timeout is needed because the  **
+** worker may be waiting for several subgoals and for the state of the other workers **
+** of its SCC, while it can only sleep on the entry of one of these subgoals         */
+static inline void wait_for_answer_event(sg_fr_ptr sg_fr, ans_node_ptr ans_node) {
+  int events = SgFr_answer_events(sg_fr);
+
+  __sync_fetch_and_add(&SgFr_waiting_workers(sg_fr), 1);
+  if (TrNode_child(ans_node) == NULL && SgFr_sg_ent_state(sg_fr) < complete) {
+#ifdef __linux__
+    struct timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = ANSWER_EVENT_WAIT_USECS * 1000;
+    syscall(SYS_futex, &SgFr_answer_events(sg_fr), FUTEX_WAIT_PRIVATE, events, &timeout, NULL, 0);
+#else
+    sched_yield();
+#endif /* __linux__ */
+  }
+  __sync_fetch_and_sub(&SgFr_waiting_workers(sg_fr), 1);
+  return;
+}
 #endif /* THREADS_CONSUMER_SHARING */
 
 #define freeze_current_cp() __freeze_current_cp( PASS_REGS1 )
@@ -1062,6 +1380,9 @@ static inline void __mark_as_completed(sg_fr_ptr sg_fr USES_REGS) {
 #endif /* THREADS_FULL_SHARING || THREADS_CONSUMER_SHARING */
   SgFr_state(sg_fr) = complete;
   UNLOCK_SG_FR(sg_fr);
+#ifdef THREADS_CONSUMER_SHARING
+  signal_answer_event(sg_fr);
+#endif /* THREADS_CONSUMER_SHARING */
 #ifdef MODE_DIRECTED_TABLING
   if (SgFr_invalid_chain(sg_fr)) {
     ans_node_ptr current_node, next_node;
@@ -1089,6 +1410,9 @@ static inline void __mark_as_completed(sg_fr_ptr sg_fr USES_REGS) {
       FREE_ANSWER_TRIE_NODE(current_node);
       current_node = next_node;
     }
+#elif defined(EPOCH_RECLAMATION)
+    /* other threads may still be reading the invalid answer nodes */
+    retire_invalid_answers(sg_fr);
 #endif /* !THREADS_FULL_SHARING && !THREADS_CONSUMER_SHARING */
   }
 #endif /* MODE_DIRECTED_TABLING */
@@ -1355,6 +1679,9 @@ static inline void __abolish_incomplete_subgoals(choiceptr prune_cp USES_REGS) {
 	TrNode_child(SgFr_answer_trie(sg_fr)) = NULL;
 	UNLOCK_SG_FR(sg_fr);
 	free_answer_trie(node, TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST);
+#ifdef EPOCH_RECLAMATION
+	retire_invalid_answers(sg_fr);
+#endif /* EPOCH_RECLAMATION */
 #ifdef THREADS_FULL_SHARING
         if (IsMode_Batched(TabEnt_mode(SgFr_tab_ent(sg_fr)))) {
 	  SgFr_batched_last_answer(sg_fr) = NULL;
@@ -37,6 +37,13 @@ typedef struct table_entry {
   struct subgoal_trie_node *subgoal_trie;
 #endif /* THREADS_NO_SHARING */
   struct subgoal_trie_hash *hash_chain;
+#ifdef INCREMENTAL_TABLING
+  UInt generation;
+  struct subgoal_frame *retired_subgoals;
+#endif /* INCREMENTAL_TABLING */
+#ifdef GROUND_CALL_HASHING
+  struct ground_call_hash *ground_calls;
+#endif /* GROUND_CALL_HASHING */
   struct table_entry *next;
 } *tab_ent_ptr;
 
@@ -49,6 +56,9 @@ typedef struct table_entry {
 #define TabEnt_mode_directed(X)   ((X)->mode_directed_array)
 #define TabEnt_subgoal_trie(X)    ((X)->subgoal_trie)
 #define TabEnt_hash_chain(X)      ((X)->hash_chain)
+#define TabEnt_generation(X)      ((X)->generation)
+#define TabEnt_retired_sg_fr(X)   ((X)->retired_subgoals)
+#define TabEnt_ground_calls(X)    ((X)->ground_calls)
 #define TabEnt_next(X)            ((X)->next)
 
 
@@ -81,6 +91,21 @@ typedef struct answer_trie_node {
 #endif /* ANSWER_TRIE_LOCK_USING_NODE_FIELD */
 } *ans_node_ptr;
 
+#ifdef COMPACT_ANSWER_TRIES
+typedef struct compact_answer_trie_node {
+  OPCODE trie_instruction;  /* u.opc */
+#ifdef YAPOR
+  int or_arg;               /* u.Otapl.or_arg */
+#endif /* YAPOR */
+  unsigned int next;
+  Term entry;
+} *cmp_node_ptr;
+
+typedef cmp_node_ptr ans_inst_node_ptr;
+#else
+typedef ans_node_ptr ans_inst_node_ptr;
+#endif /* COMPACT_ANSWER_TRIES */
+
 typedef struct global_trie_node {
   Term entry;
   struct global_trie_node *parent;
@@ -101,6 +126,44 @@ typedef struct global_trie_node {
 #define TrNode_next(X)    ((X)->next)
 #define TrNode_lock(X)    ((X)->lock)
 
+/* compact answer trie nodes are stored in depth-first order, thus the first child **
+** of a node is the node that follows it and the 'next' field keeps the offset to  **
+** its next sibling node (0 for the last sibling) shifted by one bit to leave room **
+** for the leaf flag                                                                */
+#define CmpNode_instr(X)    ((X)->trie_instruction)
+#define CmpNode_or_arg(X)   ((X)->or_arg)
+#define CmpNode_entry(X)    ((X)->entry)
+#define CmpNode_offset(X)   ((X)->next)
+#define CmpNode_child(X)    ((X) + 1)
+#define CmpNode_next(X)     ((X)->next >> 1 ? (X) + ((X)->next >> 1) : NULL)
+
+#ifdef ANSWER_TRIE_SWITCHES
+typedef struct answer_trie_switch {
+  struct compact_answer_trie_node *level;
+  unsigned int num_buckets;
+  unsigned int num_var_nodes;
+  struct compact_answer_trie_node **buckets;
+  struct compact_answer_trie_node **var_nodes;
+} *ans_sw_ptr;
+
+typedef struct answer_trie_switch_table {
+  int num_switches;
+  struct answer_trie_switch *switches;
+} *ans_sw_tab_ptr;
+
+/* a switch indexes the atomic nodes of a wide level of a compact answer trie by    **
+** their entries (open addressing), the trie variable nodes of the level are kept   **
+** apart in the order of the level. The switches of a compact answer trie are kept **
+** in a single block, in the order of the levels in the trie                        */
+#define AnsSw_level(X)              ((X)->level)
+#define AnsSw_num_buckets(X)        ((X)->num_buckets)
+#define AnsSw_num_var_nodes(X)      ((X)->num_var_nodes)
+#define AnsSw_buckets(X)            ((X)->buckets)
+#define AnsSw_var_nodes(X)          ((X)->var_nodes)
+#define AnsSwTab_num_switches(X)    ((X)->num_switches)
+#define AnsSwTab_switches(X)        ((X)->switches)
+#endif /* ANSWER_TRIE_SWITCHES */
+
 
 
 /******************************
@@ -132,6 +195,10 @@ typedef struct subgoal_trie_hash {
   int number_of_buckets;
   struct subgoal_trie_node **buckets;
   int number_of_nodes;
+#ifdef INCREMENTAL_HASH_EXPANSION
+  struct subgoal_trie_node **old_buckets;  /* NULL if not expanding */
+  int old_buckets_left;                   /* old buckets not yet moved */
+#endif /* INCREMENTAL_HASH_EXPANSION */
 #ifdef USE_PAGES_MALLOC
   struct subgoal_trie_hash *next;
 #endif /* USE_PAGES_MALLOC */
@@ -144,6 +211,14 @@ typedef struct answer_trie_hash {
   int number_of_buckets;
   struct answer_trie_node **buckets;
   int number_of_nodes;
+#ifdef INCREMENTAL_HASH_EXPANSION
+  struct answer_trie_node **old_buckets;  /* NULL if not expanding */
+  int old_buckets_left;                   /* old buckets not yet moved */
+#endif /* INCREMENTAL_HASH_EXPANSION */
+#ifdef ANSWER_TRIE_LOCK_FREE
+  struct answer_trie_node *old_chain;  /* nodes in the chain replaced by the hash */
+  int shift;                           /* entry bits used by the upper hash levels */
+#endif /* ANSWER_TRIE_LOCK_FREE */
 #ifdef MODE_DIRECTED_TABLING
   struct answer_trie_hash *previous;	
 #endif /*MODE_DIRECTED_TABLING*/
@@ -157,6 +232,10 @@ typedef struct global_trie_hash {
   int number_of_buckets;
   struct global_trie_node **buckets;
   int number_of_nodes;
+#ifdef INCREMENTAL_HASH_EXPANSION
+  struct global_trie_node **old_buckets;  /* NULL if not expanding */
+  int old_buckets_left;                   /* old buckets not yet moved */
+#endif /* INCREMENTAL_HASH_EXPANSION */
 #ifdef USE_PAGES_MALLOC
   struct global_trie_hash *next;
 #endif /* USE_PAGES_MALLOC */
@@ -166,11 +245,86 @@ typedef struct global_trie_hash {
 #define Hash_num_buckets(X)  ((X)->number_of_buckets)
 #define Hash_buckets(X)      ((X)->buckets)
 #define Hash_num_nodes(X)    ((X)->number_of_nodes)
+#define Hash_old_buckets(X)  ((X)->old_buckets)
+#define Hash_old_buckets_left(X)  ((X)->old_buckets_left)
+#define Hash_old_chain(X)    ((X)->old_chain)
+#define Hash_shift(X)        ((X)->shift)
 #define Hash_previous(X)     ((X)->previous)
 #define Hash_next(X)         ((X)->next)
 
 
 
+/*****************************
+**      table_snapshot      **
+*****************************/
+
+#ifdef TABLE_SNAPSHOTS
+typedef struct table_snapshot {
+  char *start;              /* mmap'ed file */
+  size_t size;
+  long subgoals;            /* loaded subgoals still using the compact answer tries of the file */
+  struct table_snapshot *next;
+} *tab_snap_ptr;
+
+#define TabSnap_start(X)     ((X)->start)
+#define TabSnap_size(X)      ((X)->size)
+#define TabSnap_subgoals(X)  ((X)->subgoals)
+#define TabSnap_next(X)      ((X)->next)
+#endif /* TABLE_SNAPSHOTS */
+
+
+
+/*****************************
+**      abolished_trie      **
+*****************************/
+
+#ifdef DEFERRED_ABOLISH
+typedef struct abolished_trie {
+  struct subgoal_trie_node *chain;  /* first level nodes (or hash) not yet freed */
+  struct abolished_trie *next;
+} *ab_trie_ptr;
+
+#define AbTrie_chain(X)  ((X)->chain)
+#define AbTrie_next(X)   ((X)->next)
+#endif /* DEFERRED_ABOLISH */
+
+
+
+/**************************
+**      ground_call      **
+**************************/
+
+#ifdef GROUND_CALL_HASHING
+typedef struct ground_call {
+  CELL hash;
+  UInt size;                        /* number of cells */
+  struct subgoal_trie_node *leaf;   /* leaf node of the call in the subgoal trie */
+  struct ground_call *next;
+  CELL cells[1];                    /* allocated with the size of the call */
+} *gr_call_ptr;
+
+typedef struct ground_call_hash {
+  UInt num_buckets;
+  UInt num_calls;
+  struct ground_call **buckets;
+} *gr_hash_ptr;
+
+/* a ground call is kept as the cells of its arguments in depth-first order:   **
+** atoms and integers as they are, the functor of compound terms (AbsPair(NULL) **
+** for lists) followed by the cells of their arguments and the functor of       **
+** floats and long integers followed by their raw cells                         */
+#define GrCall_hash(X)          ((X)->hash)
+#define GrCall_size(X)          ((X)->size)
+#define GrCall_leaf(X)          ((X)->leaf)
+#define GrCall_next(X)          ((X)->next)
+#define GrCall_cells(X)         ((X)->cells)
+#define GrHash_num_buckets(X)   ((X)->num_buckets)
+#define GrHash_num_calls(X)     ((X)->num_calls)
+#define GrHash_buckets(X)       ((X)->buckets)
+#endif /* GROUND_CALL_HASHING */
+
+
+
 /************************************************************************
 **                      Execution Data Structures                      **
 ************************************************************************/
@@ -246,6 +400,12 @@ typedef struct subgoal_entry {
   struct answer_trie_node *answer_trie;
   struct answer_trie_node *first_answer;
   struct answer_trie_node *last_answer;
+#ifdef ANSWER_TRIE_SWITCHES
+  struct answer_trie_switch_table *answer_switches;
+#endif /* ANSWER_TRIE_SWITCHES */
+#ifdef COMPACT_ANSWER_TRIES
+  struct answer_trie_node *compacted_trie;
+#endif /* COMPACT_ANSWER_TRIES */
 #ifdef MODE_DIRECTED_TABLING
   int* mode_directed_array;
   struct answer_trie_node *invalid_chain;
@@ -267,6 +427,10 @@ typedef struct subgoal_entry {
   int active_workers;
   struct subgoal_frame *subgoal_frame[THREADS_NUM_BUCKETS];
 #endif /* THREADS_FULL_SHARING || THREADS_CONSUMER_SHARING */
+#ifdef THREADS_CONSUMER_SHARING
+  volatile int answer_events;
+  volatile int waiting_workers;
+#endif /* THREADS_CONSUMER_SHARING */
 }* sg_ent_ptr;
 
 #define SgEnt_lock(X)            ((X)->lock)
@@ -277,6 +441,8 @@ typedef struct subgoal_entry {
 #define SgEnt_answer_trie(X)     ((X)->answer_trie)
 #define SgEnt_first_answer(X)    ((X)->first_answer)
 #define SgEnt_last_answer(X)     ((X)->last_answer)
+#define SgEnt_answer_switches(X) ((X)->answer_switches)
+#define SgEnt_compacted_trie(X)  ((X)->compacted_trie)
 #define SgEnt_mode_directed(X)   ((X)->mode_directed_array)
 #define SgEnt_invalid_chain(X)   ((X)->invalid_chain)
 #define SgEnt_try_answer(X)      ((X)->try_answer)
@@ -286,6 +452,8 @@ typedef struct subgoal_entry {
 #define SgEnt_sg_ent_state(X)    ((X)->state_flag)
 #define SgEnt_active_workers(X)  ((X)->active_workers)
 #define SgEnt_sg_fr(X)           ((X)->subgoal_frame)
+#define SgEnt_answer_events(X)   ((X)->answer_events)
+#define SgEnt_waiting_workers(X) ((X)->waiting_workers)
 
 
 
@@ -306,6 +474,13 @@ typedef struct subgoal_frame {
   subgoal_state_flag state_flag;
   choiceptr generator_choice_point;
   struct subgoal_frame *next;
+#ifdef LIMIT_TABLING
+  UInt timestamp;
+#endif /* LIMIT_TABLING */
+#ifdef INCREMENTAL_TABLING
+  struct incremental_dependency *incremental_dependents;
+  int incremental_invalid;
+#endif /* INCREMENTAL_TABLING */
 } *sg_fr_ptr;
 
 /* subgoal_entry fields */
@@ -322,6 +497,8 @@ typedef struct subgoal_frame {
 #define SgFr_answer_trie(X)             (SUBGOAL_ENTRY(X) answer_trie)
 #define SgFr_first_answer(X)            (SUBGOAL_ENTRY(X) first_answer)
 #define SgFr_last_answer(X)             (SUBGOAL_ENTRY(X) last_answer)
+#define SgFr_answer_switches(X)         (SUBGOAL_ENTRY(X) answer_switches)
+#define SgFr_compacted_trie(X)          (SUBGOAL_ENTRY(X) compacted_trie)
 #define SgFr_mode_directed(X)           (SUBGOAL_ENTRY(X) mode_directed_array)
 #define SgFr_invalid_chain(X)           (SUBGOAL_ENTRY(X) invalid_chain)
 #define SgFr_try_answer(X)              (SUBGOAL_ENTRY(X) try_answer)
@@ -330,6 +507,8 @@ typedef struct subgoal_frame {
 #define SgFr_gen_worker(X)              (SUBGOAL_ENTRY(X) generator_worker)
 #define SgFr_sg_ent_state(X)            (SUBGOAL_ENTRY(X) state_flag)
 #define SgFr_active_workers(X)          (SUBGOAL_ENTRY(X) active_workers)
+#define SgFr_answer_events(X)           (SUBGOAL_ENTRY(X) answer_events)
+#define SgFr_waiting_workers(X)         (SUBGOAL_ENTRY(X) waiting_workers)
 /* subgoal_frame fields */
 #define SgFr_sg_ent(X)                  ((X)->subgoal_entry)
 #define SgFr_batched_last_answer(X)     ((X)->batched_last_answer)
@@ -337,6 +516,9 @@ typedef struct subgoal_frame {
 #define SgFr_state(X)                   ((X)->state_flag)
 #define SgFr_gen_cp(X)                  ((X)->generator_choice_point)
 #define SgFr_next(X)                    ((X)->next)
+#define SgFr_timestamp(X)               ((X)->timestamp)
+#define SgFr_inc_dependents(X)          ((X)->incremental_dependents)
+#define SgFr_inc_invalid(X)             ((X)->incremental_invalid)
 
 /**********************************************************************************************************
 
@@ -345,9 +527,17 @@ typedef struct subgoal_frame {
   SgFr_tab_ent                  a pointer to the corresponding table entry.
   SgFr_arity                    the arity of the subgoal.
   SgFr_hash_chain:              a pointer to the first answer_trie_hash struct.
-  SgFr_answer_trie:             a pointer to the top answer trie node.
+  SgFr_answer_trie:             a pointer to the top answer trie node. With compact answer tries, the
+                                child of the top node of a compiled subgoal is the compact answer trie.
   SgFr_first_answer:            a pointer to the leaf answer trie node of the first answer.
+                                With compact answer tries, it points to the compact answer trie of
+                                a compiled subgoal, as the leaf answer trie nodes no longer exist
+                                (with YapOr, the leaf nodes are kept in SgFr_compacted_trie).
   SgFr_last_answer:             a pointer to the leaf answer trie node of the last answer.
+  SgFr_answer_switches:         a pointer to the switches of the wide levels of the compact answer trie.
+  SgFr_compacted_trie:          a pointer to the answer trie nodes copied to the compact answer trie. With
+                                YapOr, other workers may still be loading or consuming answers from them,
+                                thus they are only released with the answers of the subgoal.
   SgFr_mode_directed:           a pointer to the mode directed array.
   SgFr_invalid_chain:           a pointer to the first invalid leaf node when using mode directed tabling.
   SgFr_try_answer:              a pointer to the leaf answer trie node of the last tried answer.
@@ -361,6 +551,8 @@ typedef struct subgoal_frame {
   SgFr_gen_worker:              the id of the worker that had allocated the frame.
   SgFr_sg_ent_state:            a flag that indicates the subgoal entry state.
   SgFr_active_workers:          the number of workers evaluating the subgoal.
+  SgFr_answer_events:           a counter incremented when a new answer is found or the subgoal is completed.
+  SgFr_waiting_workers:         the number of workers sleeping until the next answer event.
   SgFr_sg_ent:                  a pointer to the corresponding subgoal entry.
   SgFr_batched_last_answer:     a pointer to the leaf answer trie node of the last checked answer 
                                 when using batched scheduling.
@@ -368,7 +560,55 @@ typedef struct subgoal_frame {
                                 yet found when using batched scheduling.
   SgFr_state:                   a flag that indicates the subgoal frame state.
   SgFr_gen_cp:                  a pointer to the correspondent generator choice point.
+                                For a retired frame, the oldest choice point that may still load its answers.
   SgFr_next:                    a pointer to the next subgoal frame on the chain.
+  SgFr_timestamp:               the value of the LRU clock when the subgoal was last completed, released
+                                or called. It is zero when the frame is not on the LRU chain.
+  SgFr_inc_dependents:          a pointer to the chain of incremental subgoals that called the subgoal.
+  SgFr_inc_invalid:             a flag that indicates that an incremental dynamic predicate the subgoal
+                                depends on was updated after the subgoal was completed.
+
+**********************************************************************************************************/
+
+
+
+/*************************************
+**      incremental_dependency      **
+*************************************/
+
+typedef struct incremental_dependency {
+  struct subgoal_frame *subgoal_frame;
+  struct table_entry *table_entry;
+  UInt generation;
+  struct incremental_dependency *next;
+} *inc_dep_ptr;
+
+#define IncDep_sg_fr(X)       ((X)->subgoal_frame)
+#define IncDep_tab_ent(X)     ((X)->table_entry)
+#define IncDep_generation(X)  ((X)->generation)
+#define IncDep_next(X)        ((X)->next)
+
+typedef struct incremental_predicate {
+  struct pred_entry *pred_entry;
+  struct incremental_dependency *dependents;
+  struct incremental_predicate *next;
+} *inc_pred_ptr;
+
+#define IncPred_pe(X)          ((X)->pred_entry)
+#define IncPred_dependents(X)  ((X)->dependents)
+#define IncPred_next(X)        ((X)->next)
+
+/**********************************************************************************************************
+
+  IncDep_sg_fr:          a pointer to the subgoal frame of a dependent subgoal.
+  IncDep_tab_ent:        a pointer to the table entry of the dependent subgoal.
+  IncDep_generation:     the generation of the table entry when the dependency was recorded. The 
+                         generation is incremented when the table is abolished, thus the dependencies
+                         of abolished subgoal frames are ignored.
+  IncDep_next:           a pointer to the next dependency on the chain.
+  IncPred_pe:            a pointer to the entry of the incremental dynamic predicate.
+  IncPred_dependents:    a pointer to the chain of incremental subgoals that called the predicate.
+  IncPred_next:          a pointer to the next incremental dynamic predicate on the chain.
 
 **********************************************************************************************************/
 
@@ -445,6 +685,7 @@ typedef struct suspension_frame {
     void *resume_register;
     void *block_start;
     long block_size;
+    long stored_size;  /* less than block_size if the block is compressed */
   } global_block, local_block, trail_block;
   struct suspension_frame *next;
 } *susp_fr_ptr;
@@ -456,10 +697,15 @@ typedef struct suspension_frame {
 #define SuspFr_global_reg(X)          ((X)->global_block.resume_register)
 #define SuspFr_global_start(X)        ((X)->global_block.block_start)
 #define SuspFr_global_size(X)         ((X)->global_block.block_size)
+#define SuspFr_global_stored(X)       ((X)->global_block.stored_size)
 #define SuspFr_local_reg(X)           ((X)->local_block.resume_register)
 #define SuspFr_local_start(X)         ((X)->local_block.block_start)
 #define SuspFr_local_size(X)          ((X)->local_block.block_size)
+#define SuspFr_local_stored(X)        ((X)->local_block.stored_size)
 #define SuspFr_trail_reg(X)           ((X)->trail_block.resume_register)
 #define SuspFr_trail_start(X)         ((X)->trail_block.block_start)
 #define SuspFr_trail_size(X)          ((X)->trail_block.block_size)
+#define SuspFr_trail_stored(X)        ((X)->trail_block.stored_size)
+#define SuspFr_block_bytes(X)         (SuspFr_global_size(X) + SuspFr_local_size(X) + SuspFr_trail_size(X))
+#define SuspFr_stored_bytes(X)        (SuspFr_global_stored(X) + SuspFr_local_stored(X) + SuspFr_trail_stored(X))
 #define SuspFr_next(X)                ((X)->next)
@@ -21,6 +21,24 @@
 #include "YapHeap.h"
 #include "eval.h"
 #include "tab.macros.h"
+#if defined(TABLE_SNAPSHOTS) || defined(INCREMENTAL_TABLING) || defined(EPOCH_RECLAMATION)
+#include "clause.h"
+#endif /* TABLE_SNAPSHOTS || INCREMENTAL_TABLING || EPOCH_RECLAMATION */
+#ifdef TABLE_SNAPSHOTS
+#include "yapio.h"
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#if HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#endif /* TABLE_SNAPSHOTS */
 
 static inline sg_node_ptr subgoal_trie_check_insert_entry(tab_ent_ptr, sg_node_ptr, Term USES_REGS);
 static inline sg_node_ptr subgoal_trie_check_insert_gt_entry(tab_ent_ptr, sg_node_ptr, Term USES_REGS);
@@ -64,6 +82,73 @@ static void free_global_trie_branch(gt_node_ptr, int USES_REGS);
 #else
 static void free_global_trie_branch(gt_node_ptr USES_REGS);
 #endif /* GLOBAL_TRIE_FOR_SUBTERMS */
+#ifdef ANSWER_TRIE_LOCK_FREE
+static ans_node_ptr flatten_answer_trie_hash(ans_hash_ptr, ans_node_ptr);
+#endif /* ANSWER_TRIE_LOCK_FREE */
+#ifdef COMPACT_ANSWER_TRIES
+static long count_answer_trie_nodes(ans_node_ptr);
+static cmp_node_ptr compact_answer_trie_branch(ans_node_ptr, cmp_node_ptr);
+static long free_compact_answer_trie_branch(cmp_node_ptr, int);
+static void traverse_compact_answer_trie(cmp_node_ptr, char *, int, int *, int, int, int USES_REGS);
+#endif /* COMPACT_ANSWER_TRIES */
+#ifdef TABLING_CALL_SUBSUMPTION
+struct subsumption_data;
+static int subsumption_match_entry(Term, struct subsumption_data *, int *, int *);
+static sg_fr_ptr find_subsuming_subgoal(sg_node_ptr, struct subsumption_data *, int, int);
+static int load_subsumed_answer(sg_fr_ptr, ans_node_ptr, struct subsumption_data *, CELL * USES_REGS);
+#ifdef COMPACT_ANSWER_TRIES
+static inline int load_compact_subsumed_node(sg_fr_ptr, cmp_node_ptr, ans_node_ptr, int, struct subsumption_data *, CELL * USES_REGS);
+static int load_compact_subsumed_answers(sg_fr_ptr, cmp_node_ptr, ans_node_ptr, int, struct subsumption_data *, CELL * USES_REGS);
+#endif /* COMPACT_ANSWER_TRIES */
+#ifdef ANSWER_TRIE_SWITCHES
+static long count_answer_trie_level(cmp_node_ptr, long *, long *);
+static unsigned int answer_trie_switch_buckets(long);
+static void count_answer_trie_switches(cmp_node_ptr, int *, long *);
+static void fill_answer_trie_switches(cmp_node_ptr, ans_sw_ptr *, cmp_node_ptr **);
+static ans_sw_tab_ptr build_answer_trie_switches(cmp_node_ptr);
+static ans_sw_ptr find_answer_trie_switch(ans_sw_tab_ptr, cmp_node_ptr);
+static cmp_node_ptr lookup_answer_trie_switch(ans_sw_ptr, Term);
+#endif /* ANSWER_TRIE_SWITCHES */
+static void complete_subsumed_subgoal(tab_ent_ptr, sg_fr_ptr, sg_node_ptr, int, CELL * USES_REGS);
+#endif /* TABLING_CALL_SUBSUMPTION */
+#ifdef INCREMENTAL_TABLING
+static inline void record_incremental_dependency(inc_dep_ptr * USES_REGS);
+static inline inc_pred_ptr find_incremental_predicate(PredEntry *);
+static void retire_subgoal_frame(tab_ent_ptr, sg_fr_ptr);
+static void free_incremental_dependencies(inc_dep_ptr);
+static void free_retired_subgoal_frames(tab_ent_ptr, int);
+#endif /* INCREMENTAL_TABLING */
+#ifdef DEFERRED_ABOLISH
+static void defer_subgoal_trie(tab_ent_ptr, sg_node_ptr USES_REGS);
+#endif /* DEFERRED_ABOLISH */
+#ifdef GROUND_CALL_HASHING
+static int expand_ground_call_buffer(UInt);
+static int flatten_ground_term(Term, UInt *, int);
+static inline UInt flatten_ground_call(int, CELL * USES_REGS);
+static inline sg_node_ptr lookup_ground_call(tab_ent_ptr, CELL, UInt);
+static void insert_ground_call(tab_ent_ptr, CELL, UInt, sg_node_ptr);
+static void free_ground_calls(tab_ent_ptr);
+#endif /* GROUND_CALL_HASHING */
+#ifdef TABLE_SNAPSHOTS
+struct table_snapshot_symbols;
+struct table_snapshot_writer;
+static int snapshot_symbols_init(struct table_snapshot_symbols *);
+static int snapshot_symbols_insert(struct table_snapshot_symbols *, CELL, CELL);
+static int snapshot_symbols_lookup(struct table_snapshot_symbols *, CELL, CELL *);
+static void snapshot_symbols_free(struct table_snapshot_symbols *);
+static size_t snapshot_put(struct table_snapshot_writer *, void *, size_t);
+static CELL snapshot_checksum(CELL, char *, size_t);
+static inline int snapshot_entry_mode(Term, int, int);
+static void snapshot_register_entry(struct table_snapshot_writer *, Term);
+static int snapshot_relocate_entry(Term *, struct table_snapshot_symbols *, struct table_snapshot_symbols *);
+static long snapshot_answer_trie(struct table_snapshot_writer *, cmp_node_ptr, int);
+static cmp_node_ptr snapshot_relocate_answer_trie(cmp_node_ptr, cmp_node_ptr, int, struct table_snapshot_symbols *, struct table_snapshot_symbols *);
+static int snapshot_relocate_subgoal_path(CELL *, CELL, int, struct table_snapshot_symbols *, struct table_snapshot_symbols *);
+static void snapshot_subgoal(struct table_snapshot_writer *, sg_fr_ptr, int);
+static void snapshot_subgoal_trie(struct table_snapshot_writer *, sg_node_ptr, int);
+static int release_table_snapshot_trie(cmp_node_ptr);
+#endif /* TABLE_SNAPSHOTS */
+static void show_hash_histogram(long * USES_REGS);
 static void traverse_subgoal_trie(sg_node_ptr, char *, int, int *, int, int USES_REGS);
 static void traverse_answer_trie(ans_node_ptr, char *, int, int *, int, int, int USES_REGS);
 static void traverse_global_trie(gt_node_ptr, char *, int, int *, int, int USES_REGS);
@@ -90,9 +175,14 @@ static struct trie_statistics{
   long answers_true;
   long answers_no;
   long answer_trie_nodes;
+#ifdef COMPACT_ANSWER_TRIES
+  long compact_answer_trie_nodes;
+#endif /* COMPACT_ANSWER_TRIES */
   long global_trie_terms;
   long global_trie_nodes;
   long global_trie_references;
+  long compiled_answer_tries;
+  long *hash_histogram;
 }
 #ifdef THREADS
  trie_stats[MAX_THREADS];
@@ -107,9 +197,12 @@ static struct trie_statistics{
 #define TrStat_answers_no      trie_stats[worker_id].answers_no
 #define TrStat_answers_pruned  trie_stats[worker_id].answers_pruned
 #define TrStat_ans_nodes       trie_stats[worker_id].answer_trie_nodes
+#define TrStat_cmp_ans_nodes   trie_stats[worker_id].compact_answer_trie_nodes
 #define TrStat_gt_terms        trie_stats[worker_id].global_trie_terms
 #define TrStat_gt_nodes        trie_stats[worker_id].global_trie_nodes
 #define TrStat_gt_refs         trie_stats[worker_id].global_trie_references
+#define TrStat_cmp_ans_tries   trie_stats[worker_id].compiled_answer_tries
+#define TrStat_hash_histogram  trie_stats[worker_id].hash_histogram
 #else  /*!THREADS */
  trie_stats;
 
@@ -123,9 +216,12 @@ static struct trie_statistics{
 #define TrStat_answers_no      trie_stats.answers_no
 #define TrStat_answers_pruned  trie_stats.answers_pruned
 #define TrStat_ans_nodes       trie_stats.answer_trie_nodes
+#define TrStat_cmp_ans_nodes   trie_stats.compact_answer_trie_nodes
 #define TrStat_gt_terms        trie_stats.global_trie_terms
 #define TrStat_gt_nodes        trie_stats.global_trie_nodes
 #define TrStat_gt_refs         trie_stats.global_trie_references
+#define TrStat_cmp_ans_tries   trie_stats.compiled_answer_tries
+#define TrStat_hash_histogram  trie_stats.hash_histogram
 #endif /*THREADS */
 
 #if defined(THREADS_SUBGOAL_SHARING) || defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
@@ -146,6 +242,171 @@ static struct trie_statistics{
         if (TrStat_show == SHOW_MODE_STRUCTURE)  \
           Sfprintf(TrStat_out, MESG, ##ARGS)
 
+/* bucket occupancy histograms, one row per trie level */
+#define HASH_HISTOGRAM_LEVELS     16  /* deeper levels are added to the last row */
+#define HASH_HISTOGRAM_MAX_NODES   8  /* fuller buckets are added to the last column */
+#define HASH_HISTOGRAM_SIZE       (HASH_HISTOGRAM_LEVELS * (HASH_HISTOGRAM_MAX_NODES + 1))
+#define HASH_HISTOGRAM_SUBGOAL    0
+#define HASH_HISTOGRAM_ANSWER     HASH_HISTOGRAM_SIZE
+#define HASH_HISTOGRAM_GLOBAL     0
+
+/* global trie nodes do not tag their parent pointers */
+#define UNTAG_GLOBAL_NODE(NODE)  ((CELL) (NODE))
+
+#define TRIE_NODE_LEVEL(NODE, LEVEL, NODE_PTR, UNTAG_NODE)                               \
+        { NODE_PTR level_node = (NODE_PTR) UNTAG_NODE(TrNode_parent(NODE));              \
+          LEVEL = 0;                                                                     \
+          while (level_node) {                                                           \
+            LEVEL++;                                                                     \
+            level_node = (NODE_PTR) UNTAG_NODE(TrNode_parent(level_node));               \
+          }                                                                              \
+        }
+
+#define UPDATE_HASH_HISTOGRAM(HISTOGRAM, LEVEL, NODES)                                   \
+        TrStat_hash_histogram[(HISTOGRAM) +                                              \
+          ((LEVEL) < HASH_HISTOGRAM_LEVELS ? (LEVEL) - 1 : HASH_HISTOGRAM_LEVELS - 1) *  \
+          (HASH_HISTOGRAM_MAX_NODES + 1) +                                               \
+          ((NODES) < HASH_HISTOGRAM_MAX_NODES ? (NODES) : HASH_HISTOGRAM_MAX_NODES)]++
+
+/* buckets holding a next hash level (ANSWER_TRIE_LOCK_FREE) are counted as full buckets */
+#define UPDATE_HASH_BUCKETS_HISTOGRAM(HISTOGRAM, HASH, NODE_PTR, IS_HASH, UNTAG_NODE)    \
+        if (TrStat_show == SHOW_MODE_STATISTICS) {                                       \
+          NODE_PTR *hist_bucket, *hist_last_bucket, hist_node;                           \
+          long hist_nodes;                                                               \
+          int hist_level = 0;                                                            \
+          hist_bucket = Hash_buckets(HASH);                                              \
+          hist_last_bucket = hist_bucket + Hash_num_buckets(HASH);                       \
+          do {                                                                           \
+            if (*hist_bucket && ! IS_HASH(*hist_bucket)) {                               \
+              TRIE_NODE_LEVEL(*hist_bucket, hist_level, NODE_PTR, UNTAG_NODE);           \
+              break;                                                                     \
+            }                                                                            \
+          } while (++hist_bucket != hist_last_bucket);                                   \
+          if (hist_level) {                                                              \
+            hist_bucket = Hash_buckets(HASH);                                            \
+            do {                                                                         \
+              hist_nodes = 0;                                                            \
+              hist_node = *hist_bucket;                                                  \
+              if (hist_node && IS_HASH(hist_node))                                       \
+                hist_nodes = HASH_HISTOGRAM_MAX_NODES;                                   \
+              else                                                                       \
+                while (hist_node) {                                                      \
+                  hist_nodes++;                                                          \
+                  hist_node = TrNode_next(hist_node);                                    \
+                }                                                                        \
+              UPDATE_HASH_HISTOGRAM(HISTOGRAM, hist_level, hist_nodes);                  \
+            } while (++hist_bucket != hist_last_bucket);                                 \
+          }                                                                              \
+        }
+
+#ifdef TABLING_CALL_SUBSUMPTION
+/* pending items of the call being matched against a subgoal trie branch */
+#define SUBSUMPTION_TERM          0  /* a subterm of the call                          */
+#define SUBSUMPTION_LIST          1  /* a list of the call after its CompactPairInit    */
+#define SUBSUMPTION_MARK          2  /* the tail of a list of the call (PairTermMark)   */
+#define SUBSUMPTION_TOKEN         3  /* a raw trie entry (double and long int values)   */
+#define SUBSUMPTION_STACK_SIZE 1024
+#define SUBSUMPTION_MAX_DEPTH  4096
+
+struct subsumption_item {
+  int kind;
+  Term term;
+};
+
+struct subsumption_data {
+  sg_node_ptr leaf_node;                      /* leaf node of the new subgoal      */
+  int depth;                                  /* depth of the current trie branch  */
+  int subs_arity;                             /* arity of the subsuming subgoal    */
+  Term bindings[MAX_TABLE_VARS];              /* call subterms of the trie vars    */
+#ifdef ANSWER_TRIE_SWITCHES
+  ans_sw_tab_ptr switches;                    /* switches of the subsuming subgoal */
+#endif /* ANSWER_TRIE_SWITCHES */
+  CELL answer_subs[MAX_TABLE_VARS + 1];       /* substitution to load the answers  */
+  struct subsumption_item stack[SUBSUMPTION_STACK_SIZE];
+};
+#endif /* TABLING_CALL_SUBSUMPTION */
+
+#ifdef TABLE_SNAPSHOTS
+/* a table snapshot file holds a header, the atom table, the functor table **
+** and, for each table, a table record followed by its subgoals. For each  **
+** subgoal, it holds the entries of its subgoal trie path and the nodes of **
+** its compact answer trie. The atoms and functors in the entries are kept **
+** as in the saving process and the opcodes are kept as opcode numbers.    **
+** The header keeps a checksum of the rest of the file, since the opcodes  **
+** and entries of the nodes cannot be checked one by one when loading      */
+#define TABLE_SNAPSHOT_MAGIC    "YAPTABS"
+#define TABLE_SNAPSHOT_VERSION  2
+#define TABLE_SNAPSHOT_YES      ((CELL) -1)  /* number of nodes of a subgoal with a 'TRUE' answer */
+#define TABLE_SNAPSHOT_ALIGN(SIZE)  (((SIZE) + sizeof(CELL) - 1) & ~(sizeof(CELL) - 1))
+
+/* FNV-1a over the cells of the file */
+#if SIZEOF_INT_P == 8
+#define TABLE_SNAPSHOT_CHECKSUM_BASIS  ((CELL) 0xcbf29ce484222325UL)
+#define TABLE_SNAPSHOT_CHECKSUM_PRIME  ((CELL) 0x100000001b3UL)
+#else
+#define TABLE_SNAPSHOT_CHECKSUM_BASIS  ((CELL) 0x811c9dc5UL)
+#define TABLE_SNAPSHOT_CHECKSUM_PRIME  ((CELL) 0x01000193UL)
+#endif /* SIZEOF_INT_P */
+
+/* the trie encoding options must match between the saving and the loading builds */
+#ifdef YAPOR
+#define TABLE_SNAPSHOT_FLAG_YAPOR          0x1
+#else
+#define TABLE_SNAPSHOT_FLAG_YAPOR          0x0
+#endif /* YAPOR */
+#ifdef TRIE_COMPACT_PAIRS
+#define TABLE_SNAPSHOT_FLAG_COMPACT_PAIRS  0x2
+#else
+#define TABLE_SNAPSHOT_FLAG_COMPACT_PAIRS  0x0
+#endif /* TRIE_COMPACT_PAIRS */
+#define TABLE_SNAPSHOT_FLAGS  (TABLE_SNAPSHOT_FLAG_YAPOR | TABLE_SNAPSHOT_FLAG_COMPACT_PAIRS)
+
+struct table_snapshot_header {
+  char magic[8];
+  CELL version;
+  CELL flags;
+  CELL std_top;
+  CELL node_size;
+  CELL atoms;
+  CELL functors;
+  CELL tables;
+  CELL checksum;  /* of the file after the header */
+};
+
+struct table_snapshot_table {
+  CELL name;      /* atom */
+  CELL arity;
+  CELL module;    /* atom */
+  CELL subgoals;
+};
+
+/* open addressing map from the atoms and functors of the saving process **
+** to the atoms and functors of the loading process                      */
+struct table_snapshot_symbols {
+  CELL *keys;
+  CELL *values;
+  long size;
+  long entries;
+};
+
+struct table_snapshot_writer {
+  char *buffer;                             /* table records of the file */
+  size_t buffer_size;
+  size_t buffer_top;
+  struct table_snapshot_symbols atoms;
+  struct table_snapshot_symbols functors;
+  Term *path;                               /* entries of the current subgoal trie path */
+  int path_size;
+  long subgoals;                            /* subgoals of the current table */
+  int out_of_memory;                        /* an allocation failed, the snapshot is not written */
+};
+
+#define SNAPSHOT_SYMBOLS_SLOT(SYMBOLS, KEY)  ((((KEY) >> 3) ^ ((KEY) >> 13)) & ((SYMBOLS)->size - 1))
+#define SNAPSHOT_READ_CHECK(PTR, SIZE, END) \
+        if ((char *) (PTR) + (SIZE) > (END)) \
+          goto corrupted_snapshot
+#endif /* TABLE_SNAPSHOTS */
+
 #define CHECK_DECREMENT_GLOBAL_TRIE_REFERENCE(REF,MODE)		                                            \
         if (MODE == TRAVERSE_MODE_NORMAL && IsVarTerm(REF) && REF > VarIndexOfTableTerm(MAX_TABLE_VARS)) {  \
           register gt_node_ptr gt_node = (gt_node_ptr) (REF);	                                            \
@@ -499,6 +760,63 @@ static void update_answer_trie_branch(ans_node_ptr current_node, int position) {
 #endif /* YAPOR */
 
 
+#ifdef COMPACT_ANSWER_TRIES
+static long count_answer_trie_nodes(ans_node_ptr current_node) {
+  long nodes = 0;
+
+  do {
+    nodes++;
+    if (! IS_ANSWER_LEAF_NODE(current_node))
+      nodes += count_answer_trie_nodes(TrNode_child(current_node));
+    current_node = TrNode_next(current_node);
+  } while (current_node);
+  return nodes;
+}
+
+
+static cmp_node_ptr compact_answer_trie_branch(ans_node_ptr current_node, cmp_node_ptr cmp_node) {
+  /* copies the trie level of current_node, and the levels below, to the compact **
+  ** nodes starting at cmp_node and returns the first compact node not used      */
+  cmp_node_ptr next_cmp_node;
+
+  do {
+    CmpNode_instr(cmp_node) = TrNode_instr(current_node);
+#ifdef YAPOR
+    CmpNode_or_arg(cmp_node) = TrNode_or_arg(current_node);
+#endif /* YAPOR */
+    CmpNode_entry(cmp_node) = TrNode_entry(current_node);
+    CmpNode_offset(cmp_node) = 0;
+    if (IS_ANSWER_LEAF_NODE(current_node)) {
+      TAG_AS_COMPACT_LEAF_NODE(cmp_node);
+      next_cmp_node = cmp_node + 1;
+    } else
+      next_cmp_node = compact_answer_trie_branch(TrNode_child(current_node), cmp_node + 1);
+    current_node = TrNode_next(current_node);
+    if (current_node)
+      CmpNode_offset(cmp_node) |= (unsigned int) (next_cmp_node - cmp_node) << 1;
+    cmp_node = next_cmp_node;
+  } while (current_node);
+  return cmp_node;
+}
+
+
+void free_answer_trie_nodes(ans_node_ptr current_node) {
+  /* only frees the nodes, the entries are kept by the compact answer trie */
+  CACHE_REGS
+  ans_node_ptr next_node;
+
+  do {
+    if (! IS_ANSWER_LEAF_NODE(current_node))
+      free_answer_trie_nodes(TrNode_child(current_node));
+    next_node = TrNode_next(current_node);
+    FREE_ANSWER_TRIE_NODE(current_node);
+    current_node = next_node;
+  } while (current_node);
+  return;
+}
+#endif /* COMPACT_ANSWER_TRIES */
+
+
 #ifdef GLOBAL_TRIE_FOR_SUBTERMS
 static void free_global_trie_branch(gt_node_ptr current_node, int mode USES_REGS) {
   Term t = TrNode_entry(current_node);
@@ -511,8 +829,10 @@ static void free_global_trie_branch(gt_node_ptr current_node USES_REGS) {
   child_node  = TrNode_child(parent_node);
   if (IS_GLOBAL_TRIE_HASH(child_node)) {
     gt_hash_ptr hash = (gt_hash_ptr) child_node;
-    gt_node_ptr *bucket = Hash_buckets(hash) + HASH_ENTRY(TrNode_entry(current_node), Hash_num_buckets(hash));
+    gt_node_ptr *bucket;
     int num_nodes = --Hash_num_nodes(hash);
+    MOVE_TRIE_HASH_ENTRY(hash, TrNode_entry(current_node), gt_node_ptr);
+    bucket = Hash_buckets(hash) + HASH_ENTRY(TrNode_entry(current_node), Hash_num_buckets(hash));
     child_node = *bucket;
     if (child_node != current_node) {
       while (TrNode_next(child_node) != current_node)
@@ -525,6 +845,7 @@ static void free_global_trie_branch(gt_node_ptr current_node USES_REGS) {
       CHECK_DECREMENT_GLOBAL_TRIE_FOR_SUBTERMS_REFERENCE(t, mode);
       FREE_GLOBAL_TRIE_NODE(current_node);
       if (num_nodes == 0) {
+	FINISH_TRIE_HASH_EXPANSION(hash, gt_node_ptr);
 	FREE_BUCKETS(Hash_buckets(hash));
 	FREE_GLOBAL_TRIE_HASH(hash);
 	if (parent_node != GLOBAL_root_gt) {
@@ -609,31 +930,1310 @@ static void free_global_trie_branch(gt_node_ptr current_node USES_REGS) {
 }
 
 
+#ifdef TABLING_CALL_SUBSUMPTION
+static int subsumption_match_entry(Term t, struct subsumption_data *sd, int *top_ptr, int *nbound_ptr) {
+  /* matches the trie entry t against the pending items of the call, the items    **
+  ** are updated in place and only the item at *top_ptr - 1 is overwritten. The    **
+  ** trie variables bind the call subterms in the order of their first occurrence */
+  struct subsumption_item *item;
+  Term t_call;
+  CELL *aux_pair;
+  int top = *top_ptr;
+  int nbound = *nbound_ptr;
+
+  while (top) {
+    item = sd->stack + top - 1;
+    t_call = item->term;
+    switch (item->kind) {
+    case SUBSUMPTION_TOKEN:
+      if (t != t_call)
+        return FALSE;
+      top--;
+      goto entry_matched;
+    case SUBSUMPTION_TERM:
+      if (IsVarTerm(t)) {
+        int var_index;
+        if (t >= MakeTableVarTerm(MAX_TABLE_VARS))  /* rational terms */
+          return FALSE;
+        var_index = VarIndexOfTableTerm(t);
+        if (var_index == nbound)
+          sd->bindings[nbound++] = t_call;
+        else if (var_index > nbound || ! Yap_eq(sd->bindings[var_index], t_call))
+          return FALSE;
+        top--;
+        goto entry_matched;
+      }
+      if (IsVarTerm(t_call))
+        return FALSE;
+      if (IsAtomOrIntTerm(t)) {
+        if (t != t_call)
+          return FALSE;
+        top--;
+        goto entry_matched;
+      }
+#ifdef TRIE_COMPACT_PAIRS
+      if (IsPairTerm(t_call)) {
+        if (t != CompactPairInit)
+          return FALSE;
+        item->kind = SUBSUMPTION_LIST;
+        goto entry_matched;
+      }
+#else
+      if (IsPairTerm(t_call)) {
+        if (t != AbsPair(NULL) || top == SUBSUMPTION_STACK_SIZE)
+          return FALSE;
+        aux_pair = RepPair(t_call);
+        item->term = Deref(aux_pair[1]);
+        sd->stack[top].kind = SUBSUMPTION_TERM;
+        sd->stack[top].term = Deref(aux_pair[0]);
+        top++;
+        goto entry_matched;
+      }
+#endif /* TRIE_COMPACT_PAIRS */
+      if (IsApplTerm(t_call)) {
+        Functor f = FunctorOfTerm(t_call);
+        if (t != AbsAppl((Term *)f))
+          return FALSE;
+        if (f == FunctorDouble) {
+          union {
+            Term t_dbl[sizeof(Float)/sizeof(Term)];
+            Float dbl;
+          } u;
+          u.dbl = FloatOfTerm(t_call);
+          item->kind = SUBSUMPTION_TOKEN;
+          item->term = u.t_dbl[0];
+#if SIZEOF_DOUBLE == 2 * SIZEOF_INT_P
+          if (top == SUBSUMPTION_STACK_SIZE)
+            return FALSE;
+          sd->stack[top].kind = SUBSUMPTION_TOKEN;
+          sd->stack[top].term = u.t_dbl[1];
+          top++;
+#endif /* SIZEOF_DOUBLE x SIZEOF_INT_P */
+        } else if (f == FunctorLongInt) {
+          item->kind = SUBSUMPTION_TOKEN;
+          item->term = (Term) LongIntOfTerm(t_call);
+        } else if (IsExtensionFunctor(f)) {
+          /* big ints and strings are stored in the trie as heap copies */
+          return FALSE;
+        } else {
+          int i, f_arity = ArityOfFunctor(f);
+          if (top - 1 + f_arity > SUBSUMPTION_STACK_SIZE)
+            return FALSE;
+          /* the first argument is matched first */
+          for (i = 1; i <= f_arity; i++) {
+            sd->stack[top - 1 + f_arity - i].kind = SUBSUMPTION_TERM;
+            sd->stack[top - 1 + f_arity - i].term = Deref(ArgOfTerm(i, t_call));
+          }
+          top += f_arity - 1;
+        }
+        goto entry_matched;
+      }
+      return FALSE;
+#ifdef TRIE_COMPACT_PAIRS
+    case SUBSUMPTION_MARK:
+      if (t == CompactPairEndTerm) {
+        item->kind = SUBSUMPTION_TERM;
+        goto entry_matched;
+      }
+      if (! IsPairTerm(t_call))
+        return FALSE;
+      item->kind = SUBSUMPTION_LIST;
+      /* fall through */
+    case SUBSUMPTION_LIST:
+      aux_pair = RepPair(t_call);
+      if (t == CompactPairEndList) {
+        if (Deref(aux_pair[1]) != TermNil)
+          return FALSE;
+        item->kind = SUBSUMPTION_TERM;
+        item->term = Deref(aux_pair[0]);
+        goto entry_matched;
+      }
+      /* the list in the trie goes on, thus t is the first entry of the head */
+      if (top == SUBSUMPTION_STACK_SIZE)
+        return FALSE;
+      item->kind = SUBSUMPTION_MARK;
+      item->term = Deref(aux_pair[1]);
+      sd->stack[top].kind = SUBSUMPTION_TERM;
+      sd->stack[top].term = Deref(aux_pair[0]);
+      top++;
+      break;
+#endif /* TRIE_COMPACT_PAIRS */
+    default:
+      return FALSE;
+    }
+  }
+  return FALSE;
+
+entry_matched:
+  *top_ptr = top;
+  *nbound_ptr = nbound;
+  return TRUE;
+}
+
+
+static sg_fr_ptr find_subsuming_subgoal(sg_node_ptr current_node, struct subsumption_data *sd, int top, int nbound) {
+  /* searches the trie level of current_node, and the levels below, for a completed **
+  ** subgoal more general than the call with the pending items sd->stack[0..top-1]  */
+  sg_fr_ptr sg_fr = NULL;
+
+  if (IS_SUBGOAL_TRIE_HASH(current_node)) {
+    /* the trie variables are in other buckets than the call subterms */
+    sg_node_ptr *bucket, *last_bucket;
+    int array;
+    sg_hash_ptr hash = (sg_hash_ptr) current_node;
+    for (array = 0; array < TRIE_HASH_BUCKET_ARRAYS(hash); array++) {
+      bucket = TRIE_HASH_BUCKET_ARRAY(hash, array);
+      last_bucket = bucket + TRIE_HASH_BUCKET_ARRAY_SIZE(hash, array);
+      do {
+        if (*bucket && (sg_fr = find_subsuming_subgoal(*bucket, sd, top, nbound)))
+          return sg_fr;
+      } while (++bucket != last_bucket);
+    }
+    return NULL;
+  }
+
+  if (++sd->depth > SUBSUMPTION_MAX_DEPTH) {
+    sd->depth--;
+    return NULL;
+  }
+  do {
+    struct subsumption_item saved_item = sd->stack[top - 1];
+    int next_top = top, next_nbound = nbound;
+    if (current_node != sd->leaf_node &&
+        subsumption_match_entry(TrNode_entry(current_node), sd, &next_top, &next_nbound)) {
+      if (IS_SUBGOAL_LEAF_NODE(current_node)) {
+        if (next_top == 0 && TrNode_sg_fr(current_node)) {
+          sg_fr = get_subgoal_frame(current_node);
+          if (sg_fr && SgFr_state(sg_fr) >= complete)
+            sd->subs_arity = next_nbound;
+          else
+            sg_fr = NULL;
+        }
+      } else if (next_top && TrNode_child(current_node))
+        sg_fr = find_subsuming_subgoal(TrNode_child(current_node), sd, next_top, next_nbound);
+    }
+    sd->stack[top - 1] = saved_item;
+    if (sg_fr)
+      break;
+    current_node = TrNode_next(current_node);
+  } while (current_node);
+  sd->depth--;
+  return sg_fr;
+}
+
+
+static int load_subsumed_answer(sg_fr_ptr sg_fr, ans_node_ptr ans_node, struct subsumption_data *sd, CELL *subs_ptr USES_REGS) {
+  /* loads the answer ans_node of the subsuming subgoal and, if it unifies with the **
+  ** call, inserts it in the answer trie of sg_fr. Returns TRUE if sg_fr has no     **
+  ** variables and therefore cannot have more answers                               */
+  CELL *saved_hr = HR;
+  tr_fr_ptr saved_tr = TR;
+  int i, subs_arity = sd->subs_arity, answer_found = FALSE;
+
+  sd->answer_subs[0] = subs_arity;
+  for (i = 1; i <= subs_arity; i++)
+    sd->answer_subs[i] = MkVarTerm();
+  load_answer(ans_node, sd->answer_subs);
+  for (i = 1; i <= subs_arity; i++)
+    if (! Yap_unify(sd->answer_subs[i], sd->bindings[subs_arity - i]))
+      break;
+  if (i > subs_arity) {
+    ans_node_ptr new_ans_node = answer_search(sg_fr, subs_ptr);
+    if (! IS_ANSWER_LEAF_NODE(new_ans_node)) {
+      TAG_AS_ANSWER_LEAF_NODE(new_ans_node);
+      if (SgFr_first_answer(sg_fr) == NULL)
+        SgFr_first_answer(sg_fr) = new_ans_node;
+      else
+        TrNode_child(SgFr_last_answer(sg_fr)) = new_ans_node;
+      SgFr_last_answer(sg_fr) = new_ans_node;
+    }
+    answer_found = TRUE;
+  }
+  /* the call variables are in the substitution of sg_fr */
+  for (i = 1; i <= subs_ptr[0]; i++)
+    RESET_VARIABLE(subs_ptr[i]);
+  TR = saved_tr;
+  HR = saved_hr;
+  return (answer_found && subs_ptr[0] == 0);
+}
+
+
+#ifdef COMPACT_ANSWER_TRIES
+static inline int load_compact_subsumed_node(sg_fr_ptr sg_fr, cmp_node_ptr current_node, ans_node_ptr aux_node, int position, struct subsumption_data *sd, CELL *subs_ptr USES_REGS) {
+  TrNode_entry(aux_node) = CmpNode_entry(current_node);
+  if (IS_COMPACT_LEAF_NODE(current_node))
+    return load_subsumed_answer(sg_fr, aux_node, sd, subs_ptr PASS_REGS);
+  return load_compact_subsumed_answers(sg_fr, CmpNode_child(current_node), aux_node, position, sd, subs_ptr PASS_REGS);
+}
+
+
+static int load_compact_subsumed_answers(sg_fr_ptr sg_fr, cmp_node_ptr current_node, ans_node_ptr parent_node, int position, struct subsumption_data *sd, CELL *subs_ptr USES_REGS) {
+  /* the compact nodes have no parent pointers, thus load_answer() is given a   **
+  ** temporary node for each level of the branch being visited. While the call  **
+  ** binds the trie variables to atomic terms, each level of the branch is one  **
+  ** trie variable (position) and the branches with other entries are skipped   */
+  struct answer_trie_node aux_node;
+  Term t_call = 0;
+
+  if (position >= 0 && position < sd->subs_arity && IsAtomOrIntTerm(sd->bindings[position]))
+    t_call = sd->bindings[position];
+  TrNode_parent(&aux_node) = parent_node;
+#ifdef ANSWER_TRIE_SWITCHES
+  if (t_call && sd->switches) {
+    ans_sw_ptr sw = find_answer_trie_switch(sd->switches, current_node);
+    if (sw) {
+      /* visits the node of t_call and the trie variable nodes in the order of the level */
+      cmp_node_ptr call_node = lookup_answer_trie_switch(sw, t_call);
+      cmp_node_ptr *var_node = AnsSw_var_nodes(sw);
+      cmp_node_ptr *last_var_node = var_node + AnsSw_num_var_nodes(sw);
+      while (call_node || var_node != last_var_node) {
+        if (var_node != last_var_node && (call_node == NULL || *var_node < call_node))
+          current_node = *var_node++;
+        else {
+          current_node = call_node;
+          call_node = NULL;
+        }
+        if (load_compact_subsumed_node(sg_fr, current_node, &aux_node, position + 1, sd, subs_ptr PASS_REGS))
+          return TRUE;
+      }
+      return FALSE;
+    }
+  }
+#endif /* ANSWER_TRIE_SWITCHES */
+  do {
+    Term t = CmpNode_entry(current_node);
+    if (t_call == 0 || t == t_call || (IsVarTerm(t) && t < MakeTableVarTerm(MAX_TABLE_VARS))) {
+      if (load_compact_subsumed_node(sg_fr, current_node, &aux_node, t_call ? position + 1 : -1, sd, subs_ptr PASS_REGS))
+        return TRUE;
+    }
+    current_node = CmpNode_next(current_node);
+  } while (current_node);
+  return FALSE;
+}
+#endif /* COMPACT_ANSWER_TRIES */
+
+
+#ifdef ANSWER_TRIE_SWITCHES
+#define IS_SWITCH_ATOMIC_ENTRY(T)  (! IsVarTerm(T) && IsAtomOrIntTerm(T))
+#define IS_SWITCH_VAR_ENTRY(T)     (IsVarTerm(T) && (T) < MakeTableVarTerm(MAX_TABLE_VARS))
+
+static long count_answer_trie_level(cmp_node_ptr current_node, long *atomic_nodes, long *var_nodes) {
+  long nodes = 0;
+
+  *atomic_nodes = *var_nodes = 0;
+  do {
+    Term t = CmpNode_entry(current_node);
+    nodes++;
+    if (IS_SWITCH_ATOMIC_ENTRY(t))
+      (*atomic_nodes)++;
+    else if (IS_SWITCH_VAR_ENTRY(t))
+      (*var_nodes)++;
+    current_node = CmpNode_next(current_node);
+  } while (current_node);
+  return nodes;
+}
+
+
+static unsigned int answer_trie_switch_buckets(long atomic_nodes) {
+  /* the buckets are at most half full */
+  unsigned int num_buckets = 2;
+
+  while (num_buckets < 2 * atomic_nodes)
+    num_buckets <<= 1;
+  return num_buckets;
+}
+
+
+static void count_answer_trie_switches(cmp_node_ptr current_node, int *num_switches, long *num_ptrs) {
+  /* only the levels reached through atomic and trie variable entries can be **
+  ** visited with a bound trie variable by load_compact_subsumed_answers()   */
+  long atomic_nodes, var_nodes;
+
+  if (count_answer_trie_level(current_node, &atomic_nodes, &var_nodes) >= MIN_NODES_PER_TRIE_SWITCH && atomic_nodes) {
+    (*num_switches)++;
+    *num_ptrs += answer_trie_switch_buckets(atomic_nodes) + var_nodes;
+  }
+  do {
+    Term t = CmpNode_entry(current_node);
+    if (! IS_COMPACT_LEAF_NODE(current_node) && (IS_SWITCH_ATOMIC_ENTRY(t) || IS_SWITCH_VAR_ENTRY(t)))
+      count_answer_trie_switches(CmpNode_child(current_node), num_switches, num_ptrs);
+    current_node = CmpNode_next(current_node);
+  } while (current_node);
+  return;
+}
+
+
+static void fill_answer_trie_switches(cmp_node_ptr current_node, ans_sw_ptr *sw_ptr, cmp_node_ptr **free_ptr) {
+  /* the switches are filled in the order of the levels in the compact trie, **
+  ** thus they are sorted by the address of their first node                 */
+  long atomic_nodes, var_nodes;
+  cmp_node_ptr level = current_node;
+
+  if (count_answer_trie_level(current_node, &atomic_nodes, &var_nodes) >= MIN_NODES_PER_TRIE_SWITCH && atomic_nodes) {
+    ans_sw_ptr sw = (*sw_ptr)++;
+    unsigned int num_buckets = answer_trie_switch_buckets(atomic_nodes);
+    AnsSw_level(sw) = level;
+    AnsSw_num_buckets(sw) = num_buckets;
+    AnsSw_num_var_nodes(sw) = 0;
+    AnsSw_buckets(sw) = *free_ptr;
+    AnsSw_var_nodes(sw) = *free_ptr + num_buckets;
+    *free_ptr += num_buckets + var_nodes;
+    memset(AnsSw_buckets(sw), 0, num_buckets * sizeof(cmp_node_ptr));
+    do {
+      Term t = CmpNode_entry(current_node);
+      if (IS_SWITCH_ATOMIC_ENTRY(t)) {
+        unsigned int i = HASH_ENTRY(t, num_buckets);
+        while (AnsSw_buckets(sw)[i])
+          i = (i + 1) & (num_buckets - 1);
+        AnsSw_buckets(sw)[i] = current_node;
+      } else if (IS_SWITCH_VAR_ENTRY(t))
+        AnsSw_var_nodes(sw)[AnsSw_num_var_nodes(sw)++] = current_node;
+      current_node = CmpNode_next(current_node);
+    } while (current_node);
+    current_node = level;
+  }
+  do {
+    Term t = CmpNode_entry(current_node);
+    if (! IS_COMPACT_LEAF_NODE(current_node) && (IS_SWITCH_ATOMIC_ENTRY(t) || IS_SWITCH_VAR_ENTRY(t)))
+      fill_answer_trie_switches(CmpNode_child(current_node), sw_ptr, free_ptr);
+    current_node = CmpNode_next(current_node);
+  } while (current_node);
+  return;
+}
+
+
+static ans_sw_tab_ptr build_answer_trie_switches(cmp_node_ptr cmp_trie) {
+  /* an answer trie without wide levels gets an empty table, thus its **
+  ** levels are not counted again by the next subsumed calls          */
+  ans_sw_tab_ptr sw_tab;
+  ans_sw_ptr sw;
+  cmp_node_ptr *free_ptr;
+  int num_switches = 0;
+  long num_ptrs = 0;
+
+  count_answer_trie_switches(cmp_trie, &num_switches, &num_ptrs);
+  ALLOC_BLOCK(sw_tab, sizeof(struct answer_trie_switch_table) + num_switches * sizeof(struct answer_trie_switch) + num_ptrs * sizeof(cmp_node_ptr), struct answer_trie_switch_table);
+  sw = (ans_sw_ptr) (sw_tab + 1);
+  free_ptr = (cmp_node_ptr *) (sw + num_switches);
+  AnsSwTab_num_switches(sw_tab) = num_switches;
+  AnsSwTab_switches(sw_tab) = sw;
+  if (num_switches)
+    fill_answer_trie_switches(cmp_trie, &sw, &free_ptr);
+  return sw_tab;
+}
+
+
+static ans_sw_ptr find_answer_trie_switch(ans_sw_tab_ptr sw_tab, cmp_node_ptr level) {
+  ans_sw_ptr switches = AnsSwTab_switches(sw_tab);
+  int low = 0, high = AnsSwTab_num_switches(sw_tab) - 1;
+
+  while (low <= high) {
+    int middle = (low + high) / 2;
+    if (AnsSw_level(switches + middle) == level)
+      return switches + middle;
+    if (AnsSw_level(switches + middle) < level)
+      low = middle + 1;
+    else
+      high = middle - 1;
+  }
+  return NULL;
+}
+
+
+static cmp_node_ptr lookup_answer_trie_switch(ans_sw_ptr sw, Term t) {
+  unsigned int i = HASH_ENTRY(t, AnsSw_num_buckets(sw));
+  cmp_node_ptr node;
+
+  while ((node = AnsSw_buckets(sw)[i])) {
+    if (CmpNode_entry(node) == t)
+      return node;
+    i = (i + 1) & (AnsSw_num_buckets(sw) - 1);
+  }
+  return NULL;
+}
+
+#undef IS_SWITCH_ATOMIC_ENTRY
+#undef IS_SWITCH_VAR_ENTRY
+#endif /* ANSWER_TRIE_SWITCHES */
+
+
+static void complete_subsumed_subgoal(tab_ent_ptr tab_ent, sg_fr_ptr sg_fr, sg_node_ptr leaf_node, int pred_arity, CELL *subs_ptr USES_REGS) {
+  /* if a completed subgoal of tab_ent subsumes the new subgoal sg_fr, the answers **
+  ** of the subsuming subgoal that unify with the call are copied to sg_fr, which  **
+  ** is then marked as completed and executes as any other completed subgoal       */
+  struct subsumption_data sd;
+  sg_node_ptr root_node = get_insert_subgoal_trie(tab_ent PASS_REGS);
+  sg_fr_ptr gen_sg_fr;
+  int i;
+
+  if (pred_arity == 0 || pred_arity > SUBSUMPTION_STACK_SIZE || TrNode_child(root_node) == NULL)
+    return;
+#ifdef MODE_DIRECTED_TABLING
+  if (TabEnt_mode_directed(tab_ent))
+    return;
+#endif /* MODE_DIRECTED_TABLING */
+  sd.leaf_node = leaf_node;
+  sd.depth = 0;
+  sd.subs_arity = 0;
+#ifdef ANSWER_TRIE_SWITCHES
+  sd.switches = NULL;
+#endif /* ANSWER_TRIE_SWITCHES */
+  for (i = 1; i <= pred_arity; i++) {
+    sd.stack[pred_arity - i].kind = SUBSUMPTION_TERM;
+    sd.stack[pred_arity - i].term = Deref(XREGS[i]);
+  }
+  gen_sg_fr = find_subsuming_subgoal(TrNode_child(root_node), &sd, pred_arity, 0);
+  if (gen_sg_fr == NULL)
+    return;
+
+  LOCK_SG_FR(gen_sg_fr);
+  if (IS_COMPACT_ANSWER_TRIE(gen_sg_fr)) {
+#ifdef COMPACT_ANSWER_TRIES
+    cmp_node_ptr cmp_trie = (cmp_node_ptr) TrNode_child(SgFr_answer_trie(gen_sg_fr));
+    if (cmp_trie) {
+      struct answer_trie_node aux_root_node;
+#ifdef ANSWER_TRIE_SWITCHES
+      if (SgFr_answer_switches(gen_sg_fr) == NULL)
+        SgFr_answer_switches(gen_sg_fr) = build_answer_trie_switches(cmp_trie);
+      sd.switches = SgFr_answer_switches(gen_sg_fr);
+#endif /* ANSWER_TRIE_SWITCHES */
+      TrNode_parent(&aux_root_node) = NULL;
+      load_compact_subsumed_answers(sg_fr, cmp_trie, &aux_root_node, 0, &sd, subs_ptr PASS_REGS);
+    }
+#endif /* COMPACT_ANSWER_TRIES */
+  } else {
+    ans_node_ptr ans_node = SgFr_first_answer(gen_sg_fr);
+    while (ans_node) {
+      if (load_subsumed_answer(sg_fr, ans_node, &sd, subs_ptr PASS_REGS))
+        break;
+      ans_node = TrNode_child(ans_node);
+    }
+  }
+  UNLOCK_SG_FR(gen_sg_fr);
+  mark_as_completed(sg_fr);
+#ifdef LIMIT_TABLING
+  insert_into_global_sg_fr_list(sg_fr);
+#endif /* LIMIT_TABLING */
+  return;
+}
+#endif /* TABLING_CALL_SUBSUMPTION */
+
+
+#if defined(INCREMENTAL_TABLING) || defined(EPOCH_RECLAMATION)
+choiceptr oldest_loading_choice_point(void) {
+  /* returns the oldest choice point that may still load the answers of a completed **
+  ** subgoal, i.e. the oldest loader node or node of the trie instructions           */
+  CACHE_REGS
+  choiceptr cp = B, oldest_cp = NULL;
+
+  while (cp) {
+    if (cp->cp_ap) {
+      op_numbers op = Yap_op_from_opcode(cp->cp_ap->opc);
+      if (op == _table_load_answer || (op >= _trie_do_var && op <= _trie_retry_gterm))
+        oldest_cp = cp;
+    }
+    cp = cp->cp_b;
+  }
+  return oldest_cp;
+}
+#endif /* INCREMENTAL_TABLING || EPOCH_RECLAMATION */
+
+
+#ifdef INCREMENTAL_TABLING
+static inline void record_incremental_dependency(inc_dep_ptr *dependents USES_REGS) {
+  /* a new subgoal is pushed on the LOCAL_top_sg_fr chain with the previous top subgoal as **
+  ** its dependent, thus the dependents of the top subgoal reach any subgoal on the chain, **
+  ** including the one that made the call                                                  */
+  sg_fr_ptr sg_fr = LOCAL_top_sg_fr;
+  tab_ent_ptr tab_ent;
+  inc_dep_ptr inc_dep;
+
+  if (sg_fr == NULL)
+    return;
+  tab_ent = SgFr_tab_ent(sg_fr);
+  if (! IsMode_Incremental(TabEnt_flags(tab_ent)))
+    return;
+  inc_dep = *dependents;
+  if (inc_dep && IncDep_sg_fr(inc_dep) == sg_fr && IncDep_generation(inc_dep) == TabEnt_generation(tab_ent))
+    return;  /* already recorded by the previous call */
+  new_incremental_dependency(inc_dep, sg_fr, *dependents);
+  *dependents = inc_dep;
+  return;
+}
+
+
+static inline inc_pred_ptr find_incremental_predicate(PredEntry *pe) {
+  inc_pred_ptr inc_pred = GLOBAL_root_inc_pred;
+
+  while (inc_pred && IncPred_pe(inc_pred) != pe)
+    inc_pred = IncPred_next(inc_pred);
+  return inc_pred;
+}
+
+
+static void retire_subgoal_frame(tab_ent_ptr tab_ent, sg_fr_ptr sg_fr) {
+  /* invalidated subgoal frames are replaced by new ones and kept until the choice points **
+  ** that may still load their answers are gone. The generator choice point of a retired  **
+  ** frame is no longer used, thus it is reused to store the oldest of such choice points  */
+  free_incremental_dependencies(SgFr_inc_dependents(sg_fr));
+  SgFr_inc_dependents(sg_fr) = NULL;
+  SgFr_gen_cp(sg_fr) = oldest_loading_choice_point();
+  SgFr_next(sg_fr) = TabEnt_retired_sg_fr(tab_ent);
+  TabEnt_retired_sg_fr(tab_ent) = sg_fr;
+  return;
+}
+
+
+static void free_incremental_dependencies(inc_dep_ptr inc_dep) {
+  while (inc_dep) {
+    inc_dep_ptr next_inc_dep = IncDep_next(inc_dep);
+    FREE_INCREMENTAL_DEPENDENCY(inc_dep);
+    inc_dep = next_inc_dep;
+  }
+  return;
+}
+
+
+static void free_retired_subgoal_frames(tab_ent_ptr tab_ent, int abolish) {
+  /* unless the table is being abolished, only the frames whose oldest **
+  ** loading choice point was meanwhile removed are released           */
+  CACHE_REGS
+  sg_fr_ptr sg_fr = TabEnt_retired_sg_fr(tab_ent);
+  sg_fr_ptr *sg_fr_ptr_ptr = &TabEnt_retired_sg_fr(tab_ent);
+
+  while (sg_fr) {
+    sg_fr_ptr next_sg_fr = SgFr_next(sg_fr);
+    if (! abolish && SgFr_gen_cp(sg_fr) && EQUAL_OR_YOUNGER_CP(B, SgFr_gen_cp(sg_fr))) {
+      sg_fr_ptr_ptr = &SgFr_next(sg_fr);
+      sg_fr = next_sg_fr;
+      continue;
+    }
+    *sg_fr_ptr_ptr = next_sg_fr;
+    free_answer_hash_chain(SgFr_hash_chain(sg_fr));
+    if (TrNode_child(SgFr_answer_trie(sg_fr))) {
+      FREE_SUBGOAL_ANSWER_TRIE(sg_fr);
+    }
+    FREE_ANSWER_TRIE_NODE(SgFr_answer_trie(sg_fr));
+#ifdef MODE_DIRECTED_TABLING
+    if (SgFr_mode_directed(sg_fr))
+      FREE_BLOCK(SgFr_mode_directed(sg_fr));
+#endif /* MODE_DIRECTED_TABLING */
+    free_incremental_dependencies(SgFr_inc_dependents(sg_fr));
+    FREE_SUBGOAL_FRAME(sg_fr);
+    sg_fr = next_sg_fr;
+  }
+  return;
+}
+#endif /* INCREMENTAL_TABLING */
+
+
+#ifdef DEFERRED_ABOLISH
+static void defer_subgoal_trie(tab_ent_ptr tab_ent, sg_node_ptr chain USES_REGS) {
+  /* the detached subgoal trie is freed later by free_abolished_subtrie() */
+  ab_trie_ptr ab_trie;
+
+#ifdef LIMIT_TABLING
+  { /* the subgoals of the detached trie cannot be released by limit_table_space() */
+    sg_fr_ptr sg_fr = LOCAL_first_sg_fr;
+    while (sg_fr) {
+      sg_fr_ptr next_sg_fr = SgFr_next(sg_fr);
+      if (SgFr_tab_ent(sg_fr) == tab_ent) {
+	remove_from_global_sg_fr_list(sg_fr);
+      }
+      sg_fr = next_sg_fr;
+    }
+  }
+#endif /* LIMIT_TABLING */
+  ALLOC_BLOCK(ab_trie, sizeof(struct abolished_trie), struct abolished_trie);
+  AbTrie_chain(ab_trie) = chain;
+  LOCK(GLOBAL_abolished_tries_lock);
+  AbTrie_next(ab_trie) = GLOBAL_abolished_tries;
+  GLOBAL_abolished_tries = ab_trie;
+  GLOBAL_abolished_tries_pending++;
+  UNLOCK(GLOBAL_abolished_tries_lock);
+  return;
+}
+#endif /* DEFERRED_ABOLISH */
+
+
+#ifdef GROUND_CALL_HASHING
+static int expand_ground_call_buffer(UInt needed) {
+  CELL *new_buffer;
+  UInt new_size;
+
+  if (needed > GROUND_CALL_MAX_CELLS)
+    return FALSE;
+  new_size = GLOBAL_ground_call_buffer_size ? GLOBAL_ground_call_buffer_size : 4 * GROUND_CALL_MIN_CELLS;
+  while (new_size < needed)
+    new_size *= 2;
+  if (new_size > GROUND_CALL_MAX_CELLS)
+    new_size = GROUND_CALL_MAX_CELLS;
+  ALLOC_BLOCK(new_buffer, new_size * sizeof(CELL), CELL);
+  if (GLOBAL_ground_call_buffer) {
+    memcpy((void *)new_buffer, (void *)GLOBAL_ground_call_buffer, GLOBAL_ground_call_buffer_size * sizeof(CELL));
+    FREE_BLOCK(GLOBAL_ground_call_buffer);
+  }
+  GLOBAL_ground_call_buffer = new_buffer;
+  GLOBAL_ground_call_buffer_size = new_size;
+  return TRUE;
+}
+
+
+static int flatten_ground_term(Term t, UInt *size_ptr, int depth) {
+  /* appends the cells of a ground term to the ground call buffer. Fails on variables,
+  ** on opaque terms and on terms too large or too deep to be worth hashing. The last
+  ** argument of compound terms and the tail of lists are flattened iteratively */
+  UInt size = *size_ptr;
+
+  if (depth > GROUND_CALL_MAX_DEPTH)
+    return FALSE;
+  while (TRUE) {
+    t = Deref(t);
+    if (size + 3 > GLOBAL_ground_call_buffer_size && ! expand_ground_call_buffer(size + 3))
+      return FALSE;
+    if (IsVarTerm(t)) {
+      return FALSE;
+    } else if (IsAtomOrIntTerm(t)) {
+      GLOBAL_ground_call_buffer[size++] = t;
+      break;
+    } else if (IsPairTerm(t)) {
+      CELL *aux_pair = RepPair(t);
+      GLOBAL_ground_call_buffer[size++] = AbsPair(NULL);
+      *size_ptr = size;
+      if (! flatten_ground_term(aux_pair[0], size_ptr, depth + 1))
+        return FALSE;
+      size = *size_ptr;
+      t = aux_pair[1];
+    } else {
+      Functor f = FunctorOfTerm(t);
+      CELL *aux_appl = RepAppl(t);
+      if (f == FunctorDouble) {
+        GLOBAL_ground_call_buffer[size++] = AbsAppl((Term *)f);
+#if SIZEOF_DOUBLE == 2 * SIZEOF_INT_P
+        GLOBAL_ground_call_buffer[size++] = aux_appl[2];
+#endif /* SIZEOF_DOUBLE x SIZEOF_INT_P */
+        GLOBAL_ground_call_buffer[size++] = aux_appl[1];
+        break;
+      } else if (f == FunctorLongInt) {
+        GLOBAL_ground_call_buffer[size++] = AbsAppl((Term *)f);
+        GLOBAL_ground_call_buffer[size++] = aux_appl[1];
+        break;
+      } else if (IsExtensionFunctor(f)) {
+        return FALSE;
+      } else {
+        int i, arity = ArityOfFunctor(f);
+        GLOBAL_ground_call_buffer[size++] = AbsAppl((Term *)f);
+        *size_ptr = size;
+        for (i = 1; i < arity; i++)
+          if (! flatten_ground_term(aux_appl[i], size_ptr, depth + 1))
+            return FALSE;
+        size = *size_ptr;
+        t = aux_appl[arity];
+      }
+    }
+  }
+  *size_ptr = size;
+  return TRUE;
+}
+
+
+static inline UInt flatten_ground_call(int arity, CELL *hash_ptr USES_REGS) {
+  /* returns the number of cells of the flattened call, or zero if the call is too small or if
+  ** it has arguments that are neither ground nor distinct free variables. The free variables
+  ** are flattened as the subgoal trie variables they are given by subgoal_search_loop() */
+  CELL hash;
+  UInt size = 0;
+  int i, j, vars = 0;
+
+  for (i = 1; i <= arity; i++) {
+    Term t = Deref(XREGS[i]);
+    if (IsVarTerm(t))
+      for (j = 1; j < i; j++)
+        if (Deref(XREGS[j]) == t)
+          return 0;
+  }
+  for (i = 1; i <= arity; i++) {
+    Term t = Deref(XREGS[i]);
+    if (IsVarTerm(t)) {
+      if (size + 1 > GLOBAL_ground_call_buffer_size && ! expand_ground_call_buffer(size + 1))
+        return 0;
+      GLOBAL_ground_call_buffer[size++] = MakeTableVarTerm(vars);
+      vars++;
+    } else if (! flatten_ground_term(t, &size, 0))
+      return 0;
+  }
+  if (size < GROUND_CALL_MIN_CELLS)
+    return 0;
+  hash = (CELL) size;
+  for (i = 0; i < size; i++)
+    hash = (hash ^ (GLOBAL_ground_call_buffer[i] >> 3)) * 16777619;
+  *hash_ptr = hash ^ (hash >> 16);
+  return size;
+}
+
+
+static inline sg_node_ptr lookup_ground_call(tab_ent_ptr tab_ent, CELL hash, UInt size) {
+  gr_hash_ptr gr_hash = TabEnt_ground_calls(tab_ent);
+  gr_call_ptr gr_call;
+
+  GLOBAL_ground_call_lookups++;
+  if (gr_hash == NULL)
+    return NULL;
+  gr_call = GrHash_buckets(gr_hash)[hash & (GrHash_num_buckets(gr_hash) - 1)];
+  while (gr_call) {
+    if (GrCall_hash(gr_call) == hash && GrCall_size(gr_call) == size &&
+        memcmp((void *)GrCall_cells(gr_call), (void *)GLOBAL_ground_call_buffer, size * sizeof(CELL)) == 0) {
+      GLOBAL_ground_call_hits++;
+      return GrCall_leaf(gr_call);
+    }
+    gr_call = GrCall_next(gr_call);
+  }
+  return NULL;
+}
+
+
+static void insert_ground_call(tab_ent_ptr tab_ent, CELL hash, UInt size, sg_node_ptr leaf) {
+  gr_hash_ptr gr_hash = TabEnt_ground_calls(tab_ent);
+  gr_call_ptr gr_call, *bucket;
+
+  if (gr_hash == NULL) {
+    ALLOC_BLOCK(gr_hash, sizeof(struct ground_call_hash), struct ground_call_hash);
+    GrHash_num_buckets(gr_hash) = GROUND_CALL_BASE_BUCKETS;
+    GrHash_num_calls(gr_hash) = 0;
+    ALLOC_BLOCK(GrHash_buckets(gr_hash), GROUND_CALL_BASE_BUCKETS * sizeof(gr_call_ptr), gr_call_ptr);
+    INIT_BUCKETS(GrHash_buckets(gr_hash), GROUND_CALL_BASE_BUCKETS);
+    TabEnt_ground_calls(tab_ent) = gr_hash;
+  } else if (GrHash_num_calls(gr_hash) > 2 * GrHash_num_buckets(gr_hash)) {
+    /* expand the hash table */
+    gr_call_ptr *old_buckets = GrHash_buckets(gr_hash);
+    UInt i, old_num_buckets = GrHash_num_buckets(gr_hash);
+    GrHash_num_buckets(gr_hash) = 2 * old_num_buckets;
+    ALLOC_BLOCK(GrHash_buckets(gr_hash), GrHash_num_buckets(gr_hash) * sizeof(gr_call_ptr), gr_call_ptr);
+    INIT_BUCKETS(GrHash_buckets(gr_hash), GrHash_num_buckets(gr_hash));
+    for (i = 0; i < old_num_buckets; i++) {
+      gr_call = old_buckets[i];
+      while (gr_call) {
+        gr_call_ptr next_gr_call = GrCall_next(gr_call);
+        bucket = GrHash_buckets(gr_hash) + (GrCall_hash(gr_call) & (GrHash_num_buckets(gr_hash) - 1));
+        GrCall_next(gr_call) = *bucket;
+        *bucket = gr_call;
+        gr_call = next_gr_call;
+      }
+    }
+    FREE_BLOCK(old_buckets);
+  }
+  ALLOC_BLOCK(gr_call, sizeof(struct ground_call) + (size - 1) * sizeof(CELL), struct ground_call);
+  GrCall_hash(gr_call) = hash;
+  GrCall_size(gr_call) = size;
+  GrCall_leaf(gr_call) = leaf;
+  memcpy((void *)GrCall_cells(gr_call), (void *)GLOBAL_ground_call_buffer, size * sizeof(CELL));
+  bucket = GrHash_buckets(gr_hash) + (hash & (GrHash_num_buckets(gr_hash) - 1));
+  GrCall_next(gr_call) = *bucket;
+  *bucket = gr_call;
+  GrHash_num_calls(gr_hash)++;
+  return;
+}
+
+
+static void free_ground_calls(tab_ent_ptr tab_ent) {
+  gr_hash_ptr gr_hash = TabEnt_ground_calls(tab_ent);
+  UInt i;
+
+  if (gr_hash == NULL)
+    return;
+  TabEnt_ground_calls(tab_ent) = NULL;
+  for (i = 0; i < GrHash_num_buckets(gr_hash); i++) {
+    gr_call_ptr gr_call = GrHash_buckets(gr_hash)[i];
+    while (gr_call) {
+      gr_call_ptr next_gr_call = GrCall_next(gr_call);
+      FREE_BLOCK(gr_call);
+      gr_call = next_gr_call;
+    }
+  }
+  FREE_BLOCK(GrHash_buckets(gr_hash));
+  FREE_BLOCK(gr_hash);
+  return;
+}
+#endif /* GROUND_CALL_HASHING */
+
+#ifdef TABLE_SNAPSHOTS
+static int snapshot_symbols_init(struct table_snapshot_symbols *symbols) {
+  /* returns FALSE if the map cannot be allocated, the map can be freed anyway */
+  symbols->size = 256;
+  symbols->entries = 0;
+  symbols->keys = (CELL *) calloc(symbols->size, sizeof(CELL));
+  symbols->values = (CELL *) calloc(symbols->size, sizeof(CELL));
+  return (symbols->keys && symbols->values);
+}
+
+
+static int snapshot_symbols_insert(struct table_snapshot_symbols *symbols, CELL key, CELL value) {
+  /* returns FALSE if the map cannot grow, the map is then left unchanged */
+  long i;
+
+  if (2 * (symbols->entries + 1) > symbols->size) {
+    /* double the map and insert again the old entries */
+    CELL *old_keys = symbols->keys, *old_values = symbols->values;
+    long old_size = symbols->size;
+    CELL *new_keys = (CELL *) calloc(2 * old_size, sizeof(CELL));
+    CELL *new_values = (CELL *) calloc(2 * old_size, sizeof(CELL));
+    if (new_keys == NULL || new_values == NULL) {
+      free(new_keys);
+      free(new_values);
+      return FALSE;
+    }
+    symbols->keys = new_keys;
+    symbols->values = new_values;
+    symbols->size = 2 * old_size;
+    symbols->entries = 0;
+    for (i = 0; i < old_size; i++)
+      if (old_keys[i])
+        snapshot_symbols_insert(symbols, old_keys[i], old_values[i]);
+    free(old_keys);
+    free(old_values);
+  }
+  i = SNAPSHOT_SYMBOLS_SLOT(symbols, key);
+  while (symbols->keys[i] && symbols->keys[i] != key)
+    i = (i + 1) & (symbols->size - 1);
+  if (symbols->keys[i] == 0) {
+    symbols->keys[i] = key;
+    symbols->entries++;
+  }
+  symbols->values[i] = value;
+  return TRUE;
+}
+
+
+static int snapshot_symbols_lookup(struct table_snapshot_symbols *symbols, CELL key, CELL *value) {
+  long i = SNAPSHOT_SYMBOLS_SLOT(symbols, key);
+
+  while (symbols->keys[i]) {
+    if (symbols->keys[i] == key) {
+      *value = symbols->values[i];
+      return TRUE;
+    }
+    i = (i + 1) & (symbols->size - 1);
+  }
+  return FALSE;
+}
+
+
+static void snapshot_symbols_free(struct table_snapshot_symbols *symbols) {
+  free(symbols->keys);
+  free(symbols->values);
+  return;
+}
+
+
+static size_t snapshot_put(struct table_snapshot_writer *sw, void *data, size_t size) {
+  /* appends the data to the buffer of the writer, padded to a CELL boundary, **
+  ** and returns its offset in the buffer. If the buffer cannot grow, nothing  **
+  ** is appended and the writer is marked as out of memory                    */
+  size_t offset = sw->buffer_top;
+  size_t aligned_size = TABLE_SNAPSHOT_ALIGN(size);
+
+  if (sw->out_of_memory)
+    return offset;
+  while (sw->buffer_top + aligned_size > sw->buffer_size) {
+    char *buffer = (char *) realloc(sw->buffer, 2 * sw->buffer_size);
+    if (buffer == NULL) {
+      sw->out_of_memory = TRUE;
+      return offset;
+    }
+    sw->buffer = buffer;
+    sw->buffer_size *= 2;
+  }
+  memcpy(sw->buffer + offset, data, size);
+  memset(sw->buffer + offset + size, 0, aligned_size - size);
+  sw->buffer_top += aligned_size;
+  return offset;
+}
+
+
+static CELL snapshot_checksum(CELL checksum, char *data, size_t size) {
+  /* the size is a multiple of CELL, as the records of the file are padded */
+  CELL *ptr = (CELL *) data, *end = (CELL *) (data + size);
+
+  while (ptr < end) {
+    checksum ^= *ptr++;
+    checksum *= TABLE_SNAPSHOT_CHECKSUM_PRIME;
+  }
+  return checksum;
+}
+
+
+static inline int snapshot_entry_mode(Term t, int mode, int closing) {
+  /* returns the traverse mode of the entry that follows t, or -1 if t cannot be **
+  ** saved. Only the answer tries have closing functors after the double and    **
+  ** long int values (closing == TRUE)                                          */
+  if (mode == TRAVERSE_MODE_NORMAL) {
+    if (IsVarTerm(t) && t >= MakeTableVarTerm(MAX_TABLE_VARS))
+      return -1;  /* global trie and rational term references */
+    if (IsApplTerm(t)) {
+      Functor f = (Functor) RepAppl(t);
+      if (f == FunctorDouble)
+	return TRAVERSE_MODE_DOUBLE;
+      if (f == FunctorLongInt)
+	return TRAVERSE_MODE_LONGINT;
+      if (IsExtensionFunctor(f))
+	return -1;  /* big ints, strings and data-base references */
+    }
+    return TRAVERSE_MODE_NORMAL;
+  }
+  if (mode == TRAVERSE_MODE_DOUBLE) {
+#if SIZEOF_DOUBLE == 2 * SIZEOF_INT_P
+    return TRAVERSE_MODE_DOUBLE2;
+  }
+  if (mode == TRAVERSE_MODE_DOUBLE2) {
+#endif /* SIZEOF_DOUBLE x SIZEOF_INT_P */
+    return closing ? TRAVERSE_MODE_DOUBLE_END : TRAVERSE_MODE_NORMAL;
+  }
+  if (mode == TRAVERSE_MODE_LONGINT)
+    return closing ? TRAVERSE_MODE_LONGINT_END : TRAVERSE_MODE_NORMAL;
+  return TRAVERSE_MODE_NORMAL;  /* TRAVERSE_MODE_DOUBLE_END || TRAVERSE_MODE_LONGINT_END */
+}
+
+
+static void snapshot_register_entry(struct table_snapshot_writer *sw, Term t) {
+  if (IsAtomTerm(t)) {
+    if (! snapshot_symbols_insert(&sw->atoms, (CELL) AtomOfTerm(t), 0))
+      sw->out_of_memory = TRUE;
+  } else if (IsApplTerm(t) && ! IsExtensionFunctor((Functor) RepAppl(t))) {
+    Functor f = (Functor) RepAppl(t);
+    if (! snapshot_symbols_insert(&sw->functors, (CELL) f, 0) ||
+	! snapshot_symbols_insert(&sw->atoms, (CELL) NameOfFunctor(f), 0))
+      sw->out_of_memory = TRUE;
+  }
+  return;
+}
+
+
+static int snapshot_relocate_entry(Term *t_ptr, struct table_snapshot_symbols *atoms, struct table_snapshot_symbols *functors) {
+  Term t = *t_ptr;
+  CELL value;
+
+  if (IsAtomTerm(t)) {
+    if (! snapshot_symbols_lookup(atoms, (CELL) AtomOfTerm(t), &value))
+      return FALSE;
+    *t_ptr = MkAtomTerm((Atom) value);
+  } else if (IsApplTerm(t) && ! IsExtensionFunctor((Functor) RepAppl(t))) {
+    if (! snapshot_symbols_lookup(functors, (CELL) RepAppl(t), &value))
+      return FALSE;
+    *t_ptr = AbsAppl((Term *) value);
+  }
+  return TRUE;
+}
+
+
+static long snapshot_answer_trie(struct table_snapshot_writer *sw, cmp_node_ptr current_node, int mode) {
+  /* registers the atoms and functors of the compact answer trie and returns **
+  ** its number of nodes, or -1 if the trie has entries that cannot be saved */
+  long nodes = 0;
+
+  do {
+    Term t = CmpNode_entry(current_node);
+    int child_mode = snapshot_entry_mode(t, mode, TRUE);
+    if (child_mode < 0)
+      return -1;
+    if (mode == TRAVERSE_MODE_NORMAL)
+      snapshot_register_entry(sw, t);
+    nodes++;
+    if (! IS_COMPACT_LEAF_NODE(current_node)) {
+      long child_nodes = snapshot_answer_trie(sw, CmpNode_child(current_node), child_mode);
+      if (child_nodes < 0)
+	return -1;
+      nodes += child_nodes;
+    }
+    current_node = CmpNode_next(current_node);
+  } while (current_node);
+  return nodes;
+}
+
+
+static cmp_node_ptr snapshot_relocate_answer_trie(cmp_node_ptr current_node, cmp_node_ptr end_node, int mode, struct table_snapshot_symbols *atoms, struct table_snapshot_symbols *functors) {
+  /* relocates the trie level of current_node, and the levels below, and returns  **
+  ** the first node after them, or NULL if the nodes are corrupted. The nodes must **
+  ** be laid out before end_node as by compact_answer_trie_branch(): the child of  **
+  ** a node follows it and its next sibling follows the levels below it           */
+  cmp_node_ptr next_node;
+
+  do {
+    int child_mode;
+    op_numbers op;
+    if (current_node >= end_node)
+      return NULL;
+    child_mode = snapshot_entry_mode(CmpNode_entry(current_node), mode, TRUE);
+    op = (op_numbers) CmpNode_instr(current_node);
+    if (child_mode < 0 || op > _std_top)
+      return NULL;
+    CmpNode_instr(current_node) = Yap_opcode(op);
+    if (mode == TRAVERSE_MODE_NORMAL && ! snapshot_relocate_entry(&CmpNode_entry(current_node), atoms, functors))
+      return NULL;
+    next_node = current_node + 1;
+    if (! IS_COMPACT_LEAF_NODE(current_node) &&
+	(next_node = snapshot_relocate_answer_trie(next_node, end_node, child_mode, atoms, functors)) == NULL)
+      return NULL;
+    if (CmpNode_next(current_node) == NULL)
+      return next_node;
+    if ((CELL) (CmpNode_offset(current_node) >> 1) != (CELL) (next_node - current_node))
+      return NULL;
+    current_node = next_node;
+  } while (TRUE);
+}
+
+
+static int snapshot_relocate_subgoal_path(CELL *path, CELL depth, int arity, struct table_snapshot_symbols *atoms, struct table_snapshot_symbols *functors) {
+  /* relocates the entries of the path and checks that they encode exactly   **
+  ** arity terms as by subgoal_search_loop(), with the variables numbered in **
+  ** order of appearance. Returns TRUE, FALSE if the path is not well formed **
+  ** or -1 if there is no memory. terms[l] holds the number of terms still   **
+  ** to read above the l-th pending list tail (TRIE_COMPACT_PAIRS)           */
+  CELL *terms, k, vars = 0;
+  int level = 0, mode = TRAVERSE_MODE_NORMAL;
+
+  if ((terms = (CELL *) malloc((depth + 1) * sizeof(CELL))) == NULL)
+    return -1;
+  terms[0] = arity;
+  for (k = 0; k < depth; k++) {
+    Term t = path[k];
+    int next_mode = snapshot_entry_mode(t, mode, FALSE);
+    if (next_mode < 0)
+      break;
+    if (mode != TRAVERSE_MODE_NORMAL) {
+      /* double and long int values */
+      mode = next_mode;
+      continue;
+    }
+    mode = next_mode;
+    if (! snapshot_relocate_entry(path + k, atoms, functors))
+      break;
+    t = path[k];
+    if (terms[level] == 0) {
+      if (level == 0)
+	break;
+#ifdef TRIE_COMPACT_PAIRS
+      /* a list tail is pending */
+      if (t == CompactPairEndList || t == CompactPairEndTerm) {
+	terms[--level]++;
+	continue;
+      }
+      terms[level] = 1;
+#endif /* TRIE_COMPACT_PAIRS */
+    }
+    terms[level]--;
+    if (IsVarTerm(t)) {
+      if ((CELL) VarIndexOfTableTerm(t) > vars)
+	break;
+      if ((CELL) VarIndexOfTableTerm(t) == vars)
+	vars++;
+    } else if (IsPairTerm(t)) {
+#ifdef TRIE_COMPACT_PAIRS
+      if (t != CompactPairInit)
+	break;
+      if (k + 1 < depth && path[k + 1] == CompactPairEndList) {
+	terms[level]++;
+	k++;
+      } else
+	terms[++level] = 1;
+#else
+      terms[level] += 2;
+#endif /* TRIE_COMPACT_PAIRS */
+    } else if (IsApplTerm(t) && ! IsExtensionFunctor((Functor) RepAppl(t))) {
+      terms[level] += ArityOfFunctor((Functor) RepAppl(t));
+    }
+  }
+  k = (k == depth && level == 0 && terms[0] == 0 && mode == TRAVERSE_MODE_NORMAL);
+  free(terms);
+  return (int) k;
+}
+
+
+static void snapshot_subgoal(struct table_snapshot_writer *sw, sg_fr_ptr sg_fr, int depth) {
+  /* appends the subgoal to the buffer of the writer. Incomplete subgoals and **
+  ** subgoals with entries that cannot be saved (big ints, strings, global    **
+  ** trie and rational term references) are not saved                         */
+  cmp_node_ptr cmp_trie = NULL, aux_cmp_trie = NULL;
+  CELL nodes, aux_depth = depth;
+  long i, aux_nodes;
+  int mode = TRAVERSE_MODE_NORMAL;
+
+  if (SgFr_state(sg_fr) < complete || sw->out_of_memory)
+    return;
+  for (i = 0; i < depth; i++) {
+    int next_mode = snapshot_entry_mode(sw->path[i], mode, FALSE);
+    if (next_mode < 0)
+      return;
+    if (mode == TRAVERSE_MODE_NORMAL)
+      snapshot_register_entry(sw, sw->path[i]);
+    mode = next_mode;
+  }
+  LOCK_SG_FR(sg_fr);
+  if (SgFr_first_answer(sg_fr) == NULL) {
+    nodes = 0;
+  } else if (SgFr_first_answer(sg_fr) == SgFr_answer_trie(sg_fr)) {
+    nodes = TABLE_SNAPSHOT_YES;
+  } else {
+    long cmp_nodes;
+    if (SgFr_state(sg_fr) < compiled) {
+      /* the answer trie is not compacted in place as when the table is first **
+      ** executed, since it may still be in use by the loader nodes of the     **
+      ** load_answers mode. A compact copy is saved and then released instead  */
+      if (SgFr_compacted_trie(sg_fr) == NULL)
+	update_answer_trie_instructions(sg_fr);
+      aux_cmp_trie = build_compact_answer_trie(SgFr_compacted_trie(sg_fr), &aux_nodes);
+      cmp_trie = aux_cmp_trie;
+    } else
+      cmp_trie = (cmp_node_ptr) TrNode_child(SgFr_answer_trie(sg_fr));
+    cmp_nodes = snapshot_answer_trie(sw, cmp_trie, TRAVERSE_MODE_NORMAL);
+    if (cmp_nodes < 0) {
+      UNLOCK_SG_FR(sg_fr);
+      if (aux_cmp_trie) {
+	FREE_BLOCK(aux_cmp_trie);
+	UPDATE_COMPACT_ANSWER_TRIE_NODES(-aux_nodes);
+      }
+      return;
+    }
+    nodes = (CELL) cmp_nodes;
+  }
+  snapshot_put(sw, &aux_depth, sizeof(CELL));
+  if (depth)
+    snapshot_put(sw, sw->path, depth * sizeof(Term));
+  snapshot_put(sw, &nodes, sizeof(CELL));
+  if (cmp_trie) {
+    size_t offset = snapshot_put(sw, cmp_trie, nodes * sizeof(struct compact_answer_trie_node));
+    cmp_node_ptr cmp_node = (cmp_node_ptr) (sw->buffer + offset);
+    if (! sw->out_of_memory)
+      for (i = 0; i < (long) nodes; i++, cmp_node++)
+	CmpNode_instr(cmp_node) = (OPCODE) Yap_op_from_opcode(CmpNode_instr(cmp_node));
+  }
+  UNLOCK_SG_FR(sg_fr);
+  if (aux_cmp_trie) {
+    FREE_BLOCK(aux_cmp_trie);
+    UPDATE_COMPACT_ANSWER_TRIE_NODES(-aux_nodes);
+  }
+  sw->subgoals++;
+  return;
+}
+
+
+static void snapshot_subgoal_trie(struct table_snapshot_writer *sw, sg_node_ptr current_node, int depth) {
+  if (IS_SUBGOAL_TRIE_HASH(current_node)) {
+    sg_node_ptr *bucket, *last_bucket;
+    int array;
+    sg_hash_ptr hash;
+    hash = (sg_hash_ptr) current_node;
+    for (array = 0; array < TRIE_HASH_BUCKET_ARRAYS(hash); array++) {
+      bucket = TRIE_HASH_BUCKET_ARRAY(hash, array);
+      last_bucket = bucket + TRIE_HASH_BUCKET_ARRAY_SIZE(hash, array);
+      do {
+        if (*bucket)
+          snapshot_subgoal_trie(sw, *bucket, depth);
+      } while (++bucket != last_bucket);
+    }
+    return;
+  }
+
+  if (sw->out_of_memory)
+    return;
+  if (depth == sw->path_size) {
+    Term *path = (Term *) realloc(sw->path, 2 * sw->path_size * sizeof(Term));
+    if (path == NULL) {
+      sw->out_of_memory = TRUE;
+      return;
+    }
+    sw->path = path;
+    sw->path_size *= 2;
+  }
+  do {
+    sw->path[depth] = TrNode_entry(current_node);
+    if (IS_SUBGOAL_LEAF_NODE(current_node)) {
+      sg_fr_ptr sg_fr = get_subgoal_frame(current_node);
+      if (sg_fr)
+	snapshot_subgoal(sw, sg_fr, depth + 1);
+    } else
+      snapshot_subgoal_trie(sw, TrNode_child(current_node), depth + 1);
+    current_node = TrNode_next(current_node);
+  } while (current_node);
+  return;
+}
+
+
+static int release_table_snapshot_trie(cmp_node_ptr cmp_trie) {
+  /* returns TRUE if the compact answer trie is in a mapped table snapshot. **
+  ** The file is unmapped when its last loaded subgoal is released         */
+  tab_snap_ptr *tab_snap_addr = &GLOBAL_table_snapshots;
+
+  while (*tab_snap_addr) {
+    tab_snap_ptr tab_snap = *tab_snap_addr;
+    if ((char *) cmp_trie >= TabSnap_start(tab_snap) && (char *) cmp_trie < TabSnap_start(tab_snap) + TabSnap_size(tab_snap)) {
+      if (--TabSnap_subgoals(tab_snap) == 0) {
+	*tab_snap_addr = TabSnap_next(tab_snap);
+	munmap(TabSnap_start(tab_snap), TabSnap_size(tab_snap));
+	free(tab_snap);
+      }
+      return TRUE;
+    }
+    tab_snap_addr = &TabSnap_next(tab_snap);
+  }
+  return FALSE;
+}
+#endif /* TABLE_SNAPSHOTS */
+
+
+static void show_hash_histogram(long *histogram USES_REGS) {
+  int i, level, nodes;
+  long buckets = 0;
+
+  for (i = 0; i < HASH_HISTOGRAM_SIZE; i++)
+    buckets += histogram[i];
+  if (buckets == 0)
+    return;
+  Sfprintf(TrStat_out, "    Hash buckets with 0/1/2/.../%d+ nodes\n", HASH_HISTOGRAM_MAX_NODES);
+  for (level = 0; level < HASH_HISTOGRAM_LEVELS; level++) {
+    long *row = histogram + level * (HASH_HISTOGRAM_MAX_NODES + 1);
+    buckets = 0;
+    for (nodes = 0; nodes <= HASH_HISTOGRAM_MAX_NODES; nodes++)
+      buckets += row[nodes];
+    if (buckets) {
+      Sfprintf(TrStat_out, "      Level %d%s:", level + 1, level + 1 == HASH_HISTOGRAM_LEVELS ? "+" : "");
+      for (nodes = 0; nodes <= HASH_HISTOGRAM_MAX_NODES; nodes++)
+        Sfprintf(TrStat_out, " %ld", row[nodes]);
+      Sfprintf(TrStat_out, "\n");
+    }
+  }
+  return;
+}
+
+
 static void traverse_subgoal_trie(sg_node_ptr current_node, char *str, int str_index, int *arity, int mode, int position USES_REGS) {
   int *current_arity = NULL, current_str_index = 0, current_mode = 0;
 
   /* test if hashing */
   if (IS_SUBGOAL_TRIE_HASH(current_node)) {
     sg_node_ptr *bucket, *last_bucket;
+    int array;
     sg_hash_ptr hash;
     hash = (sg_hash_ptr) current_node;
-    bucket = Hash_buckets(hash);
-    last_bucket = bucket + Hash_num_buckets(hash);
+    UPDATE_HASH_BUCKETS_HISTOGRAM(HASH_HISTOGRAM_SUBGOAL, hash, sg_node_ptr, IS_SUBGOAL_TRIE_HASH, UNTAG_SUBGOAL_NODE);
     current_arity = (int *) malloc(sizeof(int) * (arity[0] + 1));
     memcpy(current_arity, arity, sizeof(int) * (arity[0] + 1));
-    do {
-      if (*bucket) {
-        traverse_subgoal_trie(*bucket, str, str_index, arity, mode, TRAVERSE_POSITION_FIRST PASS_REGS);
-	memcpy(arity, current_arity, sizeof(int) * (current_arity[0] + 1));
+    for (array = 0; array < TRIE_HASH_BUCKET_ARRAYS(hash); array++) {
+      bucket = TRIE_HASH_BUCKET_ARRAY(hash, array);
+      last_bucket = bucket + TRIE_HASH_BUCKET_ARRAY_SIZE(hash, array);
+      do {
+        if (*bucket) {
+          traverse_subgoal_trie(*bucket, str, str_index, arity, mode, TRAVERSE_POSITION_FIRST PASS_REGS);
+	  memcpy(arity, current_arity, sizeof(int) * (current_arity[0] + 1));
 #ifdef TRIE_COMPACT_PAIRS
-	if (arity[arity[0]] == -2 && str[str_index - 1] != '[')
-	  str[str_index - 1] = ',';
+	  if (arity[arity[0]] == -2 && str[str_index - 1] != '[')
+	    str[str_index - 1] = ',';
 #else
-	if (arity[arity[0]] == -1)
-	  str[str_index - 1] = '|';
+	  if (arity[arity[0]] == -1)
+	    str[str_index - 1] = '|';
 #endif /* TRIE_COMPACT_PAIRS */
-      }
-    } while (++bucket != last_bucket);
+        }
+      } while (++bucket != last_bucket);
+    }
     free(current_arity);
     return;
   }
@@ -671,7 +2271,14 @@ static void traverse_subgoal_trie(sg_node_ptr current_node, char *str, int str_i
 	SHOW_TABLE_STRUCTURE("    TRUE\n");
       } else {
 	arity[0] = 0;
-	traverse_answer_trie(TrNode_child(SgFr_answer_trie(sg_fr)), &str[str_index], 0, arity, 0, TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST PASS_REGS);
+	if (SgFr_state(sg_fr) >= compiled)
+	  TrStat_cmp_ans_tries++;
+#ifdef COMPACT_ANSWER_TRIES
+	if (IS_COMPACT_ANSWER_TRIE(sg_fr))
+	  traverse_compact_answer_trie((cmp_node_ptr) TrNode_child(SgFr_answer_trie(sg_fr)), &str[str_index], 0, arity, 0, TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST PASS_REGS);
+	else
+#endif /* COMPACT_ANSWER_TRIES */
+	  traverse_answer_trie(TrNode_child(SgFr_answer_trie(sg_fr)), &str[str_index], 0, arity, 0, TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST PASS_REGS);
 	if (SgFr_state(sg_fr) < complete) {
 	  TrStat_sg_incomplete++;
 	  SHOW_TABLE_STRUCTURE("    ---> INCOMPLETE\n");
@@ -710,25 +2317,42 @@ static void traverse_answer_trie(ans_node_ptr current_node, char *str, int str_i
   /* test if hashing */
   if (IS_ANSWER_TRIE_HASH(current_node)) {
     ans_node_ptr *bucket, *last_bucket;
+    int array;
     ans_hash_ptr hash;
     hash = (ans_hash_ptr) current_node;
-    bucket = Hash_buckets(hash);
-    last_bucket = bucket + Hash_num_buckets(hash);
+    UPDATE_HASH_BUCKETS_HISTOGRAM(HASH_HISTOGRAM_ANSWER, hash, ans_node_ptr, IS_ANSWER_TRIE_HASH, UNTAG_ANSWER_NODE);
     current_arity = (int *) malloc(sizeof(int) * (arity[0] + 1));
     memcpy(current_arity, arity, sizeof(int) * (arity[0] + 1));
-    do {
-      if (*bucket) {
-        traverse_answer_trie(*bucket, str, str_index, arity, var_index, mode, TRAVERSE_POSITION_FIRST PASS_REGS);
-	memcpy(arity, current_arity, sizeof(int) * (current_arity[0] + 1));
+#ifdef ANSWER_TRIE_LOCK_FREE
+    if (Hash_old_chain(hash)) {
+      traverse_answer_trie(Hash_old_chain(hash), str, str_index, arity, var_index, mode, TRAVERSE_POSITION_FIRST PASS_REGS);
+      memcpy(arity, current_arity, sizeof(int) * (current_arity[0] + 1));
 #ifdef TRIE_COMPACT_PAIRS
-	if (arity[arity[0]] == -2 && str[str_index - 1] != '[')
-	  str[str_index - 1] = ',';
+      if (arity[arity[0]] == -2 && str[str_index - 1] != '[')
+	str[str_index - 1] = ',';
 #else
-	if (arity[arity[0]] == -1)
-	  str[str_index - 1] = '|';
+      if (arity[arity[0]] == -1)
+	str[str_index - 1] = '|';
 #endif /* TRIE_COMPACT_PAIRS */
-      }
-    } while (++bucket != last_bucket);
+    }
+#endif /* ANSWER_TRIE_LOCK_FREE */
+    for (array = 0; array < TRIE_HASH_BUCKET_ARRAYS(hash); array++) {
+      bucket = TRIE_HASH_BUCKET_ARRAY(hash, array);
+      last_bucket = bucket + TRIE_HASH_BUCKET_ARRAY_SIZE(hash, array);
+      do {
+        if (*bucket) {
+          traverse_answer_trie(*bucket, str, str_index, arity, var_index, mode, TRAVERSE_POSITION_FIRST PASS_REGS);
+	  memcpy(arity, current_arity, sizeof(int) * (current_arity[0] + 1));
+#ifdef TRIE_COMPACT_PAIRS
+	  if (arity[arity[0]] == -2 && str[str_index - 1] != '[')
+	    str[str_index - 1] = ',';
+#else
+	  if (arity[arity[0]] == -1)
+	    str[str_index - 1] = '|';
+#endif /* TRIE_COMPACT_PAIRS */
+        }
+      } while (++bucket != last_bucket);
+    }
     free(current_arity);
     return;
   }
@@ -794,31 +2418,95 @@ static void traverse_answer_trie(ans_node_ptr current_node, char *str, int str_i
 }
 
 
+#ifdef COMPACT_ANSWER_TRIES
+static void traverse_compact_answer_trie(cmp_node_ptr current_node, char *str, int str_index, int *arity, int var_index, int mode, int position USES_REGS) {
+  int *current_arity = NULL, current_str_index = 0, current_var_index = 0, current_mode = 0;
+
+  /* save current state if first sibling node */
+  if (position == TRAVERSE_POSITION_FIRST) {
+    current_arity = (int *) malloc(sizeof(int) * (arity[0] + 1));
+    memcpy(current_arity, arity, sizeof(int) * (arity[0] + 1));
+    current_str_index = str_index;
+    current_var_index = var_index;
+    current_mode = mode;
+  }
+
+  /* print VAR if starting a term */
+  if (arity[0] == 0 && mode == TRAVERSE_MODE_NORMAL) {
+    str_index += sprintf(& str[str_index], "    VAR%d: ", var_index);
+    var_index++;
+  }
+
+  /* process current trie node */
+  TrStat_ans_nodes++;
+  TrStat_cmp_ans_nodes++;
+  traverse_trie_node(CmpNode_entry(current_node), str, &str_index, arity, &mode, TRAVERSE_TYPE_ANSWER PASS_REGS);
+
+  /* show answer .... */
+  if (IS_COMPACT_LEAF_NODE(current_node)) {
+    TrStat_answers++;
+    str[str_index] = 0;
+    SHOW_TABLE_STRUCTURE("%s\n", str);
+  }
+  /* ... or continue with child node */
+  else
+    traverse_compact_answer_trie(CmpNode_child(current_node), str, str_index, arity, var_index, mode, TRAVERSE_POSITION_FIRST PASS_REGS);
+
+  /* restore the initial state and continue with sibling nodes */
+  if (position == TRAVERSE_POSITION_FIRST) {
+    str_index = current_str_index;
+    var_index = current_var_index;
+    mode = current_mode;
+    current_node = CmpNode_next(current_node);
+    while (current_node) {
+      memcpy(arity, current_arity, sizeof(int) * (current_arity[0] + 1));
+#ifdef TRIE_COMPACT_PAIRS
+      if (arity[arity[0]] == -2 && str[str_index - 1] != '[')
+	str[str_index - 1] = ',';
+#else
+      if (arity[arity[0]] == -1)
+	str[str_index - 1] = '|';
+#endif /* TRIE_COMPACT_PAIRS */
+      traverse_compact_answer_trie(current_node, str, str_index, arity, var_index, mode, TRAVERSE_POSITION_NEXT PASS_REGS);
+      current_node = CmpNode_next(current_node);
+    }
+    free(current_arity);
+  }
+
+  return;
+}
+#endif /* COMPACT_ANSWER_TRIES */
+
+
 static void traverse_global_trie(gt_node_ptr current_node, char *str, int str_index, int *arity, int mode, int position USES_REGS) {
   int *current_arity = NULL, current_str_index = 0, current_mode = 0;
 
   /* test if hashing */
   if (IS_GLOBAL_TRIE_HASH(current_node)) {
     gt_node_ptr *bucket, *last_bucket;
+    int array;
     gt_hash_ptr hash;
     hash = (gt_hash_ptr) current_node;
-    bucket = Hash_buckets(hash);
-    last_bucket = bucket + Hash_num_buckets(hash);
+    UPDATE_HASH_BUCKETS_HISTOGRAM(HASH_HISTOGRAM_GLOBAL, hash, gt_node_ptr, IS_GLOBAL_TRIE_HASH, UNTAG_GLOBAL_NODE);
     current_arity = (int *) malloc(sizeof(int) * (arity[0] + 1));
     memcpy(current_arity, arity, sizeof(int) * (arity[0] + 1));
-    do {
-      if (*bucket) {
-        traverse_global_trie(*bucket, str, str_index, arity, mode, TRAVERSE_POSITION_FIRST PASS_REGS);
-	memcpy(arity, current_arity, sizeof(int) * (current_arity[0] + 1));
+    for (array = 0; array < TRIE_HASH_BUCKET_ARRAYS(hash); array++) {
+      bucket = TRIE_HASH_BUCKET_ARRAY(hash, array);
+      last_bucket = bucket + TRIE_HASH_BUCKET_ARRAY_SIZE(hash, array);
+      do {
+        if (*bucket) {
+          traverse_global_trie(*bucket, str, str_index, arity, mode, TRAVERSE_POSITION_FIRST PASS_REGS);
+	  memcpy(arity, current_arity, sizeof(int) * (current_arity[0] + 1));
 #ifdef TRIE_COMPACT_PAIRS
-	if (arity[arity[0]] == -2 && str[str_index - 1] != '[')
-	  str[str_index - 1] = ',';
+	  if (arity[arity[0]] == -2 && str[str_index - 1] != '[')
+	    str[str_index - 1] = ',';
 #else
-	if (arity[arity[0]] == -1)
-	  str[str_index - 1] = '|';
+	  if (arity[arity[0]] == -1)
+	    str[str_index - 1] = '|';
 #endif /* TRIE_COMPACT_PAIRS */
-      }
-    } while (++bucket != last_bucket);
+        }
+      } while (++bucket != last_bucket);
+    }
     free(current_arity);
     return;
   }
@@ -1060,7 +2748,12 @@ sg_fr_ptr subgoal_search(yamop *preg, CELL **Yaddr) {
   int *mode_directed, aux_mode_directed[MAX_TABLE_VARS];
   int subs_pos = 0;
 #endif /* MODE_DIRECTED_TABLING */
+#ifdef GROUND_CALL_HASHING
+  UInt ground_size = 0;
+  CELL ground_hash;
+#endif /* GROUND_CALL_HASHING */
 
+  enter_epoch();
   stack_vars = *Yaddr;
   subs_arity = 0;
   pred_arity = preg->y_u.Otapl.s;
@@ -1068,6 +2761,28 @@ sg_fr_ptr subgoal_search(yamop *preg, CELL **Yaddr) {
   current_sg_node = get_insert_subgoal_trie(tab_ent PASS_REGS);
   LOCK_SUBGOAL_TRIE(tab_ent);
 
+#ifdef GROUND_CALL_HASHING
+  if (IsMode_GroundHash(TabEnt_flags(tab_ent)) && ! IsMode_GlobalTrie(TabEnt_mode(tab_ent))
+#ifdef MODE_DIRECTED_TABLING
+      && TabEnt_mode_directed(tab_ent) == NULL
+#endif /* MODE_DIRECTED_TABLING */
+      && (ground_size = flatten_ground_call(pred_arity, &ground_hash PASS_REGS)) != 0) {
+    sg_node_ptr leaf = lookup_ground_call(tab_ent, ground_hash, ground_size);
+    if (leaf) {
+      /* repeated call -> skip the subgoal trie walk and only number the free variables */
+      for (i = 1; i <= pred_arity; i++) {
+        Term t = Deref(XREGS[i]);
+        if (IsVarTerm(t)) {
+          STACK_PUSH_UP(t, stack_vars);
+          *((CELL *)t) = GLOBAL_table_var_enumerator(subs_arity);
+          subs_arity++;
+        }
+      }
+      current_sg_node = leaf;
+      goto ground_call_found;
+    }
+  }
+#endif /* GROUND_CALL_HASHING */
 #ifdef MODE_DIRECTED_TABLING
   mode_directed = TabEnt_mode_directed(tab_ent);
   if (mode_directed) {
@@ -1096,6 +2811,12 @@ sg_fr_ptr subgoal_search(yamop *preg, CELL **Yaddr) {
     for (i = 1; i <= pred_arity; i++)
       current_sg_node = subgoal_search_loop(tab_ent, current_sg_node, Deref(XREGS[i]), &subs_arity, &stack_vars PASS_REGS);
   }
+#ifdef GROUND_CALL_HASHING
+  if (ground_size)
+    insert_ground_call(tab_ent, ground_hash, ground_size, current_sg_node);
+
+ground_call_found:
+#endif /* GROUND_CALL_HASHING */
 
   STACK_PUSH_UP(subs_arity, stack_vars);
   *Yaddr = stack_vars++;
@@ -1120,6 +2841,11 @@ sg_fr_ptr subgoal_search(yamop *preg, CELL **Yaddr) {
 #endif /* MODE_DIRECTED_TABLING */
 #if !defined(THREADS_FULL_SHARING) && !defined(THREADS_CONSUMER_SHARING)
     new_subgoal_frame(sg_fr, preg, mode_directed);
+#ifdef TABLING_CALL_SUBSUMPTION
+    if (IsMode_Subsumptive(TabEnt_mode(tab_ent)) && ! IsMode_GlobalTrie(TabEnt_mode(tab_ent)) &&
+        ! IsMode_CoInductive(TabEnt_flags(tab_ent)) && ! IsMode_Incremental(TabEnt_flags(tab_ent)))
+      complete_subsumed_subgoal(tab_ent, sg_fr, current_sg_node, pred_arity, *Yaddr PASS_REGS);
+#endif /* TABLING_CALL_SUBSUMPTION */
     *sg_fr_end = sg_fr;
     __sync_synchronize();
     TAG_AS_SUBGOAL_LEAF_NODE(current_sg_node);
@@ -1153,13 +2879,38 @@ sg_fr_ptr subgoal_search(yamop *preg, CELL **Yaddr) {
     UNLOCK_SUBGOAL_NODE(current_sg_node);
 #endif /* !THREADS */
     sg_fr = (sg_fr_ptr) UNTAG_SUBGOAL_NODE(*sg_fr_end);
+#ifdef INCREMENTAL_TABLING
+    if (SgFr_inc_invalid(sg_fr)) {
+      /* invalidated subgoal -> evaluate it again with a new subgoal frame */
+      sg_fr_ptr old_sg_fr = sg_fr;
+      new_subgoal_frame(sg_fr, preg, SgFr_mode_directed(old_sg_fr));
+#ifdef MODE_DIRECTED_TABLING
+      SgFr_mode_directed(old_sg_fr) = NULL;
+#endif /* MODE_DIRECTED_TABLING */
+      retire_subgoal_frame(tab_ent, old_sg_fr);
+      *sg_fr_end = sg_fr;
+      TAG_AS_SUBGOAL_LEAF_NODE(current_sg_node);
+    }
+#endif /* INCREMENTAL_TABLING */
 #ifdef LIMIT_TABLING
     if (SgFr_state(sg_fr) <= ready) {  /* incomplete or ready */
       remove_from_global_sg_fr_list(sg_fr);
+    } else if (SgFr_timestamp(sg_fr)) {  /* completed and not in use */
+      update_global_sg_fr_list(sg_fr);
     }
 #endif /* LIMIT_TABLING */
   }
+#ifdef INCREMENTAL_TABLING
+  if (IsMode_Incremental(TabEnt_flags(tab_ent)) && sg_fr != LOCAL_top_sg_fr)
+    record_incremental_dependency(&SgFr_inc_dependents(sg_fr) PASS_REGS);
+  if (TabEnt_retired_sg_fr(tab_ent))
+    free_retired_subgoal_frames(tab_ent, FALSE);
+#endif /* INCREMENTAL_TABLING */
   UNLOCK_SUBGOAL_TRIE(tab_ent);
+#ifdef LIMIT_TABLING
+  if (GLOBAL_table_space_limit && SgFr_state(sg_fr) <= ready)  /* subgoal to be evaluated */
+    limit_table_space();
+#endif /* LIMIT_TABLING */
   return sg_fr;
 }
 
@@ -1333,13 +3084,11 @@ CELL *exec_substitution(gt_node_ptr current_node, CELL *aux_stack) {
 }
 
 
-void update_answer_trie(sg_fr_ptr sg_fr) {
+void update_answer_trie_instructions(sg_fr_ptr sg_fr) {
   ans_node_ptr current_node;
 
   free_answer_hash_chain(SgFr_hash_chain(sg_fr));
   SgFr_hash_chain(sg_fr) = NULL;
-  SgFr_state(sg_fr) += 2;  /* complete --> compiled : complete_in_use --> compiled_in_use */
-
 #if defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
   SgFr_sg_ent_state(sg_fr) += 2;  /* complete --> compiled */
 #ifdef THREADS_FULL_SHARING
@@ -1367,6 +3116,66 @@ void update_answer_trie(sg_fr_ptr sg_fr) {
     update_answer_trie_branch(current_node, TRAVERSE_POSITION_FIRST);
 #endif /* YAPOR */
   }
+#ifdef COMPACT_ANSWER_TRIES
+  /* marks the answer trie as ready to be compacted */
+  SgFr_compacted_trie(sg_fr) = TrNode_child(SgFr_answer_trie(sg_fr));
+#endif /* COMPACT_ANSWER_TRIES */
+  return;
+}
+
+
+#ifdef COMPACT_ANSWER_TRIES
+cmp_node_ptr build_compact_answer_trie(ans_node_ptr current_node, long *nodes_ptr) {
+  /* the answer trie nodes are only read, thus the compact answer **
+  ** trie can be built without holding the lock of the subgoal    */
+  cmp_node_ptr cmp_trie;
+  long nodes = count_answer_trie_nodes(current_node);
+
+  ALLOC_BLOCK(cmp_trie, nodes * sizeof(struct compact_answer_trie_node), struct compact_answer_trie_node);
+  UPDATE_COMPACT_ANSWER_TRIE_NODES(nodes);
+  compact_answer_trie_branch(current_node, cmp_trie);
+  *nodes_ptr = nodes;
+  return cmp_trie;
+}
+
+
+void install_compact_answer_trie(sg_fr_ptr sg_fr, cmp_node_ptr cmp_trie) {
+  TrNode_child(SgFr_answer_trie(sg_fr)) = (ans_node_ptr) cmp_trie;
+#ifdef YAPOR
+  /* the loader and consumer nodes of other workers may still point to the **
+  ** answer trie nodes, thus they are kept in SgFr_compacted_trie until the  **
+  ** answers of the subgoal are released and the first and last answers     **
+  ** remain valid leaf nodes. Note that, with YapOr, the compact trie adds to **
+  ** (and does not replace) the memory used by the answer trie nodes         */
+#else
+  free_answer_trie_nodes(SgFr_compacted_trie(sg_fr));
+  SgFr_compacted_trie(sg_fr) = NULL;
+  /* the leaf nodes were released, but the first and last answers should still **
+  ** tell that the subgoal has answers, thus they point to the compact trie    */
+  SgFr_first_answer(sg_fr) = (ans_node_ptr) cmp_trie;
+  SgFr_last_answer(sg_fr) = (ans_node_ptr) cmp_trie;
+#endif /* YAPOR */
+  SgFr_state(sg_fr) += 2;  /* complete --> compiled : complete_in_use --> compiled_in_use */
+  return;
+}
+#endif /* COMPACT_ANSWER_TRIES */
+
+
+void update_answer_trie(sg_fr_ptr sg_fr) {
+#ifdef COMPACT_ANSWER_TRIES
+  long nodes;
+
+  /* the instructions may be already updated by compact_completed_answer_trie() */
+  if (SgFr_compacted_trie(sg_fr) == NULL)
+    update_answer_trie_instructions(sg_fr);
+  if (SgFr_compacted_trie(sg_fr))
+    install_compact_answer_trie(sg_fr, build_compact_answer_trie(SgFr_compacted_trie(sg_fr), &nodes));
+  else
+    SgFr_state(sg_fr) += 2;  /* complete --> compiled : complete_in_use --> compiled_in_use */
+#else
+  update_answer_trie_instructions(sg_fr);
+  SgFr_state(sg_fr) += 2;  /* complete --> compiled : complete_in_use --> compiled_in_use */
+#endif /* COMPACT_ANSWER_TRIES */
   return;
 }
 
@@ -1378,6 +3187,7 @@ void free_subgoal_trie(sg_node_ptr current_node, int mode, int position) {
     sg_node_ptr *bucket, *last_bucket;
     sg_hash_ptr hash;
     hash = (sg_hash_ptr) current_node;
+    FINISH_TRIE_HASH_EXPANSION(hash, sg_node_ptr);
     bucket = Hash_buckets(hash);
     last_bucket = bucket + Hash_num_buckets(hash);
     do {
@@ -1433,8 +3243,9 @@ void free_subgoal_trie(sg_node_ptr current_node, int mode, int position) {
       ans_node_ptr ans_node;
       free_answer_hash_chain(SgFr_hash_chain(sg_fr));
       ans_node = SgFr_answer_trie(sg_fr);
-      if (TrNode_child(ans_node))
-	free_answer_trie(TrNode_child(ans_node), TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST);
+      if (TrNode_child(ans_node)) {
+	FREE_SUBGOAL_ANSWER_TRIE(sg_fr);
+      }
       IF_ABOLISH_ANSWER_TRIE_SHARED_DATA_STRUCTURES {
 	FREE_ANSWER_TRIE_NODE(ans_node);
 #if defined(THREADS_FULL_SHARING) || defined(THREADS_CONSUMER_SHARING)
@@ -1459,6 +3270,9 @@ void free_subgoal_trie(sg_node_ptr current_node, int mode, int position) {
 #ifdef LIMIT_TABLING
       remove_from_global_sg_fr_list(sg_fr);
 #endif /* LIMIT_TABLING */
+#ifdef INCREMENTAL_TABLING
+      free_incremental_dependencies(SgFr_inc_dependents(sg_fr));
+#endif /* INCREMENTAL_TABLING */
 #if defined(MODE_DIRECTED_TABLING) && !defined(THREADS_FULL_SHARING) && !defined(THREADS_CONSUMER_SHARING)
       if (SgFr_mode_directed(sg_fr))
 	FREE_BLOCK(SgFr_mode_directed(sg_fr));
@@ -1547,15 +3361,127 @@ void free_answer_trie(ans_node_ptr current_node, int mode, int position) {
 }
 
 
+#ifdef COMPACT_ANSWER_TRIES
+static long free_compact_answer_trie_branch(cmp_node_ptr current_node, int mode) {
+  CACHE_REGS
+  long nodes = 0;
+
+  do {
+    nodes++;
+    if (! IS_COMPACT_LEAF_NODE(current_node)) {
+      int child_mode;
+      if (mode == TRAVERSE_MODE_NORMAL) {
+	Term t = CmpNode_entry(current_node);
+	if (IsApplTerm(t)) {
+	  Functor f = (Functor) RepAppl(t);
+	  if (f == FunctorDouble)
+	    child_mode = TRAVERSE_MODE_DOUBLE;
+	  else if (f == FunctorLongInt)
+	    child_mode = TRAVERSE_MODE_LONGINT;
+	  else if (f == FunctorBigInt || f == FunctorString)
+	    child_mode = TRAVERSE_MODE_BIGINT_OR_STRING;
+	  else
+	    child_mode = TRAVERSE_MODE_NORMAL;
+	} else
+	  child_mode = TRAVERSE_MODE_NORMAL;
+      } else if (mode == TRAVERSE_MODE_LONGINT) {
+	child_mode = TRAVERSE_MODE_LONGINT_END;
+      } else if (mode == TRAVERSE_MODE_BIGINT_OR_STRING) {
+	Yap_FreeCodeSpace((char *)CmpNode_entry(current_node));
+	child_mode = TRAVERSE_MODE_BIGINT_OR_STRING_END;
+      } else if (mode == TRAVERSE_MODE_DOUBLE) {
+#if SIZEOF_DOUBLE == 2 * SIZEOF_INT_P
+	child_mode = TRAVERSE_MODE_DOUBLE2;
+      } else if (mode == TRAVERSE_MODE_DOUBLE2) {
+#endif /* SIZEOF_DOUBLE x SIZEOF_INT_P */
+	child_mode = TRAVERSE_MODE_DOUBLE_END;
+      } else {
+	child_mode = TRAVERSE_MODE_NORMAL;
+      }
+      nodes += free_compact_answer_trie_branch(CmpNode_child(current_node), child_mode);
+    }
+    CHECK_DECREMENT_GLOBAL_TRIE_REFERENCE(CmpNode_entry(current_node), mode);
+    current_node = CmpNode_next(current_node);
+  } while (current_node);
+  return nodes;
+}
+
+
+void free_compact_answer_trie(cmp_node_ptr cmp_trie) {
+  long nodes = free_compact_answer_trie_branch(cmp_trie, TRAVERSE_MODE_NORMAL);
+  UPDATE_COMPACT_ANSWER_TRIE_NODES(- nodes);
+#ifdef TABLE_SNAPSHOTS
+  if (release_table_snapshot_trie(cmp_trie))
+    return;
+#endif /* TABLE_SNAPSHOTS */
+  FREE_BLOCK(cmp_trie);
+  return;
+}
+#endif /* COMPACT_ANSWER_TRIES */
+
+
+#ifdef ANSWER_TRIE_LOCK_FREE
+static ans_node_ptr flatten_answer_trie_hash(ans_hash_ptr hash, ans_node_ptr chain) {
+  /* appends to chain all the nodes of the hash and of its next hash levels, **
+  ** the next hash levels are freed and the hash is left without buckets     */
+#ifdef THREADS
+  CACHE_REGS
+#endif /* THREADS */
+  ans_node_ptr chain_node, next_node, *bucket, *last_bucket;
+
+  bucket = Hash_buckets(hash);
+  last_bucket = bucket + Hash_num_buckets(hash);
+  do {
+    chain_node = *bucket;
+    if (chain_node && IS_ANSWER_TRIE_HASH(chain_node)) {
+      chain = flatten_answer_trie_hash((ans_hash_ptr) chain_node, chain);
+      FREE_ANSWER_TRIE_HASH((ans_hash_ptr) chain_node);
+    } else {
+      while (chain_node) {
+        next_node = TrNode_next(chain_node);
+        TrNode_next(chain_node) = chain;
+        chain = chain_node;
+        chain_node = next_node;
+      }
+    }
+  } while (++bucket != last_bucket);
+  chain_node = Hash_old_chain(hash);
+  while (chain_node) {
+    next_node = TrNode_next(chain_node);
+    TrNode_next(chain_node) = chain;
+    chain = chain_node;
+    chain_node = next_node;
+  }
+  FREE_BUCKETS(Hash_buckets(hash));
+  return chain;
+}
+#endif /* ANSWER_TRIE_LOCK_FREE */
+
+
 void free_answer_hash_chain(ans_hash_ptr hash) {
-#if defined(THREADS_NO_SHARING) || defined(THREADS_SUBGOAL_SHARING)
+#ifdef THREADS
   CACHE_REGS
-#endif /* THREADS_NO_SHARING || THREADS_SUBGOAL_SHARING */
+#endif /* THREADS */
+
+#ifdef ANSWER_TRIE_LOCK_FREE
+  while (hash) {
+    ans_node_ptr chain_node;
+    ans_hash_ptr next_hash;
 
+    if (Hash_buckets(hash)) {  /* not an invalidated hash */
+      chain_node = Hash_old_chain(hash);
+      TrNode_child((ans_node_ptr) UNTAG_ANSWER_NODE(TrNode_parent(chain_node))) = flatten_answer_trie_hash(hash, NULL);
+    }
+    next_hash = Hash_next(hash);
+    FREE_ANSWER_TRIE_HASH(hash);
+    hash = next_hash;
+  }
+#else
   while (hash) {
     ans_node_ptr chain_node, *bucket, *last_bucket;
     ans_hash_ptr next_hash;
 
+    FINISH_TRIE_HASH_EXPANSION(hash, ans_node_ptr);
     bucket = Hash_buckets(hash);
     last_bucket = bucket + Hash_num_buckets(hash);
     while (! *bucket)
@@ -1575,6 +3501,7 @@ void free_answer_hash_chain(ans_hash_ptr hash) {
     FREE_ANSWER_TRIE_HASH(hash);
     hash = next_hash;
   }
+#endif /* ANSWER_TRIE_LOCK_FREE */
   return;
 }
 
@@ -1587,6 +3514,11 @@ void abolish_table(tab_ent_ptr tab_ent) {
   CACHE_REGS
   sg_node_ptr sg_node;
 
+#if defined(YAPOR) && defined(COMPACT_ANSWER_TRIES_AT_COMPLETION)
+  /* the queued subgoal frames of the table may be released below */
+  flush_compaction_queue(tab_ent);
+#endif /* YAPOR && COMPACT_ANSWER_TRIES_AT_COMPLETION */
+
 #ifdef THREADS
   if (GLOBAL_NOfThreads == 1) {
     ATTACH_PAGES(_pages_tab_ent);
@@ -1607,9 +3539,17 @@ void abolish_table(tab_ent_ptr tab_ent) {
   }
 #endif /* THREADS */
   sg_node = get_subgoal_trie_for_abolish(tab_ent PASS_REGS);
+#ifdef GROUND_CALL_HASHING
+  free_ground_calls(tab_ent);
+#endif /* GROUND_CALL_HASHING */
   if (sg_node) {
     if (TrNode_child(sg_node)) {
       if (TabEnt_arity(tab_ent)) {
+#ifdef DEFERRED_ABOLISH
+	if (GLOBAL_abolish_mode == ABOLISH_MODE_DEFERRED)
+	  defer_subgoal_trie(tab_ent, TrNode_child(sg_node) PASS_REGS);
+	else
+#endif /* DEFERRED_ABOLISH */
 	free_subgoal_trie(TrNode_child(sg_node), TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_FIRST);
       } else {
 	sg_fr_ptr sg_fr = get_subgoal_frame_for_abolish(sg_node PASS_REGS);
@@ -1623,6 +3563,9 @@ void abolish_table(tab_ent_ptr tab_ent) {
 #ifdef LIMIT_TABLING
 	  remove_from_global_sg_fr_list(sg_fr);
 #endif /* LIMIT_TABLING */
+#ifdef INCREMENTAL_TABLING
+	  free_incremental_dependencies(SgFr_inc_dependents(sg_fr));
+#endif /* INCREMENTAL_TABLING */
 	  FREE_SUBGOAL_FRAME(sg_fr);
 	}
       }
@@ -1633,14 +3576,654 @@ void abolish_table(tab_ent_ptr tab_ent) {
     FREE_SUBGOAL_TRIE_NODE(sg_node);
 #endif /* THREADS_NO_SHARING */
   }
+#ifdef INCREMENTAL_TABLING
+  /* the dependencies recorded for the released subgoal frames are now stale */
+  TabEnt_generation(tab_ent)++;
+  free_retired_subgoal_frames(tab_ent, TRUE);
+#endif /* INCREMENTAL_TABLING */
+  return;
+}
+
+#ifdef LIMIT_TABLING
+void limit_table_space(void) {
+  CACHE_REGS
+  sg_fr_ptr sg_fr, next_sg_fr, last_sg_fr;
+  long limit, bytes, initial_bytes, evicted_subgoals;
+  UInt epoch;
+  int round;
+
+  limit = GLOBAL_table_space_limit;
+  if (limit == 0 || (initial_bytes = table_space_in_use()) <= limit)
+    return;
+  bytes = initial_bytes;
+  evicted_subgoals = 0;
+  /* the first round moves the subgoals completed, released or called since
+  ** the previous eviction pass to the end of the LRU chain and releases the
+  ** others, the second round releases the subgoals in LRU order */
+  for (round = 0; round < 2 && bytes > limit && LOCAL_first_sg_fr; round++) {
+    epoch = LOCAL_lru_epoch;
+    LOCAL_lru_epoch = LOCAL_lru_clock;
+    last_sg_fr = LOCAL_last_sg_fr;
+    next_sg_fr = LOCAL_first_sg_fr;
+    do {
+      sg_fr = next_sg_fr;
+      next_sg_fr = SgFr_next(sg_fr);
+      if (SgFr_timestamp(sg_fr) > epoch) {
+	if (sg_fr != LOCAL_last_sg_fr) {
+	  UInt timestamp = SgFr_timestamp(sg_fr);
+	  remove_from_global_sg_fr_list(sg_fr);
+	  insert_into_global_sg_fr_list(sg_fr);
+	  SgFr_timestamp(sg_fr) = timestamp;
+	}
+      } else if (SgFr_state(sg_fr) != ready && 
+		 SgFr_first_answer(sg_fr) && SgFr_first_answer(sg_fr) != SgFr_answer_trie(sg_fr)) {
+	/* release the answers of the subgoal */
+	free_answer_hash_chain(SgFr_hash_chain(sg_fr));
+	SgFr_hash_chain(sg_fr) = NULL;
+	FREE_SUBGOAL_ANSWER_TRIE(sg_fr);
+	TrNode_child(SgFr_answer_trie(sg_fr)) = NULL;
+	SgFr_first_answer(sg_fr) = NULL;
+	SgFr_last_answer(sg_fr) = NULL;
+#ifdef INCOMPLETE_TABLING
+	SgFr_try_answer(sg_fr) = NULL;
+#endif /* INCOMPLETE_TABLING */
+#ifdef MODE_DIRECTED_TABLING
+	if (SgFr_invalid_chain(sg_fr)) {
+	  ans_node_ptr current_node, next_node;
+	  /* free invalid answer nodes */
+	  current_node = SgFr_invalid_chain(sg_fr);
+	  SgFr_invalid_chain(sg_fr) = NULL;
+	  while (current_node) {
+	    next_node = TrNode_next(current_node);	
+	    FREE_ANSWER_TRIE_NODE(current_node);
+	    current_node = next_node;
+	  }
+	}
+#endif /* MODE_DIRECTED_TABLING */
+	SgFr_state(sg_fr) = ready;
+	remove_from_global_sg_fr_list(sg_fr);
+	evicted_subgoals++;
+	if ((bytes = table_space_in_use()) <= limit)
+	  break;
+      }
+    } while (sg_fr != last_sg_fr);
+  }
+  if (evicted_subgoals) {
+    __sync_fetch_and_add(&GLOBAL_evicted_subgoals, evicted_subgoals);
+    __sync_fetch_and_add(&GLOBAL_evicted_bytes, initial_bytes - bytes);
+  }
+  return;
+}
+#endif /* LIMIT_TABLING */
+
+
+#ifdef INCREMENTAL_TABLING
+void new_incremental_predicate(PredEntry *pe) {
+  inc_pred_ptr inc_pred;
+
+  if (find_incremental_predicate(pe))
+    return;
+  ALLOC_BLOCK(inc_pred, sizeof(struct incremental_predicate), struct incremental_predicate);
+  IncPred_pe(inc_pred) = pe;
+  IncPred_dependents(inc_pred) = NULL;
+  IncPred_next(inc_pred) = GLOBAL_root_inc_pred;
+  GLOBAL_root_inc_pred = inc_pred;
+  return;
+}
+
+
+void incremental_predicate_call(PredEntry *pe) {
+  CACHE_REGS
+  inc_pred_ptr inc_pred;
+
+  if (LOCAL_top_sg_fr == NULL || (inc_pred = find_incremental_predicate(pe)) == NULL)
+    return;
+  record_incremental_dependency(&IncPred_dependents(inc_pred) PASS_REGS);
+  return;
+}
+
+
+void incremental_predicate_update(PredEntry *pe) {
+  /* invalidates the completed subgoals that depend on the updated predicate. The **
+  ** dependents of an invalidated subgoal are appended to the chain being checked, **
+  ** while subgoals still being evaluated keep their dependencies on the predicate */
+  inc_pred_ptr inc_pred;
+  inc_dep_ptr inc_dep, kept_inc_dep;
+
+  if ((inc_pred = find_incremental_predicate(pe)) == NULL)
+    return;
+  GLOBAL_incremental_updates++;
+  inc_dep = IncPred_dependents(inc_pred);
+  kept_inc_dep = NULL;
+  while (inc_dep) {
+    inc_dep_ptr next_inc_dep = IncDep_next(inc_dep);
+    sg_fr_ptr sg_fr = IncDep_sg_fr(inc_dep);
+    if (IncDep_generation(inc_dep) != TabEnt_generation(IncDep_tab_ent(inc_dep)) || SgFr_inc_invalid(sg_fr)) {
+      /* abolished or already invalidated subgoal */
+      FREE_INCREMENTAL_DEPENDENCY(inc_dep);
+    } else if (SgFr_state(sg_fr) < complete) {
+      IncDep_next(inc_dep) = kept_inc_dep;
+      kept_inc_dep = inc_dep;
+    } else {
+      SgFr_inc_invalid(sg_fr) = TRUE;
+      GLOBAL_invalidated_subgoals++;
+      if (SgFr_inc_dependents(sg_fr)) {
+        inc_dep_ptr last_inc_dep = SgFr_inc_dependents(sg_fr);
+        while (IncDep_next(last_inc_dep))
+          last_inc_dep = IncDep_next(last_inc_dep);
+        IncDep_next(last_inc_dep) = next_inc_dep;
+        next_inc_dep = SgFr_inc_dependents(sg_fr);
+        SgFr_inc_dependents(sg_fr) = NULL;
+      }
+      FREE_INCREMENTAL_DEPENDENCY(inc_dep);
+    }
+    inc_dep = next_inc_dep;
+  }
+  IncPred_dependents(inc_pred) = kept_inc_dep;
+  return;
+}
+#endif /* INCREMENTAL_TABLING */
+
+
+#ifdef DEFERRED_ABOLISH
+int free_abolished_subtrie(void) {
+  /* frees a first level subtrie of a detached subgoal trie. The bucket **
+  ** chains of a first level hash are joined in a single chain of nodes  */
+  CACHE_REGS
+  ab_trie_ptr ab_trie;
+  sg_node_ptr sg_node;
+
+  if (GLOBAL_abolished_tries == NULL)
+    return FALSE;
+  LOCK(GLOBAL_abolished_tries_lock);
+  if ((ab_trie = GLOBAL_abolished_tries) == NULL) {
+    UNLOCK(GLOBAL_abolished_tries_lock);
+    return FALSE;
+  }
+  sg_node = AbTrie_chain(ab_trie);
+  if (IS_SUBGOAL_TRIE_HASH(sg_node)) {
+    sg_node_ptr *bucket, *last_bucket, chain = NULL;
+    sg_hash_ptr hash = (sg_hash_ptr) sg_node;
+    FINISH_TRIE_HASH_EXPANSION(hash, sg_node_ptr);
+    bucket = Hash_buckets(hash);
+    last_bucket = bucket + Hash_num_buckets(hash);
+    do {
+      if (*bucket) {
+	sg_node = *bucket;
+	while (TrNode_next(sg_node))
+	  sg_node = TrNode_next(sg_node);
+	TrNode_next(sg_node) = chain;
+	chain = *bucket;
+      }
+    } while (++bucket != last_bucket);
+    FREE_BUCKETS(Hash_buckets(hash));
+    FREE_SUBGOAL_TRIE_HASH(hash);
+    if ((AbTrie_chain(ab_trie) = chain) == NULL) {
+      GLOBAL_abolished_tries = AbTrie_next(ab_trie);
+      GLOBAL_abolished_tries_pending--;
+      FREE_BLOCK(ab_trie);
+    }
+    UNLOCK(GLOBAL_abolished_tries_lock);
+    return TRUE;
+  }
+  if ((AbTrie_chain(ab_trie) = TrNode_next(sg_node)) == NULL) {
+    GLOBAL_abolished_tries = AbTrie_next(ab_trie);
+    GLOBAL_abolished_tries_pending--;
+    FREE_BLOCK(ab_trie);
+  }
+  GLOBAL_abolished_subtries_freed++;
+  UNLOCK(GLOBAL_abolished_tries_lock);
+  free_subgoal_trie(sg_node, TRAVERSE_MODE_NORMAL, TRAVERSE_POSITION_NEXT);
+  return TRUE;
+}
+#endif /* DEFERRED_ABOLISH */
+
+
+#ifdef EPOCH_RECLAMATION
+void retire_invalid_answers(sg_fr_ptr sg_fr) {
+  /* the invalid answers of a subgoal are no longer reachable from its answer **
+  ** trie, but threads that entered their evaluations before may still be     **
+  ** reading them, thus they are moved to the limbo list of the current epoch */
+  ans_node_ptr first_node, last_node;
+  long nodes;
+
+  first_node = __sync_lock_test_and_set(&SgFr_invalid_chain(sg_fr), NULL);
+  if (first_node == NULL)
+    return;
+  nodes = 1;
+  last_node = first_node;
+  while (TrNode_next(last_node)) {
+    last_node = TrNode_next(last_node);
+    nodes++;
+  }
+  LOCK(GLOBAL_epoch_lock);
+  TrNode_next(last_node) = GLOBAL_epoch_limbo(GLOBAL_epoch);
+  GLOBAL_epoch_limbo(GLOBAL_epoch) = first_node;
+  GLOBAL_epoch_backlog += nodes;
+  UNLOCK(GLOBAL_epoch_lock);
+  reclaim_invalid_answers();
+  return;
+}
+
+
+void reclaim_invalid_answers(void) {
+  /* the global epoch advances when all threads that entered the tables    **
+  ** announced the current epoch, even without an evaluation running, as    **
+  ** they may be loading answers. The answers retired two epochs before     **
+  ** cannot be reached by any thread and are freed                          */
+  CACHE_REGS
+  ans_node_ptr current_node, next_node;
+  long epoch, nodes;
+  int wid, quiescent;
+
+  if (GLOBAL_epoch_backlog == 0)
+    return;
+  LOCK(GLOBAL_epoch_lock);
+  epoch = GLOBAL_epoch;
+  quiescent = TRUE;
+  LOCK(GLOBAL_ThreadHandlesLock);
+  for (wid = 0; wid < MAX_THREADS && Yap_local[wid] && quiescent; wid++)
+    if (REMOTE_ThreadHandle(wid).in_use && REMOTE_epoch(wid) != NO_EPOCH && REMOTE_epoch(wid) != epoch)
+      quiescent = FALSE;
+  UNLOCK(GLOBAL_ThreadHandlesLock);
+  if (quiescent == FALSE) {
+    UNLOCK(GLOBAL_epoch_lock);
+    return;
+  }
+  current_node = GLOBAL_epoch_limbo(epoch + 1);
+  GLOBAL_epoch_limbo(epoch + 1) = NULL;
+  GLOBAL_epoch = epoch + 1;
+  nodes = 0;
+  while (current_node) {
+    next_node = TrNode_next(current_node);
+    FREE_ANSWER_TRIE_NODE(current_node);
+    current_node = next_node;
+    nodes++;
+  }
+  GLOBAL_epoch_backlog -= nodes;
+  GLOBAL_epoch_reclaimed += nodes;
+  UNLOCK(GLOBAL_epoch_lock);
   return;
 }
+#endif /* EPOCH_RECLAMATION */
+
+
+#ifdef TABLE_SNAPSHOTS
+int save_tables(char *file_name, tab_ent_ptr *tab_ents, int n) {
+  CACHE_REGS
+  struct table_snapshot_header header;
+  struct table_snapshot_writer sw, sym;
+  FILE *file;
+  long i;
+  int ok;
+
+  sw.buffer_size = 4096;
+  sw.buffer_top = 0;
+  sw.buffer = (char *) malloc(sw.buffer_size);
+  sw.path_size = 256;
+  sw.path = (Term *) malloc(sw.path_size * sizeof(Term));
+  sw.out_of_memory = (sw.buffer == NULL || sw.path == NULL);
+  if (! snapshot_symbols_init(&sw.atoms))
+    sw.out_of_memory = TRUE;
+  if (! snapshot_symbols_init(&sw.functors))
+    sw.out_of_memory = TRUE;
+  for (i = 0; i < n && ! sw.out_of_memory; i++) {
+    tab_ent_ptr tab_ent = tab_ents[i];
+    struct table_snapshot_table table;
+    Term mod = TabEnt_pe(tab_ent)->ModuleOfPred;
+    sg_node_ptr sg_node;
+    size_t offset;
+#if defined(YAPOR) && defined(COMPACT_ANSWER_TRIES_AT_COMPLETION)
+    /* the answer tries of the table are compacted below */
+    flush_compaction_queue(tab_ent);
+#endif /* YAPOR && COMPACT_ANSWER_TRIES_AT_COMPLETION */
+
+    if (IsMode_GlobalTrie(TabEnt_mode(tab_ent)))
+      continue;
+    table.name = (CELL) TabEnt_atom(tab_ent);
+    table.arity = TabEnt_arity(tab_ent);
+    table.module = (CELL) AtomOfTerm(mod ? mod : TermProlog);
+    table.subgoals = 0;
+    if (! snapshot_symbols_insert(&sw.atoms, table.name, 0) ||
+	! snapshot_symbols_insert(&sw.atoms, table.module, 0)) {
+      sw.out_of_memory = TRUE;
+      break;
+    }
+    offset = snapshot_put(&sw, &table, sizeof(struct table_snapshot_table));
+    sw.subgoals = 0;
+    sg_node = get_subgoal_trie(tab_ent);
+    if (sg_node && TrNode_child(sg_node)) {
+      LOCK_SUBGOAL_TRIE(tab_ent);
+      if (TabEnt_arity(tab_ent)) {
+	snapshot_subgoal_trie(&sw, TrNode_child(sg_node), 0);
+      } else {
+	sg_fr_ptr sg_fr = get_subgoal_frame(sg_node);
+	if (sg_fr)
+	  snapshot_subgoal(&sw, sg_fr, 0);
+      }
+      UNLOCK_SUBGOAL_TRIE(tab_ent);
+    }
+    if (! sw.out_of_memory)
+      ((struct table_snapshot_table *) (sw.buffer + offset))->subgoals = sw.subgoals;
+  }
+
+  memset(&header, 0, sizeof(struct table_snapshot_header));
+  strcpy(header.magic, TABLE_SNAPSHOT_MAGIC);
+  header.version = TABLE_SNAPSHOT_VERSION;
+  header.flags = TABLE_SNAPSHOT_FLAGS;
+  header.std_top = _std_top;
+  header.node_size = sizeof(struct compact_answer_trie_node);
+  header.atoms = sw.atoms.entries;
+  header.functors = sw.functors.entries;
+  for (i = 0; i < n; i++)
+    if (! IsMode_GlobalTrie(TabEnt_mode(tab_ents[i])))
+      header.tables++;
+
+  /* the atom and functor tables are put in a second buffer, thus the **
+  ** checksum of the file is known before writing the header           */
+  sym.buffer_size = 4096;
+  sym.buffer_top = 0;
+  sym.buffer = (char *) malloc(sym.buffer_size);
+  sym.out_of_memory = (sym.buffer == NULL);
+  if (! sw.out_of_memory) {
+    CELL record[3];
+    /* atom table: old atom, wide flag, size in bytes and name */
+    for (i = 0; i < sw.atoms.size; i++) {
+      Atom at = (Atom) sw.atoms.keys[i];
+      char *name;
+      if (at == NULL)
+	continue;
+      record[0] = (CELL) at;
+      if (IsWideAtom(at)) {
+	record[1] = TRUE;
+	record[2] = (wcslen(RepAtom(at)->WStrOfAE) + 1) * sizeof(wchar_t);
+	name = (char *) RepAtom(at)->WStrOfAE;
+      } else {
+	record[1] = FALSE;
+	record[2] = strlen(RepAtom(at)->StrOfAE) + 1;
+	name = RepAtom(at)->StrOfAE;
+      }
+      snapshot_put(&sym, record, 3 * sizeof(CELL));
+      snapshot_put(&sym, name, record[2]);
+    }
+    /* functor table: old functor, old atom and arity */
+    for (i = 0; i < sw.functors.size; i++) {
+      Functor f = (Functor) sw.functors.keys[i];
+      if (f == NULL)
+	continue;
+      record[0] = (CELL) f;
+      record[1] = (CELL) NameOfFunctor(f);
+      record[2] = ArityOfFunctor(f);
+      snapshot_put(&sym, record, 3 * sizeof(CELL));
+    }
+  }
+  header.checksum = snapshot_checksum(TABLE_SNAPSHOT_CHECKSUM_BASIS, sym.buffer, sym.buffer_top);
+  header.checksum = snapshot_checksum(header.checksum, sw.buffer, sw.buffer_top);
+
+  ok = FALSE;
+  if (sw.out_of_memory || sym.out_of_memory) {
+    Yap_Error(OUT_OF_HEAP_ERROR, TermNil, "save_tables/2 (out of memory)");
+  } else if ((file = fopen(file_name, "wb")) == NULL) {
+    Yap_Error(SYSTEM_ERROR, TermNil, "save_tables/2 (fopen %s: %s)", file_name, strerror(errno));
+  } else {
+    ok = (fwrite(&header, sizeof(struct table_snapshot_header), 1, file) == 1);
+    if (ok && sym.buffer_top)
+      ok = (fwrite(sym.buffer, 1, sym.buffer_top, file) == sym.buffer_top);
+    if (ok && sw.buffer_top)
+      ok = (fwrite(sw.buffer, 1, sw.buffer_top, file) == sw.buffer_top);
+    if (fclose(file) != 0)
+      ok = FALSE;
+    if (! ok)
+      Yap_Error(SYSTEM_ERROR, TermNil, "save_tables/2 (fwrite %s: %s)", file_name, strerror(errno));
+  }
+  free(sym.buffer);
+  free(sw.buffer);
+  free(sw.path);
+  snapshot_symbols_free(&sw.atoms);
+  snapshot_symbols_free(&sw.functors);
+  return ok;
+}
+
+
+int load_tables(char *file_name, tab_ent_ptr *tab_ents, int n) {
+  CACHE_REGS
+  struct table_snapshot_header *header;
+  struct table_snapshot_symbols atoms, functors;
+  tab_snap_ptr tab_snap;
+  char *start, *end, *ptr;
+  struct stat file_stat;
+  long i, j;
+  int fd, keep_mapping, out_of_memory = FALSE;
+
+  if ((fd = open(file_name, O_RDONLY)) < 0) {
+    Yap_Error(SYSTEM_ERROR, TermNil, "load_tables/2 (open %s: %s)", file_name, strerror(errno));
+    return FALSE;
+  }
+  if (fstat(fd, &file_stat) < 0 || (size_t) file_stat.st_size < sizeof(struct table_snapshot_header)) {
+    close(fd);
+    Yap_Error(SYSTEM_ERROR, TermNil, "load_tables/2 (%s: not a table snapshot)", file_name);
+    return FALSE;
+  }
+  /* the private mapping allows relocating the compact answer tries in place */
+  start = (char *) mmap(NULL, (size_t) file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (start == (char *) MAP_FAILED) {
+    Yap_Error(SYSTEM_ERROR, TermNil, "load_tables/2 (mmap %s: %s)", file_name, strerror(errno));
+    return FALSE;
+  }
+  end = start + file_stat.st_size;
+  header = (struct table_snapshot_header *) start;
+  if (strncmp(header->magic, TABLE_SNAPSHOT_MAGIC, sizeof(header->magic)) ||
+      header->version != TABLE_SNAPSHOT_VERSION ||
+      header->flags != TABLE_SNAPSHOT_FLAGS ||
+      header->std_top != _std_top ||
+      header->node_size != sizeof(struct compact_answer_trie_node)) {
+    munmap(start, (size_t) file_stat.st_size);
+    Yap_Error(SYSTEM_ERROR, TermNil, "load_tables/2 (%s: incompatible table snapshot)", file_name);
+    return FALSE;
+  }
+  ptr = start + sizeof(struct table_snapshot_header);
+  if ((end - ptr) % sizeof(CELL) ||
+      snapshot_checksum(TABLE_SNAPSHOT_CHECKSUM_BASIS, ptr, end - ptr) != header->checksum) {
+    munmap(start, (size_t) file_stat.st_size);
+    Yap_Error(SYSTEM_ERROR, TermNil, "load_tables/2 (%s: corrupted table snapshot)", file_name);
+    return FALSE;
+  }
+#if defined(YAPOR_COPY) || defined(YAPOR_SBA)
+  /* the other workers are processes that do not share the mapping, **
+  ** thus the compact answer tries are copied to the table space     */
+  keep_mapping = (GLOBAL_number_workers == 1);
+#else
+  keep_mapping = TRUE;
+#endif /* YAPOR_COPY || YAPOR_SBA */
+  tab_snap = (tab_snap_ptr) malloc(sizeof(struct table_snapshot));
+  if (tab_snap == NULL) {
+    munmap(start, (size_t) file_stat.st_size);
+    Yap_Error(OUT_OF_HEAP_ERROR, TermNil, "load_tables/2 (out of memory)");
+    return FALSE;
+  }
+  TabSnap_start(tab_snap) = start;
+  TabSnap_size(tab_snap) = (size_t) file_stat.st_size;
+  TabSnap_subgoals(tab_snap) = 0;
+  out_of_memory = ! snapshot_symbols_init(&atoms);
+  if (! snapshot_symbols_init(&functors) || out_of_memory)
+    goto no_memory;
+
+  /* atom table */
+  for (i = 0; i < header->atoms; i++) {
+    CELL *record = (CELL *) ptr;
+    Atom at;
+    SNAPSHOT_READ_CHECK(ptr, 3 * sizeof(CELL), end);
+    if (record[2] > (CELL) (end - ptr))
+      goto corrupted_snapshot;
+    SNAPSHOT_READ_CHECK(ptr, 3 * sizeof(CELL) + TABLE_SNAPSHOT_ALIGN(record[2]), end);
+    if (record[2] == 0 || ptr[3 * sizeof(CELL) + record[2] - 1] != 0)
+      goto corrupted_snapshot;
+    if (record[1]) {
+      while (!(at = Yap_LookupWideAtom((wchar_t *) (record + 3))))
+	if (!Yap_growheap(FALSE, 0, NULL))
+	  goto no_memory;
+    } else {
+      while (!(at = Yap_LookupAtom((char *) (record + 3))))
+	if (!Yap_growheap(FALSE, 0, NULL))
+	  goto no_memory;
+    }
+    if (! snapshot_symbols_insert(&atoms, record[0], (CELL) at))
+      goto no_memory;
+    ptr += 3 * sizeof(CELL) + TABLE_SNAPSHOT_ALIGN(record[2]);
+  }
+  /* functor table */
+  for (i = 0; i < header->functors; i++) {
+    CELL *record = (CELL *) ptr;
+    CELL at;
+    Functor f;
+    SNAPSHOT_READ_CHECK(ptr, 3 * sizeof(CELL), end);
+    if (! snapshot_symbols_lookup(&atoms, record[1], &at))
+      goto corrupted_snapshot;
+    while (!(f = Yap_MkFunctor((Atom) at, (unsigned int) record[2])))
+      if (!Yap_growheap(FALSE, 0, NULL))
+	goto no_memory;
+    if (! snapshot_symbols_insert(&functors, record[0], (CELL) f))
+      goto no_memory;
+    ptr += 3 * sizeof(CELL);
+  }
+
+  /* tables */
+  for (i = 0; i < header->tables; i++) {
+    struct table_snapshot_table *table = (struct table_snapshot_table *) ptr;
+    tab_ent_ptr tab_ent = NULL;
+    CELL name, module;
+    SNAPSHOT_READ_CHECK(ptr, sizeof(struct table_snapshot_table), end);
+    if (! snapshot_symbols_lookup(&atoms, table->name, &name) ||
+	! snapshot_symbols_lookup(&atoms, table->module, &module))
+      goto corrupted_snapshot;
+    for (j = 0; j < n; j++) {
+      Term mod = TabEnt_pe(tab_ents[j])->ModuleOfPred;
+      if ((CELL) TabEnt_atom(tab_ents[j]) == name && TabEnt_arity(tab_ents[j]) == table->arity &&
+	  (CELL) AtomOfTerm(mod ? mod : TermProlog) == module && ! IsMode_GlobalTrie(TabEnt_mode(tab_ents[j]))) {
+	tab_ent = tab_ents[j];
+	break;
+      }
+    }
+    ptr += sizeof(struct table_snapshot_table);
+
+    for (j = 0; j < table->subgoals; j++) {
+      CELL depth, nodes, *path;
+      cmp_node_ptr cmp_trie;
+      SNAPSHOT_READ_CHECK(ptr, sizeof(CELL), end);
+      depth = *(CELL *) ptr;
+      if (depth > (CELL) (end - ptr) / sizeof(CELL))
+	goto corrupted_snapshot;
+      SNAPSHOT_READ_CHECK(ptr, (depth + 2) * sizeof(CELL), end);
+      path = (CELL *) ptr + 1;
+      nodes = path[depth];
+      ptr += (depth + 2) * sizeof(CELL);
+      cmp_trie = (cmp_node_ptr) ptr;
+      if (nodes != TABLE_SNAPSHOT_YES) {
+	if (nodes > (CELL) (end - ptr) / sizeof(struct compact_answer_trie_node))
+	  goto corrupted_snapshot;
+	ptr += nodes * sizeof(struct compact_answer_trie_node);
+      }
+      if (tab_ent) {
+	sg_node_ptr current_sg_node;
+	sg_fr_ptr *sg_fr_end;
+	CELL k;
+	int path_ok = snapshot_relocate_subgoal_path(path, depth, TabEnt_arity(tab_ent), &atoms, &functors);
+
+	if (path_ok < 0)
+	  goto no_memory;
+	if (! path_ok)
+	  goto corrupted_snapshot;
+	LOCK_SUBGOAL_TRIE(tab_ent);
+	current_sg_node = get_insert_subgoal_trie(tab_ent PASS_REGS);
+	for (k = 0; k < depth; k++)
+	  current_sg_node = subgoal_trie_check_insert_entry(tab_ent, current_sg_node, path[k] PASS_REGS);
+	sg_fr_end = get_insert_subgoal_frame_addr(current_sg_node PASS_REGS);
+#ifndef THREADS
+	LOCK_SUBGOAL_NODE(current_sg_node);
+#endif /* !THREADS */
+	if (*sg_fr_end == NULL) {
+	  /* subgoals already in the table are kept */
+	  sg_fr_ptr sg_fr;
+	  if (nodes && nodes != TABLE_SNAPSHOT_YES &&
+	      snapshot_relocate_answer_trie(cmp_trie, cmp_trie + nodes, TRAVERSE_MODE_NORMAL, &atoms, &functors) != cmp_trie + nodes) {
+#ifndef THREADS
+	    UNLOCK_SUBGOAL_NODE(current_sg_node);
+#endif /* !THREADS */
+	    UNLOCK_SUBGOAL_TRIE(tab_ent);
+	    goto corrupted_snapshot;
+	  }
+	  new_subgoal_frame(sg_fr, TabEnt_pe(tab_ent)->CodeOfPred, NULL);
+	  if (nodes == TABLE_SNAPSHOT_YES) {
+	    SgFr_first_answer(sg_fr) = SgFr_answer_trie(sg_fr);
+	    SgFr_last_answer(sg_fr) = SgFr_answer_trie(sg_fr);
+	  } else if (nodes) {
+	    if (keep_mapping) {
+	      TabSnap_subgoals(tab_snap)++;
+	    } else {
+	      cmp_node_ptr aux_cmp_trie = cmp_trie;
+	      ALLOC_BLOCK(cmp_trie, nodes * sizeof(struct compact_answer_trie_node), struct compact_answer_trie_node);
+	      memcpy(cmp_trie, aux_cmp_trie, nodes * sizeof(struct compact_answer_trie_node));
+	    }
+	    UPDATE_COMPACT_ANSWER_TRIE_NODES(nodes);
+	    TrNode_child(SgFr_answer_trie(sg_fr)) = (ans_node_ptr) cmp_trie;
+	    SgFr_first_answer(sg_fr) = (ans_node_ptr) cmp_trie;
+	    SgFr_last_answer(sg_fr) = (ans_node_ptr) cmp_trie;
+	  }
+	  SgFr_state(sg_fr) = compiled;
+#ifdef LIMIT_TABLING
+	  insert_into_global_sg_fr_list(sg_fr);
+#endif /* LIMIT_TABLING */
+	  *sg_fr_end = sg_fr;
+	  __sync_synchronize();
+	  TAG_AS_SUBGOAL_LEAF_NODE(current_sg_node);
+	}
+#ifndef THREADS
+	UNLOCK_SUBGOAL_NODE(current_sg_node);
+#endif /* !THREADS */
+	UNLOCK_SUBGOAL_TRIE(tab_ent);
+      }
+    }
+  }
+
+  snapshot_symbols_free(&atoms);
+  snapshot_symbols_free(&functors);
+  if (TabSnap_subgoals(tab_snap)) {
+    TabSnap_next(tab_snap) = GLOBAL_table_snapshots;
+    GLOBAL_table_snapshots = tab_snap;
+  } else {
+    munmap(start, (size_t) file_stat.st_size);
+    free(tab_snap);
+  }
+  return TRUE;
+
+no_memory:
+  out_of_memory = TRUE;
+corrupted_snapshot:
+  /* the subgoals loaded so far are kept */
+  snapshot_symbols_free(&atoms);
+  snapshot_symbols_free(&functors);
+  if (TabSnap_subgoals(tab_snap)) {
+    TabSnap_next(tab_snap) = GLOBAL_table_snapshots;
+    GLOBAL_table_snapshots = tab_snap;
+  } else {
+    munmap(start, (size_t) file_stat.st_size);
+    free(tab_snap);
+  }
+  if (out_of_memory)
+    Yap_Error(OUT_OF_HEAP_ERROR, TermNil, "load_tables/2 (out of memory)");
+  else
+    Yap_Error(SYSTEM_ERROR, TermNil, "load_tables/2 (%s: corrupted table snapshot)", file_name);
+  return FALSE;
+}
+#endif /* TABLE_SNAPSHOTS */
 
 
 void show_table(tab_ent_ptr tab_ent, int show_mode, IOSTREAM *out) {
   CACHE_REGS
   sg_node_ptr sg_node;
 
+  enter_epoch();
   TrStat_out = out;
   TrStat_show = show_mode;
   TrStat_subgoals = 0;
@@ -1653,10 +4236,15 @@ void show_table(tab_ent_ptr tab_ent, int show_mode, IOSTREAM *out) {
   TrStat_answers_pruned = 0;
 #endif /* TABLING_INNER_CUTS */
   TrStat_ans_nodes = 0;
+#ifdef COMPACT_ANSWER_TRIES
+  TrStat_cmp_ans_nodes = 0;
+#endif /* COMPACT_ANSWER_TRIES */
   TrStat_gt_refs = 0;
-  if (show_mode == SHOW_MODE_STATISTICS)
+  TrStat_cmp_ans_tries = 0;
+  if (show_mode == SHOW_MODE_STATISTICS) {
+    TrStat_hash_histogram = (long *) calloc(2 * HASH_HISTOGRAM_SIZE, sizeof(long));
     Sfprintf(TrStat_out, "Table statistics for predicate '%s", AtomName(TabEnt_atom(tab_ent)));
-  else  /* SHOW_MODE_STRUCTURE */
+  } else  /* SHOW_MODE_STRUCTURE */
     Sfprintf(TrStat_out, "Table structure for predicate '%s", AtomName(TabEnt_atom(tab_ent)));
 #ifdef MODE_DIRECTED_TABLING
   if (TabEnt_mode_directed(tab_ent)) {
@@ -1729,6 +4317,7 @@ void show_table(tab_ent_ptr tab_ent, int show_mode, IOSTREAM *out) {
     Sfprintf(TrStat_out, "  Subgoal trie structure\n");
     Sfprintf(TrStat_out, "    Subgoals: %ld (%ld incomplete)\n", TrStat_subgoals, TrStat_sg_incomplete);
     Sfprintf(TrStat_out, "    Subgoal trie nodes: %ld\n", TrStat_sg_nodes);
+    show_hash_histogram(TrStat_hash_histogram + HASH_HISTOGRAM_SUBGOAL PASS_REGS);
     Sfprintf(TrStat_out, "  Answer trie structure(s)\n");
 #ifdef TABLING_INNER_CUTS
     Sfprintf(TrStat_out, "    Answers: %ld (%ld pruned)\n", TrStat_answers, TrStat_answers_pruned);
@@ -1737,9 +4326,18 @@ void show_table(tab_ent_ptr tab_ent, int show_mode, IOSTREAM *out) {
 #endif /* TABLING_INNER_CUTS */
     Sfprintf(TrStat_out, "    Answers 'TRUE': %ld\n", TrStat_answers_true);
     Sfprintf(TrStat_out, "    Answers 'NO': %ld\n", TrStat_answers_no);
+#ifdef COMPACT_ANSWER_TRIES
+    Sfprintf(TrStat_out, "    Answer trie nodes: %ld (%ld compacted)\n", TrStat_ans_nodes, TrStat_cmp_ans_nodes);
+#else
     Sfprintf(TrStat_out, "    Answer trie nodes: %ld\n", TrStat_ans_nodes);
+#endif /* COMPACT_ANSWER_TRIES */
+    show_hash_histogram(TrStat_hash_histogram + HASH_HISTOGRAM_ANSWER PASS_REGS);
+    if (TrStat_cmp_ans_tries)
+      Sfprintf(TrStat_out, "    Hash buckets of compiled answer tries: n/a (%ld tries)\n", TrStat_cmp_ans_tries);
     Sfprintf(TrStat_out, "  Global trie references: %ld\n", TrStat_gt_refs);
+    free(TrStat_hash_histogram);
   }
+  leave_epoch();
   return;
 }
 
@@ -1752,9 +4350,10 @@ void show_global_trie(int show_mode, IOSTREAM *out) {
   TrStat_gt_terms = 0;
   TrStat_gt_nodes = 1;
   TrStat_gt_refs = 0;
-  if (show_mode == SHOW_MODE_STATISTICS)
+  if (show_mode == SHOW_MODE_STATISTICS) {
+    TrStat_hash_histogram = (long *) calloc(HASH_HISTOGRAM_SIZE, sizeof(long));
     Sfprintf(TrStat_out, "Global trie statistics\n");
-  else  /* SHOW_MODE_STRUCTURE */
+  } else  /* SHOW_MODE_STRUCTURE */
     Sfprintf(TrStat_out, "Global trie structure\n");
   if (TrNode_child(GLOBAL_root_gt)) {
     char *str = (char *) malloc(sizeof(char) * SHOW_TABLE_STR_ARRAY_SIZE);
@@ -1769,6 +4368,8 @@ void show_global_trie(int show_mode, IOSTREAM *out) {
     Sfprintf(TrStat_out, "  Terms: %ld\n", TrStat_gt_terms);
     Sfprintf(TrStat_out, "  Global trie nodes: %ld\n", TrStat_gt_nodes);
     Sfprintf(TrStat_out, "  Global trie auto references: %ld\n", TrStat_gt_refs);
+    show_hash_histogram(TrStat_hash_histogram + HASH_HISTOGRAM_GLOBAL PASS_REGS);
+    free(TrStat_hash_histogram);
   }
   return;
 }
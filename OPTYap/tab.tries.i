@@ -135,6 +135,7 @@ static inline sg_node_ptr subgoal_trie_check_insert_entry(tab_ent_ptr tab_ent, s
     sg_node_ptr *bucket;
     int count_nodes = 0;
     hash = (sg_hash_ptr) child_node;
+    MOVE_TRIE_HASH_ENTRY(hash, t, sg_node_ptr);
     bucket = Hash_buckets(hash) + HASH_ENTRY(t, Hash_num_buckets(hash));
     child_node = *bucket;
     while (child_node) {
@@ -149,6 +150,13 @@ static inline sg_node_ptr subgoal_trie_check_insert_entry(tab_ent_ptr tab_ent, s
     *bucket = child_node;
     Hash_num_nodes(hash)++;
     count_nodes++;
+#ifdef INCREMENTAL_HASH_EXPANSION
+    STEP_TRIE_HASH_EXPANSION(hash, sg_node_ptr, HASH_EXPANSION_STEPS);
+    if (count_nodes >= MAX_NODES_PER_BUCKET && Hash_num_nodes(hash) > Hash_num_buckets(hash) && Hash_old_buckets(hash) == NULL) {
+      /* expand current hash */
+      START_TRIE_HASH_EXPANSION(hash, sg_node_ptr);
+    }
+#else
     if (count_nodes >= MAX_NODES_PER_BUCKET && Hash_num_nodes(hash) > Hash_num_buckets(hash)) {
       /* expand current hash */
       sg_node_ptr chain_node, next_node, *old_bucket, *old_hash_buckets, *new_hash_buckets;
@@ -173,6 +181,7 @@ static inline sg_node_ptr subgoal_trie_check_insert_entry(tab_ent_ptr tab_ent, s
       Hash_num_buckets(hash) = num_buckets;
       FREE_BUCKETS(old_hash_buckets);
     }
+#endif /* INCREMENTAL_HASH_EXPANSION */
     UNLOCK_SUBGOAL_NODE(parent_node);
     return child_node;
   }
@@ -379,7 +388,7 @@ subgoal_trie_hash:
 ************************************************************************/
 
 #ifdef INCLUDE_ANSWER_TRIE_CHECK_INSERT
-#ifndef ANSWER_TRIE_LOCK_AT_WRITE_LEVEL /* ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL || ANSWER_TRIE_LOCK_AT_NODE_LEVEL || ! YAPOR */
+#if !defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL) && !defined(ANSWER_TRIE_LOCK_FREE) /* ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL || ANSWER_TRIE_LOCK_AT_NODE_LEVEL || ! YAPOR */
 #ifdef MODE_GLOBAL_TRIE_ENTRY
 static inline ans_node_ptr answer_trie_check_insert_gt_entry(sg_fr_ptr sg_fr, ans_node_ptr parent_node, Term t, int instr USES_REGS) {
 #else
@@ -435,6 +444,7 @@ static inline ans_node_ptr answer_trie_check_insert_entry(sg_fr_ptr sg_fr, ans_n
     ans_node_ptr *bucket;
     int count_nodes = 0;
     hash = (ans_hash_ptr) child_node;
+    MOVE_TRIE_HASH_ENTRY(hash, t, ans_node_ptr);
     bucket = Hash_buckets(hash) + HASH_ENTRY(t, Hash_num_buckets(hash));
     child_node = *bucket;
     while (child_node) {
@@ -449,6 +459,13 @@ static inline ans_node_ptr answer_trie_check_insert_entry(sg_fr_ptr sg_fr, ans_n
     *bucket = child_node;
     Hash_num_nodes(hash)++;
     count_nodes++;
+#ifdef INCREMENTAL_HASH_EXPANSION
+    STEP_TRIE_HASH_EXPANSION(hash, ans_node_ptr, HASH_EXPANSION_STEPS);
+    if (count_nodes >= MAX_NODES_PER_BUCKET && Hash_num_nodes(hash) > Hash_num_buckets(hash) && Hash_old_buckets(hash) == NULL) {
+      /* expand current hash */
+      START_TRIE_HASH_EXPANSION(hash, ans_node_ptr);
+    }
+#else
     if (count_nodes >= MAX_NODES_PER_BUCKET && Hash_num_nodes(hash) > Hash_num_buckets(hash)) {
       /* expand current hash */ 
       ans_node_ptr chain_node, next_node, *old_bucket, *old_hash_buckets, *new_hash_buckets;
@@ -473,11 +490,12 @@ static inline ans_node_ptr answer_trie_check_insert_entry(sg_fr_ptr sg_fr, ans_n
       Hash_num_buckets(hash) = num_buckets;
       FREE_BUCKETS(old_hash_buckets);
     }
+#endif /* INCREMENTAL_HASH_EXPANSION */
     UNLOCK_ANSWER_NODE(parent_node);
     return child_node;
   }
 }
-#else /* ANSWER_TRIE_LOCK_AT_WRITE_LEVEL */
+#elif defined(ANSWER_TRIE_LOCK_AT_WRITE_LEVEL)
 #ifdef MODE_GLOBAL_TRIE_ENTRY
 static inline ans_node_ptr answer_trie_check_insert_gt_entry(sg_fr_ptr sg_fr, ans_node_ptr parent_node, Term t, int instr USES_REGS) {
 #else
@@ -670,6 +688,77 @@ answer_trie_hash:
     return child_node;
   }
 }
+#else /* ANSWER_TRIE_LOCK_FREE */
+#ifdef MODE_GLOBAL_TRIE_ENTRY
+static inline ans_node_ptr answer_trie_check_insert_gt_entry(sg_fr_ptr sg_fr, ans_node_ptr parent_node, Term t, int instr USES_REGS) {
+#else
+static inline ans_node_ptr answer_trie_check_insert_entry(sg_fr_ptr sg_fr, ans_node_ptr parent_node, Term t, int instr USES_REGS) {
+#endif /* MODE_GLOBAL_TRIE_ENTRY */
+  /* chains are only changed by publishing a new first node (or a new hash level that **
+  ** replaces the whole chain) with a compare-and-swap, thus nodes are never moved and  **
+  ** a chain, once read, can be searched without locking                               */
+  ans_node_ptr child_node, first_node, new_node = NULL;
+  ans_node_ptr *chain_ptr;
+  ans_hash_ptr hash = NULL;
+  int count_nodes;
+
+  TABLING_ERROR_CHECKING(answer_trie_check_insert_(gt)_entry, IS_ANSWER_LEAF_NODE(parent_node));
+  chain_ptr = &TrNode_child(parent_node);
+  while (1) {
+    first_node = *chain_ptr;
+    if (first_node && IS_ANSWER_TRIE_HASH(first_node)) {
+      /* go down to the next hash level */
+      hash = (ans_hash_ptr) first_node;
+      child_node = Hash_old_chain(hash);
+      while (child_node) {
+        if (TrNode_entry(child_node) == t)
+          goto found_node;
+        child_node = TrNode_next(child_node);
+      }
+      chain_ptr = Hash_buckets(hash) + HASH_ENTRY_AT_LEVEL(t, Hash_num_buckets(hash), Hash_shift(hash));
+      continue;
+    }
+    count_nodes = 0;
+    child_node = first_node;
+    while (child_node) {
+      if (TrNode_entry(child_node) == t)
+        goto found_node;
+      count_nodes++;
+      child_node = TrNode_next(child_node);
+    }
+    if (count_nodes >= MAX_NODES_PER_TRIE_LEVEL && (hash == NULL || Hash_shift(hash) + HASH_LEVEL_BITS <= HASH_MAX_SHIFT)) {
+      /* replace the chain by a new hash level using the next entry bits */
+      ans_hash_ptr new_hash;
+      new_lock_free_answer_trie_hash(new_hash, count_nodes, first_node, hash ? Hash_shift(hash) + HASH_LEVEL_BITS : 0);
+      if (BOOL_CAS(chain_ptr, first_node, (ans_node_ptr) new_hash)) {
+        if (hash == NULL) {
+          /* only the first hash level is in the chain, the next levels are freed with it */
+          AnsHash_init_chain_fields(new_hash, sg_fr);
+        }
+      } else {
+        FREE_BUCKETS(Hash_buckets(new_hash));
+        FREE_ANSWER_TRIE_HASH(new_hash);
+      }
+      continue;
+    }
+    if (new_node == NULL) {
+      new_answer_trie_node(new_node, instr, t, NULL, parent_node, first_node);
+    } else
+      TrNode_next(new_node) = first_node;
+    if (BOOL_CAS(chain_ptr, first_node, new_node)) {
+#ifdef MODE_GLOBAL_TRIE_ENTRY
+      INCREMENT_GLOBAL_TRIE_REFERENCE(t);
+#endif /* MODE_GLOBAL_TRIE_ENTRY */
+      return new_node;
+    }
+  }
+
+found_node:
+  if (new_node) {
+    FREE_ANSWER_TRIE_NODE(new_node);
+  }
+  return child_node;
+}
 #endif /* ANSWER_TRIE_LOCK_LEVEL */
 #endif /* INCLUDE_ANSWER_TRIE_CHECK_INSERT */
 
@@ -735,6 +824,7 @@ static inline gt_node_ptr global_trie_check_insert_entry(gt_node_ptr parent_node
     gt_node_ptr *bucket;
     int count_nodes = 0;
     hash = (gt_hash_ptr) child_node; 
+    MOVE_TRIE_HASH_ENTRY(hash, t, gt_node_ptr);
     bucket = Hash_buckets(hash) + HASH_ENTRY(t, Hash_num_buckets(hash));
     child_node = *bucket;
     while (child_node) { 
@@ -749,6 +839,13 @@ static inline gt_node_ptr global_trie_check_insert_entry(gt_node_ptr parent_node
     *bucket = child_node;
     Hash_num_nodes(hash)++;
     count_nodes++;
+#ifdef INCREMENTAL_HASH_EXPANSION
+    STEP_TRIE_HASH_EXPANSION(hash, gt_node_ptr, HASH_EXPANSION_STEPS);
+    if (count_nodes >= MAX_NODES_PER_BUCKET && Hash_num_nodes(hash) > Hash_num_buckets(hash) && Hash_old_buckets(hash) == NULL) {
+      /* expand current hash */
+      START_TRIE_HASH_EXPANSION(hash, gt_node_ptr);
+    }
+#else
     if (count_nodes >= MAX_NODES_PER_BUCKET && Hash_num_nodes(hash) > Hash_num_buckets(hash)) {
       /* expand current hash */
       gt_node_ptr chain_node, next_node, *old_bucket, *old_hash_buckets, *new_hash_buckets;
@@ -773,6 +870,7 @@ static inline gt_node_ptr global_trie_check_insert_entry(gt_node_ptr parent_node
       Hash_num_buckets(hash) = num_buckets;
       FREE_BUCKETS(old_hash_buckets);
     }
+#endif /* INCREMENTAL_HASH_EXPANSION */
     UNLOCK_GLOBAL_NODE(parent_node);
     return child_node;
   }
@@ -1519,7 +1617,7 @@ static inline ans_node_ptr answer_search_loop(sg_fr_ptr sg_fr, ans_node_ptr curr
 	ANSWER_CHECK_INSERT_ENTRY(sg_fr, current_node, AbsAppl((Term *)f), _trie_retry_null + in_pair);
 	ANSWER_CHECK_INSERT_ENTRY(sg_fr, current_node, li, _trie_retry_extension);
 	ANSWER_CHECK_INSERT_ENTRY(sg_fr, current_node, AbsAppl((Term *)f), _trie_retry_longint);
-      } else if (f == FunctorBigInt || FunctorString) {
+      } else if (f == FunctorBigInt || f == FunctorString) {
 	CELL *opq = Yap_HeapStoreOpaqueTerm(t);
 	ANSWER_CHECK_INSERT_ENTRY(sg_fr, current_node, AbsAppl((Term *)f), _trie_retry_null + in_pair);
 	ANSWER_CHECK_INSERT_ENTRY(sg_fr, current_node, (CELL)opq, _trie_retry_extension);
@@ -1733,8 +1831,18 @@ static inline ans_node_ptr answer_search_sum(sg_fr_ptr sg_fr, ans_node_ptr curre
 static void invalidate_answer_trie(ans_node_ptr current_node, sg_fr_ptr sg_fr, int position USES_REGS) {
   if (IS_ANSWER_TRIE_HASH(current_node)) {
     ans_hash_ptr hash;
+#ifndef ANSWER_TRIE_LOCK_FREE
     ans_node_ptr *bucket, *last_bucket;
+#endif /* ! ANSWER_TRIE_LOCK_FREE */
     hash = (ans_hash_ptr) current_node;
+#ifdef ANSWER_TRIE_LOCK_FREE
+    /* other workers may be publishing new hashes at the head of the subgoal chain, **
+    ** thus the hash is left in the chain without buckets and freed with the chain  */
+    current_node = flatten_answer_trie_hash(hash, NULL);
+    Hash_buckets(hash) = NULL;
+    invalidate_answer_trie(current_node, sg_fr, TRAVERSE_POSITION_FIRST PASS_REGS);
+#else
+    FINISH_TRIE_HASH_EXPANSION(hash, ans_node_ptr);
     bucket = Hash_buckets(hash);
     last_bucket = bucket + Hash_num_buckets(hash);
     do {
@@ -1762,6 +1870,7 @@ static void invalidate_answer_trie(ans_node_ptr current_node, sg_fr_ptr sg_fr, i
       SgFr_hash_chain(sg_fr) = Hash_next(hash);
     FREE_BUCKETS(Hash_buckets(hash));
     FREE_ANSWER_TRIE_HASH(hash);
+#endif /* ANSWER_TRIE_LOCK_FREE */
   } else {
     if (position == TRAVERSE_POSITION_FIRST) {
       ans_node_ptr next_node = TrNode_next(current_node);
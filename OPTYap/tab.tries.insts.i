@@ -59,14 +59,26 @@
 #define VARS_ENTRY(INDEX)  (VARS_ARITY_ENTRY + 1 + vars_arity - (INDEX))
 #define SUBS_ENTRY(INDEX)  (SUBS_ARITY_ENTRY + 1 + subs_arity - (INDEX))
 
+/* with compact answer tries, the try/retry instructions **
+** are never executed by the last node of a trie level    */
+#ifdef COMPACT_ANSWER_TRIES
+#define TrInst_entry(NODE) CmpNode_entry(NODE)
+#define TrInst_child(NODE) CmpNode_child(NODE)
+#define TrInst_next(NODE)  ((NODE) + (CmpNode_offset(NODE) >> 1))
+#else
+#define TrInst_entry(NODE) TrNode_entry(NODE)
+#define TrInst_child(NODE) TrNode_child(NODE)
+#define TrInst_next(NODE)  TrNode_next(NODE)
+#endif /* COMPACT_ANSWER_TRIES */
+
 #define next_trie_instruction(NODE)                                     \
-        PREG = (yamop *) TrNode_child(NODE);                            \
+        PREG = (yamop *) TrInst_child(NODE);                            \
         PREFETCH_OP(PREG);                                              \
         GONext()
 
 #define next_instruction(CONDITION, NODE)                               \
         if (CONDITION) {                                                \
-          PREG = (yamop *) TrNode_child(NODE);                          \
+          PREG = (yamop *) TrInst_child(NODE);                          \
         } else {  /* procceed */                                        \
 	  PREG = (yamop *) CPREG;                                       \
 	  TOP_STACK = ENV;                                              \
@@ -81,6 +93,21 @@
           aux_stack = TOP_STACK;                                        \
 	}
 
+/* with answer trie ranges, the alternatives of a shared trie node **
+** are taken in ranges of siblings (see SCH_new_trie_alternative)  */
+#ifdef ANSWER_TRIE_RANGES
+#define TRIE_update_alternative(CUR_ALT, NEW_ALT)                       \
+        if (SCH_top_shared_cp(B)) {                                     \
+          if (SCH_trie_range_active())                                  \
+            SCH_trie_range_alternative(CUR_ALT, NEW_ALT);               \
+          else                                                          \
+            SCH_new_trie_alternative(CUR_ALT, NEW_ALT);                 \
+        } else
+#else
+#define TRIE_update_alternative(CUR_ALT, NEW_ALT)                       \
+        YAPOR_update_alternative(CUR_ALT, NEW_ALT)
+#endif /* ANSWER_TRIE_RANGES */
+
 /* macros 'store_trie_node', 'restore_trie_node' and 'pop_trie_node'   **
 ** do not include 'set_cut' because trie instructions are cut safe     */
 
@@ -108,7 +135,7 @@
         restore_yaam_reg_cpdepth(B);                                    \
         CPREG = B->cp_cp;                                               \
         ENV = B->cp_env;                                                \
-        YAPOR_update_alternative(PREG, (yamop *) AP)                    \
+        TRIE_update_alternative(PREG, (yamop *) AP)                     \
         B->cp_ap = (yamop *) AP;                                        \
         TOP_STACK = (CELL *) PROTECT_FROZEN_B(B);                       \
         SET_BB(NORM_CP(TOP_STACK));                                     \
@@ -158,7 +185,7 @@
 #define aux_stack_extension_instr()                                     \
         TOP_STACK = &aux_stack[-2];                                     \
         TOP_STACK[HEAP_ARITY_ENTRY] = heap_arity + 2;                   \
-        TOP_STACK[HEAP_ENTRY(1)] = TrNode_entry(node);                  \
+        TOP_STACK[HEAP_ENTRY(1)] = TrInst_entry(node);                  \
         TOP_STACK[HEAP_ENTRY(2)] = 0;             /* extension mark */  \
         next_trie_instruction(node)
 
@@ -189,7 +216,7 @@
           TOP_STACK = &aux_stack[-1];                                   \
           TOP_STACK[HEAP_ARITY_ENTRY] = 1;                              \
         }                                                               \
-        Bind_Global(HR, TrNode_entry(node));                             \
+        Bind_Global(HR, TrInst_entry(node));                             \
         TOP_STACK[HEAP_ENTRY(1)] = (CELL) (HR + 1);                      \
         HR += 2;                                                         \
         next_trie_instruction(node)
@@ -411,7 +438,7 @@
 ************************************************************************/
 
   PBOp(trie_do_var, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -422,7 +449,7 @@
 
 
   PBOp(trie_trust_var, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -434,32 +461,32 @@
 
 
   PBOp(trie_try_var, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_var_instr();
   ENDPBOp();
 
 
   PBOp(trie_retry_var, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_var_instr();
   ENDPBOp();
 
 
   PBOp(trie_do_var_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -474,7 +501,7 @@
 
   PBOp(trie_trust_var_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -490,13 +517,13 @@
 
   PBOp(trie_try_var_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_var_in_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_try_var_in_pair: invalid instruction");
@@ -506,13 +533,13 @@
 
   PBOp(trie_retry_var_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_var_in_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_retry_var_in_pair: invalid instruction");
@@ -521,24 +548,24 @@
 
 
   PBOp(trie_do_val, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    int var_index = VarIndexOfTableTerm(TrNode_entry(node));
+    int var_index = VarIndexOfTableTerm(TrInst_entry(node));
 
     aux_stack_val_instr();
   ENDPBOp();
 
 
   PBOp(trie_trust_val, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    int var_index = VarIndexOfTableTerm(TrNode_entry(node));
+    int var_index = VarIndexOfTableTerm(TrInst_entry(node));
 
     pop_trie_node();
     aux_stack_val_instr();
@@ -546,39 +573,39 @@
 
 
   PBOp(trie_try_val, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    int var_index = VarIndexOfTableTerm(TrNode_entry(node));
+    int var_index = VarIndexOfTableTerm(TrInst_entry(node));
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_val_instr();
   ENDPBOp();
 
 
   PBOp(trie_retry_val, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    int var_index = VarIndexOfTableTerm(TrNode_entry(node));
+    int var_index = VarIndexOfTableTerm(TrInst_entry(node));
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_val_instr();
   ENDPBOp();
 
 
   PBOp(trie_do_val_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    int var_index = VarIndexOfTableTerm(TrNode_entry(node));
+    int var_index = VarIndexOfTableTerm(TrInst_entry(node));
 
     aux_stack_val_in_pair_instr();
 #else
@@ -589,12 +616,12 @@
 
   PBOp(trie_trust_val_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    int var_index = VarIndexOfTableTerm(TrNode_entry(node));
+    int var_index = VarIndexOfTableTerm(TrInst_entry(node));
 
     pop_trie_node();
     aux_stack_val_in_pair_instr();
@@ -606,14 +633,14 @@
 
   PBOp(trie_try_val_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    int var_index = VarIndexOfTableTerm(TrNode_entry(node));
+    int var_index = VarIndexOfTableTerm(TrInst_entry(node));
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_val_in_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_try_val_in_pair: invalid instruction");
@@ -623,14 +650,14 @@
 
   PBOp(trie_retry_val_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    int var_index = VarIndexOfTableTerm(TrNode_entry(node));
+    int var_index = VarIndexOfTableTerm(TrInst_entry(node));
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_val_in_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_retry_val_in_pair: invalid instruction");
@@ -639,24 +666,24 @@
 
 
   PBOp(trie_do_atom, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Term t = TrNode_entry(node);
+    Term t = TrInst_entry(node);
 
     aux_stack_term_instr();
   ENDPBOp();
 
 
   PBOp(trie_trust_atom, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Term t = TrNode_entry(node);
+    Term t = TrInst_entry(node);
 
     pop_trie_node();
     aux_stack_term_instr();
@@ -664,34 +691,34 @@
 
 
   PBOp(trie_try_atom, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Term t = TrNode_entry(node);
+    Term t = TrInst_entry(node);
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_term_instr();
   ENDPBOp();
 
 
   PBOp(trie_retry_atom, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Term t = TrNode_entry(node);
+    Term t = TrInst_entry(node);
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_term_instr();
   ENDPBOp();
 
 
   PBOp(trie_do_atom_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -706,7 +733,7 @@
 
   PBOp(trie_trust_atom_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -722,13 +749,13 @@
 
   PBOp(trie_try_atom_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_term_in_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_try_atom_in_pair: invalid instruction");
@@ -738,13 +765,13 @@
 
   PBOp(trie_retry_atom_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_term_in_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_retry_atom_in_pair: invalid instruction");
@@ -753,14 +780,14 @@
 
 
   PBOp(trie_do_null, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
 
     aux_stack_null_instr();
   ENDPBOp();
 
 
   PBOp(trie_trust_null, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -772,32 +799,32 @@
 
 
   PBOp(trie_try_null, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_null_instr();
   ENDPBOp();
 
 
   PBOp(trie_retry_null, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_null_instr();
   ENDPBOp();
 
 
   PBOp(trie_do_null_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -812,7 +839,7 @@
 
   PBOp(trie_trust_null_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -828,13 +855,13 @@
 
   PBOp(trie_try_null_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_new_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_try_null_in_pair: invalid instruction");
@@ -844,13 +871,13 @@
 
   PBOp(trie_retry_null_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_new_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_retry_null_in_pair: invalid instruction");
@@ -859,7 +886,7 @@
 
 
   PBOp(trie_do_pair, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -870,7 +897,7 @@
 
 
   PBOp(trie_trust_pair, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -882,36 +909,36 @@
 
 
   PBOp(trie_try_pair, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_pair_instr();
   ENDPBOp();
 
 
   PBOp(trie_retry_pair, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_pair_instr();
   ENDPBOp();
 
 
   PBOp(trie_do_appl, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Functor func = (Functor) RepAppl(TrNode_entry(node));
+    Functor func = (Functor) RepAppl(TrInst_entry(node));
     int func_arity = ArityOfFunctor(func);
 
     aux_stack_appl_instr();
@@ -919,12 +946,12 @@
 
 
   PBOp(trie_trust_appl, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Functor func = (Functor) RepAppl(TrNode_entry(node));
+    Functor func = (Functor) RepAppl(TrInst_entry(node));
     int func_arity = ArityOfFunctor(func);
 
     pop_trie_node();
@@ -933,41 +960,41 @@
 
 
   PBOp(trie_try_appl, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Functor func = (Functor) RepAppl(TrNode_entry(node));
+    Functor func = (Functor) RepAppl(TrInst_entry(node));
     int func_arity = ArityOfFunctor(func);
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_appl_instr();
   ENDPBOp();
 
 
   PBOp(trie_retry_appl, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Functor func = (Functor) RepAppl(TrNode_entry(node));
+    Functor func = (Functor) RepAppl(TrInst_entry(node));
     int func_arity = ArityOfFunctor(func);
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_appl_instr();
   ENDPBOp();
 
 
   PBOp(trie_do_appl_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Functor func = (Functor) RepAppl(TrNode_entry(node));
+    Functor func = (Functor) RepAppl(TrInst_entry(node));
     int func_arity = ArityOfFunctor(func);
 
     aux_stack_appl_in_pair_instr();
@@ -979,12 +1006,12 @@
 
   PBOp(trie_trust_appl_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Functor func = (Functor) RepAppl(TrNode_entry(node));
+    Functor func = (Functor) RepAppl(TrInst_entry(node));
     int func_arity = ArityOfFunctor(func);
 
     pop_trie_node();
@@ -997,15 +1024,15 @@
 
   PBOp(trie_try_appl_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Functor func = (Functor) RepAppl(TrNode_entry(node));
+    Functor func = (Functor) RepAppl(TrInst_entry(node));
     int func_arity = ArityOfFunctor(func);
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_appl_in_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_try_appl_in_pair: invalid instruction");
@@ -1015,15 +1042,15 @@
 
   PBOp(trie_retry_appl_in_pair, e)
 #ifdef TRIE_COMPACT_PAIRS
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
-    Functor func = (Functor) RepAppl(TrNode_entry(node));
+    Functor func = (Functor) RepAppl(TrInst_entry(node));
     int func_arity = ArityOfFunctor(func);
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_appl_in_pair_instr();
 #else
     Yap_Error(INTERNAL_ERROR, TermNil, "trie_retry_appl_in_pair: invalid instruction");
@@ -1032,7 +1059,7 @@
 
 
   PBOp(trie_do_extension, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
 
@@ -1041,7 +1068,7 @@
 
 
   PBOp(trie_trust_extension, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -1053,31 +1080,31 @@
 
 
   PBOp(trie_try_extension, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    store_trie_node(TrNode_next(node));
+    store_trie_node(TrInst_next(node));
     aux_stack_extension_instr();
   ENDPBOp();
 
 
   PBOp(trie_retry_extension, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    restore_trie_node(TrNode_next(node));
+    restore_trie_node(TrInst_next(node));
     aux_stack_extension_instr();
   ENDPBOp();
 
 
   PBOp(trie_do_double, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -1120,7 +1147,7 @@
 
 
   PBOp(trie_do_longint, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -1150,7 +1177,7 @@
 
 
   PBOp(trie_do_bigint, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = aux_stack[HEAP_ARITY_ENTRY];
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
@@ -1181,51 +1208,51 @@
 
 
   PBOp(trie_do_gterm, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = 0;
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    TOP_STACK = exec_substitution((gt_node_ptr)TrNode_entry(node), aux_stack);
+    TOP_STACK = exec_substitution((gt_node_ptr)TrInst_entry(node), aux_stack);
     next_instruction(subs_arity - 1 , node);
   ENDPBOp();
 
 
   PBOp(trie_trust_gterm, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = 0;
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
     pop_trie_node();
-    TOP_STACK = exec_substitution((gt_node_ptr)TrNode_entry(node), aux_stack);
+    TOP_STACK = exec_substitution((gt_node_ptr)TrInst_entry(node), aux_stack);
     next_instruction(subs_arity - 1 , node);
   ENDPBOp();
 
 
   PBOp(trie_try_gterm, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = TOP_STACK;
     int heap_arity = 0;
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    store_trie_node(TrNode_next(node));
-    TOP_STACK = exec_substitution((gt_node_ptr)TrNode_entry(node), aux_stack);
+    store_trie_node(TrInst_next(node));
+    TOP_STACK = exec_substitution((gt_node_ptr)TrInst_entry(node), aux_stack);
     next_instruction(subs_arity - 1, node); 
   ENDPBOp();
 
 
   PBOp(trie_retry_gterm, e)
-    register ans_node_ptr node = (ans_node_ptr) PREG;
+    register ans_inst_node_ptr node = (ans_inst_node_ptr) PREG;
     register CELL *aux_stack = (CELL *) (B + 1);
     int heap_arity = 0;
     int vars_arity = aux_stack[VARS_ARITY_ENTRY];
     int subs_arity = aux_stack[SUBS_ARITY_ENTRY];
 
-    restore_trie_node(TrNode_next(node));
-    TOP_STACK = exec_substitution((gt_node_ptr)TrNode_entry(node), aux_stack);
+    restore_trie_node(TrInst_next(node));
+    TOP_STACK = exec_substitution((gt_node_ptr)TrInst_entry(node), aux_stack);
     next_instruction(subs_arity - 1, node); 
   ENDPBOp();
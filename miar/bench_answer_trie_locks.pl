@@ -0,0 +1,51 @@
+% Stress benchmark for the answer trie lock schemes.
+%
+% Several workers insert the answers of a single tabled subgoal with
+% a wide first level (hashed) and a narrow second level, and every
+% answer is found twice, so that both the insert and the lookup paths
+% of answer_trie_check_insert_entry() are exercised concurrently.
+%
+% Build one yap for each scheme, by selecting one of the answer trie
+% lock schemes in OPTYap/opt.config.h:
+%   ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL
+%   ANSWER_TRIE_LOCK_AT_NODE_LEVEL
+%   ANSWER_TRIE_LOCK_AT_WRITE_LEVEL
+%   ANSWER_TRIE_LOCK_FREE
+% and then compare the times reported for 1, 2, 4, 8 ... workers:
+%
+% ./yap -l ../yaptab-par/miar/bench_answer_trie_locks.pl -w 8 -s 40000 -h 300000 -t 80000
+
+:- yap_flag(tabling_mode,[local,load_answers,local_trie]).
+
+keys(20000).
+values(4).
+
+:- table answer/2.
+answer(K, V):- keys(NK), values(NV), between(1, NK, K), between(1, NV, V).
+answer(K, V):- keys(NK), values(NV), between(1, NK, K0), K is NK + 1 - K0, between(1, NV, V).
+
+go_parallel:- parallel(answer(_,_)),
+       fail.
+
+go_parallel.
+
+
+go_single:- answer(_,_),
+	    fail.
+go_single.
+
+
+bench:- statistics(walltime, [T0,_]),
+        go_parallel,
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        findall(K-V, answer(K,V), L), length(L, N),
+        format('answers: ~d  walltime: ~d ms~n', [N,T]).
+
+
+
+:- parallel_mode(on).
+
+:- bench.
+%:- tabling_statistics.
+:-halt.
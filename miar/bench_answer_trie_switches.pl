@@ -0,0 +1,40 @@
+% Benchmark for the answer trie switches (requires YAP compiled with
+% ANSWER_TRIE_SWITCHES, i.e., with COMPACT_ANSWER_TRIES and
+% TABLING_CALL_SUBSUMPTION).
+%
+% The workload evaluates the open call f(X,Y), whose compact answer trie
+% has a first level with one node for each value of X, and then calls
+% f(N,Y) for every value N. With tabling_mode(f/2,subsumptive) each
+% f(N,Y) call is subsumed by the completed f(X,Y) subgoal. Without the
+% switches, the answers of each call are filtered by scanning all the
+% nodes of the first level of the answer trie of f(X,Y). With the
+% switches, the node of N is looked up in a hashed switch of the level
+% (see load_compact_subsumed_answers() in OPTYap/tab.tries.c).
+%
+% ./yap -l ../yaptab-par/miar/bench_answer_trie_switches.pl
+
+:- table f/2.
+
+values(20000).
+
+f(X,Y):- values(N), between(1, N, X), Y is X * 2.
+f(X,Y):- values(N), between(1, N, X), X mod 3 =:= 0, Y is X * 3.
+
+go:- f(_,_), fail.
+go:- values(N), between(1, N, X), f(X,_), fail.
+go.
+
+
+bench(Mode):- abolish_all_tables,
+        tabling_mode(f/2, Mode),
+        statistics(walltime, [T0,_]),
+        go,
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        format('call mode: ~w  walltime: ~d ms~n', [Mode,T]).
+
+
+
+:- bench(subsumptive).
+%:- tabling_statistics.
+:-halt.
@@ -0,0 +1,47 @@
+% Benchmark for the YapOr wait modes.
+%
+% The workload is an or-parallel search with uneven branches, thus the
+% workers run out of work at different times and spend part of the
+% execution in the scheduler, waiting for sharing answers or for new
+% work. With parallel_wait_mode(spin) the waiting workers keep their
+% cores busy, with parallel_wait_mode(block) they sleep after a short
+% spin (see BLOCKING_WAIT_SPINS and BLOCKING_WAIT_USECS in
+% OPTYap/opt.config.h).
+%
+% Compare both modes with as many workers as cores and then with more
+% workers than cores (oversubscription), e.g. in a 4 core machine:
+%
+% ./yap -l ../yaptab-par/miar/bench_blocking_wait.pl -w 4 -s 40000 -h 300000 -t 80000
+% ./yap -l ../yaptab-par/miar/bench_blocking_wait.pl -w 8 -s 40000 -h 300000 -t 80000
+% ./yap -l ../yaptab-par/miar/bench_blocking_wait.pl -w 16 -s 40000 -h 300000 -t 80000
+
+branches(64).
+
+work(B, S):- branches(NB), between(1, NB, B), Size is (B mod 8 + 1) * 20000, loop(Size, 0, S).
+
+loop(0, S, S):- !.
+loop(N, S0, S):- S1 is (S0 + N * N) mod 1000003, N1 is N - 1, loop(N1, S1, S).
+
+go_parallel:- parallel(work(_,_)),
+       fail.
+go_parallel.
+
+
+bench(Mode):- parallel_wait_mode(Mode),
+        statistics(walltime, [T0,_]),
+        statistics(cputime, [C0,_]),
+        go_parallel,
+        statistics(walltime, [T1,_]),
+        statistics(cputime, [C1,_]),
+        T is T1 - T0,
+        C is C1 - C0,
+        format('wait mode: ~w  walltime: ~d ms  cputime (worker 0): ~d ms~n', [Mode,T,C]).
+
+
+
+:- parallel_mode(on).
+
+:- bench(spin).
+:- bench(block).
+%:- or_statistics.
+:-halt.
@@ -0,0 +1,43 @@
+% Benchmark for the tabling call modes.
+%
+% The workload first evaluates the open reachability call path(X,Y) on a
+% chain with cross edges and then calls path(N,Y) for every node N. With
+% tabling_mode(path/2,variant) each path(N,Y) call is a new subgoal and
+% is evaluated from the program clauses, with
+% tabling_mode(path/2,subsumptive) it is subsumed by the completed
+% path(X,Y) subgoal and its answers are filtered from the answer trie of
+% path(X,Y) (see complete_subsumed_subgoal() in OPTYap/tab.tries.c).
+%
+% Compare both modes, e.g.:
+%
+% ./yap -l ../yaptab-par/miar/bench_call_subsumption.pl
+
+:- table path/2.
+
+nodes(300).
+
+edge(X,Y):- nodes(N), between(1, N, X), Y is X mod N + 1.
+edge(X,Y):- nodes(N), between(1, N, X), X mod 7 =:= 0, Y is (X * 3) mod N + 1.
+
+path(X,Y):- path(X,Z), edge(Z,Y).
+path(X,Y):- edge(X,Y).
+
+go:- path(_,_), fail.
+go:- nodes(N), between(1, N, X), path(X,_), fail.
+go.
+
+
+bench(Mode):- abolish_all_tables,
+        tabling_mode(path/2, Mode),
+        statistics(walltime, [T0,_]),
+        go,
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        format('call mode: ~w  walltime: ~d ms~n', [Mode,T]).
+
+
+
+:- bench(variant).
+:- bench(subsumptive).
+%:- tabling_statistics.
+:-halt.
@@ -0,0 +1,54 @@
+% Benchmark for the deferred abolish mode (requires YAP compiled with
+% DEFERRED_ABOLISH, i.e., without THREADS).
+%
+% The workload calls path(N,Y) for every node N of a chain with cross
+% edges and then abolishes all tables, a number of times. In immediate
+% mode abolish_all_tables/0 releases the whole table space before
+% returning. With yap_flag(table_abolish_mode,deferred) the subgoal tries
+% are only detached from their table entries and the first level subtries
+% are released one at a time when new subgoals are called (see
+% free_abolished_subtrie() in OPTYap/tab.tries.c). The released subtries
+% and the detached tries still pending are reported by tabling_statistics/2.
+%
+% ./yap -l ../yaptab-par/miar/bench_deferred_abolish.pl
+
+:- table path/2.
+
+nodes(300).
+rounds(20).
+
+edge(X,Y):- nodes(N), between(1, N, X), Y is X mod N + 1.
+edge(X,Y):- nodes(N), between(1, N, X), X mod 7 =:= 0, Y is (X * 3) mod N + 1.
+
+path(X,Y):- path(X,Z), edge(Z,Y).
+path(X,Y):- edge(X,Y).
+
+go:- nodes(N), between(1, N, X), path(X,_), fail.
+go.
+
+run:- rounds(R), between(1, R, _), go, statistics(walltime, [T0,_]),
+      abolish_all_tables, statistics(walltime, [T1,_]),
+      nb_getval(abolish_time, A0), A is A0 + T1 - T0, nb_setval(abolish_time, A), fail.
+run.
+
+
+bench(Mode):- abolish_all_tables,
+        yap_flag(table_abolish_mode, Mode),
+        nb_setval(abolish_time, 0),
+        tabling_statistics(abolished_tries, [F0,_]),
+        statistics(walltime, [T0,_]),
+        run,
+        statistics(walltime, [T1,_]),
+        tabling_statistics(abolished_tries, [F1,P]),
+        nb_getval(abolish_time, A),
+        T is T1 - T0,
+        F is F1 - F0,
+        format('~w: walltime: ~d ms  abolish_all_tables: ~d ms  freed subtries: ~d  pending tries: ~d~n', [Mode,T,A,F,P]),
+        yap_flag(table_abolish_mode, immediate).
+
+
+
+:- bench(immediate).
+:- bench(deferred).
+%:- tabling_statistics.
+:-halt.
@@ -0,0 +1,50 @@
+% Benchmark for the granularity control of the YapOr sharing requests.
+% It needs a YapOr build with YAPOR_GRANULARITY_CONTROL defined (off by
+% default, see OPTYap/opt.config.h).
+%
+% With YAPOR_GRANULARITY_CONTROL the work done by each alternative taken
+% from a shared node is timed and averaged in counters of its
+% predicate, and a worker refuses a sharing request when
+% its private nodes are expected to do less work than
+% parallel_granularity/1 times the average cost of a sharing operation.
+% The fine grained goal below shares many tiny num/2 and edge/2
+% alternatives, the coarse grained one shares alternatives that run a
+% longer loop each.
+% Both goals are run without (ratio 0) and with the granularity control
+% and or_statistics(granularity,[SharingTime,WorkTime]) gives the
+% sharing time vs the work time (microseconds) of each run.
+%
+% ./yap -l ../yaptab-par/miar/bench_granularity.pl -w 4 -s 100000 -h 300000
+
+nodes(20000).
+
+%% num(N, X) leaves a choice point with one tiny alternative for each X
+num(N, N).
+num(N, X):- N > 1, N1 is N - 1, num(N1, X).
+
+edge(X, Y):- nodes(N), Y is (X * 7) mod N + 1.
+edge(X, Y):- nodes(N), Y is (X * 13) mod N + 1.
+
+fine:- nodes(N), num(N, X), edge(X, Y), edge(Y, Z), edge(Z, _), fail.
+fine.
+
+coarse:- num(200, X), between(1, 5000, I), _ is I * X, fail.
+coarse.
+
+bench(Name, Ratio, Goal):-
+        parallel_granularity(Ratio),
+        or_statistics(granularity, [S0,W0]),
+        statistics(walltime, [T0,_]),
+        parallel(Goal),
+        statistics(walltime, [T1,_]),
+        or_statistics(granularity, [S1,W1]),
+        T is T1 - T0, S is S1 - S0, W is W1 - W0,
+        ( W > 0 -> R is S / W ; R = 0 ),
+        format('~w (ratio ~w): walltime: ~d ms, sharing/work time: ~4f~n', [Name,Ratio,T,R]).
+
+
+
+:- parallel_granularity(Default),
+   bench(fine, 0, fine), bench(fine, Default, fine),
+   bench(coarse, 0, coarse), bench(coarse, Default, coarse).
+:- halt.
@@ -0,0 +1,53 @@
+% Benchmark for the ground_hash tabling mode (requires YAP compiled with
+% GROUND_CALL_HASHING, i.e., without YapOr and THREADS).
+%
+% The workload calls sum_plain/2 and sum_hashed/2 repeatedly with the
+% same large ground lists. Both predicates are tabled and have the same
+% clauses, but sum_hashed/2 is set with tabling_mode ground_hash. For
+% sum_plain/2 each repeated call walks the subgoal trie term by term. For
+% sum_hashed/2 the call is flattened, hashed and compared with the stored
+% call (see lookup_ground_call() in OPTYap/tab.tries.c). The number of
+% hits and lookups is reported by tabling_statistics/2.
+%
+% ./yap -l ../yaptab-par/miar/bench_ground_call_hashing.pl
+
+:- table sum_plain/2, sum_hashed/2.
+:- tabling_mode(sum_hashed/2, ground_hash).
+
+lists(20).
+length_of_lists(10000).
+rounds(20).
+
+sum_plain(L,S):- add_list(L,S).
+sum_hashed(L,S):- add_list(L,S).
+
+make_lists(Ls):- lists(N), length_of_lists(M),
+        findall(L, (between(1, N, I), findall(f(I,J), between(1, M, J), L)), Ls).
+
+add_list([],0).
+add_list([f(_,J)|L],S):- add_list(L,S0), S is S0 + J.
+
+in_list(X,[X|_]).
+in_list(X,[_|L]):- in_list(X,L).
+
+run(P,Ls):- rounds(R), between(1, R, _), in_list(L, Ls), call(P, L, _), fail.
+run(_,_).
+
+
+bench(P):- make_lists(Ls),
+        tabling_statistics(ground_calls, [H0,L0]),
+        statistics(walltime, [T0,_]),
+        run(P, Ls),
+        statistics(walltime, [T1,_]),
+        tabling_statistics(ground_calls, [H1,L1]),
+        T is T1 - T0,
+        H is H1 - H0,
+        L is L1 - L0,
+        format('~w: walltime: ~d ms  ground call hits: ~d  lookups: ~d~n', [P,T,H,L]).
+
+
+
+:- bench(sum_plain).
+:- bench(sum_hashed).
+%:- tabling_statistics.
+:-halt.
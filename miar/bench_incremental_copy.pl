@@ -0,0 +1,50 @@
+% Benchmark for the YapOr copy modes.
+%
+% The workload is an or-parallel search where each branch is reached
+% through a deep deterministic prefix, thus the workers stacks hold a
+% large common part when they share work. With parallel_copy_mode(full)
+% the sharing worker copies the stacks from the root node, with
+% parallel_copy_mode(incremental) it copies only the segments between its
+% current node and the top node of the requesting worker (see
+% COMPUTE_SEGMENTS_TO_COPY_TO() in OPTYap/or.copy_engine.c). The bytes
+% copied per sharing operation are reported by or_statistics/0.
+%
+% Compare both modes for 2, 4, 8 ... workers, e.g.:
+%
+% ./yap -l ../yaptab-par/miar/bench_incremental_copy.pl -w 4 -s 40000 -h 300000 -t 80000
+% ./yap -l ../yaptab-par/miar/bench_incremental_copy.pl -w 8 -s 40000 -h 300000 -t 80000
+
+prefix(20000).
+branches(8).
+depth(7).
+
+work(S):- prefix(N), build(N, L), search(L, S).
+
+build(0, []):- !.
+build(N, [N|L]):- N1 is N - 1, build(N1, L).
+
+search(L, S):- depth(D), choose(D, L, 0, S).
+
+choose(0, _, S, S):- !.
+choose(D, L, S0, S):- branches(NB), between(1, NB, B), S1 is (S0 * NB + B) mod 1000003, D1 is D - 1, choose(D1, L, S1, S).
+
+go_parallel:- parallel(work(_)),
+       fail.
+go_parallel.
+
+
+bench(Mode):- parallel_copy_mode(Mode),
+        statistics(walltime, [T0,_]),
+        go_parallel,
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        format('copy mode: ~w  walltime: ~d ms~n', [Mode,T]).
+
+
+
+:- parallel_mode(on).
+
+:- bench(full).
+:- bench(incremental).
+%:- or_statistics.
+:-halt.
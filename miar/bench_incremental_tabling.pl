@@ -0,0 +1,66 @@
+% Benchmark for incremental tabling (requires YAP compiled with
+% INCREMENTAL_TABLING, i.e., sequential tabling).
+%
+% The workload computes the transitive closure of two graphs, a large
+% road/2 graph and a small rail/2 graph, and then updates the rail/2
+% relation a number of times, calling all the path subgoals again after
+% each update. With abolish_all_tables the whole table space is evaluated
+% again after each update. With incremental tabling only the completed
+% subgoals that depend on rail/2 are invalidated (see
+% incremental_predicate_update() in OPTYap/tab.tries.c), thus the
+% road_path/2 subgoals keep their answers. The updates and the
+% invalidated subgoals are reported by tabling_statistics/2.
+%
+% ./yap -l ../yaptab-par/miar/bench_incremental_tabling.pl
+
+:- dynamic road/2, rail/2 as incremental.
+:- table road_path/2, rail_path/2 as incremental.
+
+road_nodes(300).
+rail_nodes(20).
+updates(50).
+
+road_path(X,Y):- road(X,Y).
+road_path(X,Y):- road(X,Z), road_path(Z,Y).
+
+rail_path(X,Y):- rail(X,Y).
+rail_path(X,Y):- rail(X,Z), rail_path(Z,Y).
+
+init:- retractall(road(_,_)), retractall(rail(_,_)), fail.
+init:- road_nodes(N), N1 is N - 1,
+       between(1, N1, X), Y is X + 1, assertz(road(X,Y)), fail.
+init:- rail_nodes(N), N1 is N - 1,
+       between(1, N1, X), Y is X + 1, assertz(rail(X,Y)), fail.
+init.
+
+go:- road_nodes(N), between(1, N, X), road_path(X,_), fail.
+go:- rail_nodes(N), between(1, N, X), rail_path(X,_), fail.
+go.
+
+% adds and removes a back edge of the rail graph
+update(I):- X is I mod 10 + 2, assertz(rail(X,1)), retract(rail(X,1)).
+
+run(abolish):- updates(U), between(1, U, I), update(I), abolish_all_tables, go, fail.
+run(incremental):- updates(U), between(1, U, I), update(I), go, fail.
+run(_).
+
+
+bench(Mode):- abolish_all_tables,
+        init,
+        go,
+        tabling_statistics(incremental_updates, [U0,S0]),
+        statistics(walltime, [T0,_]),
+        run(Mode),
+        statistics(walltime, [T1,_]),
+        tabling_statistics(incremental_updates, [U1,S1]),
+        T is T1 - T0,
+        U is U1 - U0,
+        S is S1 - S0,
+        format('~w: walltime: ~d ms  updates: ~d  invalidated subgoals: ~d~n', [Mode,T,U,S]).
+
+
+
+:- bench(abolish).
+:- bench(incremental).
+%:- tabling_statistics.
+:-halt.
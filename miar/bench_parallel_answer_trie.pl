@@ -0,0 +1,45 @@
+% Benchmark for the parallel consumption of a completed answer trie.
+%
+% The answers of the completed subgoal answer(X,Y) are consumed inside
+% parallel/1 and each answer runs a loop. With ANSWER_TRIE_RANGES (see
+% OPTYap/opt.config.h) a worker that takes a shared node of the answer
+% trie also takes a range of the following siblings of the trie level
+% (SCH_new_trie_alternative() in OPTYap/or.macros.h) and exploits them
+% without locking the or-frame of the node, thus the idle workers take
+% disjoint ranges of the first level subtries. The first level of the trie
+% has one node for each X and the subtrie of X has its Y answers.
+% or_statistics(answer_trie_ranges,[Ranges,TrieNodes]) gives the ranges
+% taken and the trie nodes in them, and the answers found by all the
+% workers are checked against the completed table.
+%
+% ./yap -l ../yaptab-par/miar/bench_parallel_answer_trie.pl -w 4 -s 100000 -h 300000
+
+:- table answer/2.
+:- dynamic found/2.
+
+answer(X, Y):- between(1, 2000, X), between(1, 4, Y).
+
+loop(0, _):- !.
+loop(N, X):- _ is X * X, M is N - 1, loop(M, X).
+
+consume(Work):- answer(X, Y), loop(Work, X), assertz(found(X,Y)), fail.
+consume(_).
+
+bench(Work):-
+        retractall(found(_,_)),
+        or_statistics(answer_trie_ranges, [R0,N0]),
+        statistics(walltime, [T0,_]),
+        parallel(consume(Work)),
+        statistics(walltime, [T1,_]),
+        or_statistics(answer_trie_ranges, [R1,N1]),
+        T is T1 - T0, R is R1 - R0, N is N1 - N0,
+        findall(X-Y, found(X,Y), L), sort(L, S),
+        findall(X-Y, answer(X,Y), A), sort(A, S0),
+        ( S == S0 -> length(L, Answers) ; Answers = wrong ),
+        format('work ~d: ~w answers, walltime: ~d ms, ~d ranges with ~d trie nodes~n', [Work,Answers,T,R,N]).
+
+
+
+:- parallel_granularity(0), findall(_, answer(_,_), _),
+   bench(100), bench(1000), bench(10000).
+:- halt.
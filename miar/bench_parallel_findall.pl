@@ -0,0 +1,44 @@
+% Benchmark for parallel_findall/3 with many answers.
+%
+% Each worker keeps its answers in a local chunk of QG_ANSWER_SLOTS
+% answers (see CUT_buffer_answer() in OPTYap/or.macros.h) and only stores
+% the chunk in the leftmost or-frame, under the or-frame lock, when it is
+% full or when the worker leaves its branch or takes another alternative
+% of a shared node. The answers are returned in the same left-to-right
+% order as findall/3, which is also checked with unbalanced branches,
+% where the work of each branch depends on its first choice.
+%
+% ./yap -l ../yaptab-par/miar/bench_parallel_findall.pl -w 4
+
+answers(50000).
+
+gen(X):- answers(N), M is N // 4, between(1, 4, I), between(1, M, J), X is (I - 1) * M + J.
+
+unbalanced(X):- branch(A), N is (A mod 7) * 3000, loop(N), branch(B), B =< 3, X is A * 10 + B.
+
+branch(1). branch(2). branch(3). branch(4). branch(5). branch(6). branch(7). branch(8). branch(9). branch(10).
+branch(11). branch(12). branch(13). branch(14). branch(15). branch(16). branch(17). branch(18). branch(19). branch(20).
+branch(21). branch(22). branch(23). branch(24). branch(25). branch(26). branch(27). branch(28). branch(29). branch(30).
+branch(31). branch(32). branch(33). branch(34). branch(35). branch(36). branch(37). branch(38). branch(39). branch(40).
+
+loop(0):- !.
+loop(N):- M is N - 1, loop(M).
+
+bench(Name, Goal):-
+        statistics(walltime, [T0,_]),
+        call(Goal),
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        format('~w: walltime: ~d ms~n', [Name,T]).
+
+check(L1, L2):- ( L1 == L2 -> format('same answers in the same order~n', []) ; format('different answers~n', []) ).
+
+
+
+:- bench(parallel_findall, parallel_findall(X, gen(X), L1)), bench(findall, findall(X, gen(X), L2)), check(L1, L2).
+:- parallel_findall(X, unbalanced(X), L1), findall(X, unbalanced(X), L2), check(L1, L2).
+:- parallel_findall(X, unbalanced(X), L1), findall(X, unbalanced(X), L2), check(L1, L2).
+:- parallel_findall(X, unbalanced(X), L1), findall(X, unbalanced(X), L2), check(L1, L2).
+:- parallel_findall(X, unbalanced(X), L1), findall(X, unbalanced(X), L2), check(L1, L2).
+:- parallel_findall(X, unbalanced(X), L1), findall(X, unbalanced(X), L2), check(L1, L2).
+:- halt.
@@ -0,0 +1,65 @@
+% Benchmark for the per-worker magazines of free tabling structs.
+%
+% The workload is the transitive closure of a chain of nodes, evaluated
+% inside parallel/1, with one subgoal per node and about half a million
+% answers. With STRUCT_MAGAZINES (see OPTYap/opt.config.h) the workers
+% allocate the subgoal frames, dependency frames and trie nodes from their
+% own magazines, and the global lock of each struct type is taken once per
+% batch of MAGAZINE_BATCH_SIZE structs.
+% tabling_statistics(magazine_locks,[GlobalLocks,Waits]) gives the global
+% lock acquisitions and how many of them waited for another worker, and
+% tabling_statistics/0 gives the details for each struct type. The
+% workload runs three times, so that the later runs reuse the structs
+% kept in the depot of free structs and release the batches that do not
+% fit in it.
+%
+% Compare the lock waits and times for 1, 8 and 32 workers, e.g.:
+%
+% ./yap -l ../yaptab-par/miar/bench_struct_magazines.pl -w 1 -s 40000 -h 300000 -t 80000
+% ./yap -l ../yaptab-par/miar/bench_struct_magazines.pl -w 8 -s 40000 -h 300000 -t 80000
+% ./yap -l ../yaptab-par/miar/bench_struct_magazines.pl -w 32 -s 40000 -h 300000 -t 80000
+
+:- yap_flag(tabling_mode,[local,load_answers,local_trie]).
+
+:- dynamic edge/2.
+
+size(1000).
+
+make_chain:- size(N),
+        ( between(1, N, X), Y is X + 1,
+          assert(edge(X,Y)),
+          fail
+        ; true ).
+
+:- table path/2.
+path(X, Z):- edge(X, Z).
+path(X, Z):- edge(X, Y), path(Y, Z).
+
+go_parallel:- parallel(path(_,_)),
+       fail.
+
+go_parallel.
+
+
+bench(Run):- abolish_all_tables,
+        tabling_statistics(magazine_locks, [L0,W0]),
+        statistics(walltime, [T0,_]),
+        go_parallel,
+        statistics(walltime, [T1,_]),
+        tabling_statistics(magazine_locks, [L1,W1]),
+        T is T1 - T0,
+        L is L1 - L0,
+        W is W1 - W0,
+        format('~w run: walltime: ~d ms  global locks: ~d  lock waits: ~d~n', [Run,T,L,W]).
+
+
+
+:- make_chain.
+
+:- parallel_mode(on).
+
+:- bench(first).
+:- bench(second).
+:- bench(third).
+%:- tabling_statistics.
+:-halt.
@@ -0,0 +1,52 @@
+% Benchmark for the compression of the suspended branches.
+%
+% Each parallel branch builds a large list on the global stack and then
+% consumes the answers of a tabled subgoal shared by all branches. The
+% workers that run out of answers before the subgoal is completed suspend
+% their branches, saving the private part of their stacks (see
+% suspend_branch() in OPTYap/tab.completion.c). With SUSPENSION_COMPRESSION
+% the saved blocks are compressed, and opt_statistics(suspended_blocks,
+% [BytesStored,BytesSuspended]) reports the bytes suspended and stored by
+% all the suspensions. The number of suspensions depends on the scheduling,
+% thus the benchmark may need more than one run, or more workers, to
+% suspend some branches. yap_flag(suspension_space_threshold,Bytes) makes
+% the parallel goal raise an error when its suspended blocks went above
+% Bytes.
+%
+% ./yap -l ../yaptab-par/miar/bench_suspension_compression.pl -w 4 -s 100000 -h 300000
+
+:- table reach/2.
+
+arc(X,Y):- between(1,300,X), Y is X mod 300 + 1.
+arc(X,Y):- between(1,300,X), Y is (X*7) mod 300 + 1.
+
+reach(X,Y):- reach(X,Z), arc(Z,Y).
+reach(X,Y):- arc(X,Y).
+
+branch(1). branch(2). branch(3). branch(4).
+branch(5). branch(6). branch(7). branch(8).
+
+data(0, []):- !.
+data(N, [f(N,a,b,[])|L]):- M is N - 1, data(M, L).
+
+task(I, Y):- branch(I), data(20000, D), reach(1, Y), D = [_|_].
+
+bench:-
+        statistics(walltime, [T0,_]),
+        parallel_findall(I-Y, task(I,Y), L),
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        length(L, N),
+        opt_statistics(suspended_blocks, [Stored,Suspended]),
+        format('~d answers: walltime: ~d ms~n', [N,T]),
+        ( Suspended > 0 ->
+          Ratio is Stored / Suspended,
+          format('suspended blocks: ~d bytes, stored in ~d bytes (ratio ~3f)~n', [Suspended,Stored,Ratio])
+        ;
+          format('no branches were suspended~n', [])
+        ).
+
+
+
+:- bench.
+:- halt.
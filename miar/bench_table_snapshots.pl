@@ -0,0 +1,48 @@
+% Benchmark for the table snapshots.
+%
+% The workload evaluates the reachability calls path(N,Y) for every node
+% N and saves the completed tables of path/2 to a snapshot file with
+% save_tables/2. It then abolishes the tables and loads them back with
+% load_tables/2: the loaded subgoals are completed subgoals whose answers
+% are consumed directly from the mapped file (see load_tables() in
+% OPTYap/tab.tries.c), thus the second run does not evaluate path/2.
+%
+% Compare the evaluation and loading times, e.g.:
+%
+% ./yap -l ../yaptab-par/miar/bench_table_snapshots.pl
+
+:- table path/2.
+
+nodes(300).
+
+edge(X,Y):- nodes(N), between(1, N, X), Y is X mod N + 1.
+edge(X,Y):- nodes(N), between(1, N, X), X mod 7 =:= 0, Y is (X * 3) mod N + 1.
+
+path(X,Y):- path(X,Z), edge(Z,Y).
+path(X,Y):- edge(X,Y).
+
+go:- nodes(N), between(1, N, X), path(X,_), fail.
+go.
+
+file('/tmp/bench_table_snapshots.tbl').
+
+
+bench(Run):- statistics(walltime, [T0,_]),
+        run(Run),
+        go,
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        format('run: ~w  walltime: ~d ms~n', [Run,T]).
+
+run(evaluate):- abolish_all_tables.
+run(load):- abolish_all_tables, file(F), load_tables(path/2, F).
+
+save:- file(F), save_tables(path/2, F).
+
+
+
+:- bench(evaluate).
+:- save.
+:- bench(load).
+%:- tabling_statistics.
+:-halt.
@@ -0,0 +1,51 @@
+% Benchmark for the table space limit (requires YAP compiled with
+% LIMIT_TABLING).
+%
+% The workload calls path(N,Y) for every node N of a chain with cross
+% edges, twice. Without a limit the second pass obtains all answers from
+% the completed tables. With yap_flag(table_space_limit,Bytes) the answer
+% tries of the least recently used completed subgoals are released when a
+% new subgoal is called and the table space is above the limit (see
+% limit_table_space() in OPTYap/tab.tries.c), thus part of the subgoals of
+% the second pass are evaluated again. The released subgoals and memory
+% are reported by tabling_statistics/2.
+%
+% Compare several limits, e.g.:
+%
+% ./yap -l ../yaptab-par/miar/bench_table_space_limit.pl
+
+:- table path/2.
+
+nodes(400).
+
+edge(X,Y):- nodes(N), between(1, N, X), Y is X mod N + 1.
+edge(X,Y):- nodes(N), between(1, N, X), X mod 7 =:= 0, Y is (X * 3) mod N + 1.
+
+path(X,Y):- path(X,Z), edge(Z,Y).
+path(X,Y):- edge(X,Y).
+
+go:- nodes(N), between(1, N, X), path(X,_), fail.
+go.
+
+
+bench(Limit):- abolish_all_tables,
+        yap_flag(table_space_limit, Limit),
+        tabling_statistics(evicted_subgoals, [B0,S0]),
+        statistics(walltime, [T0,_]),
+        go,
+        go,
+        statistics(walltime, [T1,_]),
+        tabling_statistics(evicted_subgoals, [B1,S1]),
+        T is T1 - T0,
+        S is S1 - S0,
+        B is B1 - B0,
+        format('table space limit: ~d bytes  walltime: ~d ms  evicted subgoals: ~d (~d bytes)~n', [Limit,T,S,B]).
+
+
+
+:- bench(0).
+:- bench(4000000).
+:- bench(1000000).
+:- bench(250000).
+%:- tabling_statistics.
+:-halt.
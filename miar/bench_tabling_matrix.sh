@@ -0,0 +1,119 @@
+#!/bin/sh
+#
+# Runs miar/bench_tabling_suite.pl over a matrix of configurations and
+# collects one CSV file with the results.
+#
+# Each configuration gives the configure options and the opt.config.h
+# options to turn on and off. The sources are copied once to the work
+# directory and, for each configuration, OPTYap/opt.config.h is restored
+# and edited, YAP is built in its own directory, and the suite is run for
+# each number of workers (or threads) and each scheduling strategy.
+#
+# Usage: miar/bench_tabling_matrix.sh [CSV file]
+#
+# Environment variables:
+#   WORK        work directory (default /tmp/yap_bench_matrix)
+#   CONFIGS     file with the configurations (default: the list below)
+#   WORKERS     numbers of workers or threads (default "1 2 4 8")
+#   SCHEDULING  tabling modes (default "batched local")
+#   BENCHMARKS  benchmarks to run, each one in its own YAP process
+#               (default: all the benchmarks of the suite)
+#   TIMEOUT     seconds allowed for each benchmark run (default 600)
+#   BENCH_SCALE passed to the suite
+#   YAP_FLAGS   stack sizes for the parallel runs (default "-s 40000 -h 300000 -t 80000")
+#   JOBS        parallel make jobs (default: number of processors)
+#   CFLAGS, CXXFLAGS  passed to configure (recent compilers need
+#               CFLAGS=-fcommon CXXFLAGS=-std=gnu++98)
+#
+# Each line of the configurations has the form
+#   name|engine|configure options|opt.config.h options
+# where engine is seq, yapor or threads and each opt.config.h option is
+# MACRO=on or MACRO=off. Lines starting with '#' are ignored. The
+# threads engines (--enable-threads with THREADS_*_SHARING) do not build
+# in this tree, thus they are not in the default list.
+#
+# The configurations that fail to build and the benchmark runs that crash
+# or time out are listed at the end, and the script then exits with
+# status 1.
+
+SRC=`cd \`dirname $0\`/.. && pwd`
+CSV=${1:-`pwd`/bench_tabling.csv}
+WORK=${WORK:-/tmp/yap_bench_matrix}
+WORKERS=${WORKERS:-"1 2 4 8"}
+SCHEDULING=${SCHEDULING:-"batched local"}
+BENCHMARKS=${BENCHMARKS:-"chain_left chain_right cycle_left cycle_right grid_left grid_right random_left random_right same_generation shortest_path"}
+TIMEOUT=${TIMEOUT:-600}
+JOBS=${JOBS:-`getconf _NPROCESSORS_ONLN 2> /dev/null || echo 1`}
+YAP_FLAGS=${YAP_FLAGS:-"-s 40000 -h 300000 -t 80000"}
+COMMON="--disable-myddas --with-readline=no --with-gmp=no"
+
+default_configs() {
+cat <<EOF
+seq|seq|--enable-tabling|
+yapor_node_locks|yapor|--enable-tabling --enable-or-parallelism=copy|
+yapor_entry_locks|yapor|--enable-tabling --enable-or-parallelism=copy|SUBGOAL_TRIE_LOCK_AT_NODE_LEVEL=off SUBGOAL_TRIE_LOCK_AT_ENTRY_LEVEL=on ANSWER_TRIE_LOCK_AT_NODE_LEVEL=off ANSWER_TRIE_LOCK_AT_ENTRY_LEVEL=on
+yapor_write_locks|yapor|--enable-tabling --enable-or-parallelism=copy|SUBGOAL_TRIE_LOCK_AT_NODE_LEVEL=off SUBGOAL_TRIE_LOCK_AT_WRITE_LEVEL=on ANSWER_TRIE_LOCK_AT_NODE_LEVEL=off ANSWER_TRIE_LOCK_AT_WRITE_LEVEL=on
+EOF
+}
+
+# set_option FILE MACRO on|off
+set_option() {
+  case $3 in
+    on)  sed -e "s|^/\* *#define $2\([ 	][^*]*[^ *]\) *\*/|#define $2\1|" $1 > $1.tmp ;;
+    off) sed -e "s|^#define $2\([ 	].*\)$|/* #define $2\1 */|" $1 > $1.tmp ;;
+  esac
+  mv $1.tmp $1
+}
+
+mkdir -p $WORK
+echo "copying the sources to $WORK/src"
+rm -rf $WORK/src
+mkdir -p $WORK/src
+(cd $SRC && tar cf - --exclude=.git .) | (cd $WORK/src && tar xf -)
+cp $WORK/src/OPTYap/opt.config.h $WORK/opt.config.h.orig
+
+FAILED=$WORK/failed
+rm -f $FAILED
+touch $FAILED
+
+echo "config,engine,workers,scheduling,benchmark,size,walltime_ms,table_bytes,answers,answers_per_sec" > $CSV
+
+if test -n "$CONFIGS"; then cat $CONFIGS; else default_configs; fi | grep -v '^#' | grep -v '^$' |
+while IFS='|' read NAME ENGINE OPTIONS DEFINES; do
+  echo "building $NAME"
+  cp $WORK/opt.config.h.orig $WORK/src/OPTYap/opt.config.h
+  for DEFINE in $DEFINES; do
+    set_option $WORK/src/OPTYap/opt.config.h `echo $DEFINE | sed -e 's/=/ /'`
+  done
+  BUILD=$WORK/build_$NAME
+  rm -rf $BUILD
+  mkdir -p $BUILD
+  if ! (cd $BUILD && $WORK/src/configure $COMMON $OPTIONS > configure.log 2>&1 &&
+        make -j$JOBS yap > make.log 2>&1 && make startup.yss >> make.log 2>&1); then
+    echo "  build failed, see $BUILD (configuration skipped)"
+    echo "build of $NAME, see $BUILD" >> $FAILED
+    continue
+  fi
+  if test $ENGINE = seq; then RUN_WORKERS=1; else RUN_WORKERS=$WORKERS; fi
+  for W in $RUN_WORKERS; do
+    for SCHED in $SCHEDULING; do
+      echo "  running $NAME with $W worker(s) and $SCHED scheduling"
+      if test $ENGINE = yapor; then ARGS="-w $W $YAP_FLAGS"; else ARGS=""; fi
+      for BENCH in $BENCHMARKS; do
+        if ! (cd $BUILD && BENCH_CONFIG=$NAME BENCH_ENGINE=$ENGINE BENCH_WORKERS=$W BENCH_SCHEDULING=$SCHED \
+              BENCH_ONLY=$BENCH BENCH_CSV=$CSV timeout $TIMEOUT ./yap -l $SRC/miar/bench_tabling_suite.pl $ARGS \
+              > run_${W}_${SCHED}_$BENCH.log 2>&1 < /dev/null); then
+          echo "    $BENCH failed, see $BUILD/run_${W}_${SCHED}_$BENCH.log"
+          echo "$BENCH with $NAME, see $BUILD/run_${W}_${SCHED}_$BENCH.log" >> $FAILED
+        fi
+      done
+    done
+  done
+done
+
+echo "results in $CSV"
+if test -s $FAILED; then
+  echo "failed:"
+  sed -e 's/^/  /' $FAILED
+  exit 1
+fi
@@ -0,0 +1,148 @@
+% Tabling benchmark suite.
+%
+% Each benchmark builds its graph with assert/1, evaluates a tabled goal
+% with all answers and records one CSV line with the walltime, the table
+% memory in use (tabling_statistics(total_memory,_), i.e., code 0 of
+% p_get_optyap_statistics() in OPTYap/opt.preds.c), the number of answers
+% in the table and the answers per second. The benchmarks are:
+%
+%   chain_left / chain_right     transitive closure of a chain
+%   cycle_left / cycle_right     transitive closure of a cycle
+%   grid_left / grid_right       transitive closure of a grid
+%   random_left / random_right   transitive closure of a random graph
+%   same_generation              same generation on a binary tree
+%   shortest_path                mode-directed (min) shortest paths on a
+%                                random weighted graph (skipped when YAP is
+%                                compiled without MODE_DIRECTED_TABLING)
+%
+% The run is driven by the environment variables below, which are set by
+% miar/bench_tabling_matrix.sh for each point of the configuration matrix:
+%
+%   BENCH_CONFIG      name of the opt.config.h/configure configuration
+%   BENCH_ENGINE      seq (default), yapor (parallel/1) or threads
+%   BENCH_WORKERS     number of workers or threads (default 1)
+%   BENCH_SCHEDULING  batched (default) or local
+%   BENCH_SCALE       multiplies the benchmark sizes (default 1)
+%   BENCH_ONLY        run only the named benchmark
+%   BENCH_CSV         append the CSV lines to this file (default stdout)
+%
+% ./yap -l ../yaptab-par/miar/bench_tabling_suite.pl
+% BENCH_ENGINE=yapor BENCH_WORKERS=8 ./yap -l ../yaptab-par/miar/bench_tabling_suite.pl -w 8 -s 40000 -h 300000 -t 80000
+
+:- dynamic edge/2, wedge/3, par/2, node/1.
+
+:- table path_l/2, path_r/2, sg/2.
+% mode-directed tabling is not available with YapOr, sp/3 is then not
+% tabled and shortest_path is skipped
+:- catch(table(sp(index,index,min)), _, true).
+
+path_l(X,Y):- path_l(X,Z), edge(Z,Y).
+path_l(X,Y):- edge(X,Y).
+
+path_r(X,Y):- edge(X,Z), path_r(Z,Y).
+path_r(X,Y):- edge(X,Y).
+
+sg(X,X):- node(X).
+sg(X,Y):- par(X,XP), sg(XP,YP), par(Y,YP).
+
+sp(X,Y,D):- wedge(X,Y,D).
+sp(X,Y,D):- sp(X,Z,D1), wedge(Z,Y,W), D is D1 + W.
+
+
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%%                             benchmarks                              %%
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+%% benchmark(Name, BaseSize, Graph, Goal)
+benchmark(chain_left,      1500, chain,  path_l(_,_)).
+benchmark(chain_right,     1500, chain,  path_r(_,_)).
+benchmark(cycle_left,       700, cycle,  path_l(_,_)).
+benchmark(cycle_right,      700, cycle,  path_r(_,_)).
+benchmark(grid_left,         30, grid,   path_l(_,_)).
+benchmark(grid_right,        30, grid,   path_r(_,_)).
+benchmark(random_left,     1000, random, path_l(_,_)).
+benchmark(random_right,    1000, random, path_r(_,_)).
+benchmark(same_generation,   10, tree,   sg(_,_)).
+benchmark(shortest_path,    600, wrandom, sp(_,_,_)).
+
+make_graph(chain, N):- between(1, N, X), X < N, Y is X + 1, assert(edge(X,Y)), fail.
+make_graph(cycle, N):- between(1, N, X), Y is X mod N + 1, assert(edge(X,Y)), fail.
+make_graph(grid, N):- between(1, N, I), between(1, N, J), X is (I - 1) * N + J,
+        ( J < N, Y is X + 1, assert(edge(X,Y)) ; I < N, Y is X + N, assert(edge(X,Y)) ), fail.
+make_graph(random, N):- E is 2 * N, nb_setval(bench_seed, 12345),
+        between(1, E, _), random_node(N, X), random_node(N, Y), assert(edge(X,Y)), fail.
+make_graph(tree, D):- Last is (1 << (D + 1)) - 1, between(1, Last, X), assert(node(X)),
+        X > 1, P is X // 2, assert(par(X,P)), fail.
+make_graph(wrandom, N):- E is 3 * N, nb_setval(bench_seed, 12345),
+        between(1, E, _), random_node(N, X), random_node(N, Y), random_node(10, W),
+        assert(wedge(X,Y,W)), fail.
+make_graph(_, _).
+
+%% deterministic linear congruential generator, the graphs must be the same in all runs
+random_node(N, X):- nb_getval(bench_seed, S0), S is (S0 * 1103515245 + 12345) mod 2147483648,
+        nb_setval(bench_seed, S), X is (S >> 16) mod N + 1.
+
+clean_graph:- retractall(edge(_,_)), retractall(wedge(_,_,_)),
+        retractall(par(_,_)), retractall(node(_)).
+
+
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%%                               runner                                %%
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+env(Name, _, Value):- getenv(Name, Value), Value \== '', !.
+env(_, Default, Default).
+
+env_number(Name, Default, Value):- env(Name, Default, A), ( atom(A) -> atom_number(A, Value) ; Value = A ).
+
+run_goal(seq, _, Goal):- call(Goal), fail.
+run_goal(yapor, _, Goal):- parallel(Goal), fail.
+run_goal(threads, W, Goal):- findall(Id, (between(1, W, _), thread_create((call(Goal), fail ; true), Id, [])), Ids),
+        member_id(Id, Ids), thread_join(Id, _), fail.
+run_goal(_, _, _).
+
+member_id(X, [X|_]).
+member_id(X, [_|L]):- member_id(X, L).
+
+count_answers(Goal, N):- nb_setval(bench_answers, 0),
+        ( call(Goal), nb_getval(bench_answers, C0), C is C0 + 1, nb_setval(bench_answers, C), fail ; true ),
+        nb_getval(bench_answers, N).
+
+run_benchmark(Name, Out):- benchmark(Name, BaseSize, Graph, Goal),
+        env('BENCH_CONFIG', default, Config),
+        env('BENCH_ENGINE', seq, Engine),
+        env_number('BENCH_WORKERS', 1, W),
+        env('BENCH_SCHEDULING', batched, Sched),
+        env_number('BENCH_SCALE', 1, Scale),
+        ( Graph == grid -> Size is integer(BaseSize * sqrt(Scale))
+        ; Graph == tree -> Size is BaseSize + integer(log(Scale) / log(4))
+        ; Size is BaseSize * Scale ),
+        abolish_all_tables, clean_graph, make_graph(Graph, Size),
+        yap_flag(tabling_mode, Sched),
+        garbage_collect,
+        statistics(walltime, [T0,_]),
+        run_goal(Engine, W, Goal),
+        statistics(walltime, [T1,_]),
+        tabling_statistics(total_memory, [Bytes,_]),
+        count_answers(Goal, Answers),
+        T is T1 - T0,
+        ( T > 0 -> Rate is integer(Answers * 1000 / T) ; Rate = 0 ),
+        format(Out, '~w,~w,~d,~w,~w,~d,~d,~d,~d,~d~n', [Config,Engine,W,Sched,Name,Size,T,Bytes,Answers,Rate]),
+        flush_output(Out),
+        abolish_all_tables, clean_graph.
+
+csv_header(Out):- format(Out, 'config,engine,workers,scheduling,benchmark,size,walltime_ms,table_bytes,answers,answers_per_sec~n', []).
+
+suite:- env('BENCH_ONLY', all, Only),
+        env('BENCH_CSV', user_output, File),
+        ( File == user_output -> Out = user_output, csv_header(Out) ; open(File, append, Out) ),
+        ( benchmark(Name, _, _, Goal), ( Only == all ; Only == Name ),
+          predicate_property(Goal, tabled), run_benchmark(Name, Out), fail ; true ),
+        ( File == user_output -> true ; close(Out) ).
+
+
+
+:- suite.
+:- halt.
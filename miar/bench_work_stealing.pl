@@ -0,0 +1,53 @@
+% Benchmark for the YapOr scheduler modes.
+%
+% The workload is an all-solutions N-queens search, a wide search tree
+% where most of the available work is in the upper nodes. With
+% parallel_scheduler_mode(bitmap) the idle workers select a victim from
+% the workers bitmaps and their loads (see get_work() in
+% OPTYap/or.scheduler.c), with parallel_scheduler_mode(steal) they first
+% steal the oldest work offer published by a busy worker below them
+% (see STEAL_DEQUE_SIZE in OPTYap/opt.config.h).
+%
+% Compare both modes for 1, 2, 4, 8 ... workers, e.g.:
+%
+% ./yap -l ../yaptab-par/miar/bench_work_stealing.pl -w 8 -s 40000 -h 300000 -t 80000
+% ./yap -l ../yaptab-par/miar/bench_work_stealing.pl -w 32 -s 40000 -h 300000 -t 80000
+% ./yap -l ../yaptab-par/miar/bench_work_stealing.pl -w 64 -s 40000 -h 300000 -t 80000
+
+size(11).
+
+queens(N, Qs):- range(1, N, Ns), select_queens(Ns, [], Qs).
+
+range(N, N, [N]):- !.
+range(M, N, [M|Ns]):- M1 is M + 1, range(M1, N, Ns).
+
+select_queens([], Qs, Qs).
+select_queens(Ns, Placed, Qs):- del(Q, Ns, Rest), safe(Placed, Q, 1), select_queens(Rest, [Q|Placed], Qs).
+
+del(X, [X|Xs], Xs).
+del(X, [Y|Ys], [Y|Xs]):- del(X, Ys, Xs).
+
+safe([], _, _).
+safe([Q|Qs], Q0, D):- Q0 =\= Q + D, Q0 =\= Q - D, D1 is D + 1, safe(Qs, Q0, D1).
+
+go_parallel:- size(N),
+       parallel(queens(N,_)),
+       fail.
+go_parallel.
+
+
+bench(Mode):- parallel_scheduler_mode(Mode),
+        statistics(walltime, [T0,_]),
+        go_parallel,
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        format('scheduler mode: ~w  walltime: ~d ms~n', [Mode,T]).
+
+
+
+:- parallel_mode(on).
+
+:- bench(bitmap).
+:- bench(steal).
+%:- or_statistics.
+:-halt.
@@ -0,0 +1,40 @@
+% Timeline of the YapOr scheduler events.
+%
+% With YAPOR_TRACING (see OPTYap/opt.config.h) each worker records the
+% begin and end of get_work, p_share_work, q_share_work,
+% share_private_nodes, suspend_branch, resume_suspension_frame,
+% public_completion and its idle periods in a ring of TRACE_BUFFER_SIZE
+% events. The sharing requests refused while a worker is idle are not
+% recorded as events, their number is given in the refused_requests
+% argument of the end of the idle period. The rings are reset at each
+% parallel goal and yapor_trace_dump/1 writes the last events of each
+% worker in the Chrome trace event JSON format (open it with
+% chrome://tracing or Perfetto).
+%
+% ./yap -l ../yaptab-par/miar/bench_yapor_trace.pl -w 4
+
+queens(N, Qs):- numbers(1, N, Ns), select_queens(Ns, [], Qs).
+
+numbers(I, N, []):- I > N.
+numbers(I, N, [I|Ns]):- I =< N, I1 is I + 1, numbers(I1, N, Ns).
+
+select_one(X, [X|L], L).
+select_one(X, [Y|L], [Y|R]):- select_one(X, L, R).
+
+select_queens([], Qs, Qs).
+select_queens(Ns, Placed, Qs):- select_one(Q, Ns, Rest), safe(Placed, Q, 1), select_queens(Rest, [Q|Placed], Qs).
+
+safe([], _, _).
+safe([Q|Qs], Q0, D):- Q0 =\= Q + D, Q0 =\= Q - D, D1 is D + 1, safe(Qs, Q0, D1).
+
+bench(Name, Goal):-
+        statistics(walltime, [T0,_]),
+        call(Goal),
+        statistics(walltime, [T1,_]),
+        T is T1 - T0,
+        format('~w: walltime: ~d ms~n', [Name,T]).
+
+
+
+:- bench(parallel_queens, (parallel(queens(10, _)) ; true)), yapor_trace_dump('yapor_trace.json').
+:- halt.